@@ -1,12 +1,20 @@
 /**
  * @file pwm_dimmer.h
  * @brief MOSFET PWM LED 디밍 드라이버
+ *
+ * LEDC 13비트 1 kHz. 페이드/램프는 LEDC 하드웨어 페이드로 실행하고, 하드웨어 한계
+ * (1회 1023 스텝)를 넘는 긴 램프는 세그먼트로 나눠 페이드 완료 인터럽트에서 이어
+ * 건다 — 램프 동안 CPU는 세그먼트 경계에서만 깨어난다. 스텝당 1023 PWM 주기보다
+ * 느린 램프(전체 구간 약 139분 초과)는 짧은 세그먼트 사이에 hold를 넣어 끝 시각을 맞춘다.
+ * pwm_dimmer_set()은 진행 중인 램프를 즉시 중단한다 (안전 차단).
  */
 #ifndef RBMS_PWM_DIMMER_H
 #define RBMS_PWM_DIMMER_H
 
 #include "esp_err.h"
 #include "driver/gpio.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -14,8 +22,16 @@ extern "C" {
 
 esp_err_t pwm_dimmer_init(gpio_num_t gpio);
 esp_err_t pwm_dimmer_set(uint16_t brightness);        /* 0~1000 */
-esp_err_t pwm_dimmer_fade_to(uint16_t target, uint32_t duration_ms);
-uint16_t  pwm_dimmer_get(void);
+esp_err_t pwm_dimmer_fade_to(uint16_t target, uint32_t duration_ms);  /* 현재 밝기에서 */
+
+/**
+ * @brief from 밝기로 맞춘 뒤 duration_ms 동안 to까지 선형 램프
+ * @note 스케줄러 일출/일몰 구간 재적용용 (부팅/안전 차단 복구 후 중간 지점부터)
+ */
+esp_err_t pwm_dimmer_ramp(uint16_t from, uint16_t to, uint32_t duration_ms);
+
+uint16_t  pwm_dimmer_get(void);                        /* 현재 밝기 (램프 중에도) */
+bool      pwm_dimmer_is_ramping(void);
 esp_err_t pwm_dimmer_deinit(void);
 
 #ifdef __cplusplus
@@ -4,22 +4,132 @@
  */
 #include "pwm_dimmer.h"
 #include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
 #include "driver/ledc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 
 static const char *TAG = "pwm_dimmer";
 
 #define LEDC_TIMER       LEDC_TIMER_0
 #define LEDC_CHANNEL     LEDC_CHANNEL_0
 #define LEDC_FREQUENCY   1000
+#define LEDC_RESOLUTION  LEDC_TIMER_13_BIT   /* 1 kHz × 8192 = 8.2 MHz ≤ XTAL 40 MHz */
+#define DUTY_MAX         8191
 #define BRIGHTNESS_MAX   1000
 
+/*
+ * 하드웨어 페이드 1회 한계: 스텝 수(duty_num) ≤ 1023, 스텝당 PWM 주기(duty_cycle) ≤ 1023.
+ * 13비트 전체 구간(8191 스텝)을 30분에 가려면 나눠야 하므로 세그먼트당 1000 스텝,
+ * 세그먼트 끝(페이드 완료 인터럽트)에서 다음 세그먼트를 이어 건다.
+ */
+#define FADE_SEG_STEPS   1000
+/*
+ * 스텝당 1023 주기(1 kHz에서 1.023 s)보다 느린 램프 (전체 구간 약 139분 초과, 일출/일몰
+ * 최대 255분): 그대로 두면 하드웨어가 주기를 잘라 일찍 끝난다. 짧은 세그먼트를 최대
+ * 주기로 페이드하고 남은 시간은 멈춰 있다가 (hold) 다음 세그먼트 — 계단은 16/8191.
+ */
+#define FADE_CYCLE_MAX   1023
+#define FADE_HOLD_STEPS  16
+
+#define DIMMER_TASK_STACK 2048
+#define DIMMER_TASK_PRIO  5
+
 static bool s_initialized = false;
-static uint16_t s_brightness = 0;
+static SemaphoreHandle_t s_lock = NULL;
+static TaskHandle_t s_task = NULL;
+
+/* 진행 중인 램프 (s_lock 보호) */
+static bool     s_ramp_active = false;
+static uint32_t s_ramp_duty = 0;     /* 목표 duty */
+static uint32_t s_seg_duty = 0;      /* 진행 중인 세그먼트의 끝 duty */
+static int64_t  s_seg_end_us = 0;    /* 세그먼트 끝 시각 (느린 램프: 페이드 후 hold까지) */
+static int64_t  s_ramp_end_us = 0;   /* 끝 시각 (esp_timer 기준) */
 
 static uint32_t brightness_to_duty(uint16_t b)
 {
-    if (b >= BRIGHTNESS_MAX) return 1023;
-    return (uint32_t)b * 1023 / BRIGHTNESS_MAX;
+    if (b >= BRIGHTNESS_MAX) return DUTY_MAX;
+    return (uint32_t)b * DUTY_MAX / BRIGHTNESS_MAX;
+}
+
+/*
+ * 다음 세그먼트 시작 (s_lock 보유).
+ * 남은 duty/시간에 비례해 나누므로 세그먼트가 늦게 끝나도 램프 끝 시각을 맞춘다.
+ */
+static esp_err_t start_segment(uint32_t duty)
+{
+    uint32_t left = (duty > s_ramp_duty) ? duty - s_ramp_duty : s_ramp_duty - duty;
+    int64_t left_us = s_ramp_end_us - esp_timer_get_time();
+
+    if (left == 0 || left_us <= 1000) {
+        s_ramp_active = false;
+        return ledc_set_duty_and_update(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL, s_ramp_duty, 0);
+    }
+
+    uint32_t steps = (left > FADE_SEG_STEPS) ? FADE_SEG_STEPS : left;
+    /* 스텝당 주기 = 남은 시간 × 주파수 / 남은 스텝 (세그먼트 크기와 무관) */
+    bool slow = left_us * LEDC_FREQUENCY / 1000000 / left > FADE_CYCLE_MAX;
+    if (slow && steps > FADE_HOLD_STEPS) steps = FADE_HOLD_STEPS;
+    uint32_t seg_duty = (duty < s_ramp_duty) ? duty + steps : duty - steps;
+    uint32_t seg_ms = (uint32_t)(left_us * steps / left / 1000);
+    if (seg_ms == 0) seg_ms = 1;
+    s_seg_duty = seg_duty;
+    s_seg_end_us = esp_timer_get_time() + (slow ? (int64_t)seg_ms * 1000 : 0);
+
+    esp_err_t ret = slow
+        ? ledc_set_fade_with_step(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL, seg_duty, 1, FADE_CYCLE_MAX)
+        : ledc_set_fade_with_time(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL, seg_duty, seg_ms);
+    if (ret == ESP_OK) {
+        ret = ledc_fade_start(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL, LEDC_FADE_NO_WAIT);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Fade segment failed: %s", esp_err_to_name(ret));
+        s_ramp_active = false;
+    }
+    return ret;
+}
+
+/* 페이드 완료 (ISR) — 세그먼트 연결은 태스크에서 (LEDC 페이드 API는 ISR 불가) */
+static bool IRAM_ATTR fade_end_isr(const ledc_cb_param_t *param, void *arg)
+{
+    BaseType_t woken = pdFALSE;
+    if (param->event == LEDC_FADE_END_EVT && s_task != NULL) {
+        vTaskNotifyGiveFromISR(s_task, &woken);
+    }
+    return woken == pdTRUE;
+}
+
+/* 세그먼트 사이에만 깨어남 (30분 램프 = 9회, 255분 램프 = hold 포함 약 1000회) */
+static void dimmer_task(void *param)
+{
+    TickType_t wait = portMAX_DELAY;
+    while (1) {
+        /* 타임아웃 = hold 끝 (페이드 완료 통지 없이 깨어남) */
+        ulTaskNotifyTake(pdTRUE, wait);
+        wait = portMAX_DELAY;
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        /* ledc_set_duty_and_update()도 페이드 완료를 내므로 세그먼트 끝인지 확인 */
+        uint32_t duty = ledc_get_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL);
+        if (s_ramp_active && duty == s_seg_duty) {
+            int64_t hold_us = s_seg_end_us - esp_timer_get_time();
+            if (hold_us > 1000) {
+                wait = pdMS_TO_TICKS(hold_us / 1000);
+                if (wait == 0) wait = 1;
+            } else {
+                start_segment(duty);
+            }
+        }
+        xSemaphoreGive(s_lock);
+    }
+}
+
+/* 진행 중인 램프/페이드 중단 (s_lock 보유) */
+static void cancel_ramp(void)
+{
+    s_ramp_active = false;
+    ledc_fade_stop(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL);
 }
 
 esp_err_t pwm_dimmer_init(gpio_num_t gpio)
@@ -27,7 +137,7 @@ esp_err_t pwm_dimmer_init(gpio_num_t gpio)
     ledc_timer_config_t tc = {
         .speed_mode      = LEDC_LOW_SPEED_MODE,
         .timer_num       = LEDC_TIMER,
-        .duty_resolution = LEDC_TIMER_10_BIT,
+        .duty_resolution = LEDC_RESOLUTION,
         .freq_hz         = LEDC_FREQUENCY,
         .clk_cfg         = LEDC_USE_XTAL_CLK,
     };
@@ -45,10 +155,26 @@ esp_err_t pwm_dimmer_init(gpio_num_t gpio)
     ret = ledc_channel_config(&cc);
     if (ret != ESP_OK) return ret;
 
-    ledc_fade_func_install(0);
-    s_brightness = 0;
+    ret = ledc_fade_func_install(0);
+    if (ret != ESP_OK) return ret;
+
+    if (s_lock == NULL) {
+        s_lock = xSemaphoreCreateMutex();
+        if (s_lock == NULL) return ESP_ERR_NO_MEM;
+    }
+    if (s_task == NULL &&
+        xTaskCreate(dimmer_task, "dimmer", DIMMER_TASK_STACK, NULL, DIMMER_TASK_PRIO,
+                    &s_task) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    ledc_cbs_t cbs = { .fade_cb = fade_end_isr };
+    ret = ledc_cb_register(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL, &cbs, NULL);
+    if (ret != ESP_OK) return ret;
+
+    s_ramp_active = false;
     s_initialized = true;
-    ESP_LOGI(TAG, "PWM dimmer init GPIO%d", gpio);
+    ESP_LOGI(TAG, "PWM dimmer init GPIO%d (13-bit, HW fade)", gpio);
     return ESP_OK;
 }
 
@@ -57,35 +183,69 @@ esp_err_t pwm_dimmer_set(uint16_t brightness)
     if (!s_initialized) return ESP_ERR_INVALID_STATE;
     if (brightness > BRIGHTNESS_MAX) brightness = BRIGHTNESS_MAX;
 
-    uint32_t duty = brightness_to_duty(brightness);
-    esp_err_t ret = ledc_set_duty_and_update(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL, duty, 0);
-    if (ret == ESP_OK) s_brightness = brightness;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    cancel_ramp();
+    esp_err_t ret = ledc_set_duty_and_update(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL,
+                                             brightness_to_duty(brightness), 0);
+    xSemaphoreGive(s_lock);
     return ret;
 }
 
+/* 램프 시작 (s_lock 보유) — duty에서 목표까지 세그먼트 연결 */
+static esp_err_t begin_ramp(uint32_t duty, uint16_t target, uint32_t duration_ms)
+{
+    if (target > BRIGHTNESS_MAX) target = BRIGHTNESS_MAX;
+    s_ramp_duty = brightness_to_duty(target);
+    s_ramp_end_us = esp_timer_get_time() + (int64_t)duration_ms * 1000;
+    s_ramp_active = true;
+    return start_segment(duty);
+}
+
 esp_err_t pwm_dimmer_fade_to(uint16_t target, uint32_t duration_ms)
 {
     if (!s_initialized) return ESP_ERR_INVALID_STATE;
-    if (target > BRIGHTNESS_MAX) target = BRIGHTNESS_MAX;
 
-    uint32_t duty = brightness_to_duty(target);
-    esp_err_t ret = ledc_set_fade_with_time(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL,
-                                             duty, duration_ms);
-    if (ret == ESP_OK) {
-        ret = ledc_fade_start(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL, LEDC_FADE_NO_WAIT);
-    }
-    if (ret == ESP_OK) s_brightness = target;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    cancel_ramp();
+    esp_err_t ret = begin_ramp(ledc_get_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL),
+                               target, duration_ms);
+    xSemaphoreGive(s_lock);
+    return ret;
+}
+
+esp_err_t pwm_dimmer_ramp(uint16_t from, uint16_t to, uint32_t duration_ms)
+{
+    if (!s_initialized) return ESP_ERR_INVALID_STATE;
+    if (from > BRIGHTNESS_MAX) from = BRIGHTNESS_MAX;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    cancel_ramp();
+    uint32_t duty = brightness_to_duty(from);
+    esp_err_t ret = ledc_set_duty_and_update(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL, duty, 0);
+    if (ret == ESP_OK) ret = begin_ramp(duty, to, duration_ms);
+    xSemaphoreGive(s_lock);
     return ret;
 }
 
 uint16_t pwm_dimmer_get(void)
 {
-    return s_brightness;
+    if (!s_initialized) return 0;
+    /* 페이드 중에도 현재 duty (하드웨어 레지스터) */
+    uint32_t duty = ledc_get_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL);
+    return (uint16_t)((duty * BRIGHTNESS_MAX + DUTY_MAX / 2) / DUTY_MAX);
+}
+
+bool pwm_dimmer_is_ramping(void)
+{
+    return s_ramp_active;
 }
 
 esp_err_t pwm_dimmer_deinit(void)
 {
     if (!s_initialized) return ESP_OK;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    cancel_ramp();
+    xSemaphoreGive(s_lock);
     ledc_fade_func_uninstall();
     s_initialized = false;
     return ESP_OK;
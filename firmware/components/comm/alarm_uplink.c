@@ -0,0 +1,132 @@
+/**
+ * @file alarm_uplink.c
+ * @brief 안전 상태 전이 경보 업링크
+ *
+ * 통지(alarm_uplink_raise)는 최신 전이 1건만 보관하고 전송 태스크를 깨운다.
+ * 태스크는 인코딩 시점의 감지 후 경과 ms(age_ms)를 실어 보내고, ACK를 받은
+ * 전이가 여전히 최신이면 대기를 끝낸다.
+ */
+#include "alarm_uplink.h"
+#include "cbor_codec.h"
+#include "thread_node.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "alarm";
+
+#define ALARM_TASK_STACK  3072
+#define ALARM_TASK_PRIO   5       /* safety(6) 아래, thread 리포트(3) 위 */
+#define ALARM_RETRY_MS    1000    /* 재전송 소진/미연결 후 재시도 간격 */
+
+static TaskHandle_t s_task = NULL;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/* s_mux 보호 */
+static int s_state = 0;            /* 마지막으로 통지된 상태 (SAFETY_OK) */
+static bool s_pending = false;
+static cbor_alarm_t s_alarm;       /* 미전달 최신 전이 */
+static int64_t s_detect_us;
+static alarm_uplink_stats_t s_stats;
+
+void alarm_uplink_raise(int safety_status)
+{
+    int64_t now = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&s_mux);
+    bool changed = (safety_status != s_state);
+    if (changed) {
+        if (s_pending) s_stats.superseded++;
+        s_alarm.seq++;
+        s_alarm.prev_status = s_state;
+        s_alarm.safety_status = safety_status;
+        s_detect_us = now;
+        s_state = safety_status;
+        s_pending = true;
+        s_stats.raised++;
+    }
+    taskEXIT_CRITICAL(&s_mux);
+
+    TaskHandle_t task = s_task;
+    if (changed && task != NULL) xTaskNotifyGive(task);
+}
+
+static void alarm_task(void *param)
+{
+    uint8_t buf[32];
+
+    while (1) {
+        taskENTER_CRITICAL(&s_mux);
+        bool pending = s_pending;
+        cbor_alarm_t alarm = s_alarm;
+        int64_t detect_us = s_detect_us;
+        taskEXIT_CRITICAL(&s_mux);
+
+        if (!pending) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        if (!thread_node_is_connected()) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ALARM_RETRY_MS));
+            continue;
+        }
+
+        alarm.age_ms = (uint32_t)((esp_timer_get_time() - detect_us) / 1000);
+        size_t len = 0;
+        if (cbor_encode_alarm(&alarm, buf, sizeof(buf), &len) != ESP_OK) {
+            taskENTER_CRITICAL(&s_mux);
+            if (s_alarm.seq == alarm.seq) s_pending = false;  /* 인코딩 불가 상태값 */
+            taskEXIT_CRITICAL(&s_mux);
+            continue;
+        }
+
+        esp_err_t ret = thread_node_send_alarm(buf, len);
+        uint32_t latency_ms = (uint32_t)((esp_timer_get_time() - detect_us) / 1000);
+
+        taskENTER_CRITICAL(&s_mux);
+        bool latest = (s_alarm.seq == alarm.seq);
+        if (ret == ESP_OK) {
+            s_stats.delivered++;
+            s_stats.last_latency_ms = latency_ms;
+            if (latency_ms > s_stats.max_latency_ms) s_stats.max_latency_ms = latency_ms;
+        } else {
+            s_stats.send_failed++;
+        }
+        if (latest && ret != ESP_ERR_TIMEOUT) s_pending = false;  /* RST는 재전송해도 같은 결과 */
+        taskEXIT_CRITICAL(&s_mux);
+
+        if (ret == ESP_OK) {
+            ESP_LOGI(TAG, "Alarm #%u %d -> %d delivered in %lu ms", alarm.seq,
+                     alarm.prev_status, alarm.safety_status, (unsigned long)latency_ms);
+        } else {
+            ESP_LOGW(TAG, "Alarm #%u not delivered: %s", alarm.seq, esp_err_to_name(ret));
+            if (ret == ESP_ERR_TIMEOUT) {
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ALARM_RETRY_MS));
+            }
+        }
+    }
+}
+
+esp_err_t alarm_uplink_start(void)
+{
+    if (s_task != NULL) return ESP_ERR_INVALID_STATE;
+
+    if (xTaskCreate(alarm_task, "alarm", ALARM_TASK_STACK, NULL, ALARM_TASK_PRIO,
+                    &s_task) != pdPASS) {
+        s_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    xTaskNotifyGive(s_task);  /* 시작 전 통지된 전이 처리 */
+    return ESP_OK;
+}
+
+esp_err_t alarm_uplink_get_stats(alarm_uplink_stats_t *out)
+{
+    if (out == NULL) return ESP_ERR_INVALID_ARG;
+
+    taskENTER_CRITICAL(&s_mux);
+    *out = s_stats;
+    taskEXIT_CRITICAL(&s_mux);
+    return ESP_OK;
+}
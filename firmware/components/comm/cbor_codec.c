@@ -3,13 +3,23 @@
  * @brief 경량 CBOR 인코더/디코더 (외부 라이브러리 불필요)
  *
  * CBOR 정수 키 매핑 (IoT 효율):
- *   1: temp_hot, 2: temp_cool, 3: humidity, 4: battery_v,
- *   5: heater_duty, 6: light_duty, 7: safety_status
+ *   1: temp_hot, 2: temp_cool, 3: humidity, 4: battery_pct,
+ *   5: heater_duty, 6: light_duty, 7: safety_status, 19: schema 버전
  *
- * 서버 bridge (mqtt_influx_bridge.py)의 FIELD_MAP과 동일.
+ * 필드 구성은 telemetry_schema.h (schema/telemetry.json 생성)의 X-macro에서
+ * 디스크립터 테이블로 전개한다. 서버 rbms_schema.py와 같은 원본.
+ *
+ * 값 포맷:
+ *   FLOAT32 — 0xFA + 4 bytes (기존 포맷, 마커 없음)
+ *   SCALED  — 키 0 = 1 마커 (맵 첫 항목), 값은 x100 정수 (3250 = 32.50°C)
+ *   BATCH   — 키 0 = 2 마커, 첫 샘플 절대값 + 이후 샘플 델타 배열
  */
 #include "cbor_codec.h"
+#include "cbor_reader.h"
 #include "esp_log.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 
 static const char *TAG = "cbor_codec";
@@ -17,17 +27,52 @@ static const char *TAG = "cbor_codec";
 /* CBOR Major Types */
 #define CBOR_UINT    (0 << 5)
 #define CBOR_NEGINT  (1 << 5)
+#define CBOR_ARRAY   (4 << 5)
 #define CBOR_MAP     (5 << 5)
 #define CBOR_FLOAT32 0xFA
 
-/* CBOR 정수 키 (서버 bridge와 동일) */
-#define KEY_TEMP_HOT     1
-#define KEY_TEMP_COOL    2
-#define KEY_HUMIDITY     3
-#define KEY_BATTERY      4
-#define KEY_HEATER_DUTY  5
-#define KEY_LIGHT_DUTY   6
-#define KEY_SAFETY       7
+/* 필드 디스크립터 (스키마 순서 = 인코딩 순서 = 마스크 비트) */
+typedef struct {
+    uint8_t  key;
+    uint8_t  kind;      /* RBMS_KIND_SCALED: float, RBMS_KIND_ENUM: int */
+    uint8_t  optional;  /* 음수면 생략 */
+    uint16_t offset;    /* sensor_report_t 내 위치 */
+} field_desc_t;
+
+static const field_desc_t s_fields[CBOR_REPORT_FIELDS] = {
+#define X(id, key, member, kind, opt) { (key), (kind), (opt), offsetof(sensor_report_t, member) },
+    RBMS_TELEMETRY_FIELDS(X)
+#undef X
+};
+
+/* 수신 키 → 필드 인덱스 + 1 (0 = 텔레메트리 필드 아님) */
+#define FIELD_KEY_LIMIT 24
+static const uint8_t s_key_to_field[FIELD_KEY_LIMIT] = {
+#define X(id, key, member, kind, opt) [(key)] = CBOR_FIELD_IDX_##id + 1,
+    RBMS_TELEMETRY_FIELDS(X)
+#undef X
+};
+
+_Static_assert(CBOR_REPORT_FIELDS <= 16, "field_mask is 16-bit");
+#define X(id, key, member, kind, opt) \
+    _Static_assert((key) > 0 && (key) < FIELD_KEY_LIMIT, #id " key must be 1-byte"); \
+    _Static_assert(sizeof(((sensor_report_t *)0)->member) == 4, #id " member size");
+RBMS_TELEMETRY_FIELDS(X)
+#undef X
+
+static inline float field_float(const sensor_report_t *r, const field_desc_t *f)
+{
+    float v;
+    memcpy(&v, (const uint8_t *)r + f->offset, sizeof(v));
+    return v;
+}
+
+static inline int field_int(const sensor_report_t *r, const field_desc_t *f)
+{
+    int v;
+    memcpy(&v, (const uint8_t *)r + f->offset, sizeof(v));
+    return v;
+}
 
 static size_t cbor_write_uint(uint8_t *buf, uint8_t major, uint32_t val)
 {
@@ -38,14 +83,30 @@ static size_t cbor_write_uint(uint8_t *buf, uint8_t major, uint32_t val)
         buf[0] = major | 24;
         buf[1] = (uint8_t)val;
         return 2;
-    } else {
+    } else if (val <= 0xFFFF) {
         buf[0] = major | 25;
         buf[1] = (val >> 8) & 0xFF;
         buf[2] = val & 0xFF;
         return 3;
+    } else {
+        buf[0] = major | 26;
+        buf[1] = (val >> 24) & 0xFF;
+        buf[2] = (val >> 16) & 0xFF;
+        buf[3] = (val >> 8) & 0xFF;
+        buf[4] = val & 0xFF;
+        return 5;
     }
 }
 
+/* 부호 있는 정수: 음수는 CBOR negint (-1 - n) */
+static size_t cbor_write_int(uint8_t *buf, int32_t val)
+{
+    if (val >= 0) {
+        return cbor_write_uint(buf, CBOR_UINT, (uint32_t)val);
+    }
+    return cbor_write_uint(buf, CBOR_NEGINT, (uint32_t)(-1 - val));
+}
+
 static size_t cbor_write_float(uint8_t *buf, float val)
 {
     uint32_t bits;
@@ -58,21 +119,40 @@ static size_t cbor_write_float(uint8_t *buf, float val)
     return 5;
 }
 
+/* 리포트 값 1개 기록 (포맷에 따라 float32 또는 x100 정수) */
+static size_t cbor_write_value(uint8_t *buf, cbor_report_format_t format, float val)
+{
+    if (format == CBOR_REPORT_SCALED) {
+        float scaled = val * (float)CBOR_SCALED_FACTOR;
+        if (isnan(scaled)) scaled = 0.0f;
+        if (scaled > (float)INT32_MAX) scaled = (float)INT32_MAX;
+        if (scaled < (float)INT32_MIN) scaled = (float)INT32_MIN;
+        return cbor_write_int(buf, (int32_t)lroundf(scaled));
+    }
+    return cbor_write_float(buf, val);
+}
+
 esp_err_t cbor_encode_report(const sensor_report_t *report,
                               uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    return cbor_encode_report_fmt(report, CBOR_REPORT_FLOAT32, buf, buf_size, out_len);
+}
+
+esp_err_t cbor_encode_report_fmt(const sensor_report_t *report, cbor_report_format_t format,
+                                  uint8_t *buf, size_t buf_size, size_t *out_len)
 {
     if (report == NULL || buf == NULL || out_len == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    /* 필드 수 계산 */
-    int field_count = 3;  /* temp_hot, temp_cool, humidity (항상) */
-    if (report->battery_pct >= 0.0f) field_count++;
-    if (report->heater_duty >= 0.0f) field_count++;
-    if (report->light_duty >= 0.0f)  field_count++;
-    if (report->safety_status >= 0)  field_count++;
+    uint16_t mask = cbor_report_field_mask(report);
+    int field_count = 1;  /* 스키마 버전 */
+    for (int i = 0; i < CBOR_REPORT_FIELDS; i++) {
+        if (mask & (1 << i)) field_count++;
+    }
+    if (format == CBOR_REPORT_SCALED) field_count++;  /* 키 0 마커 */
 
-    /* 최소 버퍼: 1(map) + 7*(1+5) = 43, 64이면 충분 */
+    /* 최소 버퍼: 1(map) + 2(ver) + 7*(1+5) = 45, 64이면 충분 */
     if (buf_size < 64) {
         return ESP_ERR_NO_MEM;
     }
@@ -82,116 +162,612 @@ esp_err_t cbor_encode_report(const sensor_report_t *report,
     /* Map 헤더 */
     buf[pos++] = CBOR_MAP | (uint8_t)field_count;
 
-    /* 1: temp_hot */
-    pos += cbor_write_uint(buf + pos, CBOR_UINT, KEY_TEMP_HOT);
-    pos += cbor_write_float(buf + pos, report->temp_hot);
+    /* 0: 포맷 마커 (SCALED만, 맵 첫 항목) */
+    if (format == CBOR_REPORT_SCALED) {
+        pos += cbor_write_uint(buf + pos, CBOR_UINT, CBOR_KEY_MSG_TYPE);
+        pos += cbor_write_uint(buf + pos, CBOR_UINT, CBOR_MSG_REPORT_SCALED);
+    }
+
+    /* 19: 스키마 버전 */
+    pos += cbor_write_uint(buf + pos, CBOR_UINT, CBOR_KEY_SCHEMA_VERSION);
+    pos += cbor_write_uint(buf + pos, CBOR_UINT, RBMS_SCHEMA_VERSION);
+
+    /* 텔레메트리 필드 (스키마 순서, 옵션 필드는 음수면 생략) */
+    for (int i = 0; i < CBOR_REPORT_FIELDS; i++) {
+        if (!(mask & (1 << i))) continue;
+        const field_desc_t *f = &s_fields[i];
+        pos += cbor_write_uint(buf + pos, CBOR_UINT, f->key);
+        if (f->kind == RBMS_KIND_ENUM) {
+            pos += cbor_write_uint(buf + pos, CBOR_UINT, (uint32_t)field_int(report, f));
+        } else {
+            pos += cbor_write_value(buf + pos, format, field_float(report, f));
+        }
+    }
+
+    *out_len = pos;
+    ESP_LOGD(TAG, "Encoded %d bytes (%d fields)", (int)pos, field_count);
+    return ESP_OK;
+}
+
+esp_err_t cbor_decode_report(const uint8_t *buf, size_t len, sensor_report_t *report)
+{
+    if (buf == NULL || report == NULL || len < 2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* 기본값: 필수 필드 0, 옵션 필드 -1 (미사용) */
+    for (int i = 0; i < CBOR_REPORT_FIELDS; i++) {
+        const field_desc_t *f = &s_fields[i];
+        uint8_t *dst = (uint8_t *)report + f->offset;
+        if (f->kind == RBMS_KIND_ENUM) {
+            int v = f->optional ? -1 : 0;
+            memcpy(dst, &v, sizeof(v));
+        } else {
+            float v = f->optional ? -1.0f : 0.0f;
+            memcpy(dst, &v, sizeof(v));
+        }
+    }
+
+    cbor_reader_t rd;
+    cbor_item_t map;
+    cbor_reader_init(&rd, buf, len);
+    if (cbor_reader_next(&rd, &map) != ESP_OK || map.type != CBOR_TYPE_MAP) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool scaled = false;
+
+    /* 잘린 입력은 그때까지 읽은 필드만 반영 */
+    for (uint64_t i = 0; i < map.uval; i++) {
+        cbor_item_t key, val;
+        if (cbor_reader_next(&rd, &key) != ESP_OK ||
+            cbor_reader_next(&rd, &val) != ESP_OK) {
+            break;
+        }
+
+        /* 포맷 마커는 부호 없는 정수만 (음수/문자열/simple을 SCALED로 오인하지 않음) */
+        if (key.type == CBOR_TYPE_UINT && key.uval == CBOR_KEY_MSG_TYPE) {
+            if (val.type != CBOR_TYPE_UINT) return ESP_ERR_INVALID_ARG;
+            scaled = (val.uval == CBOR_MSG_REPORT_SCALED);
+            continue;
+        }
+
+        /* 알 수 없는 키/값 타입은 건너뜀 (중첩 컨테이너 포함) */
+        float fval = 0;
+        if (key.type != CBOR_TYPE_UINT ||
+            cbor_item_to_float(&val, &fval) != ESP_OK) {
+            if (cbor_reader_skip(&rd, &val) != ESP_OK) break;
+            continue;
+        }
+        bool is_int = (val.type == CBOR_TYPE_UINT || val.type == CBOR_TYPE_NEGINT);
+
+        /* 스키마 버전 등 텔레메트리 필드가 아닌 키는 무시 (새 버전의 키 포함) */
+        if (key.uval >= FIELD_KEY_LIMIT || s_key_to_field[key.uval] == 0) {
+            continue;
+        }
+        const field_desc_t *f = &s_fields[s_key_to_field[key.uval] - 1];
+        uint8_t *dst = (uint8_t *)report + f->offset;
+
+        if (f->kind == RBMS_KIND_ENUM) {
+            int iv = (int)fval;
+            memcpy(dst, &iv, sizeof(iv));
+        } else {
+            /* SCALED 포맷의 정수 값만 환산 */
+            if (scaled && is_int) {
+                fval /= (float)CBOR_SCALED_FACTOR;
+            }
+            memcpy(dst, &fval, sizeof(fval));
+        }
+    }
+
+    return ESP_OK;
+}
 
-    /* 2: temp_cool */
-    pos += cbor_write_uint(buf + pos, CBOR_UINT, KEY_TEMP_COOL);
-    pos += cbor_write_float(buf + pos, report->temp_cool);
+/* --- 리포트 템플릿 (고정 폭 값 슬롯) --- */
 
-    /* 3: humidity */
-    pos += cbor_write_uint(buf + pos, CBOR_UINT, KEY_HUMIDITY);
-    pos += cbor_write_float(buf + pos, report->humidity);
+#define CBOR_UINT16_AI  25
+#define CBOR_UINT8_AI   24
+#define TMPL_INT_WIDTH  3   /* 0x19/0x39 + 2 bytes */
+#define TMPL_F32_WIDTH  5   /* 0xFA + 4 bytes */
+
+uint16_t cbor_report_field_mask(const sensor_report_t *report)
+{
+    if (report == NULL) return 0;
+    uint16_t mask = 0;
+    for (int i = 0; i < CBOR_REPORT_FIELDS; i++) {
+        const field_desc_t *f = &s_fields[i];
+        bool present = !f->optional ||
+                       (f->kind == RBMS_KIND_ENUM ? field_int(report, f) >= 0
+                                                  : field_float(report, f) >= 0.0f);
+        if (present) mask |= (uint16_t)(1 << i);
+    }
+    return mask;
+}
+
+/* 템플릿 최대 길이: 맵 헤더 + 마커 + 버전 + 모든 필드 (키 1 byte) */
+#define X(id, key, member, kind, opt) \
+    + 1 + ((kind) == RBMS_KIND_ENUM ? 2 : TMPL_F32_WIDTH)
+_Static_assert(1 + 2 + 2 RBMS_TELEMETRY_FIELDS(X) <= CBOR_TEMPLATE_MAX,
+               "CBOR_TEMPLATE_MAX too small for schema");
+#undef X
+
+esp_err_t cbor_template_init(cbor_report_template_t *tmpl, uint16_t field_mask,
+                              cbor_report_format_t format)
+{
+    if (tmpl == NULL || (field_mask >> CBOR_REPORT_FIELDS) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int field_count = 1;  /* 스키마 버전 */
+    for (int i = 0; i < CBOR_REPORT_FIELDS; i++) {
+        if (field_mask & (1 << i)) field_count++;
+    }
+    if (format == CBOR_REPORT_SCALED) field_count++;
+
+    memset(tmpl, 0, sizeof(*tmpl));
+    tmpl->field_mask = field_mask;
+    tmpl->format = format;
+
+    /* 최대 1 + 2 + 2 + 6*(1+5) + (1+2) = 44 bytes < CBOR_TEMPLATE_MAX */
+    size_t pos = 0;
+    tmpl->buf[pos++] = CBOR_MAP | (uint8_t)field_count;
+    if (format == CBOR_REPORT_SCALED) {
+        pos += cbor_write_uint(tmpl->buf + pos, CBOR_UINT, CBOR_KEY_MSG_TYPE);
+        pos += cbor_write_uint(tmpl->buf + pos, CBOR_UINT, CBOR_MSG_REPORT_SCALED);
+    }
+    pos += cbor_write_uint(tmpl->buf + pos, CBOR_UINT, CBOR_KEY_SCHEMA_VERSION);
+    pos += cbor_write_uint(tmpl->buf + pos, CBOR_UINT, RBMS_SCHEMA_VERSION);
+
+    /* 키 순서는 cbor_encode_report_fmt()와 동일 (스키마 순서) */
+    for (int i = 0; i < CBOR_REPORT_FIELDS; i++) {
+        if (!(field_mask & (1 << i))) continue;
+        pos += cbor_write_uint(tmpl->buf + pos, CBOR_UINT, s_fields[i].key);
+        tmpl->offset[i] = (uint8_t)pos;
+        if (s_fields[i].kind == RBMS_KIND_ENUM) {
+            tmpl->buf[pos] = CBOR_UINT | CBOR_UINT8_AI;
+            pos += 2;
+        } else if (format == CBOR_REPORT_SCALED) {
+            tmpl->buf[pos] = CBOR_UINT | CBOR_UINT16_AI;
+            pos += TMPL_INT_WIDTH;
+        } else {
+            tmpl->buf[pos] = CBOR_FLOAT32;
+            pos += TMPL_F32_WIDTH;
+        }
+    }
+
+    tmpl->len = (uint8_t)pos;
+    ESP_LOGD(TAG, "Template built: mask=0x%04x, %d bytes", field_mask, (int)pos);
+    return ESP_OK;
+}
+
+/* x100 정수를 16-bit 인자 고정 폭으로 기록 (범위 밖은 포화) */
+static void tmpl_put_scaled(uint8_t *p, float val)
+{
+    float scaled = val * (float)CBOR_SCALED_FACTOR;
+    int32_t v;
+    if (isnan(scaled)) {
+        v = 0;
+    } else if (scaled > 65535.0f) {
+        v = 65535;
+    } else if (scaled < -65536.0f) {
+        v = -65536;
+    } else {
+        /* 범위가 제한되어 있으므로 lroundf 대신 0.5 가산 후 절삭 (half away from zero) */
+        v = (int32_t)(scaled + ((scaled >= 0.0f) ? 0.5f : -0.5f));
+    }
+    uint32_t arg = (v >= 0) ? (uint32_t)v : (uint32_t)(-1 - v);
+    p[0] = ((v >= 0) ? CBOR_UINT : CBOR_NEGINT) | CBOR_UINT16_AI;
+    p[1] = (uint8_t)(arg >> 8);
+    p[2] = (uint8_t)(arg & 0xFF);
+}
+
+/* 값 슬롯 덮어쓰기 (필드 구성 일치는 호출자가 보장) */
+static void tmpl_fill(cbor_report_template_t *tmpl, const sensor_report_t *report)
+{
+    for (int i = 0; i < CBOR_REPORT_FIELDS; i++) {
+        if (tmpl->offset[i] == 0) continue;
+        const field_desc_t *f = &s_fields[i];
+        uint8_t *p = tmpl->buf + tmpl->offset[i];
+        if (f->kind == RBMS_KIND_ENUM) {
+            p[1] = (uint8_t)field_int(report, f);
+        } else if (tmpl->format == CBOR_REPORT_SCALED) {
+            tmpl_put_scaled(p, field_float(report, f));
+        } else {
+            cbor_write_float(p, field_float(report, f));
+        }
+    }
+}
+
+esp_err_t cbor_template_patch(cbor_report_template_t *tmpl, const sensor_report_t *report)
+{
+    if (tmpl == NULL || report == NULL || tmpl->len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (cbor_report_field_mask(report) != tmpl->field_mask) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    tmpl_fill(tmpl, report);
+    return ESP_OK;
+}
+
+esp_err_t cbor_template_encode(cbor_report_template_t *tmpl, const sensor_report_t *report,
+                                cbor_report_format_t format,
+                                const uint8_t **out, size_t *out_len)
+{
+    if (tmpl == NULL || report == NULL || out == NULL || out_len == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint16_t mask = cbor_report_field_mask(report);
+    if (tmpl->len == 0 || tmpl->field_mask != mask || tmpl->format != format) {
+        esp_err_t err = cbor_template_init(tmpl, mask, format);
+        if (err != ESP_OK) return err;
+    }
+
+    tmpl_fill(tmpl, report);
+
+    *out = tmpl->buf;
+    *out_len = tmpl->len;
+    return ESP_OK;
+}
+
+/* --- 배치 (델타 인코딩) --- */
+
+/* x100 정수 변환 (int16 범위로 포화) */
+static int16_t cbor_scale_i16(float val)
+{
+    float scaled = val * (float)CBOR_SCALED_FACTOR;
+    if (isnan(scaled)) return 0;
+    if (scaled > 32767.0f) return 32767;
+    if (scaled < -32768.0f) return -32768;
+    return (int16_t)lroundf(scaled);
+}
+
+/* 경계 검사 후 헤더/정수 기록 (항목당 최대 5 bytes) */
+static bool cbor_put_head(uint8_t *buf, size_t buf_size, size_t *pos,
+                          uint8_t major, uint32_t val)
+{
+    if (*pos + 5 > buf_size) return false;
+    *pos += cbor_write_uint(buf + *pos, major, val);
+    return true;
+}
+
+static bool cbor_put_int(uint8_t *buf, size_t buf_size, size_t *pos, int32_t val)
+{
+    if (*pos + 5 > buf_size) return false;
+    *pos += cbor_write_int(buf + *pos, val);
+    return true;
+}
+
+void cbor_batch_reset(sensor_batch_t *batch)
+{
+    if (batch == NULL) return;
+    memset(batch, 0, sizeof(*batch));
+    batch->battery_pct = -1.0f;
+    batch->safety_status = -1;
+}
+
+esp_err_t cbor_batch_add(sensor_batch_t *batch, uint32_t timestamp,
+                          const sensor_report_t *report)
+{
+    if (batch == NULL || report == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* 가득 차면 가장 오래된 샘플 제거 */
+    if (batch->count >= CBOR_BATCH_MAX_SAMPLES) {
+        memmove(&batch->samples[0], &batch->samples[1],
+                sizeof(sensor_sample_t) * (CBOR_BATCH_MAX_SAMPLES - 1));
+        batch->count = CBOR_BATCH_MAX_SAMPLES - 1;
+        ESP_LOGW(TAG, "Batch full, dropped oldest sample");
+    }
+
+    sensor_sample_t *s = &batch->samples[batch->count++];
+    s->timestamp = timestamp;
+    s->temp_hot  = cbor_scale_i16(report->temp_hot);
+    s->temp_cool = cbor_scale_i16(report->temp_cool);
+    s->humidity  = cbor_scale_i16(report->humidity);
 
-    /* 4: battery (옵션) */
     if (report->battery_pct >= 0.0f) {
-        pos += cbor_write_uint(buf + pos, CBOR_UINT, KEY_BATTERY);
-        pos += cbor_write_float(buf + pos, report->battery_pct);
+        batch->battery_pct = report->battery_pct;
+    }
+    if (report->safety_status > batch->safety_status) {
+        batch->safety_status = report->safety_status;
     }
+    return ESP_OK;
+}
+
+esp_err_t cbor_encode_batch(const sensor_batch_t *batch, uint32_t now,
+                             uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    if (batch == NULL || buf == NULL || out_len == NULL ||
+        batch->count == 0 || batch->count > CBOR_BATCH_MAX_SAMPLES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int field_count = 5;  /* 마커, 버전, age, base, deltas */
+    if (batch->battery_pct >= 0.0f) field_count++;
+    if (batch->safety_status >= 0)  field_count++;
 
-    /* 5: heater_duty (옵션, Type A) */
-    if (report->heater_duty >= 0.0f) {
-        pos += cbor_write_uint(buf + pos, CBOR_UINT, KEY_HEATER_DUTY);
-        pos += cbor_write_float(buf + pos, report->heater_duty);
+    const sensor_sample_t *s0 = &batch->samples[0];
+    size_t pos = 0;
+    bool ok = cbor_put_head(buf, buf_size, &pos, CBOR_MAP, (uint32_t)field_count);
+
+    /* 0: 배치 마커 */
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_MSG_TYPE);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_MSG_BATCH);
+
+    /* 19: 스키마 버전 */
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_SCHEMA_VERSION);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, RBMS_SCHEMA_VERSION);
+
+    /* 20: 첫 샘플 경과 시간 (시계 역행 시 음수 가능) */
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_BATCH_AGE);
+    ok = ok && cbor_put_int(buf, buf_size, &pos, (int32_t)(now - s0->timestamp));
+
+    /* 21: 첫 샘플 절대값 */
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_BATCH_BASE);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_ARRAY, 3);
+    ok = ok && cbor_put_int(buf, buf_size, &pos, s0->temp_hot);
+    ok = ok && cbor_put_int(buf, buf_size, &pos, s0->temp_cool);
+    ok = ok && cbor_put_int(buf, buf_size, &pos, s0->humidity);
+
+    /* 22: 이후 샘플 델타 (평탄화 배열, 샘플당 4개) */
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_BATCH_DELTAS);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_ARRAY,
+                             (uint32_t)(batch->count - 1) * 4);
+    for (int i = 1; ok && i < batch->count; i++) {
+        const sensor_sample_t *prev = &batch->samples[i - 1];
+        const sensor_sample_t *cur = &batch->samples[i];
+        ok = cbor_put_int(buf, buf_size, &pos, (int32_t)(cur->timestamp - prev->timestamp));
+        ok = ok && cbor_put_int(buf, buf_size, &pos, cur->temp_hot - prev->temp_hot);
+        ok = ok && cbor_put_int(buf, buf_size, &pos, cur->temp_cool - prev->temp_cool);
+        ok = ok && cbor_put_int(buf, buf_size, &pos, cur->humidity - prev->humidity);
     }
 
-    /* 6: light_duty (옵션, Type A) */
-    if (report->light_duty >= 0.0f) {
-        pos += cbor_write_uint(buf + pos, CBOR_UINT, KEY_LIGHT_DUTY);
-        pos += cbor_write_float(buf + pos, report->light_duty);
+    /* 4: battery (x100 정수, 옵션) */
+    if (ok && batch->battery_pct >= 0.0f) {
+        ok = cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_BATTERY);
+        ok = ok && cbor_put_int(buf, buf_size, &pos, cbor_scale_i16(batch->battery_pct));
     }
 
     /* 7: safety (옵션) */
-    if (report->safety_status >= 0) {
-        pos += cbor_write_uint(buf + pos, CBOR_UINT, KEY_SAFETY);
-        pos += cbor_write_uint(buf + pos, CBOR_UINT, (uint32_t)report->safety_status);
+    if (ok && batch->safety_status >= 0) {
+        ok = cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_SAFETY);
+        ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT,
+                                 (uint32_t)batch->safety_status);
+    }
+
+    if (!ok) {
+        return ESP_ERR_NO_MEM;
     }
 
     *out_len = pos;
-    ESP_LOGD(TAG, "Encoded %d bytes (%d fields)", (int)pos, field_count);
+    ESP_LOGD(TAG, "Encoded batch %d bytes (%d samples)", (int)pos, batch->count);
     return ESP_OK;
 }
 
-esp_err_t cbor_decode_report(const uint8_t *buf, size_t len, sensor_report_t *report)
+esp_err_t cbor_encode_alarm(const cbor_alarm_t *alarm, uint8_t *buf, size_t buf_size,
+                             size_t *out_len)
 {
-    if (buf == NULL || report == NULL || len < 2) {
+    if (alarm == NULL || buf == NULL || out_len == NULL ||
+        alarm->safety_status < 0 || alarm->prev_status < 0) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    /* 기본값 */
-    report->temp_hot = 0;
-    report->temp_cool = 0;
-    report->humidity = 0;
-    report->battery_pct = -1.0f;
-    report->heater_duty = -1.0f;
-    report->light_duty = -1.0f;
-    report->safety_status = -1;
+    size_t pos = 0;
+    bool ok = cbor_put_head(buf, buf_size, &pos, CBOR_MAP, 6);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_MSG_TYPE);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_MSG_ALARM);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_SCHEMA_VERSION);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, RBMS_SCHEMA_VERSION);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_SAFETY);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, (uint32_t)alarm->safety_status);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_ALARM_SEQ);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, alarm->seq);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_ALARM_PREV);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, (uint32_t)alarm->prev_status);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_ALARM_AGE_MS);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, alarm->age_ms);
+    if (!ok) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    *out_len = pos;
+    return ESP_OK;
+}
+
+esp_err_t cbor_encode_time(const cbor_time_t *t, uint8_t *buf, size_t buf_size,
+                            size_t *out_len)
+{
+    if (t == NULL || buf == NULL || out_len == NULL || t->ms > 999) {
+        return ESP_ERR_INVALID_ARG;
+    }
 
     size_t pos = 0;
-    int map_count = buf[pos] & 0x1F;
-    pos++;
-
-    for (int i = 0; i < map_count && pos < len; i++) {
-        /* 정수 키 파싱 */
-        uint32_t key = 0;
-        if ((buf[pos] & 0xE0) == CBOR_UINT) {
-            uint8_t ai = buf[pos] & 0x1F;
-            pos++;
-            if (ai < 24) {
-                key = ai;
-            } else if (ai == 24 && pos < len) {
-                key = buf[pos++];
+    bool ok = cbor_put_head(buf, buf_size, &pos, CBOR_MAP, 4);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_MSG_TYPE);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_MSG_TIME);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_TIME_SEC);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, t->unix_sec);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_TIME_MS);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, t->ms);
+    ok = ok && cbor_put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_TIME_UTC_OFFSET);
+    ok = ok && cbor_put_int(buf, buf_size, &pos, t->utc_offset_min);
+    if (!ok) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    *out_len = pos;
+    return ESP_OK;
+}
+
+esp_err_t cbor_decode_time(const uint8_t *buf, size_t len, cbor_time_t *t)
+{
+    if (buf == NULL || t == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    cbor_reader_t rd;
+    cbor_item_t map, key, val;
+    int32_t v;
+    cbor_reader_init(&rd, buf, len);
+    if (cbor_reader_next(&rd, &map) != ESP_OK || map.type != CBOR_TYPE_MAP || map.uval == 0 ||
+        cbor_reader_get_int(&rd, &v) != ESP_OK || v != CBOR_KEY_MSG_TYPE ||
+        cbor_reader_get_int(&rd, &v) != ESP_OK || v != CBOR_MSG_TIME) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    bool has_sec = false;
+    memset(t, 0, sizeof(*t));
+    for (uint64_t i = 1; i < map.uval; i++) {
+        if (cbor_reader_next(&rd, &key) != ESP_OK || key.type != CBOR_TYPE_UINT ||
+            cbor_reader_next(&rd, &val) != ESP_OK) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        switch (key.uval) {
+            case CBOR_KEY_TIME_SEC:
+                if (val.type != CBOR_TYPE_UINT || val.uval > UINT32_MAX) return ESP_ERR_INVALID_ARG;
+                t->unix_sec = (uint32_t)val.uval;
+                has_sec = true;
+                break;
+            case CBOR_KEY_TIME_MS:
+                if (val.type != CBOR_TYPE_UINT || val.uval > 999) return ESP_ERR_INVALID_ARG;
+                t->ms = (uint16_t)val.uval;
+                break;
+            case CBOR_KEY_TIME_UTC_OFFSET: {
+                int64_t off = (val.type == CBOR_TYPE_UINT) ? (int64_t)val.uval
+                            : (val.type == CBOR_TYPE_NEGINT) ? -1 - (int64_t)val.uval
+                            : INT64_MAX;
+                if (off < -720 || off > 840) return ESP_ERR_INVALID_ARG;
+                t->utc_offset_min = (int16_t)off;
+                break;
             }
-        } else {
-            break;  /* 예상치 못한 타입 */
+            default:
+                if (cbor_reader_skip(&rd, &val) != ESP_OK) return ESP_ERR_INVALID_ARG;
+                break;
+        }
+    }
+    return has_sec ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t cbor_decode_batch(const uint8_t *buf, size_t len, uint32_t now,
+                             sensor_batch_t *batch)
+{
+    if (buf == NULL || batch == NULL || len < 2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    cbor_batch_reset(batch);
+
+    cbor_reader_t rd;
+    cbor_item_t map;
+    cbor_reader_init(&rd, buf, len);
+    if (cbor_reader_next(&rd, &map) != ESP_OK || map.type != CBOR_TYPE_MAP) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool is_batch = false;
+    int32_t age = 0;
+
+    for (uint64_t i = 0; i < map.uval; i++) {
+        cbor_item_t key, arr, val;
+        int32_t v = 0;
+        if (cbor_reader_next(&rd, &key) != ESP_OK) {
+            return ESP_ERR_INVALID_ARG;
         }
 
-        if (pos >= len) break;
+        /* 알 수 없는 키는 값째 건너뜀 (새 필드를 추가해도 이전 수신 측 동작) */
+        switch (key.type == CBOR_TYPE_UINT ? key.uval : UINT64_MAX) {
+            case CBOR_KEY_MSG_TYPE:
+                if (cbor_reader_get_int(&rd, &v) != ESP_OK || v != CBOR_MSG_BATCH) {
+                    return ESP_ERR_INVALID_ARG;
+                }
+                is_batch = true;
+                break;
 
-        /* 값 파싱: float32 또는 uint */
-        float fval = 0;
-        if (buf[pos] == CBOR_FLOAT32 && pos + 5 <= len) {
-            pos++;
-            uint32_t bits = ((uint32_t)buf[pos] << 24) |
-                            ((uint32_t)buf[pos+1] << 16) |
-                            ((uint32_t)buf[pos+2] << 8) |
-                            (uint32_t)buf[pos+3];
-            memcpy(&fval, &bits, sizeof(fval));
-            pos += 4;
-        } else if ((buf[pos] & 0xE0) == CBOR_UINT) {
-            uint8_t ai = buf[pos] & 0x1F;
-            pos++;
-            if (ai < 24) {
-                fval = (float)ai;
-            } else if (ai == 24 && pos < len) {
-                fval = (float)buf[pos++];
+            case CBOR_KEY_BATCH_AGE:
+                if (cbor_reader_get_int(&rd, &age) != ESP_OK) return ESP_ERR_INVALID_ARG;
+                break;
+
+            case CBOR_KEY_BATCH_BASE: {
+                int32_t hot, cool, hum;
+                if (cbor_reader_next(&rd, &arr) != ESP_OK ||
+                    arr.type != CBOR_TYPE_ARRAY || arr.uval != 3 ||
+                    cbor_reader_get_int(&rd, &hot) != ESP_OK ||
+                    cbor_reader_get_int(&rd, &cool) != ESP_OK ||
+                    cbor_reader_get_int(&rd, &hum) != ESP_OK) {
+                    return ESP_ERR_INVALID_ARG;
+                }
+                batch->samples[0].temp_hot  = (int16_t)hot;
+                batch->samples[0].temp_cool = (int16_t)cool;
+                batch->samples[0].humidity  = (int16_t)hum;
+                batch->count = 1;
+                break;
             }
-        } else {
-            break;
-        }
 
-        switch (key) {
-            case KEY_TEMP_HOT:    report->temp_hot = fval; break;
-            case KEY_TEMP_COOL:   report->temp_cool = fval; break;
-            case KEY_HUMIDITY:    report->humidity = fval; break;
-            case KEY_BATTERY:     report->battery_pct = fval; break;
-            case KEY_HEATER_DUTY: report->heater_duty = fval; break;
-            case KEY_LIGHT_DUTY:  report->light_duty = fval; break;
-            case KEY_SAFETY:      report->safety_status = (int)fval; break;
-            default: break;
+            case CBOR_KEY_BATCH_DELTAS: {
+                /* base가 먼저 와야 누적 가능 */
+                if (batch->count != 1 ||
+                    cbor_reader_next(&rd, &arr) != ESP_OK ||
+                    arr.type != CBOR_TYPE_ARRAY || (arr.uval % 4) != 0) {
+                    return ESP_ERR_INVALID_ARG;
+                }
+                if (arr.uval / 4 + 1 > CBOR_BATCH_MAX_SAMPLES) {
+                    return ESP_ERR_INVALID_SIZE;
+                }
+                uint32_t n = (uint32_t)(arr.uval / 4);
+                for (uint32_t k = 1; k <= n; k++) {
+                    int32_t dt, dh, dc, du;
+                    if (cbor_reader_get_int(&rd, &dt) != ESP_OK ||
+                        cbor_reader_get_int(&rd, &dh) != ESP_OK ||
+                        cbor_reader_get_int(&rd, &dc) != ESP_OK ||
+                        cbor_reader_get_int(&rd, &du) != ESP_OK) {
+                        return ESP_ERR_INVALID_ARG;
+                    }
+                    const sensor_sample_t *prev = &batch->samples[k - 1];
+                    sensor_sample_t *cur = &batch->samples[k];
+                    cur->timestamp = prev->timestamp + (uint32_t)dt;
+                    cur->temp_hot  = (int16_t)(prev->temp_hot + dh);
+                    cur->temp_cool = (int16_t)(prev->temp_cool + dc);
+                    cur->humidity  = (int16_t)(prev->humidity + du);
+                }
+                batch->count = (uint8_t)(n + 1);
+                break;
+            }
+
+            case CBOR_KEY_SCHEMA_VERSION:
+                if (cbor_reader_get_int(&rd, &v) != ESP_OK) return ESP_ERR_INVALID_ARG;
+                break;
+
+            case CBOR_KEY_BATTERY:
+                if (cbor_reader_get_int(&rd, &v) != ESP_OK) return ESP_ERR_INVALID_ARG;
+                batch->battery_pct = (float)v / (float)CBOR_SCALED_FACTOR;
+                break;
+
+            case CBOR_KEY_SAFETY:
+                if (cbor_reader_get_int(&rd, &v) != ESP_OK) return ESP_ERR_INVALID_ARG;
+                batch->safety_status = v;
+                break;
+
+            default:
+                if (cbor_reader_next(&rd, &val) != ESP_OK ||
+                    cbor_reader_skip(&rd, &val) != ESP_OK) {
+                    return ESP_ERR_INVALID_ARG;
+                }
+                break;
         }
     }
 
+    if (!is_batch || batch->count == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* 상대 timestamp → 수신 시각 기준 절대값 */
+    uint32_t base = now - (uint32_t)age;
+    for (int i = 0; i < batch->count; i++) {
+        batch->samples[i].timestamp += base;
+    }
     return ESP_OK;
 }
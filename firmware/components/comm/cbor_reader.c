@@ -0,0 +1,223 @@
+/**
+ * @file cbor_reader.c
+ * @brief 스트리밍 CBOR pull-parser (zero-copy, 재귀/힙 없음)
+ *
+ * 모든 읽기 전에 남은 길이를 확인한다. next()는 자신이 소비하는 바이트
+ * (헤더, 문자열 본문)만 검사하고 배열/맵 항목 수는 그대로 돌려준다.
+ * 잘린 맵에서도 앞쪽 항목을 읽을 수 있게 하기 위함이다.
+ * skip()은 항목당 최소 1 byte이므로 남은 항목 수가 남은 바이트 수를
+ * 넘으면 즉시 거부하여 카운터가 오버플로하지 않도록 한다.
+ */
+#include "cbor_reader.h"
+#include <math.h>
+#include <string.h>
+
+/* CBOR Major Types */
+#define MT_UINT    0
+#define MT_NEGINT  1
+#define MT_BYTES   2
+#define MT_TEXT    3
+#define MT_ARRAY   4
+#define MT_MAP     5
+#define MT_TAG     6
+#define MT_SIMPLE  7
+
+/* Additional info */
+#define AI_1BYTE      24
+#define AI_2BYTE      25
+#define AI_4BYTE      26
+#define AI_8BYTE      27
+#define AI_INDEFINITE 31
+
+/* IEEE 754 half → float */
+static float half_to_float(uint16_t h)
+{
+    int exp = (h >> 10) & 0x1F;
+    int mant = h & 0x3FF;
+    float val;
+    if (exp == 0) {
+        val = ldexpf((float)mant, -24);
+    } else if (exp != 31) {
+        val = ldexpf((float)(mant + 1024), exp - 25);
+    } else {
+        val = (mant == 0) ? INFINITY : NAN;
+    }
+    return (h & 0x8000) ? -val : val;
+}
+
+static uint64_t read_be(const uint8_t *p, size_t n)
+{
+    uint64_t v = 0;
+    for (size_t i = 0; i < n; i++) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+void cbor_reader_init(cbor_reader_t *r, const uint8_t *buf, size_t len)
+{
+    if (r == NULL) return;
+    r->buf = buf;
+    r->len = (buf != NULL) ? len : 0;
+    r->pos = 0;
+}
+
+bool cbor_reader_at_end(const cbor_reader_t *r)
+{
+    return r == NULL || r->pos >= r->len;
+}
+
+esp_err_t cbor_reader_next(cbor_reader_t *r, cbor_item_t *item)
+{
+    if (r == NULL || item == NULL) return ESP_ERR_INVALID_ARG;
+    if (r->pos >= r->len) return ESP_ERR_NOT_FOUND;
+
+    const uint8_t ib = r->buf[r->pos];
+    const uint8_t major = ib >> 5;
+    const uint8_t ai = ib & 0x1F;
+    size_t avail = r->len - r->pos - 1;
+
+    /* 인자 바이트 수 */
+    size_t arg_len;
+    if (ai < AI_1BYTE) {
+        arg_len = 0;
+    } else if (ai <= AI_8BYTE) {
+        arg_len = (size_t)1 << (ai - AI_1BYTE);
+    } else if (ai == AI_INDEFINITE) {
+        return ESP_ERR_NOT_SUPPORTED;
+    } else {
+        return ESP_ERR_INVALID_ARG;  /* 28~30 예약 */
+    }
+    if (arg_len > avail) return ESP_ERR_INVALID_SIZE;
+
+    uint64_t arg = (arg_len == 0) ? ai : read_be(r->buf + r->pos + 1, arg_len);
+    size_t next_pos = r->pos + 1 + arg_len;
+    avail -= arg_len;
+
+    memset(item, 0, sizeof(*item));
+    item->uval = arg;
+
+    switch (major) {
+        case MT_UINT:   item->type = CBOR_TYPE_UINT;   break;
+        case MT_NEGINT: item->type = CBOR_TYPE_NEGINT; break;
+        case MT_ARRAY:  item->type = CBOR_TYPE_ARRAY;  break;
+        case MT_MAP:    item->type = CBOR_TYPE_MAP;    break;
+        case MT_TAG:    item->type = CBOR_TYPE_TAG;    break;
+
+        case MT_BYTES:
+        case MT_TEXT:
+            if (arg > avail) return ESP_ERR_INVALID_SIZE;
+            item->type = (major == MT_BYTES) ? CBOR_TYPE_BYTES : CBOR_TYPE_TEXT;
+            item->ptr = r->buf + next_pos;
+            item->len = (size_t)arg;
+            next_pos += (size_t)arg;
+            break;
+
+        default: /* MT_SIMPLE */
+            if (ai == AI_2BYTE) {
+                item->type = CBOR_TYPE_FLOAT;
+                item->fval = half_to_float((uint16_t)arg);
+            } else if (ai == AI_4BYTE) {
+                uint32_t bits = (uint32_t)arg;
+                item->type = CBOR_TYPE_FLOAT;
+                memcpy(&item->fval, &bits, sizeof(item->fval));
+            } else if (ai == AI_8BYTE) {
+                double d;
+                memcpy(&d, &arg, sizeof(d));
+                item->type = CBOR_TYPE_FLOAT;
+                item->fval = (float)d;
+            } else {
+                item->type = CBOR_TYPE_SIMPLE;
+            }
+            break;
+    }
+
+    r->pos = next_pos;
+    return ESP_OK;
+}
+
+/*
+ * 남은 자식 항목 수에 item의 자식을 더한다.
+ * 합이 남은 바이트 수를 넘으면 false (uval * 2 오버플로 전에 검사).
+ */
+static bool add_children(uint64_t *pending, const cbor_item_t *item, size_t remaining)
+{
+    uint64_t n;
+    switch (item->type) {
+        case CBOR_TYPE_ARRAY: n = item->uval; break;
+        case CBOR_TYPE_MAP:
+            if (item->uval > remaining) return false;
+            n = item->uval * 2;
+            break;
+        case CBOR_TYPE_TAG:   n = 1; break;
+        default:              n = 0; break;
+    }
+    if (n > remaining || *pending > remaining - n) return false;
+    *pending += n;
+    return true;
+}
+
+esp_err_t cbor_reader_skip(cbor_reader_t *r, const cbor_item_t *item)
+{
+    if (r == NULL || item == NULL) return ESP_ERR_INVALID_ARG;
+
+    /* pending <= 남은 바이트 수 불변식 유지 */
+    uint64_t pending = 0;
+    if (!add_children(&pending, item, r->len - r->pos)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    while (pending > 0) {
+        cbor_item_t child;
+        esp_err_t err = cbor_reader_next(r, &child);
+        if (err == ESP_ERR_NOT_FOUND) return ESP_ERR_INVALID_SIZE;
+        if (err != ESP_OK) return err;
+        pending--;
+        if (!add_children(&pending, &child, r->len - r->pos)) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t cbor_item_to_int(const cbor_item_t *item, int32_t *val)
+{
+    if (item == NULL || val == NULL) return ESP_ERR_INVALID_ARG;
+    if (item->type == CBOR_TYPE_UINT) {
+        if (item->uval > (uint64_t)INT32_MAX) return ESP_ERR_INVALID_SIZE;
+        *val = (int32_t)item->uval;
+        return ESP_OK;
+    }
+    if (item->type == CBOR_TYPE_NEGINT) {
+        if (item->uval > (uint64_t)INT32_MAX) return ESP_ERR_INVALID_SIZE;
+        *val = -1 - (int32_t)item->uval;
+        return ESP_OK;
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t cbor_item_to_float(const cbor_item_t *item, float *val)
+{
+    if (item == NULL || val == NULL) return ESP_ERR_INVALID_ARG;
+    switch (item->type) {
+        case CBOR_TYPE_FLOAT:  *val = item->fval; return ESP_OK;
+        case CBOR_TYPE_UINT:   *val = (float)item->uval; return ESP_OK;
+        case CBOR_TYPE_NEGINT: *val = -1.0f - (float)item->uval; return ESP_OK;
+        default:               return ESP_ERR_INVALID_ARG;
+    }
+}
+
+esp_err_t cbor_reader_get_int(cbor_reader_t *r, int32_t *val)
+{
+    cbor_item_t item;
+    esp_err_t err = cbor_reader_next(r, &item);
+    if (err != ESP_OK) return err;
+    return cbor_item_to_int(&item, val);
+}
+
+esp_err_t cbor_reader_get_float(cbor_reader_t *r, float *val)
+{
+    cbor_item_t item;
+    esp_err_t err = cbor_reader_next(r, &item);
+    if (err != ESP_OK) return err;
+    return cbor_item_to_float(&item, val);
+}
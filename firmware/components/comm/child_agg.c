@@ -0,0 +1,206 @@
+/**
+ * @file child_agg.c
+ * @brief 자식 리포트 집계 버퍼
+ *
+ * 항목은 수신 순으로 앞에서부터 채우고, 인코딩은 앞에서부터 들어가는 만큼
+ * 담는다. 전송 중(앞쪽 inflight개) 항목은 대체/제거하지 않으므로 전송 도중
+ * 도착한 리포트는 뒤에 쌓였다가 다음 데이터그램으로 나간다.
+ */
+#include "child_agg.h"
+#include "cbor_codec.h"
+#include "cbor_reader.h"
+#include <string.h>
+
+#define CBOR_UINT  (0 << 5)
+#define CBOR_BYTES (2 << 5)
+#define CBOR_ARRAY (4 << 5)
+#define CBOR_MAP   (5 << 5)
+
+/* 맵 헤더(1) + {0: 5}(2) + {19: ver}(2) + 키 23(1) + 배열 헤더(1) */
+#define AGG_HDR_LEN   7
+
+void child_agg_init(child_agg_t *a)
+{
+    if (a == NULL) return;
+    memset(a, 0, sizeof(*a));
+}
+
+/*
+ * 메시지 타입/safety 확인 — 리포트끼리만 대체 가능, 나머지(배치 샘플,
+ * 명령 응답)는 모두 전달. 리포트/배치 외 타입과 safety 이상은 즉시 전송.
+ */
+static esp_err_t classify(const uint8_t *payload, size_t len, bool *report, bool *urgent)
+{
+    cbor_reader_t rd;
+    cbor_item_t map;
+    cbor_reader_init(&rd, payload, len);
+    if (cbor_reader_next(&rd, &map) != ESP_OK || map.type != CBOR_TYPE_MAP) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int32_t msg_type = CBOR_MSG_REPORT;
+    int32_t safety = 0;
+    for (uint64_t i = 0; i < map.uval; i++) {
+        cbor_item_t key, val;
+        if (cbor_reader_next(&rd, &key) != ESP_OK || cbor_reader_next(&rd, &val) != ESP_OK) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (key.type == CBOR_TYPE_UINT && key.uval == CBOR_KEY_MSG_TYPE) {
+            cbor_item_to_int(&val, &msg_type);
+        } else if (key.type == CBOR_TYPE_UINT && key.uval == CBOR_KEY_SAFETY) {
+            cbor_item_to_int(&val, &safety);
+        }
+        if (cbor_reader_skip(&rd, &val) != ESP_OK) return ESP_ERR_INVALID_ARG;
+    }
+
+    *report = (msg_type == CBOR_MSG_REPORT || msg_type == CBOR_MSG_REPORT_SCALED);
+    *urgent = (!*report && msg_type != CBOR_MSG_BATCH) || safety > 0;
+    return ESP_OK;
+}
+
+esp_err_t child_agg_add(child_agg_t *a, uint16_t node_id, const uint8_t *payload,
+                        size_t len, uint32_t now_ms)
+{
+    if (a == NULL || payload == NULL || len == 0) return ESP_ERR_INVALID_ARG;
+    if (len > CHILD_AGG_PAYLOAD_MAX) return ESP_ERR_INVALID_SIZE;
+
+    bool report, urgent;
+    esp_err_t ret = classify(payload, len, &report, &urgent);
+    if (ret != ESP_OK) return ret;
+
+    child_agg_entry_t *e = NULL;
+    if (report) {
+        for (uint8_t i = a->inflight; i < a->count; i++) {
+            if (a->entries[i].node_id == node_id && a->entries[i].report) {
+                e = &a->entries[i];
+                urgent = urgent || e->urgent;  /* 대체돼도 경보 흐름은 유지 */
+                a->replaced++;
+                break;
+            }
+        }
+    }
+    if (e == NULL) {
+        if (a->count >= CHILD_AGG_MAX_ENTRIES) return ESP_ERR_NO_MEM;
+        e = &a->entries[a->count++];
+        e->node_id = node_id;
+        e->first_ms = now_ms;
+    }
+
+    e->report = report;
+    e->urgent = urgent;
+    e->rx_ms = now_ms;
+    e->len = (uint8_t)len;
+    memcpy(e->payload, payload, len);
+    return ESP_OK;
+}
+
+size_t child_agg_pending(const child_agg_t *a)
+{
+    return (a == NULL) ? 0 : (size_t)(a->count - a->inflight);
+}
+
+uint32_t child_agg_next_due_ms(const child_agg_t *a, uint32_t now_ms, uint32_t window_ms)
+{
+    if (child_agg_pending(a) == 0) return UINT32_MAX;
+    if (window_ms == 0 || a->count >= CHILD_AGG_MAX_ENTRIES) return 0;
+
+    uint32_t oldest = 0;
+    for (uint8_t i = a->inflight; i < a->count; i++) {
+        if (a->entries[i].urgent) return 0;
+        uint32_t waited = now_ms - a->entries[i].first_ms;
+        if (waited > oldest) oldest = waited;
+    }
+    return (oldest >= window_ms) ? 0 : window_ms - oldest;
+}
+
+bool child_agg_due(const child_agg_t *a, uint32_t now_ms, uint32_t window_ms)
+{
+    return child_agg_pending(a) > 0 && child_agg_next_due_ms(a, now_ms, window_ms) == 0;
+}
+
+static size_t put_uint(uint8_t *buf, uint8_t major, uint32_t val)
+{
+    if (val < 24) {
+        buf[0] = major | (uint8_t)val;
+        return 1;
+    } else if (val <= 0xFF) {
+        buf[0] = major | 24;
+        buf[1] = (uint8_t)val;
+        return 2;
+    } else if (val <= 0xFFFF) {
+        buf[0] = major | 25;
+        buf[1] = (uint8_t)(val >> 8);
+        buf[2] = (uint8_t)val;
+        return 3;
+    }
+    buf[0] = major | 26;
+    buf[1] = (uint8_t)(val >> 24);
+    buf[2] = (uint8_t)(val >> 16);
+    buf[3] = (uint8_t)(val >> 8);
+    buf[4] = (uint8_t)val;
+    return 5;
+}
+
+static size_t uint_len(uint32_t val)
+{
+    return (val < 24) ? 1 : (val <= 0xFF) ? 2 : (val <= 0xFFFF) ? 3 : 5;
+}
+
+esp_err_t child_agg_encode(child_agg_t *a, uint32_t now_ms, uint8_t *buf, size_t buf_size,
+                           size_t *out_len, size_t *out_entries)
+{
+    if (a == NULL || buf == NULL || out_len == NULL || out_entries == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (a->inflight > 0) return ESP_ERR_INVALID_STATE;
+    if (a->count == 0) return ESP_ERR_NOT_FOUND;
+    if (buf_size < AGG_HDR_LEN) return ESP_ERR_NO_MEM;
+
+    size_t pos = 0;
+    buf[pos++] = CBOR_MAP | 3;
+    pos += put_uint(buf + pos, CBOR_UINT, CBOR_KEY_MSG_TYPE);
+    pos += put_uint(buf + pos, CBOR_UINT, CBOR_MSG_AGGREGATE);
+    pos += put_uint(buf + pos, CBOR_UINT, CBOR_KEY_SCHEMA_VERSION);
+    pos += put_uint(buf + pos, CBOR_UINT, RBMS_SCHEMA_VERSION);
+    pos += put_uint(buf + pos, CBOR_UINT, CBOR_KEY_AGG_ENTRIES);
+    size_t arr_pos = pos++;  /* 항목 수는 CHILD_AGG_MAX_ENTRIES(< 24) → 1 byte */
+
+    uint8_t n = 0;
+    while (n < a->count) {
+        const child_agg_entry_t *e = &a->entries[n];
+        uint32_t age_s = (now_ms - e->rx_ms) / 1000;
+        size_t need = 1 + uint_len(e->node_id) + uint_len(age_s) + uint_len(e->len) + e->len;
+        if (pos + need > buf_size) break;
+
+        buf[pos++] = CBOR_ARRAY | 3;
+        pos += put_uint(buf + pos, CBOR_UINT, e->node_id);
+        pos += put_uint(buf + pos, CBOR_UINT, age_s);
+        pos += put_uint(buf + pos, CBOR_BYTES, e->len);
+        memcpy(buf + pos, e->payload, e->len);
+        pos += e->len;
+        n++;
+    }
+    if (n == 0) return ESP_ERR_NO_MEM;
+
+    buf[arr_pos] = CBOR_ARRAY | n;
+    a->inflight = n;
+    *out_len = pos;
+    *out_entries = n;
+    return ESP_OK;
+}
+
+void child_agg_commit(child_agg_t *a)
+{
+    if (a == NULL || a->inflight == 0) return;
+
+    uint8_t left = a->count - a->inflight;
+    memmove(&a->entries[0], &a->entries[a->inflight], left * sizeof(a->entries[0]));
+    a->count = left;
+    a->inflight = 0;
+}
+
+void child_agg_abort(child_agg_t *a)
+{
+    if (a == NULL) return;
+    a->inflight = 0;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file child_mailbox.c
+ * @brief 자식별 다운링크 명령 우편함
+ *
+ * 항목은 도착 순으로 앞에서부터 채우고 제거 시 뒤를 당긴다 (슬롯 8개).
+ * 자식별 순서는 도착 순 그대로 — 가장 앞의 항목이 다음에 실을 명령.
+ */
+#include "child_mailbox.h"
+#include "cbor_codec.h"
+#include "cbor_reader.h"
+#include <string.h>
+
+void child_mailbox_init(child_mailbox_t *mb)
+{
+    if (mb == NULL) return;
+    memset(mb, 0, sizeof(*mb));
+}
+
+/* 맵 첫 항목이 {0: type}인 메시지의 seq(키 30) */
+static bool msg_seq(const uint8_t *msg, size_t len, int32_t type, uint16_t *seq)
+{
+    cbor_reader_t rd;
+    cbor_item_t map, key, val;
+    int32_t v;
+    cbor_reader_init(&rd, msg, len);
+    if (cbor_reader_next(&rd, &map) != ESP_OK || map.type != CBOR_TYPE_MAP || map.uval == 0 ||
+        cbor_reader_get_int(&rd, &v) != ESP_OK || v != CBOR_KEY_MSG_TYPE ||
+        cbor_reader_get_int(&rd, &v) != ESP_OK || v != type) {
+        return false;
+    }
+    for (uint64_t i = 1; i < map.uval; i++) {
+        if (cbor_reader_next(&rd, &key) != ESP_OK || cbor_reader_next(&rd, &val) != ESP_OK) {
+            return false;
+        }
+        if (key.type == CBOR_TYPE_UINT && key.uval == CBOR_KEY_CMD_SEQ) {
+            if (val.type != CBOR_TYPE_UINT || val.uval > UINT16_MAX) return false;
+            *seq = (uint16_t)val.uval;
+            return true;
+        }
+        if (cbor_reader_skip(&rd, &val) != ESP_OK) return false;
+    }
+    return false;
+}
+
+static void remove_at(child_mailbox_t *mb, uint8_t i)
+{
+    memmove(&mb->entries[i], &mb->entries[i + 1],
+            (size_t)(mb->count - i - 1) * sizeof(mb->entries[0]));
+    mb->count--;
+}
+
+esp_err_t child_mailbox_put(child_mailbox_t *mb, uint16_t node_id, const uint8_t *msg,
+                            size_t len, uint32_t now_ms)
+{
+    if (mb == NULL || msg == NULL) return ESP_ERR_INVALID_ARG;
+
+    esp_err_t ret = ESP_OK;
+    uint16_t seq = 0;
+    size_t mine = 0;
+    if (len > CHILD_MAILBOX_MSG_MAX) {
+        ret = ESP_ERR_INVALID_SIZE;
+    } else if (!msg_seq(msg, len, CBOR_MSG_CMD, &seq)) {
+        ret = ESP_ERR_INVALID_ARG;
+    } else {
+        for (uint8_t i = 0; i < mb->count; i++) {
+            if (mb->entries[i].node_id != node_id) continue;
+            if (mb->entries[i].seq == seq) return ESP_OK;
+            mine++;
+        }
+        if (mine >= CHILD_MAILBOX_PER_CHILD || mb->count >= CHILD_MAILBOX_SLOTS) {
+            ret = ESP_ERR_NO_MEM;
+        }
+    }
+    if (ret != ESP_OK) {
+        mb->dropped++;
+        return ret;
+    }
+
+    child_mailbox_entry_t *e = &mb->entries[mb->count++];
+    e->node_id = node_id;
+    e->seq = seq;
+    e->len = (uint8_t)len;
+    e->stored_ms = now_ms;
+    memcpy(e->msg, msg, len);
+    mb->stored++;
+    return ESP_OK;
+}
+
+esp_err_t child_mailbox_put_aggregate(child_mailbox_t *mb, const uint8_t *msg, size_t len,
+                                      uint32_t now_ms, size_t *out_stored)
+{
+    if (out_stored) *out_stored = 0;
+    if (mb == NULL || msg == NULL) return ESP_ERR_INVALID_ARG;
+
+    cbor_reader_t rd;
+    cbor_item_t map, key, val;
+    int32_t v;
+    cbor_reader_init(&rd, msg, len);
+    if (cbor_reader_next(&rd, &map) != ESP_OK || map.type != CBOR_TYPE_MAP || map.uval == 0 ||
+        cbor_reader_get_int(&rd, &v) != ESP_OK || v != CBOR_KEY_MSG_TYPE ||
+        cbor_reader_get_int(&rd, &v) != ESP_OK || v != CBOR_MSG_AGGREGATE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (uint64_t i = 1; i < map.uval; i++) {
+        if (cbor_reader_next(&rd, &key) != ESP_OK || cbor_reader_next(&rd, &val) != ESP_OK) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (!(key.type == CBOR_TYPE_UINT && key.uval == CBOR_KEY_AGG_ENTRIES &&
+              val.type == CBOR_TYPE_ARRAY)) {
+            if (cbor_reader_skip(&rd, &val) != ESP_OK) return ESP_ERR_INVALID_ARG;
+            continue;
+        }
+        for (uint64_t n = 0; n < val.uval; n++) {
+            cbor_item_t entry, payload;
+            int32_t node_id, age;
+            if (cbor_reader_next(&rd, &entry) != ESP_OK) return ESP_ERR_INVALID_ARG;
+            if (entry.type != CBOR_TYPE_ARRAY || entry.uval != 3 ||
+                cbor_reader_get_int(&rd, &node_id) != ESP_OK ||
+                cbor_reader_get_int(&rd, &age) != ESP_OK ||
+                cbor_reader_next(&rd, &payload) != ESP_OK || payload.type != CBOR_TYPE_BYTES) {
+                return ESP_ERR_INVALID_ARG;  /* 항목 경계를 잃음 */
+            }
+            if (child_mailbox_put(mb, (uint16_t)node_id, payload.ptr, payload.len,
+                                  now_ms) == ESP_OK && out_stored) {
+                (*out_stored)++;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+size_t child_mailbox_take(child_mailbox_t *mb, uint16_t node_id, const uint8_t *uplink,
+                          size_t uplink_len, uint32_t now_ms, uint32_t ttl_ms,
+                          uint8_t *out, size_t out_size)
+{
+    if (mb == NULL || mb->count == 0) return 0;
+
+    uint16_t acked;
+    bool ack = (uplink != NULL && msg_seq(uplink, uplink_len, CBOR_MSG_CMD_ACK, &acked));
+
+    uint8_t i = 0;
+    while (i < mb->count) {
+        child_mailbox_entry_t *e = &mb->entries[i];
+        if (ack && e->node_id == node_id && e->seq == acked) {
+            mb->acked++;
+            remove_at(mb, i);
+        } else if (ttl_ms > 0 && now_ms - e->stored_ms > ttl_ms) {
+            mb->expired++;
+            remove_at(mb, i);
+        } else {
+            i++;
+        }
+    }
+
+    for (i = 0; i < mb->count; i++) {
+        const child_mailbox_entry_t *e = &mb->entries[i];
+        if (e->node_id != node_id) continue;
+        if (out == NULL || e->len > out_size) return 0;
+        memcpy(out, e->msg, e->len);
+        mb->sent++;
+        return e->len;
+    }
+    return 0;
+}
+
+size_t child_mailbox_pending(const child_mailbox_t *mb, uint16_t node_id)
+{
+    if (mb == NULL) return 0;
+
+    size_t n = 0;
+    for (uint8_t i = 0; i < mb->count; i++) {
+        if (mb->entries[i].node_id == node_id) n++;
+    }
+    return n;
+}
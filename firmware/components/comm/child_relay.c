@@ -0,0 +1,212 @@
+/**
+ * @file child_relay.c
+ * @brief 자식 업링크 중계/집계 — child_agg 버퍼 + 전송 태스크
+ *
+ * 수신(ot_rx 워커)은 버퍼에 복사만 하고, 전송 태스크가 기한이 된 항목을
+ * 인코딩해 mutex 밖에서 thread_node_send_confirmed()로 보낸다.
+ * 전송 중 도착한 페이로드는 버퍼 뒤쪽에 쌓인다 (child_agg inflight).
+ *
+ * 우편함은 OT 콜백(ACK 피기백)에서도 접근하므로 mutex가 아닌 spinlock으로 보호.
+ */
+#include "child_relay.h"
+#include "child_agg.h"
+#include "child_mailbox.h"
+#include "cbor_codec.h"
+#include "cbor_reader.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <string.h>
+
+static const char *TAG = "relay";
+
+#define RELAY_TASK_STACK  3072
+#define RELAY_TASK_PRIO   2
+#define RELAY_RETRY_MS    10000   /* 게이트웨이 ACK 실패 후 최소 재시도 간격 */
+
+static child_agg_t s_agg;
+static child_relay_config_t s_cfg;
+static SemaphoreHandle_t s_mutex = NULL;
+static TaskHandle_t s_task = NULL;
+static child_relay_stats_t s_stats;   /* s_mutex 보호 */
+static child_mailbox_t s_mbox;        /* s_mbox_mux 보호 */
+static portMUX_TYPE s_mbox_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+/* 맵 첫 항목이 {0: 5}인지 — 자식은 집계를 보내지 않으므로 게이트웨이 우편 */
+static bool is_mail(const uint8_t *data, size_t len)
+{
+    cbor_reader_t rd;
+    cbor_item_t map;
+    int32_t key, type;
+    cbor_reader_init(&rd, data, len);
+    return cbor_reader_next(&rd, &map) == ESP_OK && map.type == CBOR_TYPE_MAP &&
+           cbor_reader_get_int(&rd, &key) == ESP_OK && key == CBOR_KEY_MSG_TYPE &&
+           cbor_reader_get_int(&rd, &type) == ESP_OK && type == CBOR_MSG_AGGREGATE;
+}
+
+static void mail_rx(const uint8_t *data, size_t len, uint16_t src_id)
+{
+    size_t stored = 0;
+    taskENTER_CRITICAL(&s_mbox_mux);
+    uint32_t dropped = s_mbox.dropped;
+    esp_err_t ret = child_mailbox_put_aggregate(&s_mbox, data, len, now_ms(), &stored);
+    dropped = s_mbox.dropped - dropped;
+    taskEXIT_CRITICAL(&s_mbox_mux);
+
+    if (ret != ESP_OK || dropped > 0) {
+        ESP_LOGW(TAG, "Mail from %04x: %d stored, %lu dropped (%s)", src_id, (int)stored,
+                 (unsigned long)dropped, esp_err_to_name(ret));
+    } else {
+        ESP_LOGD(TAG, "Mail from %04x: %d commands stored", src_id, (int)stored);
+    }
+}
+
+/* OT 콜백 컨텍스트 (thread_ack_payload_cb_t) — 자식 CON 업링크 ACK에 실을 명령 (없으면 시각) */
+static size_t mail_for_child(uint16_t src_id, const uint8_t *data, size_t len,
+                             uint8_t *out, size_t out_size)
+{
+    taskENTER_CRITICAL(&s_mbox_mux);
+    size_t n = child_mailbox_take(&s_mbox, src_id, data, len, now_ms(), s_cfg.mailbox_ttl_ms,
+                                  out, out_size);
+    taskEXIT_CRITICAL(&s_mbox_mux);
+    if (n == 0 && s_cfg.time_beacon != NULL) {
+        n = s_cfg.time_beacon(out, out_size);  /* 명령이 없으면 시각 */
+    }
+    return n;
+}
+
+void child_relay_rx(const uint8_t *data, size_t len, const thread_rx_meta_t *meta)
+{
+    if (s_mutex == NULL || data == NULL || meta == NULL || meta->multicast) return;
+
+    if (is_mail(data, len)) {
+        mail_rx(data, len, meta->src_id);
+        return;
+    }
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    uint32_t replaced = s_agg.replaced;
+    esp_err_t ret = child_agg_add(&s_agg, meta->src_id, data, len, now_ms());
+    if (ret == ESP_OK) {
+        s_stats.received++;
+        s_stats.replaced += s_agg.replaced - replaced;
+    } else {
+        s_stats.dropped++;
+    }
+    xSemaphoreGive(s_mutex);
+
+    TaskHandle_t task = s_task;
+    if (ret == ESP_OK && task != NULL) {
+        xTaskNotifyGive(task);  /* 즉시 전송 항목/가득 참 확인 */
+    } else if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Child %04x: %d bytes dropped (%s)", meta->src_id, (int)len,
+                 esp_err_to_name(ret));
+    }
+}
+
+static void relay_task(void *param)
+{
+    static uint8_t buf[THREAD_TX_PAYLOAD_MAX];
+    uint32_t retry_at = 0;
+    bool backoff = false;
+
+    while (1) {
+        xSemaphoreTake(s_mutex, portMAX_DELAY);
+        uint32_t now = now_ms();
+        uint32_t wait = child_agg_next_due_ms(&s_agg, now, s_cfg.window_ms);
+        if (backoff && wait != UINT32_MAX) {
+            int32_t left = (int32_t)(retry_at - now);
+            if (left > 0 && (uint32_t)left > wait) wait = (uint32_t)left;
+        }
+
+        size_t len = 0, n = 0;
+        bool send = (wait == 0 &&
+                     child_agg_encode(&s_agg, now, buf, sizeof(buf), &len, &n) == ESP_OK);
+        xSemaphoreGive(s_mutex);
+
+        if (!send) {
+            ulTaskNotifyTake(pdTRUE, (wait == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(wait));
+            continue;
+        }
+
+        esp_err_t ret = thread_node_send_confirmed(buf, len);
+
+        xSemaphoreTake(s_mutex, portMAX_DELAY);
+        if (ret == ESP_OK) {
+            child_agg_commit(&s_agg);
+            s_stats.datagrams++;
+            s_stats.entries += n;
+            backoff = false;
+        } else if (ret == ESP_FAIL) {
+            child_agg_commit(&s_agg);  /* 게이트웨이 거부 (RST) — 재전송해도 같은 결과 */
+            s_stats.dropped += n;
+        } else {
+            child_agg_abort(&s_agg);
+            s_stats.send_failed++;
+            backoff = true;
+            retry_at = now_ms() + (s_cfg.window_ms > RELAY_RETRY_MS ? s_cfg.window_ms
+                                                                    : RELAY_RETRY_MS);
+        }
+        xSemaphoreGive(s_mutex);
+
+        if (ret == ESP_OK) {
+            ESP_LOGD(TAG, "Forwarded %d child reports in %d bytes", (int)n, (int)len);
+        } else {
+            ESP_LOGW(TAG, "Aggregate of %d reports not delivered: %s", (int)n,
+                     esp_err_to_name(ret));
+        }
+    }
+}
+
+esp_err_t child_relay_start(const child_relay_config_t *cfg)
+{
+    if (cfg == NULL) return ESP_ERR_INVALID_ARG;
+    if (s_task != NULL) return ESP_ERR_INVALID_STATE;
+
+    s_cfg = *cfg;
+    child_agg_init(&s_agg);
+    child_mailbox_init(&s_mbox);
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_mutex = xSemaphoreCreateMutex();
+    if (s_mutex == NULL) return ESP_ERR_NO_MEM;
+
+    if (xTaskCreate(relay_task, "relay", RELAY_TASK_STACK, NULL, RELAY_TASK_PRIO,
+                    &s_task) != pdPASS) {
+        vSemaphoreDelete(s_mutex);
+        s_mutex = NULL;
+        s_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    thread_node_set_ack_payload_cb(mail_for_child);
+
+    ESP_LOGI(TAG, "Child relay started (window %lu ms)", (unsigned long)cfg->window_ms);
+    return ESP_OK;
+}
+
+esp_err_t child_relay_get_stats(child_relay_stats_t *out)
+{
+    if (out == NULL) return ESP_ERR_INVALID_ARG;
+    if (s_mutex == NULL) return ESP_ERR_INVALID_STATE;
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    *out = s_stats;
+    out->pending = (uint16_t)s_agg.count;
+    xSemaphoreGive(s_mutex);
+
+    taskENTER_CRITICAL(&s_mbox_mux);
+    out->mbox_stored = s_mbox.stored;
+    out->mbox_dropped = s_mbox.dropped;
+    out->mbox_sent = s_mbox.sent;
+    out->mbox_acked = s_mbox.acked;
+    out->mbox_expired = s_mbox.expired;
+    out->mbox_pending = s_mbox.count;
+    taskEXIT_CRITICAL(&s_mbox_mux);
+    return ESP_OK;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file cmd_dispatcher.c
+ * @brief 다운링크 명령 디스패처 — thread_node 수신 콜백 위에서 동작
+ *
+ * 수신 콜백은 OT 콜백이 아니라 thread_node의 ot_rx 워커(Type A) 또는
+ * thread_node_rx_poll() 호출자(Type B)에서 실행되므로 핸들러(NVS 쓰기,
+ * 확인형 응답)를 바로 실행해도 메시가 멈추지 않는다. 별도 큐/복사 없음.
+ */
+#include "cmd_dispatcher.h"
+#include "thread_node.h"
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+static const char *TAG = "cmd_disp";
+
+#define CMD_TASK_STACK  4096
+#define CMD_TASK_PRIO   2
+
+static bool s_ready = false;
+static cmd_dispatcher_config_t s_cfg;
+static volatile uint32_t s_handled = 0;
+
+/*
+ * 재전송 중복 제거: 마지막 seq와 결과 — Deep Sleep을 걸쳐도 유지
+ * (Type B: 응답이 유실되면 부모 mailbox가 다음 wake에 같은 seq를 다시 보냄)
+ */
+static RTC_DATA_ATTR bool s_has_last = false;
+static RTC_DATA_ATTR uint16_t s_last_seq = 0;
+static RTC_DATA_ATTR cmd_status_t s_last_status = CMD_STATUS_OK;
+
+static void cmd_handle(const uint8_t *data, size_t len)
+{
+    cmd_msg_t msg;
+    if (cmd_parse(data, len, &msg) != ESP_OK) {
+        ESP_LOGW(TAG, "Malformed command (%d bytes)", (int)len);
+        return;  /* seq를 모르므로 응답 불가 */
+    }
+
+    cmd_status_t status;
+    if (s_has_last && msg.seq == s_last_seq) {
+        status = s_last_status;
+        ESP_LOGD(TAG, "Duplicate seq %u, re-ack", (unsigned)msg.seq);
+    } else {
+        status = cmd_dispatch(s_cfg.table, s_cfg.count, &msg, s_cfg.ctx);
+        s_has_last = true;
+        s_last_seq = msg.seq;
+        s_last_status = status;
+    }
+
+    /* 응답은 확인형 전송 — 반환 시 게이트웨이 도착 확인 (Type B는 바로 sleep 가능) */
+    uint8_t ack[CMD_ACK_BUF_SIZE];
+    size_t ack_len = 0;
+    if (cmd_encode_ack(msg.seq, msg.cmd_id, status, ack, sizeof(ack), &ack_len) == ESP_OK &&
+        thread_node_send_confirmed(ack, ack_len) != ESP_OK) {
+        ESP_LOGW(TAG, "Ack for seq %u not delivered", (unsigned)msg.seq);
+    }
+}
+
+/* ot_rx 워커 또는 poll 호출자 컨텍스트 — data는 수신 슬롯 (반환 전까지 유효) */
+static void cmd_rx_cb(const uint8_t *data, size_t len, const thread_rx_meta_t *meta)
+{
+    if (!cmd_is_command(data, len)) {
+        /* 텔레메트리 멀티캐스트, 자식 업링크 (Type A 중계) 등 */
+        if (s_cfg.other_rx) s_cfg.other_rx(data, len, meta);
+        return;
+    }
+
+    cmd_handle(data, len);
+    s_handled++;
+}
+
+esp_err_t cmd_dispatcher_init(const cmd_dispatcher_config_t *cfg)
+{
+    if (cfg == NULL || cfg->table == NULL) return ESP_ERR_INVALID_ARG;
+    if (s_ready) return ESP_ERR_INVALID_STATE;
+
+    s_cfg = *cfg;
+    thread_node_set_rx_callback(cmd_rx_cb);
+
+    if (cfg->use_task) {
+        esp_err_t ret = thread_node_rx_start_task(CMD_TASK_STACK, CMD_TASK_PRIO);
+        if (ret != ESP_OK) {
+            thread_node_set_rx_callback(NULL);
+            return ret;
+        }
+    }
+
+    s_ready = true;
+    ESP_LOGI(TAG, "Command dispatcher ready (%d commands, %s)",
+             (int)cfg->count, cfg->use_task ? "task" : "poll");
+    return ESP_OK;
+}
+
+int cmd_dispatcher_poll(uint32_t timeout_ms)
+{
+    if (!s_ready) return 0;
+
+    /* 명령이 아닌 데이터그램으로 창이 일찍 끝나지 않게 명령 처리까지 반복 */
+    uint32_t before = s_handled;
+    TickType_t start = xTaskGetTickCount();
+    TickType_t wait = pdMS_TO_TICKS(timeout_ms);
+    do {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        uint32_t left_ms = (elapsed >= wait) ? 0 : (uint32_t)((wait - elapsed) * portTICK_PERIOD_MS);
+        thread_node_rx_poll(left_ms);
+    } while (s_handled == before && xTaskGetTickCount() - start < wait);
+
+    return (int)(s_handled - before);
+}
@@ -0,0 +1,157 @@
+/**
+ * @file cmd_protocol.c
+ * @brief 다운링크 명령 파싱/응답 인코딩/테이블 디스패치
+ */
+#include "cmd_dispatcher.h"
+#include "cbor_codec.h"
+#include "esp_log.h"
+
+static const char *TAG = "cmd";
+
+#define CBOR_UINT (0 << 5)
+#define CBOR_MAP  (5 << 5)
+
+bool cmd_is_command(const uint8_t *buf, size_t len)
+{
+    /* 인코더 규칙: 마커 {0: 3}이 맵 첫 항목 */
+    return buf != NULL && len >= 3 &&
+           (buf[0] & 0xE0) == CBOR_MAP &&
+           buf[1] == (CBOR_UINT | CBOR_KEY_MSG_TYPE) &&
+           buf[2] == (CBOR_UINT | CBOR_MSG_CMD);
+}
+
+esp_err_t cmd_parse(const uint8_t *buf, size_t len, cmd_msg_t *msg)
+{
+    if (buf == NULL || msg == NULL) return ESP_ERR_INVALID_ARG;
+
+    cbor_reader_t rd;
+    cbor_item_t map;
+    cbor_reader_init(&rd, buf, len);
+    if (cbor_reader_next(&rd, &map) != ESP_OK || map.type != CBOR_TYPE_MAP) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool is_cmd = false, has_seq = false, has_id = false;
+    msg->arg = NULL;
+    msg->arg_len = 0;
+
+    for (uint64_t i = 0; i < map.uval; i++) {
+        cbor_item_t key, val;
+        int32_t v = 0;
+        if (cbor_reader_next(&rd, &key) != ESP_OK || key.type != CBOR_TYPE_UINT) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        size_t val_start = rd.pos;
+        if (cbor_reader_next(&rd, &val) != ESP_OK ||
+            cbor_reader_skip(&rd, &val) != ESP_OK) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+
+        switch (key.uval) {
+            case CBOR_KEY_MSG_TYPE:
+                is_cmd = (cbor_item_to_int(&val, &v) == ESP_OK && v == CBOR_MSG_CMD);
+                break;
+            case CBOR_KEY_CMD_SEQ:
+                if (cbor_item_to_int(&val, &v) != ESP_OK || v < 0 || v > UINT16_MAX) {
+                    return ESP_ERR_INVALID_ARG;
+                }
+                msg->seq = (uint16_t)v;
+                has_seq = true;
+                break;
+            case CBOR_KEY_CMD_ID:
+                if (cbor_item_to_int(&val, &v) != ESP_OK || v < 0 || v > UINT8_MAX) {
+                    return ESP_ERR_INVALID_ARG;
+                }
+                msg->cmd_id = (uint8_t)v;
+                has_id = true;
+                break;
+            case CBOR_KEY_CMD_ARG:
+                /* 인자 항목 전체 (컨테이너 포함) 구간 */
+                msg->arg = buf + val_start;
+                msg->arg_len = rd.pos - val_start;
+                break;
+            default:
+                break;  /* 향후 확장 키 무시 */
+        }
+    }
+
+    if (!is_cmd || !has_seq || !has_id) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+cmd_status_t cmd_dispatch(const cmd_entry_t *table, size_t count,
+                          const cmd_msg_t *msg, void *ctx)
+{
+    if (table == NULL || msg == NULL) return CMD_STATUS_UNKNOWN;
+
+    for (size_t i = 0; i < count; i++) {
+        if (table[i].id == msg->cmd_id && table[i].handler != NULL) {
+            cbor_reader_t arg;
+            cbor_reader_init(&arg, msg->arg, msg->arg_len);
+            cmd_status_t st = table[i].handler(&arg, ctx);
+            ESP_LOGI(TAG, "cmd %d seq %u -> status %d",
+                     msg->cmd_id, (unsigned)msg->seq, (int)st);
+            return st;
+        }
+    }
+    ESP_LOGW(TAG, "Unknown cmd %d (seq %u)", msg->cmd_id, (unsigned)msg->seq);
+    return CMD_STATUS_UNKNOWN;
+}
+
+/* 0 ~ 65535 uint 헤더 기록 */
+static size_t put_uint(uint8_t *buf, uint16_t val)
+{
+    if (val < 24) {
+        buf[0] = CBOR_UINT | (uint8_t)val;
+        return 1;
+    } else if (val <= 0xFF) {
+        buf[0] = CBOR_UINT | 24;
+        buf[1] = (uint8_t)val;
+        return 2;
+    }
+    buf[0] = CBOR_UINT | 25;
+    buf[1] = (uint8_t)(val >> 8);
+    buf[2] = (uint8_t)(val & 0xFF);
+    return 3;
+}
+
+esp_err_t cmd_encode_ack(uint16_t seq, uint8_t cmd_id, cmd_status_t status,
+                         uint8_t *buf, size_t buf_size, size_t *out_len)
+{
+    /* 최대 1 + (1+1) + (2+3) + (2+2) + (2+2) = 16 bytes */
+    if (buf == NULL || out_len == NULL) return ESP_ERR_INVALID_ARG;
+    if (buf_size < CMD_ACK_BUF_SIZE) return ESP_ERR_NO_MEM;
+
+    size_t pos = 0;
+    buf[pos++] = CBOR_MAP | 4;
+    pos += put_uint(buf + pos, CBOR_KEY_MSG_TYPE);
+    pos += put_uint(buf + pos, CBOR_MSG_CMD_ACK);
+    pos += put_uint(buf + pos, CBOR_KEY_CMD_SEQ);
+    pos += put_uint(buf + pos, seq);
+    pos += put_uint(buf + pos, CBOR_KEY_CMD_ID);
+    pos += put_uint(buf + pos, cmd_id);
+    pos += put_uint(buf + pos, CBOR_KEY_CMD_STATUS);
+    pos += put_uint(buf + pos, (uint16_t)status);
+
+    *out_len = pos;
+    return ESP_OK;
+}
+
+esp_err_t cmd_arg_floats(cbor_reader_t *arg, float *out, size_t count)
+{
+    if (arg == NULL || out == NULL) return ESP_ERR_INVALID_ARG;
+
+    cbor_item_t arr;
+    if (cbor_reader_next(arg, &arr) != ESP_OK ||
+        arr.type != CBOR_TYPE_ARRAY || arr.uval != count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (cbor_reader_get_float(arg, &out[i]) != ESP_OK) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file alarm_uplink.h
+ * @brief 안전 상태 전이 경보 업링크 (Type A)
+ *
+ * safety 상태가 바뀌는 즉시 경보 메시지(CBOR_MSG_ALARM)를 주기 리포트와 별개로
+ * 보낸다. 전송은 ALARM 큐 + 별도 CON 채널(thread_node_send_alarm)이라 텔레메트리
+ * 주기/큐, 진행 중인 명령 응답·집계 CON을 기다리지 않는다.
+ * 게이트웨이 ACK까지 재시도하며, 그사이 새 전이가 오면 최신 상태를 보낸다.
+ */
+#ifndef RBMS_ALARM_UPLINK_H
+#define RBMS_ALARM_UPLINK_H
+
+#include "esp_err.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief 경보 카운터 (부팅 후 누적) */
+typedef struct {
+    uint32_t raised;            /* 상태 전이 */
+    uint32_t delivered;         /* 게이트웨이 ACK */
+    uint32_t superseded;        /* 전달 전에 새 전이로 대체 */
+    uint32_t send_failed;       /* 재전송 소진 (재시도함) */
+    uint32_t last_latency_ms;   /* 전이 감지 → 게이트웨이 ACK */
+    uint32_t max_latency_ms;
+} alarm_uplink_stats_t;
+
+/** @brief 경보 전송 태스크 시작 (thread_node_init 이후) */
+esp_err_t alarm_uplink_start(void);
+
+/**
+ * @brief 현재 safety 상태 통지 — 블로킹 없음, 이전 통지와 다를 때만 경보
+ * @param safety_status safety_status_t (SAFETY_OK로 복귀도 경보로 전송)
+ */
+void alarm_uplink_raise(int safety_status);
+
+/** @brief 경보 카운터 스냅샷 */
+esp_err_t alarm_uplink_get_stats(alarm_uplink_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_ALARM_UPLINK_H */
@@ -9,6 +9,7 @@
 #define RBMS_CBOR_CODEC_H
 
 #include "esp_err.h"
+#include "telemetry_schema.h"
 #include <stddef.h>
 #include <stdint.h>
 
@@ -16,6 +17,56 @@
 extern "C" {
 #endif
 
+/*
+ * 키/메시지 타입/필드 구성은 schema/telemetry.json에서 생성된 telemetry_schema.h가
+ * 단일 원본 (서버 게이트웨이/브릿지의 rbms_schema.py와 동일).
+ */
+
+/* 메시지 타입 마커 키 (0). 생략 시 CBOR_MSG_REPORT로 간주 (하위 호환) */
+#define CBOR_KEY_MSG_TYPE  RBMS_KEY_MSG_TYPE
+
+/* 스키마 버전 키 — 모든 텔레메트리 페이로드에 RBMS_SCHEMA_VERSION 기록 */
+#define CBOR_KEY_SCHEMA_VERSION  RBMS_KEY_SCHEMA_VERSION
+
+typedef enum {
+    CBOR_MSG_REPORT        = RBMS_MSG_REPORT,         /* float32 리포트 (마커 생략) */
+    CBOR_MSG_REPORT_SCALED = RBMS_MSG_REPORT_SCALED,  /* 정수 리포트: 값 x100 (센티 단위) */
+    CBOR_MSG_BATCH         = RBMS_MSG_BATCH,          /* 다중 샘플 배치 (델타 인코딩) */
+    CBOR_MSG_CMD           = RBMS_MSG_CMD,            /* 다운링크 명령 (서버→노드) */
+    CBOR_MSG_CMD_ACK       = RBMS_MSG_CMD_ACK,        /* 명령 응답 (노드→서버) */
+    CBOR_MSG_AGGREGATE     = RBMS_MSG_AGGREGATE,      /* 자식 리포트 묶음 (child_agg.h) */
+    CBOR_MSG_HEALTH        = RBMS_MSG_HEALTH,         /* 메시 진단 (mesh_health.h) */
+    CBOR_MSG_ALARM         = RBMS_MSG_ALARM,          /* 안전 상태 전이 경보 (alarm_uplink.h) */
+    CBOR_MSG_TIME          = RBMS_MSG_TIME,           /* 시각 비콘 (게이트웨이/부모→노드) */
+} cbor_msg_type_t;
+
+/* 텔레메트리 필드 키: CBOR_KEY_TEMP_HOT(1) ... CBOR_KEY_SAFETY(7) */
+enum {
+#define X(id, key, member, kind, opt) CBOR_KEY_##id = (key),
+    RBMS_TELEMETRY_FIELDS(X)
+#undef X
+};
+
+/*
+ * 명령/응답 키 (cmd_dispatcher.h). 텔레메트리 키와 겹치지 않게 30번대 사용.
+ *   명령: {0: 3, 30: seq, 31: cmd_id, 32: arg}
+ *   응답: {0: 4, 30: seq, 31: cmd_id, 33: status}
+ */
+#define CBOR_KEY_CMD_SEQ     RBMS_KEY_CMD_SEQ
+#define CBOR_KEY_CMD_ID      RBMS_KEY_CMD_ID
+#define CBOR_KEY_CMD_ARG     RBMS_KEY_CMD_ARG
+#define CBOR_KEY_CMD_STATUS  RBMS_KEY_CMD_STATUS
+
+/** @brief 리포트 값 인코딩 방식 */
+typedef enum {
+    CBOR_REPORT_FLOAT32 = 0,  /* 모든 값 float32 (5 bytes/값) */
+    CBOR_REPORT_SCALED,       /* 값 x100 정수 (1~3 bytes/값), 키 0 마커 포함 */
+} cbor_report_format_t;
+
+/* SCALED 포맷 배율: 0.01 단위 (0.01°C, 0.01%RH) */
+#define CBOR_SCALED_FACTOR RBMS_SCALED_FACTOR
+
+/* 멤버는 RBMS_TELEMETRY_FIELDS와 일치해야 함 (scaled → float, enum → int) */
 typedef struct {
     float temp_hot;
     float temp_cool;
@@ -26,6 +77,80 @@ typedef struct {
     int   safety_status;  /* safety_status_t, 음수면 미사용 */
 } sensor_report_t;
 
+/*
+ * 배치 포맷 (CBOR_MSG_BATCH):
+ *   {0: 2, 19: schema_ver, 20: base_age, 21: [hot0, cool0, hum0],
+ *    22: [dt1, dhot1, dcool1, dhum1, dt2, ...], 4: battery, 7: safety}
+ *   base_age = 인코딩 시점 기준 첫 샘플의 경과 초
+ *   dtN      = 이전 샘플 대비 경과 초, dX = 이전 샘플 대비 x100 정수 차이
+ */
+#define CBOR_KEY_BATCH_AGE     RBMS_KEY_BATCH_AGE
+#define CBOR_KEY_BATCH_BASE    RBMS_KEY_BATCH_BASE
+#define CBOR_KEY_BATCH_DELTAS  RBMS_KEY_BATCH_DELTAS
+
+/* 집계 포맷 (CBOR_MSG_AGGREGATE, child_agg.h): {0: 5, 19: ver, 23: [[node_id, age, payload], ...]} */
+#define CBOR_KEY_AGG_ENTRIES   RBMS_KEY_AGG_ENTRIES
+
+/* 메시 진단 포맷 (CBOR_MSG_HEALTH) — 항목 구성은 mesh_health.h */
+#define CBOR_KEY_HEALTH_NODE    RBMS_KEY_HEALTH_NODE
+#define CBOR_KEY_HEALTH_MLE     RBMS_KEY_HEALTH_MLE
+#define CBOR_KEY_HEALTH_MAC     RBMS_KEY_HEALTH_MAC
+#define CBOR_KEY_HEALTH_UPLINK  RBMS_KEY_HEALTH_UPLINK
+#define CBOR_KEY_HEALTH_LINKS   RBMS_KEY_HEALTH_LINKS
+
+/*
+ * 경보 포맷 (CBOR_MSG_ALARM): {0: 7, 19: ver, 7: safety, 40: seq, 41: prev, 42: age_ms}
+ *   seq    = 부팅 후 전이 순번 (16-bit, 순환)
+ *   prev   = 전이 이전 safety 상태
+ *   age_ms = 전이 감지 후 이 데이터그램 인코딩까지 경과 ms (지연 측정)
+ */
+#define CBOR_KEY_ALARM_SEQ     RBMS_KEY_ALARM_SEQ
+#define CBOR_KEY_ALARM_PREV    RBMS_KEY_ALARM_PREV
+#define CBOR_KEY_ALARM_AGE_MS  RBMS_KEY_ALARM_AGE_MS
+
+typedef struct {
+    uint16_t seq;
+    int      safety_status;   /* safety_status_t */
+    int      prev_status;
+    uint32_t age_ms;
+} cbor_alarm_t;
+
+/*
+ * 시각 비콘 (CBOR_MSG_TIME): {0: 8, 50: unix_sec, 51: ms, 52: utc_offset_min}
+ *   게이트웨이가 주기적으로 ff03::1에 NON 전송하고 CON ACK에도 싣는다.
+ *   utc_offset_min = 게이트웨이 지역 시간대의 현재 UTC 오프셋 (분, DST 반영)
+ */
+#define CBOR_KEY_TIME_SEC         RBMS_KEY_TIME_SEC
+#define CBOR_KEY_TIME_MS          RBMS_KEY_TIME_MS
+#define CBOR_KEY_TIME_UTC_OFFSET  RBMS_KEY_TIME_UTC_OFFSET
+
+#define CBOR_TIME_BUF_SIZE 24
+
+typedef struct {
+    uint32_t unix_sec;
+    uint16_t ms;               /* 0~999 */
+    int16_t  utc_offset_min;   /* -720~840 */
+} cbor_time_t;
+
+/* 8샘플 배치 ≈ 72 bytes — 단일 802.15.4 프레임(127 bytes)에 수용 */
+#define CBOR_BATCH_MAX_SAMPLES 8
+#define CBOR_BATCH_BUF_SIZE    96
+
+/** @brief 배치 샘플 (x100 정수, RTC 메모리 보관용) */
+typedef struct {
+    uint32_t timestamp;  /* 샘플 시각 (초, 노드 RTC 기준) */
+    int16_t  temp_hot;   /* x100 °C */
+    int16_t  temp_cool;  /* x100 °C */
+    int16_t  humidity;   /* x100 %RH */
+} sensor_sample_t;
+
+typedef struct {
+    uint8_t         count;
+    sensor_sample_t samples[CBOR_BATCH_MAX_SAMPLES];
+    float           battery_pct;    /* 최신 값, 음수면 미사용 */
+    int             safety_status;  /* 배치 중 최악 상태, 음수면 미사용 */
+} sensor_batch_t;
+
 /**
  * @brief 센서 데이터를 CBOR Map으로 인코딩
  * @param report 센서 데이터
@@ -36,14 +161,144 @@ typedef struct {
 esp_err_t cbor_encode_report(const sensor_report_t *report,
                               uint8_t *buf, size_t buf_size, size_t *out_len);
 
+/**
+ * @brief 지정한 값 포맷으로 리포트 인코딩
+ *
+ * CBOR_REPORT_SCALED는 {0: 1} 마커 뒤에 각 값을 x100 정수(음수는 CBOR negint)로
+ * 기록한다. 0.1°C/0.1%RH 유효 정밀도를 유지하면서 필드당 2 bytes를 줄인다.
+ *
+ * @param report 센서 데이터
+ * @param format 값 인코딩 방식
+ * @param buf 출력 버퍼 (64 bytes 이상)
+ * @param buf_size 버퍼 크기
+ * @param[out] out_len 인코딩된 바이트 수
+ */
+esp_err_t cbor_encode_report_fmt(const sensor_report_t *report, cbor_report_format_t format,
+                                  uint8_t *buf, size_t buf_size, size_t *out_len);
+
 /**
  * @brief CBOR 데이터 디코딩 (서버 명령 등)
+ *
+ * float32/float16/정수 값과 키 0 포맷 마커를 모두 인식한다.
+ * SCALED 마커가 있으면 정수 값을 1/100로 환산한다.
+ *
  * @param buf 입력 버퍼
  * @param len 데이터 길이
  * @param[out] report 디코딩 결과
+ * @return ESP_ERR_INVALID_ARG 맵이 아니거나 포맷 마커가 부호 없는 정수가 아님
  */
 esp_err_t cbor_decode_report(const uint8_t *buf, size_t len, sensor_report_t *report);
 
+/*
+ * 리포트 템플릿: 필드 구성(mask)과 포맷별로 맵 헤더/키를 한 번만 기록하고,
+ * 매 주기 고정 폭 값 슬롯만 제자리에서 덮어쓴다.
+ *   FLOAT32 — 0xFA + 4 bytes (기존과 동일)
+ *   SCALED  — x100 정수를 항상 16-bit 인자(0x19/0x39 + 2 bytes)로 기록 (±655.35)
+ *   safety  — 0x18 + 1 byte
+ * 고정 폭 정수는 최소 길이 인코딩이 아니지만 유효한 CBOR이며 디코더가 그대로 읽는다.
+ */
+enum {
+#define X(id, key, member, kind, opt) CBOR_FIELD_IDX_##id,
+    RBMS_TELEMETRY_FIELDS(X)
+#undef X
+};
+
+/* 필드 마스크 비트: CBOR_FIELD_TEMP_HOT ... CBOR_FIELD_SAFETY (스키마 순서) */
+enum {
+#define X(id, key, member, kind, opt) CBOR_FIELD_##id = (1 << CBOR_FIELD_IDX_##id),
+    RBMS_TELEMETRY_FIELDS(X)
+#undef X
+};
+#define CBOR_REPORT_FIELDS      RBMS_TELEMETRY_FIELD_COUNT
+#define CBOR_TEMPLATE_MAX       48
+
+typedef struct {
+    uint8_t buf[CBOR_TEMPLATE_MAX];
+    uint8_t  len;                         /* 0 = 미생성 */
+    uint16_t field_mask;
+    cbor_report_format_t format;
+    uint8_t offset[CBOR_REPORT_FIELDS];   /* 필드별 값 헤더 위치, 0 = 없음 */
+} cbor_report_template_t;
+
+/** @brief 리포트에서 인코딩 대상 필드 마스크 계산 (음수 옵션 필드 제외) */
+uint16_t cbor_report_field_mask(const sensor_report_t *report);
+
+/** @brief 필드 마스크/포맷으로 템플릿 생성 (값 슬롯은 0) */
+esp_err_t cbor_template_init(cbor_report_template_t *tmpl, uint16_t field_mask,
+                              cbor_report_format_t format);
+
+/**
+ * @brief 값 슬롯만 덮어쓰기
+ * @return 리포트의 필드 구성이 템플릿과 다르면 ESP_ERR_INVALID_STATE
+ */
+esp_err_t cbor_template_patch(cbor_report_template_t *tmpl, const sensor_report_t *report);
+
+/**
+ * @brief 템플릿으로 리포트 인코딩 (필드 구성/포맷이 바뀌면 재생성 후 패치)
+ *
+ * 결과는 tmpl->buf를 가리키므로 호출자 스택 버퍼 없이 thread_node_send()에
+ * 바로 넘길 수 있다. 다음 호출 전까지 유효.
+ */
+esp_err_t cbor_template_encode(cbor_report_template_t *tmpl, const sensor_report_t *report,
+                                cbor_report_format_t format,
+                                const uint8_t **out, size_t *out_len);
+
+/** @brief 배치 비우기 */
+void cbor_batch_reset(sensor_batch_t *batch);
+
+/**
+ * @brief 배치에 샘플 추가
+ *
+ * 배치가 가득 차면 가장 오래된 샘플을 버린다.
+ * battery_pct는 최신 유효 값, safety_status는 최댓값을 유지한다.
+ *
+ * @param batch 배치
+ * @param timestamp 샘플 시각 (초)
+ * @param report 센서 데이터
+ */
+esp_err_t cbor_batch_add(sensor_batch_t *batch, uint32_t timestamp,
+                          const sensor_report_t *report);
+
+/**
+ * @brief 배치를 델타 인코딩된 CBOR Map으로 인코딩
+ * @param batch 배치 (count >= 1)
+ * @param now 현재 시각 (초, timestamp와 같은 기준) — base_age 계산용
+ * @param buf 출력 버퍼
+ * @param buf_size 버퍼 크기 (부족하면 ESP_ERR_NO_MEM)
+ * @param[out] out_len 인코딩된 바이트 수
+ */
+esp_err_t cbor_encode_batch(const sensor_batch_t *batch, uint32_t now,
+                             uint8_t *buf, size_t buf_size, size_t *out_len);
+
+/**
+ * @brief 경보 인코딩
+ * @param buf_size 버퍼 크기 (부족하면 ESP_ERR_NO_MEM, 결과 최대 22 bytes)
+ */
+esp_err_t cbor_encode_alarm(const cbor_alarm_t *alarm, uint8_t *buf, size_t buf_size,
+                             size_t *out_len);
+
+/**
+ * @brief 시각 비콘 인코딩 (결과 최대 20 bytes)
+ */
+esp_err_t cbor_encode_time(const cbor_time_t *t, uint8_t *buf, size_t buf_size,
+                            size_t *out_len);
+
+/**
+ * @brief 시각 비콘 디코딩
+ * @return 비콘이 아니면 ESP_ERR_NOT_FOUND, 형식/범위 오류면 ESP_ERR_INVALID_ARG
+ */
+esp_err_t cbor_decode_time(const uint8_t *buf, size_t len, cbor_time_t *t);
+
+/**
+ * @brief 배치 디코딩
+ * @param buf 입력 버퍼
+ * @param len 데이터 길이
+ * @param now 수신 시각 (초) — 샘플 timestamp 복원 기준
+ * @param[out] batch 디코딩 결과
+ */
+esp_err_t cbor_decode_batch(const uint8_t *buf, size_t len, uint32_t now,
+                             sensor_batch_t *batch);
+
 #ifdef __cplusplus
 }
 #endif
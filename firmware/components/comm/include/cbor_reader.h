@@ -0,0 +1,102 @@
+/**
+ * @file cbor_reader.h
+ * @brief 스트리밍 CBOR pull-parser (zero-copy, 재귀/힙 없음)
+ *
+ * 입력 버퍼 위에서 항목을 하나씩 꺼내는 증분 파서.
+ * 바이트/텍스트 문자열은 입력 버퍼를 가리키는 포인터로 반환하며
+ * 복사하지 않는다. 컨테이너 건너뛰기는 남은 항목 카운터로 처리하여
+ * 중첩 깊이와 무관하게 스택 사용량이 일정하다.
+ *
+ * 지원: uint/negint (최대 64-bit), byte/text string, array, map, tag,
+ *       simple (false/true/null/undefined), float16/32/64
+ * 미지원: indefinite length (ESP_ERR_NOT_SUPPORTED)
+ */
+#ifndef RBMS_CBOR_READER_H
+#define RBMS_CBOR_READER_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    CBOR_TYPE_UINT = 0,
+    CBOR_TYPE_NEGINT,
+    CBOR_TYPE_BYTES,
+    CBOR_TYPE_TEXT,
+    CBOR_TYPE_ARRAY,
+    CBOR_TYPE_MAP,
+    CBOR_TYPE_TAG,
+    CBOR_TYPE_SIMPLE,
+    CBOR_TYPE_FLOAT,
+} cbor_type_t;
+
+/* SIMPLE 값 */
+#define CBOR_SIMPLE_FALSE     20
+#define CBOR_SIMPLE_TRUE      21
+#define CBOR_SIMPLE_NULL      22
+#define CBOR_SIMPLE_UNDEFINED 23
+
+typedef struct {
+    cbor_type_t    type;
+    uint64_t       uval;  /* UINT 값, NEGINT 인자 n (값 = -1-n), TAG 번호,
+                             SIMPLE 값, ARRAY/MAP 항목 수 (map은 쌍 개수) */
+    float          fval;  /* FLOAT */
+    const uint8_t *ptr;   /* BYTES/TEXT 데이터 (입력 버퍼 내부) */
+    size_t         len;   /* BYTES/TEXT 길이 */
+} cbor_item_t;
+
+typedef struct {
+    const uint8_t *buf;
+    size_t         len;
+    size_t         pos;
+} cbor_reader_t;
+
+/** @brief 입력 버퍼로 리더 초기화 (버퍼는 파싱 중 유지되어야 함) */
+void cbor_reader_init(cbor_reader_t *r, const uint8_t *buf, size_t len);
+
+/**
+ * @brief 다음 항목 읽기
+ *
+ * 컨테이너(array/map/tag)는 헤더만 소비한다. 자식 항목은 이어지는
+ * next 호출로 읽거나 cbor_reader_skip()으로 건너뛴다. 항목 수는 검증하지
+ * 않으므로 순회 시 next의 반환값으로 종료를 판단해야 한다.
+ *
+ * @return ESP_OK, ESP_ERR_NOT_FOUND (입력 끝), ESP_ERR_INVALID_SIZE (잘린 헤더,
+ *         문자열 길이가 남은 바이트 초과), ESP_ERR_NOT_SUPPORTED (indefinite),
+ *         ESP_ERR_INVALID_ARG (예약된 헤더)
+ */
+esp_err_t cbor_reader_next(cbor_reader_t *r, cbor_item_t *item);
+
+/**
+ * @brief 방금 읽은 항목의 자식 항목 전체 건너뛰기 (비재귀)
+ *
+ * 스칼라 항목이면 아무것도 하지 않는다. 남은 항목 수가 남은 바이트 수를
+ * 넘으면 읽기 전에 ESP_ERR_INVALID_SIZE.
+ */
+esp_err_t cbor_reader_skip(cbor_reader_t *r, const cbor_item_t *item);
+
+/** @brief 입력을 모두 소비했는지 */
+bool cbor_reader_at_end(const cbor_reader_t *r);
+
+/** @brief uint/negint 항목을 int32로 변환 (범위 밖이면 ESP_ERR_INVALID_SIZE) */
+esp_err_t cbor_item_to_int(const cbor_item_t *item, int32_t *val);
+
+/** @brief 정수 또는 float 항목을 float로 변환 */
+esp_err_t cbor_item_to_float(const cbor_item_t *item, float *val);
+
+/** @brief 다음 항목을 int32로 읽기 */
+esp_err_t cbor_reader_get_int(cbor_reader_t *r, int32_t *val);
+
+/** @brief 다음 항목을 float로 읽기 (정수 허용) */
+esp_err_t cbor_reader_get_float(cbor_reader_t *r, float *val);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_CBOR_READER_H */
@@ -0,0 +1,97 @@
+/**
+ * @file child_agg.h
+ * @brief 자식 리포트 집계 버퍼 (Router 측 다중 노드 데이터그램)
+ *
+ * Type A(Router)가 자식(Type B)의 업링크 페이로드를 창(window) 동안 모아
+ * 하나의 CBOR 데이터그램으로 게이트웨이에 올린다:
+ *   {0: 5, 19: schema_ver, 23: [[node_id, age, payload], ...]}
+ *   node_id = 자식 IPv6 주소 마지막 16비트 (게이트웨이 node_id와 동일)
+ *   age     = 라우터 수신 후 인코딩까지 경과 초 (신선도)
+ *   payload = 자식이 보낸 CBOR 맵 그대로 (byte string)
+ *
+ * 같은 노드의 새 리포트는 이전 리포트를 대체한다 (최신 우선).
+ * 리포트/배치 외 메시지(명령 응답 등)와 safety 이상 리포트는 즉시 전송 대상.
+ */
+#ifndef RBMS_CHILD_AGG_H
+#define RBMS_CHILD_AGG_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CHILD_AGG_MAX_ENTRIES  8
+#define CHILD_AGG_PAYLOAD_MAX  96     /* CBOR_BATCH_BUF_SIZE — 8샘플 배치까지 */
+
+typedef struct {
+    uint16_t node_id;
+    uint8_t  len;
+    bool     report;                       /* 단일 리포트 (같은 노드 새 리포트로 대체 가능) */
+    bool     urgent;
+    uint32_t first_ms;                     /* 이 항목 첫 수신 시각 (창 기한 기준) */
+    uint32_t rx_ms;                        /* 현재 페이로드 수신 시각 (age 기준) */
+    uint8_t  payload[CHILD_AGG_PAYLOAD_MAX];
+} child_agg_entry_t;
+
+typedef struct {
+    child_agg_entry_t entries[CHILD_AGG_MAX_ENTRIES];  /* 수신 순 */
+    uint8_t  count;
+    uint8_t  inflight;     /* 인코딩 후 전송 결과 대기 중인 앞쪽 항목 수 */
+    uint32_t replaced;     /* 같은 노드의 새 리포트로 대체된 수 (누적) */
+} child_agg_t;
+
+/** @brief 버퍼 비우기 */
+void child_agg_init(child_agg_t *a);
+
+/**
+ * @brief 자식 페이로드 추가
+ *
+ * 같은 노드의 대기 중 항목이 있으면 덮어쓴다 (전송 중 항목 제외).
+ * @param now_ms 단조 시각 (ms)
+ * @return ESP_ERR_NO_MEM 가득 참 (먼저 flush), ESP_ERR_INVALID_SIZE 페이로드 초과,
+ *         ESP_ERR_INVALID_ARG CBOR 맵이 아님
+ */
+esp_err_t child_agg_add(child_agg_t *a, uint16_t node_id, const uint8_t *payload,
+                        size_t len, uint32_t now_ms);
+
+/** @brief 전송 대기 항목 수 (전송 중 제외) */
+size_t child_agg_pending(const child_agg_t *a);
+
+/**
+ * @brief 지금 내보내야 하는지
+ *
+ * 대기 항목이 있고 (가득 참 | 즉시 전송 항목 | 가장 오래된 항목이 window_ms 경과)이면 true.
+ * window_ms = 0 이면 대기 항목이 있으면 항상 true.
+ */
+bool child_agg_due(const child_agg_t *a, uint32_t now_ms, uint32_t window_ms);
+
+/** @brief 가장 오래된 대기 항목이 기한에 이르기까지 남은 ms (대기 항목 없으면 UINT32_MAX) */
+uint32_t child_agg_next_due_ms(const child_agg_t *a, uint32_t now_ms, uint32_t window_ms);
+
+/**
+ * @brief 집계 데이터그램 인코딩
+ *
+ * 앞에서부터 buf_size에 들어가는 만큼 담고 그 항목들을 전송 중으로 표시한다.
+ * 결과에 따라 child_agg_commit() (성공) 또는 child_agg_abort() (다음에 재시도)를 호출.
+ * @param[out] out_entries 담은 항목 수
+ * @return ESP_ERR_NOT_FOUND 대기 항목 없음, ESP_ERR_INVALID_STATE 전송 중 항목 있음,
+ *         ESP_ERR_NO_MEM 첫 항목도 들어가지 않음
+ */
+esp_err_t child_agg_encode(child_agg_t *a, uint32_t now_ms, uint8_t *buf, size_t buf_size,
+                           size_t *out_len, size_t *out_entries);
+
+/** @brief 전송 중 항목 제거 (게이트웨이 ACK 수신) */
+void child_agg_commit(child_agg_t *a);
+
+/** @brief 전송 중 표시 해제 — 항목은 남겨 다음 flush에 다시 보냄 */
+void child_agg_abort(child_agg_t *a);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_CHILD_AGG_H */
@@ -0,0 +1,87 @@
+/**
+ * @file child_mailbox.h
+ * @brief 자식별 다운링크 명령 우편함 (Router 측 피기백 전달)
+ *
+ * SED 자식(Type B)은 수신기를 끄고 있으므로 게이트웨이는 부모 Router(Type A)에
+ * 자식 앞 명령을 맡긴다 (집계 포맷 재사용):
+ *   {0: 5, 23: [[node_id, 0, command], ...]}   (게이트웨이 → Router)
+ * Router는 자식의 다음 CON 업링크 ACK에 가장 오래된 명령을 실어 보낸다.
+ * 자식이 명령 응답({0: 4, 30: seq})을 올리면 그 seq를 지우고, 그 응답의 ACK에
+ * 다음 명령이 실리므로 한 번의 wake에 여러 명령이 차례로 전달된다.
+ * 응답이 올 때까지는 업링크마다 같은 명령을 다시 싣는다 (디스패처가 seq로 중복 제거).
+ */
+#ifndef RBMS_CHILD_MAILBOX_H
+#define RBMS_CHILD_MAILBOX_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CHILD_MAILBOX_SLOTS      8
+#define CHILD_MAILBOX_PER_CHILD  4
+#define CHILD_MAILBOX_MSG_MAX    48    /* ACK 피기백 한도 (명령은 30 bytes 내외) */
+
+typedef struct {
+    uint16_t node_id;
+    uint16_t seq;
+    uint8_t  len;
+    uint32_t stored_ms;
+    uint8_t  msg[CHILD_MAILBOX_MSG_MAX];
+} child_mailbox_entry_t;
+
+typedef struct {
+    child_mailbox_entry_t entries[CHILD_MAILBOX_SLOTS];  /* 도착 순 */
+    uint8_t  count;
+    /* 누적 카운터 */
+    uint32_t stored;
+    uint32_t dropped;      /* 가득 참/형식 오류 */
+    uint32_t sent;         /* ACK에 실은 횟수 (재전송 포함) */
+    uint32_t acked;        /* 자식 명령 응답으로 제거 */
+    uint32_t expired;
+} child_mailbox_t;
+
+/** @brief 우편함 비우기 (카운터 포함) */
+void child_mailbox_init(child_mailbox_t *mb);
+
+/**
+ * @brief 명령 1건 보관
+ *
+ * 같은 (node_id, seq)가 이미 있으면 게이트웨이 재전송으로 보고 무시한다.
+ * @return ESP_ERR_INVALID_ARG 명령이 아님, ESP_ERR_INVALID_SIZE 크기 초과,
+ *         ESP_ERR_NO_MEM 자식별 한도/전체 슬롯 가득 참
+ */
+esp_err_t child_mailbox_put(child_mailbox_t *mb, uint16_t node_id, const uint8_t *msg,
+                            size_t len, uint32_t now_ms);
+
+/**
+ * @brief 게이트웨이 우편 데이터그램({0: 5, 23: [...]})의 항목을 모두 보관
+ * @param[out] out_stored 보관한 항목 수 (NULL 허용, 실패 항목은 dropped)
+ * @return ESP_ERR_INVALID_ARG 집계 포맷이 아님
+ */
+esp_err_t child_mailbox_put_aggregate(child_mailbox_t *mb, const uint8_t *msg, size_t len,
+                                      uint32_t now_ms, size_t *out_stored);
+
+/**
+ * @brief 자식 업링크 수신 시 ACK에 실을 명령 선택
+ *
+ * uplink가 명령 응답이면 해당 seq를 먼저 지운다. ttl_ms가 지난 항목(모든 자식)은
+ * 만료시킨다 (0 = 만료 없음). uplink NULL = 내용 미확인 (재전송 ACK).
+ * @return 복사한 명령 길이, 없으면 0
+ */
+size_t child_mailbox_take(child_mailbox_t *mb, uint16_t node_id, const uint8_t *uplink,
+                          size_t uplink_len, uint32_t now_ms, uint32_t ttl_ms,
+                          uint8_t *out, size_t out_size);
+
+/** @brief 대기 중인 명령 수 (node_id의 것만) */
+size_t child_mailbox_pending(const child_mailbox_t *mb, uint16_t node_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_CHILD_MAILBOX_H */
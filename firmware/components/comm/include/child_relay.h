@@ -0,0 +1,78 @@
+/**
+ * @file child_relay.h
+ * @brief Router(Type A)의 자식 업링크 중계/집계 서비스
+ *
+ * 부모 경유(thread_uplink_config_t.via_parent)로 온 자식 페이로드를 child_agg
+ * 버퍼에 모아 창(window)마다 다중 노드 데이터그램 하나로 게이트웨이에 확인형 전송한다.
+ * 자식에게는 thread_node가 수신 즉시 ACK하므로 자식은 게이트웨이 왕복을 기다리지 않는다.
+ * 게이트웨이 ACK가 없으면 항목을 남겨 다음 창에 다시 보낸다.
+ *
+ * 반대 방향으로는 게이트웨이가 맡긴 자식 앞 명령을 우편함(child_mailbox.h)에 두고
+ * 자식의 다음 CON 업링크 ACK에 실어 보낸다 (thread_node_set_ack_payload_cb).
+ * SED 자식은 리포트를 보낸 그 wake에 명령을 받으므로 별도 수신 창이 필요 없다.
+ * 실을 명령이 없으면 Router의 현재 시각 비콘을 실어 자식 시계를 맞춘다.
+ *
+ * cmd_dispatcher_config_t.other_rx에 child_relay_rx를 등록해 사용.
+ */
+#ifndef RBMS_CHILD_RELAY_H
+#define RBMS_CHILD_RELAY_H
+
+#include "esp_err.h"
+#include "thread_node.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 자식 ACK에 실을 시각 비콘 제공자 ({0: 8}, cbor_encode_time)
+ *
+ * OT 콜백 컨텍스트에서 호출 — 블로킹/로그 금지.
+ * @return out에 쓴 길이 (0 = 시각 미동기, 싣지 않음)
+ */
+typedef size_t (*child_relay_time_cb_t)(uint8_t *out, size_t out_size);
+
+typedef struct {
+    uint32_t window_ms;   /* 집계 창, 0 = 수신 즉시 전달 (node_id만 붙여 중계) */
+    uint32_t mailbox_ttl_ms;  /* 자식이 가져가지 않은 명령 폐기, 0 = 만료 없음 */
+    child_relay_time_cb_t time_beacon;  /* NULL = 시각 비콘 미전달 */
+} child_relay_config_t;
+
+/** @brief 중계 카운터 (부팅 후 누적) */
+typedef struct {
+    uint32_t received;      /* 버퍼에 넣은 자식 페이로드 */
+    uint32_t replaced;      /* 같은 노드의 새 리포트로 대체 */
+    uint32_t dropped;       /* 버퍼 가득 참/형식 오류 */
+    uint32_t datagrams;     /* 게이트웨이가 ACK한 집계 데이터그램 */
+    uint32_t entries;       /* 그 안에 담긴 자식 페이로드 */
+    uint32_t send_failed;   /* 게이트웨이 ACK 없음 (다음 창에 재시도) */
+    uint16_t pending;       /* 현재 버퍼 항목 */
+    /* 우편함 (자식 앞 다운링크 명령) */
+    uint32_t mbox_stored;
+    uint32_t mbox_dropped;  /* 가득 참/형식 오류 */
+    uint32_t mbox_sent;     /* ACK에 실은 횟수 (재전송 포함) */
+    uint32_t mbox_acked;    /* 자식 명령 응답 확인 */
+    uint32_t mbox_expired;
+    uint16_t mbox_pending;
+} child_relay_stats_t;
+
+/** @brief 중계 태스크 시작 (thread_node_init 이후) */
+esp_err_t child_relay_start(const child_relay_config_t *cfg);
+
+/**
+ * @brief 수신 데이터그램 입력 — thread_rx_cb_t 호환
+ *
+ * 멀티캐스트 수신분(다른 노드의 ff03::1 업링크)은 게이트웨이가 직접 받으므로 무시.
+ * 집계 포맷({0: 5})은 게이트웨이가 맡긴 우편이므로 우편함에 넣는다.
+ */
+void child_relay_rx(const uint8_t *data, size_t len, const thread_rx_meta_t *meta);
+
+/** @brief 중계 카운터 스냅샷 */
+esp_err_t child_relay_get_stats(child_relay_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_CHILD_RELAY_H */
@@ -0,0 +1,112 @@
+/**
+ * @file cmd_dispatcher.h
+ * @brief 다운링크 명령 디스패처 (CBOR 명령 ID → 핸들러 테이블)
+ *
+ * 명령: {0: 3, 30: seq, 31: cmd_id, 32: arg}
+ * 응답: {0: 4, 30: seq, 31: cmd_id, 33: status}
+ *
+ * thread_node 수신 콜백으로 등록되며, 핸들러는 thread_node의 ot_rx 워커 또는
+ * cmd_dispatcher_poll() 호출자 컨텍스트에서 수신 슬롯을 그대로 읽어 실행한다.
+ * 같은 seq의 재전송은 핸들러를 다시 실행하지 않고 이전 결과로 응답한다.
+ * 명령이 아닌 데이터그램은 other_rx(설정 시, 예: child_relay_rx)로 넘긴다.
+ */
+#ifndef RBMS_CMD_DISPATCHER_H
+#define RBMS_CMD_DISPATCHER_H
+
+#include "esp_err.h"
+#include "cbor_reader.h"
+#include "thread_node.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CMD_ACK_BUF_SIZE 16
+
+typedef enum {
+    CMD_SET_SETPOINT        = 1,  /* arg: 핫존 목표 온도 (°C, float/int) */
+    CMD_SET_PID             = 2,  /* arg: [kp, ki, kd] */
+    CMD_SET_LIGHT           = 3,  /* arg: [on_hour, off_hour, sunrise_min, sunset_min] */
+    CMD_SET_REPORT_INTERVAL = 4,  /* arg: 리포트 주기 (초) */
+    CMD_SET_WAKE_EPOCH      = 5,  /* arg: wake 슬롯 epoch (Type B) */
+    CMD_RESCAN_SENSORS      = 6,  /* arg: 없음 — 다음 wake에 DS18B20 ROM 검색 (Type B) */
+    CMD_SWAP_SENSOR_ROLES   = 7,  /* arg: [role_a, role_b] — DS18B20 역할 교환 (0 = HOT, 1 = COOL) */
+} cmd_id_t;
+
+typedef enum {
+    CMD_STATUS_OK        = 0,
+    CMD_STATUS_UNKNOWN   = 1,  /* 이 노드 타입에 없는 명령 */
+    CMD_STATUS_BAD_ARG   = 2,  /* 인자 형식 오류 */
+    CMD_STATUS_REJECTED  = 3,  /* 값 검증 실패 (미적용) */
+    CMD_STATUS_NOT_SAVED = 4,  /* 적용됨, NVS 저장 실패 */
+} cmd_status_t;
+
+/**
+ * @brief 명령 핸들러
+ * @param arg 인자 항목 위에 초기화된 리더 (인자 없으면 빈 리더)
+ * @param ctx cmd_dispatcher_config_t.ctx
+ */
+typedef cmd_status_t (*cmd_handler_t)(cbor_reader_t *arg, void *ctx);
+
+typedef struct {
+    uint8_t       id;
+    cmd_handler_t handler;
+} cmd_entry_t;
+
+/** @brief 파싱된 명령 (arg는 메시지 버퍼 내부를 가리킴) */
+typedef struct {
+    uint16_t       seq;
+    uint8_t        cmd_id;
+    const uint8_t *arg;
+    size_t         arg_len;
+} cmd_msg_t;
+
+typedef struct {
+    const cmd_entry_t *table;
+    size_t             count;
+    void              *ctx;
+    bool               use_task;  /* true: thread_node ot_rx 워커에서 처리 (thread_node_init 이후),
+                                     false: cmd_dispatcher_poll()로 처리 (Type B) */
+    thread_rx_cb_t     other_rx;  /* 명령 외 데이터그램 (NULL = 무시) */
+} cmd_dispatcher_config_t;
+
+/* --- 프로토콜 (cmd_protocol.c) --- */
+
+/** @brief 명령 메시지인지 빠르게 확인 (맵 첫 항목이 {0: 3}) — 수신 콜백 필터 */
+bool cmd_is_command(const uint8_t *buf, size_t len);
+
+/** @brief 명령 메시지 파싱 */
+esp_err_t cmd_parse(const uint8_t *buf, size_t len, cmd_msg_t *msg);
+
+/** @brief 테이블에서 핸들러를 찾아 실행 */
+cmd_status_t cmd_dispatch(const cmd_entry_t *table, size_t count,
+                          const cmd_msg_t *msg, void *ctx);
+
+/** @brief 응답 메시지 인코딩 */
+esp_err_t cmd_encode_ack(uint16_t seq, uint8_t cmd_id, cmd_status_t status,
+                         uint8_t *buf, size_t buf_size, size_t *out_len);
+
+/** @brief 인자에서 float 배열 읽기 (정수 허용, 길이 정확히 일치해야 함) */
+esp_err_t cmd_arg_floats(cbor_reader_t *arg, float *out, size_t count);
+
+/* --- 런타임 (cmd_dispatcher.c) --- */
+
+/** @brief thread_node 수신 콜백 등록 (use_task면 ot_rx 워커 시작) */
+esp_err_t cmd_dispatcher_init(const cmd_dispatcher_config_t *cfg);
+
+/**
+ * @brief 수신 링에 쌓인 명령을 호출자 컨텍스트에서 처리 (use_task=false)
+ * @param timeout_ms 첫 명령 대기 시간, 이후 대기 없이 링을 비움
+ * @return 처리한 명령 수
+ */
+int cmd_dispatcher_poll(uint32_t timeout_ms);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_CMD_DISPATCHER_H */
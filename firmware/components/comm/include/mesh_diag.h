@@ -0,0 +1,38 @@
+/**
+ * @file mesh_diag.h
+ * @brief Router(Type A) 메시 진단 수집/보고
+ *
+ * OpenThread 이웃 테이블(자식 포함)의 RSSI/링크 마진/프레임 오류율,
+ * MLE(부모 변경/attach/파티션) 및 MAC 카운터, thread_node/child_relay 업링크
+ * 카운터를 모아 저빈도 health 메시지(mesh_health.h)로 게이트웨이에 보낸다.
+ * 주변 SED의 재전송과 배터리 소모를 일으키는 약한 링크를 찾는 용도.
+ */
+#ifndef RBMS_MESH_DIAG_H
+#define RBMS_MESH_DIAG_H
+
+#include "esp_err.h"
+#include "mesh_health.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t interval_ms;   /* health 메시지 주기 */
+} mesh_diag_config_t;
+
+/** @brief 진단 보고 태스크 시작 (thread_node_start 이후) */
+esp_err_t mesh_diag_start(const mesh_diag_config_t *cfg);
+
+/**
+ * @brief 현재 진단 스냅샷 수집 (OT lock 획득, 태스크 컨텍스트)
+ * @return ESP_ERR_INVALID_STATE OT 미초기화, ESP_ERR_TIMEOUT lock 획득 실패
+ */
+esp_err_t mesh_diag_collect(mesh_health_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_MESH_DIAG_H */
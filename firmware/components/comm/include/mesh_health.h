@@ -0,0 +1,91 @@
+/**
+ * @file mesh_health.h
+ * @brief 메시 진단(health) 메시지 — Router(Type A)의 링크/카운터 스냅샷
+ *
+ * 저빈도로 게이트웨이에 올려 재전송을 유발하는 약한 링크를 찾는다:
+ *   {0: 6, 19: schema_ver,
+ *    24: [role, uptime_s, child_count, neighbor_count],
+ *    25: [parent_changes, attach_attempts, partition_changes],   MLE 카운터
+ *    26: [tx_total, tx_retry, tx_err_cca, tx_fail, rx_total, rx_err],  MAC 카운터
+ *    27: [con_retransmits, con_timeouts, send_errors, tx_dropped, rx_dropped,
+ *         relay_failed],                                        업링크 카운터
+ *    28: [[rloc16, rssi, margin, frame_err_pct, is_child], ...]}  이웃 링크 (나쁜 순)
+ *
+ * 카운터는 부팅 후 누적 (증가율은 서버가 계산, uptime 감소 = 재부팅).
+ * 링크 목록은 링크 마진이 낮은 순으로 페이로드에 들어가는 만큼만 담는다.
+ */
+#ifndef RBMS_MESH_HEALTH_H
+#define RBMS_MESH_HEALTH_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MESH_HEALTH_MAX_LINKS  8
+
+typedef struct {
+    uint16_t rloc16;
+    int8_t   rssi;            /* 평균 RSSI (dBm) */
+    uint8_t  margin;          /* 링크 마진 (dB, 평균 RSSI - 수신 감도) */
+    uint8_t  frame_err_pct;   /* MAC 프레임 오류율 (%) */
+    bool     child;           /* 이 Router의 자식 (false = 이웃 Router) */
+} mesh_link_t;
+
+typedef struct {
+    uint8_t  role;              /* otDeviceRole */
+    uint32_t uptime_s;
+    uint8_t  child_count;
+    uint8_t  neighbor_count;    /* 전체 이웃 수 (links보다 많을 수 있음) */
+
+    uint16_t parent_changes;
+    uint16_t attach_attempts;
+    uint16_t partition_changes;
+
+    uint32_t mac_tx_total;
+    uint32_t mac_tx_retry;      /* MAC 재시도 (ACK 없음/CCA 실패) */
+    uint32_t mac_tx_err_cca;
+    uint32_t mac_tx_fail;       /* 재시도 소진 (직접 + 간접 전송) */
+    uint32_t mac_rx_total;
+    uint32_t mac_rx_err;        /* FCS/보안/형식 오류 */
+
+    uint32_t con_retransmits;   /* 업링크 CON 재전송 */
+    uint32_t con_timeouts;      /* 업링크 CON 재전송 소진 */
+    uint32_t send_errors;       /* OT 메시지 할당/전송 실패 */
+    uint32_t tx_dropped;        /* 송신 큐 거부 + 덮어쓰기 */
+    uint32_t rx_dropped;        /* 수신 링 가득 참/크기 초과 */
+    uint32_t relay_failed;      /* 자식 집계 전송 실패 (child_relay) */
+
+    uint8_t     link_count;
+    mesh_link_t links[MESH_HEALTH_MAX_LINKS];   /* 링크 마진 오름차순 */
+} mesh_health_t;
+
+/** @brief 스냅샷 비우기 */
+void mesh_health_reset(mesh_health_t *h);
+
+/**
+ * @brief 이웃 링크 추가 — 마진 오름차순 유지, 가득 차면 가장 좋은 링크를 버림
+ *
+ * neighbor_count도 함께 센다.
+ */
+void mesh_health_add_link(mesh_health_t *h, const mesh_link_t *link);
+
+/**
+ * @brief health 메시지 인코딩
+ *
+ * 고정 항목 뒤에 링크를 나쁜 순으로 buf_size에 들어가는 만큼 담는다.
+ * @param[out] out_links 담은 링크 수 (NULL 가능)
+ * @return ESP_ERR_NO_MEM 고정 항목도 들어가지 않음
+ */
+esp_err_t mesh_health_encode(const mesh_health_t *h, uint8_t *buf, size_t buf_size,
+                             size_t *out_len, size_t *out_links);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_MESH_HEALTH_H */
@@ -0,0 +1,84 @@
+/**
+ * @file msg_ring.h
+ * @brief 고정 크기 lock-free 메시지 링 (다중 생산자/다중 소비자)
+ *
+ * 슬롯마다 시퀀스 번호를 두는 bounded MPMC 큐 (Vyukov 방식).
+ * 저장 공간은 호출자가 정적으로 할당하고 push/pop은 payload를 복사한다
+ * (claim/publish, acquire/release는 슬롯 버퍼를 직접 사용).
+ * 블로킹/힙 할당/mutex 없음 — 가득 차면 즉시 ESP_ERR_NO_MEM.
+ */
+#ifndef RBMS_MSG_RING_H
+#define RBMS_MSG_RING_H
+
+#include "esp_err.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MSG_RING_PAYLOAD_MAX  128   /* 배치 리포트(CBOR_BATCH_BUF_SIZE) 이상 */
+
+typedef struct {
+    atomic_uint seq;
+    uint32_t    tag;                 /* 사용자 정의 (프레임 타입/mid 등) */
+    uint16_t    len;
+    uint8_t     data[MSG_RING_PAYLOAD_MAX];
+} msg_ring_slot_t;
+
+typedef struct {
+    msg_ring_slot_t *slots;
+    uint32_t         mask;
+    atomic_uint      head;           /* 다음 push 위치 */
+    atomic_uint      tail;           /* 다음 pop 위치 */
+} msg_ring_t;
+
+/**
+ * @brief 링 초기화
+ * @param slots 슬롯 배열 (링 수명 동안 유지)
+ * @param count 슬롯 수 (2의 거듭제곱, 2 이상)
+ */
+esp_err_t msg_ring_init(msg_ring_t *r, msg_ring_slot_t *slots, size_t count);
+
+/**
+ * @brief 메시지 추가 (복사)
+ * @return ESP_ERR_NO_MEM 가득 참, ESP_ERR_INVALID_SIZE len > MSG_RING_PAYLOAD_MAX
+ */
+esp_err_t msg_ring_push(msg_ring_t *r, uint32_t tag, const uint8_t *data, size_t len);
+
+/**
+ * @brief 가장 오래된 메시지 꺼내기
+ * @param data 출력 버퍼 (MSG_RING_PAYLOAD_MAX 이상), NULL이면 버림
+ * @param[out] tag, len NULL 허용
+ * @return ESP_ERR_NOT_FOUND 비어 있음
+ */
+esp_err_t msg_ring_pop(msg_ring_t *r, uint32_t *tag, uint8_t *data, size_t *len);
+
+/*
+ * 복사 없는 사용: 슬롯 버퍼에 직접 쓰고/읽는다.
+ * claim한 슬롯은 반드시 publish, acquire한 슬롯은 반드시 release해야 한다.
+ * 게시 전 슬롯은 소비자를, 반환 전 슬롯은 생산자를 그 위치에서 멈추게 한다.
+ */
+
+/** @brief 빈 슬롯 차지 — data/len/tag를 채운 뒤 msg_ring_publish(), 가득 차면 NULL */
+msg_ring_slot_t *msg_ring_claim(msg_ring_t *r);
+
+/** @brief claim한 슬롯을 소비자에게 게시 */
+void msg_ring_publish(msg_ring_t *r, msg_ring_slot_t *slot);
+
+/** @brief 가장 오래된 메시지 슬롯 차지 — 사용 후 msg_ring_release(), 비어 있으면 NULL */
+msg_ring_slot_t *msg_ring_acquire(msg_ring_t *r);
+
+/** @brief acquire한 슬롯 반환 */
+void msg_ring_release(msg_ring_t *r, msg_ring_slot_t *slot);
+
+/** @brief 대기 중인 메시지 수 (동시 push/pop 중에는 근사값) */
+size_t msg_ring_depth(const msg_ring_t *r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_MSG_RING_H */
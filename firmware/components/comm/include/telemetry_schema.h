@@ -0,0 +1,68 @@
+/**
+ * @file telemetry_schema.h
+ * @brief 텔레메트리 스키마 (자동 생성 — 직접 수정 금지)
+ *
+ * 원본: schema/telemetry.json
+ * 갱신: python tools/gen_schema.py
+ */
+#ifndef RBMS_TELEMETRY_SCHEMA_H
+#define RBMS_TELEMETRY_SCHEMA_H
+
+#define RBMS_SCHEMA_VERSION  1
+#define RBMS_SCALED_FACTOR   100
+
+/* 프로토콜 키 */
+#define RBMS_KEY_MSG_TYPE         0
+#define RBMS_KEY_SCHEMA_VERSION   19
+#define RBMS_KEY_BATCH_AGE        20
+#define RBMS_KEY_BATCH_BASE       21
+#define RBMS_KEY_BATCH_DELTAS     22
+#define RBMS_KEY_AGG_ENTRIES      23
+#define RBMS_KEY_HEALTH_NODE      24
+#define RBMS_KEY_HEALTH_MLE       25
+#define RBMS_KEY_HEALTH_MAC       26
+#define RBMS_KEY_HEALTH_UPLINK    27
+#define RBMS_KEY_HEALTH_LINKS     28
+#define RBMS_KEY_CMD_SEQ          30
+#define RBMS_KEY_CMD_ID           31
+#define RBMS_KEY_CMD_ARG          32
+#define RBMS_KEY_CMD_STATUS       33
+#define RBMS_KEY_ALARM_SEQ        40
+#define RBMS_KEY_ALARM_PREV       41
+#define RBMS_KEY_ALARM_AGE_MS     42
+#define RBMS_KEY_TIME_SEC         50
+#define RBMS_KEY_TIME_MS          51
+#define RBMS_KEY_TIME_UTC_OFFSET  52
+
+/* 메시지 타입 (키 0 값) */
+#define RBMS_MSG_REPORT         0
+#define RBMS_MSG_REPORT_SCALED  1
+#define RBMS_MSG_BATCH          2
+#define RBMS_MSG_CMD            3
+#define RBMS_MSG_CMD_ACK        4
+#define RBMS_MSG_AGGREGATE      5
+#define RBMS_MSG_HEALTH         6
+#define RBMS_MSG_ALARM          7
+#define RBMS_MSG_TIME           8
+
+/* 필드 값 종류 */
+#define RBMS_KIND_SCALED  0  /* float, SCALED 포맷에서 x100 정수 */
+#define RBMS_KIND_ENUM    1  /* int, 정수 그대로 */
+
+/*
+ * 텔레메트리 필드 (인코딩 순서)
+ *   X(ID, key, sensor_report_t 멤버, kind, optional)
+ *   optional = 1 이면 음수 값일 때 인코딩 생략
+ */
+#define RBMS_TELEMETRY_FIELDS(X) \
+    X(TEMP_HOT,     1, temp_hot,      RBMS_KIND_SCALED, 0) \
+    X(TEMP_COOL,    2, temp_cool,     RBMS_KIND_SCALED, 0) \
+    X(HUMIDITY,     3, humidity,      RBMS_KIND_SCALED, 0) \
+    X(BATTERY,      4, battery_pct,   RBMS_KIND_SCALED, 1) \
+    X(HEATER_DUTY,  5, heater_duty,   RBMS_KIND_SCALED, 1) \
+    X(LIGHT_DUTY,   6, light_duty,    RBMS_KIND_SCALED, 1) \
+    X(SAFETY,       7, safety_status, RBMS_KIND_ENUM,   1)
+
+#define RBMS_TELEMETRY_FIELD_COUNT  7
+
+#endif /* RBMS_TELEMETRY_SCHEMA_H */
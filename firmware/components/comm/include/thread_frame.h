@@ -0,0 +1,115 @@
+/**
+ * @file thread_frame.h
+ * @brief 업링크 전송 프레임 (CoAP 유사 확인형 전송)
+ *
+ * UDP 페이로드 앞 3 bytes 헤더:
+ *   byte 0   : Ver(2) = 1 | Type(2) | 예약(4) = 0
+ *   byte 1-2 : message id (big endian)
+ *
+ * CON은 수신 측이 같은 mid의 ACK로 응답하고, 송신 측은 ACK가 올 때까지
+ * 지수 백오프로 재전송한다. 수신 측은 최근 mid를 기억해 재전송을 한 번만 처리한다.
+ * 멀티캐스트(게이트웨이 탐색)로 받은 CON에는 노드가 응답하지 않는다 —
+ * 게이트웨이만 ACK해야 송신 측이 ACK 주소를 게이트웨이로 학습한다.
+ * Ver 비트(01)는 CBOR 맵 첫 바이트(0xA0~0xBF)와 겹치지 않으므로
+ * 헤더 없는 기존 CBOR 데이터그램과 구분된다.
+ */
+#ifndef RBMS_THREAD_FRAME_H
+#define RBMS_THREAD_FRAME_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define THREAD_FRAME_VERSION   1
+#define THREAD_FRAME_HDR_LEN   3
+#define THREAD_FRAME_DEDUP_LEN 8      /* 기억하는 최근 키 수 */
+#define THREAD_FRAME_BACKOFF_MAX_MS 60000
+
+typedef enum {
+    THREAD_FRAME_CON = 0,  /* 확인형: ACK 필요 */
+    THREAD_FRAME_NON = 1,  /* 비확인형 */
+    THREAD_FRAME_ACK = 2,  /* CON 수신 확인 */
+    THREAD_FRAME_RST = 3,  /* CON 거부 (처리 불가) */
+} thread_frame_type_t;
+
+typedef struct {
+    thread_frame_type_t type;
+    uint16_t            mid;
+} thread_frame_hdr_t;
+
+/**
+ * @brief 최근 수신 키 (중복 제거용 링)
+ *
+ * 키 = mid, 여러 송신자에게서 받는 쪽(Router의 자식 중계)은 thread_frame_dedup_key().
+ */
+typedef struct {
+    uint64_t key[THREAD_FRAME_DEDUP_LEN];
+    uint8_t  count;
+    uint8_t  next;
+} thread_frame_dedup_t;
+
+/**
+ * @brief 헤더 기록
+ * @param buf 출력 버퍼 (THREAD_FRAME_HDR_LEN 이상)
+ * @return 기록한 바이트 수 (THREAD_FRAME_HDR_LEN)
+ */
+size_t thread_frame_write_hdr(uint8_t *buf, thread_frame_type_t type, uint16_t mid);
+
+/**
+ * @brief 헤더 파싱
+ * @param[out] payload 헤더 다음 위치
+ * @param[out] payload_len 페이로드 길이
+ * @return ESP_ERR_NOT_FOUND 헤더 없는 데이터그램 (기존 CBOR), ESP_ERR_INVALID_SIZE 잘림,
+ *         ESP_ERR_NOT_SUPPORTED 다른 버전/예약 비트 사용
+ */
+esp_err_t thread_frame_parse(const uint8_t *buf, size_t len, thread_frame_hdr_t *hdr,
+                              const uint8_t **payload, size_t *payload_len);
+
+/**
+ * @brief 응답(ACK/RST)해야 하는 수신인지
+ *
+ * 유니캐스트 CON만 응답한다. 멀티캐스트 CON은 전달만 (응답은 게이트웨이 몫).
+ */
+bool thread_frame_needs_reply(thread_frame_type_t type, bool multicast);
+
+/**
+ * @brief 송신자 주소 + mid로 중복 제거 키 생성
+ *
+ * ML-EID IID는 무작위라 끝 16비트는 노드 40여 개에서도 겹칠 수 있으므로
+ * IID 하위 48비트를 쓴다.
+ * @param iid 송신자 IPv6 주소의 인터페이스 ID (8 bytes)
+ */
+uint64_t thread_frame_dedup_key(const uint8_t iid[8], uint16_t mid);
+
+/** @brief 중복 제거 링 비우기 */
+void thread_frame_dedup_reset(thread_frame_dedup_t *d);
+
+/** @brief 키를 이미 받았는지 확인만 (기록 안 함) */
+bool thread_frame_dedup_contains(const thread_frame_dedup_t *d, uint64_t key);
+
+/**
+ * @brief 키를 이미 받았는지 확인, 처음이면 기록
+ * @return true 중복 (이미 처리함)
+ */
+bool thread_frame_dedup_check(thread_frame_dedup_t *d, uint64_t key);
+
+/**
+ * @brief n번째 전송의 ACK 대기 시간
+ *
+ * base_ms x 2^attempt 에 0~50% 지터를 더한다 (CoAP ACK_RANDOM_FACTOR 1.5).
+ * @param base_ms 첫 대기 시간
+ * @param attempt 0 = 첫 전송
+ * @param rnd 난수 (esp_random())
+ */
+uint32_t thread_frame_backoff_ms(uint32_t base_ms, int attempt, uint32_t rnd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_THREAD_FRAME_H */
@@ -1,6 +1,19 @@
 /**
  * @file thread_node.h
  * @brief OpenThread 통신 모듈
+ *
+ * 업링크는 게이트웨이 unicast (주소 미확인 시 ff03::1로 탐색),
+ * 모든 데이터그램에 thread_frame.h 헤더를 붙인다.
+ *
+ * 송신은 클래스별 고정 크기 링(msg_ring.h)에 복사만 하고 즉시 반환한다.
+ * OT lock은 전송 워커 태스크(ot_tx)만 잡으므로 호출 태스크는 lock을 기다리지 않는다.
+ *
+ * 수신은 OT 콜백이 페이로드를 고정 슬롯 링에 직접 읽어 두기만 하고,
+ * 수신 콜백은 ot_rx 워커(thread_node_rx_start_task) 또는
+ * thread_node_rx_poll() 호출자 컨텍스트에서 실행한다.
+ *
+ * via_parent 설정 시 업링크는 게이트웨이 대신 부모 Router(RLOC)로 보내고,
+ * 부모가 ACK하지 않으면 그 부모와 연결된 동안 게이트웨이로 직접 보낸다.
  */
 #ifndef RBMS_THREAD_NODE_H
 #define RBMS_THREAD_NODE_H
@@ -9,12 +22,91 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include "msg_ring.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-typedef void (*thread_rx_cb_t)(const uint8_t *data, size_t len);
+/** @brief 수신 데이터그램 송신자 정보 */
+typedef struct {
+    uint16_t src_id;      /* 송신 IPv6 주소 마지막 16비트 (게이트웨이 node_id와 같은 규칙) */
+    bool     multicast;   /* 멀티캐스트 목적지로 수신 (다른 노드의 ff03::1 업링크 등) */
+} thread_rx_meta_t;
+
+/**
+ * @brief 수신 콜백 — ot_rx 워커 또는 thread_node_rx_poll() 호출자 컨텍스트
+ *
+ * data는 수신 슬롯을 직접 가리키며 반환 후 재사용된다 (필요하면 복사).
+ * 블로킹 가능 (NVS 쓰기, 확인형 전송 등). 그동안 도착분은 링에 쌓인다.
+ */
+typedef void (*thread_rx_cb_t)(const uint8_t *data, size_t len, const thread_rx_meta_t *meta);
+
+/**
+ * @brief CON ACK에 실을 응답 제공자 (Router의 자식 우편함, child_relay.h)
+ *
+ * 이 Router의 자식이 보낸 유니캐스트 CON에만 호출 (그 외에는 빈 ACK).
+ * OT 콜백 컨텍스트(OT lock 보유)에서 호출 — 블로킹/로그 금지.
+ * @param data 방금 받은 CON 페이로드 (재전송 ACK면 NULL)
+ * @return out에 쓴 길이 (0 = 빈 ACK)
+ */
+typedef size_t (*thread_ack_payload_cb_t)(uint16_t src_id, const uint8_t *data, size_t len,
+                                          uint8_t *out, size_t out_size);
+
+#define THREAD_ACK_PAYLOAD_MAX 48
+
+#define THREAD_UPLINK_ACK_TIMEOUT_DEFAULT    1000
+#define THREAD_UPLINK_MAX_RETRANSMIT_DEFAULT 3
+
+#define THREAD_TX_PAYLOAD_MAX  MSG_RING_PAYLOAD_MAX
+
+/** @brief 송신 메시지 클래스 — 큐가 가득 찼을 때 정책과 전송 우선순위 */
+typedef enum {
+    THREAD_TX_ALARM = 0,    /* 안전 경보: 최우선, 가득 차면 가장 오래된 경보를 덮어씀 */
+    THREAD_TX_CONTROL,      /* 명령 응답/CON: 가득 차면 새 메시지 거부 (호출자가 재시도) */
+    THREAD_TX_TELEMETRY,    /* 주기 리포트: 가득 차면 가장 오래된 리포트를 덮어씀 (최신 우선) */
+    THREAD_TX_CLASS_COUNT,
+} thread_tx_class_t;
+
+/** @brief 송신 큐 카운터 (부팅 후 누적) */
+typedef struct {
+    uint32_t queued[THREAD_TX_CLASS_COUNT];
+    uint32_t dropped[THREAD_TX_CLASS_COUNT];      /* 가득 차 거부된 새 메시지 */
+    uint32_t overwritten[THREAD_TX_CLASS_COUNT];  /* 새 메시지에 밀려 버려진 메시지 */
+    uint32_t sent;
+    uint32_t send_errors;                         /* OT 메시지 할당/전송 실패 */
+    uint32_t con_retransmits;                     /* 확인형/경보 전송 재전송 (ACK 대기 초과) */
+    uint32_t con_timeouts;                        /* 확인형/경보 전송 재전송 소진 */
+    uint16_t depth;                               /* 현재 대기 중 (전체 클래스) */
+    uint16_t depth_max;
+    uint32_t lock_waits;                          /* 워커의 OT lock 획득 횟수 */
+    uint32_t lock_wait_max_us;
+    uint32_t lock_wait_total_us;
+} thread_tx_stats_t;
+
+/** @brief 수신 링 카운터 (부팅 후 누적) */
+typedef struct {
+    uint32_t received;     /* OT 콜백에 도착한 데이터그램 (ACK 포함) */
+    uint32_t delivered;    /* 수신 콜백에 전달 */
+    uint32_t dropped;      /* 링 가득 참 (CON은 ACK 없이 버려 재전송 유도) */
+    uint32_t oversize;     /* 슬롯보다 큰 페이로드 (CON은 RST) */
+    uint32_t duplicates;   /* 재전송 mid */
+    uint16_t depth;
+    uint16_t depth_max;
+} thread_rx_stats_t;
+
+/** @brief 마지막 thread_node_start() 이후 연결 결과 */
+typedef struct {
+    uint32_t attach_ms;    /* start → Child/Router 역할까지, 0 = 아직 미연결 */
+    bool     resumed;      /* 저장된 부모 정보로 Child Update 시도 (false = full attach) */
+} thread_attach_info_t;
+
+typedef struct {
+    uint32_t    ack_timeout_ms;   /* 첫 ACK 대기, 재전송마다 2배 (+0~50% 지터) */
+    int         max_retransmit;   /* 첫 전송 이후 재전송 횟수 */
+    const char *gateway_addr;     /* 고정 게이트웨이 IPv6, NULL/"" = ACK로 학습 */
+    bool        via_parent;       /* 부모 Router 경유 (child_relay 실행 중인 Type A 부모, SED) */
+} thread_uplink_config_t;
 
 /**
  * @brief OpenThread 스택 초기화
@@ -22,25 +114,120 @@ typedef void (*thread_rx_cb_t)(const uint8_t *data, size_t len);
  */
 esp_err_t thread_node_init(bool is_router);
 
-/** @brief Thread 네트워크 시작 */
+/**
+ * @brief Thread 네트워크 시작
+ *
+ * OT 설정(nvs 파티션)에 이전 부모/RLOC16이 있으면 full attach 없이
+ * Child Update로 복귀한다. 완료는 thread_node_wait_attached()로 기다린다.
+ */
 esp_err_t thread_node_start(void);
 
 /**
- * @brief 데이터 전송 (CoAP UDP)
- * @param data CBOR 인코딩된 페이로드
- * @param len 데이터 길이
+ * @brief SED child timeout 설정 (thread_node_start 이전, 기본 300초)
+ *
+ * 부모는 이 시간 동안 poll이 없으면 자식을 지운다. 전송 간격(sleep x 배치)보다
+ * 길어야 다음 wake에 빠른 복귀가 가능하다.
  */
+esp_err_t thread_node_config_sed(uint32_t child_timeout_s);
+
+/**
+ * @brief 부모 연결(Child/Router 역할)까지 대기 — 폴링 없이 이벤트로 깨어남
+ * @return ESP_OK 연결됨, ESP_ERR_TIMEOUT
+ */
+esp_err_t thread_node_wait_attached(uint32_t timeout_ms);
+
+/** @brief 연결 소요 시간/복귀 방식 */
+esp_err_t thread_node_get_attach_info(thread_attach_info_t *out);
+
+/** @brief 업링크 재전송/게이트웨이 설정 (미호출 시 기본값, 게이트웨이 학습) */
+esp_err_t thread_node_config_uplink(const thread_uplink_config_t *cfg);
+
+/**
+ * @brief 비확인형(NON) 전송 예약 — 블로킹 없음, ISR 제외 어느 태스크에서나 호출 가능
+ *
+ * 페이로드를 클래스 큐에 복사하고 전송 워커를 깨운 뒤 바로 반환한다.
+ * 게이트웨이 미확인 시, 그리고 16건마다 1건은 ACK를 기다리지 않는 CON으로
+ * 보내 게이트웨이 주소를 학습/생존 확인한다.
+ *
+ * @param cls 메시지 클래스 (덮어쓰기/거부 정책)
+ * @param data CBOR 인코딩된 페이로드 (THREAD_TX_PAYLOAD_MAX 이하)
+ * @return ESP_OK 대기열 추가 (덮어쓰기 포함), ESP_ERR_NO_MEM 가득 차 거부,
+ *         ESP_ERR_INVALID_SIZE 페이로드 초과
+ */
+esp_err_t thread_node_send_async(thread_tx_class_t cls, const uint8_t *data, size_t len);
+
+/** @brief 주기 리포트 전송 (thread_node_send_async(THREAD_TX_TELEMETRY, ...)) */
 esp_err_t thread_node_send(const uint8_t *data, size_t len);
 
+/**
+ * @brief 확인형(CON) 전송 — 게이트웨이 ACK까지 블로킹
+ *
+ * ACK가 오면 즉시 반환하므로 Type B는 반환 직후 sleep 가능.
+ * ACK가 없으면 지수 백오프로 max_retransmit회 재전송한다.
+ * 전송은 CONTROL 큐를 거치며 ACK 대기 중에도 OT lock을 잡지 않는다.
+ * 동시에 1건만 진행 (다른 호출자는 대기, 경보 채널과는 독립). OT 콜백에서 호출 금지.
+ * 부모 경유 전송이 ACK 없이 끝나면 같은 호출 안에서 게이트웨이로 다시 보낸다.
+ *
+ * @return ESP_OK ACK 수신, ESP_ERR_TIMEOUT 재전송 소진,
+ *         ESP_FAIL 게이트웨이 거부 (RST)
+ */
+esp_err_t thread_node_send_confirmed(const uint8_t *data, size_t len);
+
+/**
+ * @brief 경보 확인형(CON) 전송 — ALARM 큐/별도 CON 채널, 게이트웨이 ACK까지 블로킹
+ *
+ * thread_node_send_confirmed()와 같은 재전송 규칙이지만 진행 중인 CONTROL CON을
+ * 기다리지 않고, via_parent 설정과 무관하게 게이트웨이로 직접 보낸다.
+ * 재전송 소진 후 재시도는 호출자 몫 (alarm_uplink.h).
+ *
+ * @return ESP_OK ACK 수신, ESP_ERR_TIMEOUT 재전송 소진, ESP_FAIL 게이트웨이 거부 (RST)
+ */
+esp_err_t thread_node_send_alarm(const uint8_t *data, size_t len);
+
+/** @brief 송신 큐 카운터 스냅샷 */
+esp_err_t thread_node_get_tx_stats(thread_tx_stats_t *out);
+
 /** @brief 수신 콜백 등록 */
 esp_err_t thread_node_set_rx_callback(thread_rx_cb_t cb);
 
+/**
+ * @brief 유니캐스트 CON ACK 피기백 제공자 등록 (NULL = 빈 ACK)
+ *
+ * 받는 쪽에서는 실린 페이로드가 수신 링에 일반 데이터그램으로 게시되며,
+ * thread_node_send_confirmed() 반환 시점에 이미 링에 있다.
+ */
+esp_err_t thread_node_set_ack_payload_cb(thread_ack_payload_cb_t cb);
+
+/**
+ * @brief 수신 워커(ot_rx) 시작 — 이후 수신 콜백은 이 태스크에서 실행 (Type A)
+ *
+ * thread_node_init() 이후 호출. 콜백이 하는 일에 맞춰 스택/우선순위 지정.
+ */
+esp_err_t thread_node_rx_start_task(uint32_t stack_size, int priority);
+
+/**
+ * @brief 쌓인 수신 메시지를 호출자 컨텍스트에서 처리 (워커 미사용 시, Type B)
+ * @param timeout_ms 링이 비어 있으면 첫 메시지를 기다리는 최대 시간
+ * @return 수신 콜백에 전달한 메시지 수 (워커 동작 중이면 0)
+ */
+int thread_node_rx_poll(uint32_t timeout_ms);
+
+/** @brief 수신 링 카운터 스냅샷 */
+esp_err_t thread_node_get_rx_stats(thread_rx_stats_t *out);
+
 /** @brief SED poll period 설정 (Type B) */
 esp_err_t thread_node_set_poll_period(uint32_t period_ms);
 
 /** @brief Thread 네트워크 연결 상태 */
 bool thread_node_is_connected(void);
 
+/**
+ * @brief 다음 확인형 업링크가 부모 Router 경유인지 (via_parent 설정 + 응답하는 부모)
+ *
+ * 경유 중이면 부모 우편함의 명령이 업링크 ACK에 실려 오므로 수신 창이 필요 없다.
+ */
+bool thread_node_uplink_via_parent(void);
+
 /** @brief Thread 스택 정지 */
 esp_err_t thread_node_stop(void);
 
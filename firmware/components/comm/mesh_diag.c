@@ -0,0 +1,156 @@
+/**
+ * @file mesh_diag.c
+ * @brief Router 메시 진단 수집/보고
+ *
+ * OT 테이블/카운터는 lock 안에서 한 번에 복사하고, 인코딩과 전송은 lock 밖에서 한다.
+ * health 메시지는 TELEMETRY 클래스 NON 전송 (손실 시 다음 주기가 대체, 카운터는 누적값).
+ */
+#include "mesh_diag.h"
+#include "child_relay.h"
+#include "thread_node.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_openthread.h"
+#include "esp_openthread_lock.h"
+#include "openthread/link.h"
+#include "openthread/thread.h"
+#include "openthread/thread_ftd.h"
+#include "openthread/platform/radio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "mesh_diag";
+
+#define DIAG_TASK_STACK  3072
+#define DIAG_TASK_PRIO   1
+
+static mesh_diag_config_t s_cfg;
+static TaskHandle_t s_task = NULL;
+
+/* 링크 마진: OT와 같이 수신 감도를 잡음 기준으로 사용 */
+static uint8_t link_margin(int8_t rssi, int8_t sensitivity)
+{
+    if (rssi == OT_RADIO_RSSI_INVALID || rssi <= sensitivity) return 0;
+    int margin = rssi - sensitivity;
+    return (uint8_t)(margin > UINT8_MAX ? UINT8_MAX : margin);
+}
+
+/* OT lock 보유 상태에서 호출 */
+static void collect_locked(otInstance *instance, mesh_health_t *out)
+{
+    out->role = (uint8_t)otThreadGetDeviceRole(instance);
+
+    const otMleCounters *mle = otThreadGetMleCounters(instance);
+    out->parent_changes = mle->mParentChanges;
+    out->attach_attempts = mle->mAttachAttempts;
+    out->partition_changes = mle->mPartitionIdChanges;
+
+    const otMacCounters *mac = otLinkGetCounters(instance);
+    out->mac_tx_total = mac->mTxTotal;
+    out->mac_tx_retry = mac->mTxRetry;
+    out->mac_tx_err_cca = mac->mTxErrCca;
+    out->mac_tx_fail = mac->mTxDirectMaxRetryExpiry + mac->mTxIndirectMaxRetryExpiry;
+    out->mac_rx_total = mac->mRxTotal;
+    out->mac_rx_err = mac->mRxErrFcs + mac->mRxErrSec + mac->mRxErrOther +
+                      mac->mRxErrInvalidSrcAddr + mac->mRxErrUnknownNeighbor;
+
+    /* 이웃 테이블은 자식과 이웃 Router를 모두 포함 */
+    int8_t sensitivity = otPlatRadioGetReceiveSensitivity(instance);
+    otNeighborInfoIterator it = OT_NEIGHBOR_INFO_ITERATOR_INIT;
+    otNeighborInfo info;
+    while (otThreadGetNextNeighborInfo(instance, &it, &info) == OT_ERROR_NONE) {
+        int8_t rssi = (info.mAverageRssi != OT_RADIO_RSSI_INVALID) ? info.mAverageRssi
+                                                                   : info.mLastRssi;
+        mesh_link_t link = {
+            .rloc16 = info.mRloc16,
+            .rssi = rssi,
+            .margin = link_margin(rssi, sensitivity),
+            .frame_err_pct = (uint8_t)((info.mFrameErrorRate * 100u + 0x7FFF) / 0xFFFF),
+            .child = info.mIsChild,
+        };
+        mesh_health_add_link(out, &link);
+        if (info.mIsChild && out->child_count < UINT8_MAX) out->child_count++;
+    }
+}
+
+esp_err_t mesh_diag_collect(mesh_health_t *out)
+{
+    if (out == NULL) return ESP_ERR_INVALID_ARG;
+
+    otInstance *instance = esp_openthread_get_instance();
+    if (instance == NULL) return ESP_ERR_INVALID_STATE;
+
+    mesh_health_reset(out);
+    out->uptime_s = (uint32_t)(esp_timer_get_time() / 1000000);
+
+    if (!esp_openthread_lock_acquire(pdMS_TO_TICKS(1000))) {
+        return ESP_ERR_TIMEOUT;
+    }
+    collect_locked(instance, out);
+    esp_openthread_lock_release();
+
+    thread_tx_stats_t tx;
+    thread_node_get_tx_stats(&tx);
+    out->con_retransmits = tx.con_retransmits;
+    out->con_timeouts = tx.con_timeouts;
+    out->send_errors = tx.send_errors;
+    for (int c = 0; c < THREAD_TX_CLASS_COUNT; c++) {
+        out->tx_dropped += tx.dropped[c] + tx.overwritten[c];
+    }
+
+    thread_rx_stats_t rx;
+    thread_node_get_rx_stats(&rx);
+    out->rx_dropped = rx.dropped + rx.oversize;
+
+    child_relay_stats_t relay;
+    if (child_relay_get_stats(&relay) == ESP_OK) {  /* 중계 미실행이면 0 */
+        out->relay_failed = relay.send_failed + relay.dropped;
+    }
+    return ESP_OK;
+}
+
+static void diag_task(void *param)
+{
+    static mesh_health_t health;
+    uint8_t buf[THREAD_TX_PAYLOAD_MAX];
+
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(s_cfg.interval_ms));
+        if (!thread_node_is_connected() || mesh_diag_collect(&health) != ESP_OK) {
+            continue;
+        }
+
+        size_t len = 0, links = 0;
+        if (mesh_health_encode(&health, buf, sizeof(buf), &len, &links) != ESP_OK) {
+            continue;
+        }
+        thread_node_send_async(THREAD_TX_TELEMETRY, buf, len);
+
+        if (health.link_count > 0) {
+            const mesh_link_t *worst = &health.links[0];
+            ESP_LOGI(TAG, "Health: %u neighbors (%u children), worst %04x %d dBm "
+                     "margin %u dB, MAC retry %lu/%lu",
+                     health.neighbor_count, health.child_count, worst->rloc16,
+                     worst->rssi, worst->margin, (unsigned long)health.mac_tx_retry,
+                     (unsigned long)health.mac_tx_total);
+        }
+        ESP_LOGD(TAG, "Health message %d bytes, %d/%u links", (int)len, (int)links,
+                 health.neighbor_count);
+    }
+}
+
+esp_err_t mesh_diag_start(const mesh_diag_config_t *cfg)
+{
+    if (cfg == NULL || cfg->interval_ms == 0) return ESP_ERR_INVALID_ARG;
+    if (s_task != NULL) return ESP_ERR_INVALID_STATE;
+
+    s_cfg = *cfg;
+    if (xTaskCreate(diag_task, "mesh_diag", DIAG_TASK_STACK, NULL, DIAG_TASK_PRIO,
+                    &s_task) != pdPASS) {
+        s_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Mesh diagnostics every %lu s", (unsigned long)(cfg->interval_ms / 1000));
+    return ESP_OK;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file mesh_health.c
+ * @brief 메시 진단(health) 메시지 인코딩
+ */
+#include "mesh_health.h"
+#include "cbor_codec.h"
+#include <string.h>
+
+#define CBOR_UINT  (0 << 5)
+#define CBOR_NINT  (1 << 5)
+#define CBOR_ARRAY (4 << 5)
+#define CBOR_MAP   (5 << 5)
+
+#define HEALTH_MAP_FIELDS  7   /* 0, 19, 24~28 */
+
+void mesh_health_reset(mesh_health_t *h)
+{
+    if (h == NULL) return;
+    memset(h, 0, sizeof(*h));
+}
+
+void mesh_health_add_link(mesh_health_t *h, const mesh_link_t *link)
+{
+    if (h == NULL || link == NULL) return;
+    if (h->neighbor_count < UINT8_MAX) h->neighbor_count++;
+
+    /* 삽입 위치: 마진이 같으면 먼저 온 링크 뒤 */
+    uint8_t i = h->link_count;
+    while (i > 0 && h->links[i - 1].margin > link->margin) i--;
+    if (i >= MESH_HEALTH_MAX_LINKS) return;  /* 보관 중인 링크가 모두 더 나쁨 */
+
+    uint8_t n = (h->link_count < MESH_HEALTH_MAX_LINKS) ? h->link_count
+                                                        : MESH_HEALTH_MAX_LINKS - 1;
+    memmove(&h->links[i + 1], &h->links[i], (n - i) * sizeof(h->links[0]));
+    h->links[i] = *link;
+    if (h->link_count < MESH_HEALTH_MAX_LINKS) h->link_count++;
+}
+
+static size_t uint_len(uint32_t val)
+{
+    return (val < 24) ? 1 : (val <= 0xFF) ? 2 : (val <= 0xFFFF) ? 3 : 5;
+}
+
+/* 경계 검사 후 헤더/정수 기록 */
+static bool put_head(uint8_t *buf, size_t buf_size, size_t *pos, uint8_t major, uint32_t val)
+{
+    size_t n = uint_len(val);
+    if (*pos + n > buf_size) return false;
+
+    uint8_t *p = buf + *pos;
+    if (n == 1) {
+        p[0] = major | (uint8_t)val;
+    } else if (n == 2) {
+        p[0] = major | 24;
+        p[1] = (uint8_t)val;
+    } else if (n == 3) {
+        p[0] = major | 25;
+        p[1] = (uint8_t)(val >> 8);
+        p[2] = (uint8_t)val;
+    } else {
+        p[0] = major | 26;
+        p[1] = (uint8_t)(val >> 24);
+        p[2] = (uint8_t)(val >> 16);
+        p[3] = (uint8_t)(val >> 8);
+        p[4] = (uint8_t)val;
+    }
+    *pos += n;
+    return true;
+}
+
+static bool put_int(uint8_t *buf, size_t buf_size, size_t *pos, int32_t val)
+{
+    return (val >= 0) ? put_head(buf, buf_size, pos, CBOR_UINT, (uint32_t)val)
+                      : put_head(buf, buf_size, pos, CBOR_NINT, (uint32_t)(-1 - val));
+}
+
+static bool put_uints(uint8_t *buf, size_t buf_size, size_t *pos, uint8_t key,
+                      const uint32_t *vals, size_t n)
+{
+    bool ok = put_head(buf, buf_size, pos, CBOR_UINT, key);
+    ok = ok && put_head(buf, buf_size, pos, CBOR_ARRAY, (uint32_t)n);
+    for (size_t i = 0; ok && i < n; i++) {
+        ok = put_head(buf, buf_size, pos, CBOR_UINT, vals[i]);
+    }
+    return ok;
+}
+
+esp_err_t mesh_health_encode(const mesh_health_t *h, uint8_t *buf, size_t buf_size,
+                             size_t *out_len, size_t *out_links)
+{
+    if (h == NULL || buf == NULL || out_len == NULL ||
+        h->link_count > MESH_HEALTH_MAX_LINKS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const uint32_t node[] = { h->role, h->uptime_s, h->child_count, h->neighbor_count };
+    const uint32_t mle[] = { h->parent_changes, h->attach_attempts, h->partition_changes };
+    const uint32_t mac[] = { h->mac_tx_total, h->mac_tx_retry, h->mac_tx_err_cca,
+                             h->mac_tx_fail, h->mac_rx_total, h->mac_rx_err };
+    const uint32_t uplink[] = { h->con_retransmits, h->con_timeouts, h->send_errors,
+                                h->tx_dropped, h->rx_dropped, h->relay_failed };
+
+    size_t pos = 0;
+    bool ok = put_head(buf, buf_size, &pos, CBOR_MAP, HEALTH_MAP_FIELDS);
+    ok = ok && put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_MSG_TYPE);
+    ok = ok && put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_MSG_HEALTH);
+    ok = ok && put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_SCHEMA_VERSION);
+    ok = ok && put_head(buf, buf_size, &pos, CBOR_UINT, RBMS_SCHEMA_VERSION);
+    ok = ok && put_uints(buf, buf_size, &pos, CBOR_KEY_HEALTH_NODE, node, 4);
+    ok = ok && put_uints(buf, buf_size, &pos, CBOR_KEY_HEALTH_MLE, mle, 3);
+    ok = ok && put_uints(buf, buf_size, &pos, CBOR_KEY_HEALTH_MAC, mac, 6);
+    ok = ok && put_uints(buf, buf_size, &pos, CBOR_KEY_HEALTH_UPLINK, uplink, 6);
+    ok = ok && put_head(buf, buf_size, &pos, CBOR_UINT, CBOR_KEY_HEALTH_LINKS);
+    if (!ok || pos + 1 > buf_size) return ESP_ERR_NO_MEM;
+    size_t arr_pos = pos++;  /* 링크 수는 MESH_HEALTH_MAX_LINKS(< 24) → 1 byte */
+
+    uint8_t n = 0;
+    while (n < h->link_count) {
+        const mesh_link_t *l = &h->links[n];
+        size_t start = pos;
+        ok = put_head(buf, buf_size, &pos, CBOR_ARRAY, 5);
+        ok = ok && put_head(buf, buf_size, &pos, CBOR_UINT, l->rloc16);
+        ok = ok && put_int(buf, buf_size, &pos, l->rssi);
+        ok = ok && put_head(buf, buf_size, &pos, CBOR_UINT, l->margin);
+        ok = ok && put_head(buf, buf_size, &pos, CBOR_UINT, l->frame_err_pct);
+        ok = ok && put_head(buf, buf_size, &pos, CBOR_UINT, l->child ? 1 : 0);
+        if (!ok) {
+            pos = start;  /* 나머지 링크는 생략 (neighbor_count로 알 수 있음) */
+            break;
+        }
+        n++;
+    }
+
+    buf[arr_pos] = CBOR_ARRAY | n;
+    *out_len = pos;
+    if (out_links != NULL) *out_links = n;
+    return ESP_OK;
+}
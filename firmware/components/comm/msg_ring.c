@@ -0,0 +1,130 @@
+/**
+ * @file msg_ring.c
+ * @brief 고정 크기 lock-free 메시지 링
+ *
+ * 슬롯 seq == pos        : 비어 있음, 생산자가 pos를 차지할 수 있음
+ * 슬롯 seq == pos + 1    : 채워짐, 소비자가 pos를 차지할 수 있음
+ * 소비 후 seq = pos + count (다음 바퀴의 빈 슬롯)
+ *
+ * head/tail CAS로 위치를 먼저 차지한 뒤 복사하고, seq를 release로 게시한다.
+ * claim/publish, acquire/release는 그 두 단계를 나눠 슬롯 버퍼를 직접 쓰게 한다.
+ */
+#include "msg_ring.h"
+#include <string.h>
+
+esp_err_t msg_ring_init(msg_ring_t *r, msg_ring_slot_t *slots, size_t count)
+{
+    if (r == NULL || slots == NULL || count < 2 || (count & (count - 1)) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    r->slots = slots;
+    r->mask = (uint32_t)(count - 1);
+    for (size_t i = 0; i < count; i++) {
+        atomic_init(&slots[i].seq, (unsigned)i);
+    }
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    return ESP_OK;
+}
+
+msg_ring_slot_t *msg_ring_claim(msg_ring_t *r)
+{
+    if (r == NULL) return NULL;
+
+    msg_ring_slot_t *slot;
+    unsigned pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+    for (;;) {
+        slot = &r->slots[pos & r->mask];
+        unsigned seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int dif = (int)(seq - pos);
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&r->head, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                return slot;
+            }
+        } else if (dif < 0) {
+            return NULL;  /* 한 바퀴 전 메시지가 아직 소비되지 않음 */
+        } else {
+            pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+        }
+    }
+}
+
+void msg_ring_publish(msg_ring_t *r, msg_ring_slot_t *slot)
+{
+    (void)r;
+    /* claim 시점 seq == pos (게시 전까지 이 생산자만 접근) */
+    unsigned pos = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+}
+
+msg_ring_slot_t *msg_ring_acquire(msg_ring_t *r)
+{
+    if (r == NULL) return NULL;
+
+    msg_ring_slot_t *slot;
+    unsigned pos = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    for (;;) {
+        slot = &r->slots[pos & r->mask];
+        unsigned seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int dif = (int)(seq - (pos + 1));
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&r->tail, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                return slot;
+            }
+        } else if (dif < 0) {
+            return NULL;  /* 비어 있음 (또는 생산자가 채우는 중) */
+        } else {
+            pos = atomic_load_explicit(&r->tail, memory_order_relaxed);
+        }
+    }
+}
+
+void msg_ring_release(msg_ring_t *r, msg_ring_slot_t *slot)
+{
+    /* acquire 시점 seq == pos + 1 → 다음 바퀴의 빈 슬롯 pos + count */
+    unsigned seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, seq + r->mask, memory_order_release);
+}
+
+esp_err_t msg_ring_push(msg_ring_t *r, uint32_t tag, const uint8_t *data, size_t len)
+{
+    if (r == NULL || (data == NULL && len > 0)) return ESP_ERR_INVALID_ARG;
+    if (len > MSG_RING_PAYLOAD_MAX) return ESP_ERR_INVALID_SIZE;
+
+    msg_ring_slot_t *slot = msg_ring_claim(r);
+    if (slot == NULL) return ESP_ERR_NO_MEM;
+
+    slot->tag = tag;
+    slot->len = (uint16_t)len;
+    if (len > 0) memcpy(slot->data, data, len);
+    msg_ring_publish(r, slot);
+    return ESP_OK;
+}
+
+esp_err_t msg_ring_pop(msg_ring_t *r, uint32_t *tag, uint8_t *data, size_t *len)
+{
+    if (r == NULL) return ESP_ERR_INVALID_ARG;
+
+    msg_ring_slot_t *slot = msg_ring_acquire(r);
+    if (slot == NULL) return ESP_ERR_NOT_FOUND;
+
+    if (tag) *tag = slot->tag;
+    if (len) *len = slot->len;
+    if (data && slot->len > 0) memcpy(data, slot->data, slot->len);
+    msg_ring_release(r, slot);
+    return ESP_OK;
+}
+
+size_t msg_ring_depth(const msg_ring_t *r)
+{
+    if (r == NULL) return 0;
+    unsigned head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    unsigned depth = head - tail;
+    return (depth > r->mask + 1) ? 0 : depth;  /* 읽는 사이 tail이 앞선 경우 */
+}
@@ -0,0 +1,91 @@
+/**
+ * @file thread_frame.c
+ * @brief 업링크 전송 프레임 헤더/중복 제거/재전송 백오프
+ */
+#include "thread_frame.h"
+#include <string.h>
+
+#define HDR_VER_SHIFT   6
+#define HDR_TYPE_SHIFT  4
+#define HDR_RSVD_MASK   0x0F
+
+size_t thread_frame_write_hdr(uint8_t *buf, thread_frame_type_t type, uint16_t mid)
+{
+    buf[0] = (uint8_t)((THREAD_FRAME_VERSION << HDR_VER_SHIFT) |
+                       (((uint8_t)type & 0x03) << HDR_TYPE_SHIFT));
+    buf[1] = (uint8_t)(mid >> 8);
+    buf[2] = (uint8_t)(mid & 0xFF);
+    return THREAD_FRAME_HDR_LEN;
+}
+
+esp_err_t thread_frame_parse(const uint8_t *buf, size_t len, thread_frame_hdr_t *hdr,
+                              const uint8_t **payload, size_t *payload_len)
+{
+    if (buf == NULL || hdr == NULL || payload == NULL || payload_len == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len == 0) return ESP_ERR_INVALID_SIZE;
+
+    uint8_t ver = buf[0] >> HDR_VER_SHIFT;
+    if (ver != THREAD_FRAME_VERSION) {
+        return ESP_ERR_NOT_FOUND;  /* CBOR 맵(0xA0~) 등 헤더 없는 데이터그램 */
+    }
+    if (buf[0] & HDR_RSVD_MASK) return ESP_ERR_NOT_SUPPORTED;
+    if (len < THREAD_FRAME_HDR_LEN) return ESP_ERR_INVALID_SIZE;
+
+    hdr->type = (thread_frame_type_t)((buf[0] >> HDR_TYPE_SHIFT) & 0x03);
+    hdr->mid = (uint16_t)((buf[1] << 8) | buf[2]);
+    *payload = buf + THREAD_FRAME_HDR_LEN;
+    *payload_len = len - THREAD_FRAME_HDR_LEN;
+    return ESP_OK;
+}
+
+bool thread_frame_needs_reply(thread_frame_type_t type, bool multicast)
+{
+    return type == THREAD_FRAME_CON && !multicast;
+}
+
+uint64_t thread_frame_dedup_key(const uint8_t iid[8], uint16_t mid)
+{
+    uint64_t key = 0;
+    for (int i = 2; i < 8; i++) {
+        key = (key << 8) | iid[i];
+    }
+    return (key << 16) | mid;
+}
+
+void thread_frame_dedup_reset(thread_frame_dedup_t *d)
+{
+    if (d == NULL) return;
+    memset(d, 0, sizeof(*d));
+}
+
+bool thread_frame_dedup_contains(const thread_frame_dedup_t *d, uint64_t key)
+{
+    if (d == NULL) return false;
+
+    for (int i = 0; i < d->count; i++) {
+        if (d->key[i] == key) return true;
+    }
+    return false;
+}
+
+bool thread_frame_dedup_check(thread_frame_dedup_t *d, uint64_t key)
+{
+    if (d == NULL) return false;
+    if (thread_frame_dedup_contains(d, key)) return true;
+
+    d->key[d->next] = key;
+    d->next = (uint8_t)((d->next + 1) % THREAD_FRAME_DEDUP_LEN);
+    if (d->count < THREAD_FRAME_DEDUP_LEN) d->count++;
+    return false;
+}
+
+uint32_t thread_frame_backoff_ms(uint32_t base_ms, int attempt, uint32_t rnd)
+{
+    if (attempt < 0) attempt = 0;
+
+    uint64_t t = (uint64_t)base_ms << (attempt > 16 ? 16 : attempt);
+    t += (t * (rnd % 513)) >> 10;  /* +0~50% */
+    return (t > THREAD_FRAME_BACKOFF_MAX_MS) ? THREAD_FRAME_BACKOFF_MAX_MS : (uint32_t)t;
+}
@@ -7,11 +7,27 @@
  *
  * 주의: FreeRTOS 태스크에서 OT API 호출 시
  * esp_openthread_lock_acquire/release 필수.
+ *
+ * 업링크는 thread_frame.h 헤더를 붙여 게이트웨이로 unicast 전송한다.
+ * 게이트웨이 주소는 첫 CON을 ff03::1로 보내 돌아온 ACK의 송신 주소로 학습하고
+ * RTC 메모리에 보관한다 (Deep Sleep 후에도 멀티캐스트 없이 전송).
+ *
+ * 송신 경로: 호출 태스크 → 클래스별 msg_ring (복사, lock-free) → ot_tx 워커가
+ * OT lock 1회에 최대 TX_BURST건 전송. 호출 태스크는 OT lock을 기다리지 않는다.
+ * 수신 경로: OT 콜백 → RX msg_ring 슬롯에 직접 읽기 → ot_rx 워커/poll 호출자가
+ * 슬롯 그대로 사용자 콜백 실행.
+ *
+ * 부모 경유(via_parent): 목적지는 부모 RLOC 주소, 송신 주소는 ML-EID로 고정해
+ * 부모(child_relay)가 게이트웨이와 같은 node_id를 얻게 한다.
  */
 #include "thread_node.h"
 
+#include <stdatomic.h>
 #include <string.h>
+#include "esp_attr.h"
 #include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
 #include "esp_event.h"
 #include "esp_netif.h"
 #include "esp_openthread.h"
@@ -20,25 +36,164 @@
 #include "esp_openthread_netif_glue.h"
 #include "esp_vfs_eventfd.h"
 #include "openthread/instance.h"
+#include "openthread/ip6.h"
 #include "openthread/thread.h"
+#include "openthread/thread_ftd.h"
 #include "openthread/udp.h"
 #include "openthread/dataset.h"
 #include "openthread/dataset_ftd.h"
 #include "openthread/logging.h"
 
 #include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
 
+#include "msg_ring.h"
+#include "thread_frame.h"
+
 static const char *TAG = "thread_node";
 
 static bool s_is_router = false;
 static volatile bool s_connected = false;
+
+/*
+ * 연결 완료 통지 (폴링 대신 이벤트 대기) + 소요 시간 측정.
+ * OT 설정(nvs)에 부모/RLOC16이 남아 있으면 start 시 Child Update만으로
+ * 복귀하고, 없거나 부모가 자식을 지웠으면 full attach로 넘어간다.
+ */
+#define ATTACHED_BIT  BIT0
+#define CHILD_TIMEOUT_DEFAULT_S 300
+static EventGroupHandle_t s_attach_evt = NULL;
+static int64_t s_start_us = 0;
+static volatile uint32_t s_attach_ms = 0;
+static bool s_resume = false;
+static uint32_t s_child_timeout_s = CHILD_TIMEOUT_DEFAULT_S;
 static volatile thread_rx_cb_t s_rx_cb = NULL;
+static volatile thread_ack_payload_cb_t s_ack_payload_cb = NULL;
 static otInstance *s_instance = NULL;
 static otUdpSocket s_socket;
 static esp_netif_t *s_netif = NULL;
 
-#define THREAD_UDP_PORT 5684
+#define THREAD_UDP_PORT   5684
+#define UPLINK_MCAST_ADDR "ff03::1"
+
+static thread_uplink_config_t s_uplink_cfg = {
+    .ack_timeout_ms = THREAD_UPLINK_ACK_TIMEOUT_DEFAULT,
+    .max_retransmit = THREAD_UPLINK_MAX_RETRANSMIT_DEFAULT,
+    .gateway_addr   = NULL,
+};
+
+/* 학습한 게이트웨이 주소 / 다음 mid — Deep Sleep을 걸쳐도 유지 */
+static RTC_DATA_ATTR otIp6Address s_gw_addr;
+static RTC_DATA_ATTR bool s_gw_known = false;
+static RTC_DATA_ATTR uint16_t s_next_mid;
+static RTC_DATA_ATTR bool s_mid_valid = false;
+static bool s_gw_static = false;
+
+/*
+ * 부모 Router 경유 업링크: 부모가 CON에 응답하지 않으면 그 RLOC16을 기억하고
+ * 같은 부모에 붙어 있는 동안(Deep Sleep 포함) 게이트웨이로 직접 보낸다.
+ */
+#define RLOC16_INVALID 0xFFFE
+static volatile uint16_t s_parent_rloc = RLOC16_INVALID;  /* OT 콜백이 역할 변경 시 갱신 */
+static RTC_DATA_ATTR uint16_t s_parent_failed_rloc = RLOC16_INVALID;
+
+/*
+ * CON 채널: 채널마다 1건씩 전송 (NSTART = 1), ACK는 OT 콜백이 ack_sem으로 통지.
+ * 경보는 별도 채널이라 진행 중인 명령 응답/집계 CON을 기다리지 않는다.
+ */
+typedef enum {
+    CON_CHAN_CONTROL = 0,   /* thread_node_send_confirmed() */
+    CON_CHAN_ALARM,         /* thread_node_send_alarm() */
+    CON_CHAN_COUNT,
+} con_chan_id_t;
+
+typedef struct {
+    SemaphoreHandle_t mutex;
+    SemaphoreHandle_t ack_sem;
+    thread_tx_class_t cls;
+    volatile bool pending;
+    volatile bool via_parent;
+    volatile uint16_t mid;
+    volatile esp_err_t result;
+    uint32_t retransmits;   /* mutex 보유 중에만 갱신 */
+    uint32_t timeouts;
+} con_chan_t;
+
+static con_chan_t s_con[CON_CHAN_COUNT] = {
+    [CON_CHAN_CONTROL] = { .cls = THREAD_TX_CONTROL, .result = ESP_ERR_TIMEOUT },
+    [CON_CHAN_ALARM]   = { .cls = THREAD_TX_ALARM, .result = ESP_ERR_TIMEOUT },
+};
+
+/*
+ * NON 업링크 중 주기적 CON 프로브 (블로킹 없음): 게이트웨이 미확인 시 탐색,
+ * 확인된 게이트웨이는 생존 확인. 프로브 ACK가 연속 누락되면 멀티캐스트로 재탐색.
+ */
+#define UPLINK_PROBE_EVERY   16
+#define UPLINK_PROBE_MISSES  2
+static uint16_t s_probe_mid = 0;
+static volatile bool s_probe_outstanding = false;
+static uint8_t s_probe_missed = 0;
+static uint8_t s_since_probe = 0;
+
+/*
+ * 송신 큐: 클래스별 링, 워커는 클래스 번호 순(경보 → 제어 → 리포트)으로 비움.
+ * 태그 = 부모 경유 << 18 | 프레임 타입 << 16 | mid, 목적지 주소는 전송 시점에 결정
+ * (그 사이 학습한 게이트웨이/바뀐 부모 사용)
+ */
+#define TX_RING_LEN   4
+#define TX_BURST      4     /* lock 1회당 최대 전송 수 (OT mainloop 기아 방지) */
+#define TX_TAG(type, parent, mid)  (((uint32_t)(parent) << 18) | ((uint32_t)(type) << 16) | (mid))
+#define TX_TAG_TYPE(tag)   ((thread_frame_type_t)(((tag) >> 16) & 0x03))
+#define TX_TAG_PARENT(tag) ((((tag) >> 18) & 1) != 0)
+#define TX_TAG_MID(tag)    ((uint16_t)((tag) & 0xFFFF))
+
+static msg_ring_slot_t s_tx_slots[THREAD_TX_CLASS_COUNT][TX_RING_LEN];
+static msg_ring_t s_tx_ring[THREAD_TX_CLASS_COUNT];
+static const bool s_tx_overwrite[THREAD_TX_CLASS_COUNT] = {
+    [THREAD_TX_ALARM]     = true,
+    [THREAD_TX_CONTROL]   = false,
+    [THREAD_TX_TELEMETRY] = true,
+};
+static TaskHandle_t s_tx_task = NULL;
+static portMUX_TYPE s_tx_mux = portMUX_INITIALIZER_UNLOCKED;  /* mid/프로브 상태 */
+
+/* 카운터: 생산자 측은 atomic, 워커 측(lock 대기)은 워커만 기록 */
+static atomic_uint s_tx_queued[THREAD_TX_CLASS_COUNT];
+static atomic_uint s_tx_dropped[THREAD_TX_CLASS_COUNT];
+static atomic_uint s_tx_overwritten[THREAD_TX_CLASS_COUNT];
+static atomic_uint s_tx_depth_max;
+static uint32_t s_tx_sent;
+static uint32_t s_tx_errors;
+static uint32_t s_lock_waits;
+static uint32_t s_lock_wait_max_us;
+static uint32_t s_lock_wait_total_us;
+
+/*
+ * 수신 링: OT 콜백이 페이로드를 슬롯에 직접 읽어 게시, 사용자 콜백은
+ * ot_rx 워커 또는 thread_node_rx_poll() 호출자가 실행 (OT mainloop 비점유).
+ * 통계 중 received/dropped/oversize/duplicates/depth_max는 OT 콜백만 기록.
+ * 태그 = 멀티캐스트 목적지 << 16 | 송신자 id (주소 끝 16비트, 핸들러 표시용 —
+ * 중복 제거는 더 긴 s_rx_dedup 키를 쓴다)
+ */
+#define RX_RING_LEN   8
+#define RX_TAG(src, mcast)   (((uint32_t)(mcast) << 16) | (src))
+
+static msg_ring_slot_t s_rx_slots[RX_RING_LEN];
+static msg_ring_t s_rx_ring;
+static bool s_rx_ready = false;
+static TaskHandle_t s_rx_task = NULL;
+static volatile TaskHandle_t s_rx_consumer = NULL;  /* 도착 통지 대상 */
+static uint32_t s_rx_received;
+static uint32_t s_rx_dropped;
+static uint32_t s_rx_oversize;
+static uint32_t s_rx_duplicates;
+static uint16_t s_rx_depth_max;
+static atomic_uint s_rx_delivered;
+
+/* 재전송 중복 제거, 키 = 송신자 IID 하위 48비트 << 16 | mid (OT 콜백 전용) */
+static thread_frame_dedup_t s_rx_dedup;
 
 /* ESP32-C6 네이티브 802.15.4 라디오 설정 */
 static const esp_openthread_platform_config_t s_platform_config = {
@@ -64,29 +219,397 @@ static void thread_state_changed_cb(otChangedFlags flags, void *context)
             case OT_DEVICE_ROLE_LEADER:
             case OT_DEVICE_ROLE_ROUTER:
             case OT_DEVICE_ROLE_CHILD:
+                if (s_attach_ms == 0) {
+                    uint32_t ms = (uint32_t)((esp_timer_get_time() - s_start_us) / 1000);
+                    s_attach_ms = ms ? ms : 1;
+                }
                 s_connected = true;
-                ESP_LOGI(TAG, "Thread attached, role=%d", role);
+                xEventGroupSetBits(s_attach_evt, ATTACHED_BIT);
+                ESP_LOGI(TAG, "Thread attached, role=%d (%lu ms, %s)", role,
+                         (unsigned long)s_attach_ms, s_resume ? "resume" : "attach");
                 break;
             default:
                 s_connected = false;
+                xEventGroupClearBits(s_attach_evt, ATTACHED_BIT);
                 ESP_LOGW(TAG, "Thread detached, role=%d", role);
                 break;
         }
+
+        otRouterInfo parent;
+        s_parent_rloc = (role == OT_DEVICE_ROLE_CHILD &&
+                         otThreadGetParentInfo(s_instance, &parent) == OT_ERROR_NONE)
+                        ? parent.mRloc16 : RLOC16_INVALID;
     }
 }
 
-/* OT 콜백 컨텍스트에서 호출 — lock 불필요 */
+/* 프레임 1건 전송 — 호출자가 OT lock 보유, src NULL이면 OT가 송신 주소 선택 */
+static esp_err_t frame_send_locked(thread_frame_type_t type, uint16_t mid,
+                                   const uint8_t *data, size_t len,
+                                   const otIp6Address *dst, const otIp6Address *src)
+{
+    otMessage *msg = otUdpNewMessage(s_instance, NULL);
+    if (msg == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate UDP message");
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint8_t hdr[THREAD_FRAME_HDR_LEN];
+    thread_frame_write_hdr(hdr, type, mid);
+    if (otMessageAppend(msg, hdr, sizeof(hdr)) != OT_ERROR_NONE ||
+        (len > 0 && otMessageAppend(msg, data, (uint16_t)len) != OT_ERROR_NONE)) {
+        otMessageFree(msg);
+        ESP_LOGE(TAG, "Failed to append UDP message data");
+        return ESP_ERR_NO_MEM;
+    }
+
+    otMessageInfo info;
+    memset(&info, 0, sizeof(info));
+    info.mPeerAddr = *dst;
+    info.mPeerPort = THREAD_UDP_PORT;
+    if (src != NULL) info.mSockAddr = *src;
+
+    otError err = otUdpSend(s_instance, &s_socket, msg, &info);
+    if (err != OT_ERROR_NONE) {
+        ESP_LOGE(TAG, "UDP send failed: %d", err);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+/* 업링크 목적지: 학습/설정된 게이트웨이, 없으면 멀티캐스트 */
+static bool uplink_dest(otIp6Address *dst)
+{
+    if (s_gw_known) {
+        *dst = s_gw_addr;
+        return true;
+    }
+    otIp6AddressFromString(UPLINK_MCAST_ADDR, dst);
+    return false;
+}
+
+/* 부모 Router의 RLOC 주소 (메시 로컬 프리픽스 + 0:ff:fe00:RLOC16) — OT lock 보유 */
+static bool parent_dest(otIp6Address *dst)
+{
+    uint16_t rloc = s_parent_rloc;
+    const otMeshLocalPrefix *prefix = otThreadGetMeshLocalPrefix(s_instance);
+    if (rloc == RLOC16_INVALID || prefix == NULL) return false;
+
+    memset(dst, 0, sizeof(*dst));
+    memcpy(dst->mFields.m8, prefix->m8, OT_MESH_LOCAL_PREFIX_SIZE);
+    dst->mFields.m8[11] = 0xFF;
+    dst->mFields.m8[12] = 0xFE;
+    dst->mFields.m8[14] = (uint8_t)(rloc >> 8);
+    dst->mFields.m8[15] = (uint8_t)(rloc & 0xFF);
+    return true;
+}
+
+/* 부모 경유 여부 — 미연결/Router 역할/응답 없던 부모면 게이트웨이 직접 */
+static bool uplink_via_parent(void)
+{
+    uint16_t rloc = s_parent_rloc;
+    return s_uplink_cfg.via_parent && rloc != RLOC16_INVALID && rloc != s_parent_failed_rloc;
+}
+
+/* s_tx_mux 보유 상태에서 호출 */
+static uint16_t next_mid(void)
+{
+    if (!s_mid_valid) {
+        s_next_mid = (uint16_t)esp_random();  /* 콜드 부트: 게이트웨이 중복 캐시와 충돌 방지 */
+        s_mid_valid = true;
+    }
+    return s_next_mid++;
+}
+
+/* OT 콜백 컨텍스트 — ACK 송신 주소를 게이트웨이로 학습 */
+static void learn_gateway(const otIp6Address *addr)
+{
+    if (s_gw_static) return;
+    if (s_gw_known && otIp6IsAddressEqual(&s_gw_addr, addr)) return;
+
+    s_gw_addr = *addr;
+    s_gw_known = true;
+
+    char str[OT_IP6_ADDRESS_STRING_SIZE];
+    otIp6AddressToString(addr, str, sizeof(str));
+    ESP_LOGI(TAG, "Gateway learned: %s", str);
+}
+
+/* OT 콜백 컨텍스트 — 업링크 CON/프로브의 ACK/RST 처리 */
+static void uplink_ack_rx(const thread_frame_hdr_t *hdr, const otMessageInfo *info)
+{
+    if (s_probe_outstanding && hdr->mid == s_probe_mid) {
+        if (hdr->type == THREAD_FRAME_ACK) {
+            learn_gateway(&info->mPeerAddr);
+        }
+        s_probe_outstanding = false;
+        return;
+    }
+    for (int i = 0; i < CON_CHAN_COUNT; i++) {
+        con_chan_t *ch = &s_con[i];
+        if (!ch->pending || hdr->mid != ch->mid) continue;
+        if (hdr->type == THREAD_FRAME_ACK && !ch->via_parent) {
+            learn_gateway(&info->mPeerAddr);
+        }
+        ch->result = (hdr->type == THREAD_FRAME_ACK) ? ESP_OK : ESP_FAIL;
+        ch->pending = false;
+        xSemaphoreGive(ch->ack_sem);
+        return;
+    }
+}
+
+/* OT 콜백 컨텍스트 — 이 mid의 업링크 CON이 ACK를 기다리는지 */
+static bool con_waiting(uint16_t mid)
+{
+    for (int i = 0; i < CON_CHAN_COUNT; i++) {
+        if (s_con[i].pending && s_con[i].mid == mid) return true;
+    }
+    return false;
+}
+
+/*
+ * peer가 이 Router의 자식인지 — 자식이 등록한 주소(ML-EID 등)와 비교 (OT lock 보유).
+ * 자식은 ML-EID로 보내므로 src_id(주소 끝 16비트)는 RLOC16이 아니다.
+ */
+static bool peer_is_child_locked(const otIp6Address *peer)
+{
+    if (!s_is_router) return false;
+    uint16_t max = otThreadGetMaxAllowedChildren(s_instance);
+    for (uint16_t i = 0; i < max; i++) {
+        otChildInfo info;
+        if (otThreadGetChildInfoByIndex(s_instance, i, &info) != OT_ERROR_NONE) continue;
+        otChildIp6AddressIterator it = OT_CHILD_IP6_ADDRESS_ITERATOR_INIT;
+        otIp6Address addr;
+        while (otThreadGetChildNextIp6Address(s_instance, i, &it, &addr) == OT_ERROR_NONE) {
+            if (otIp6IsAddressEqual(&addr, peer)) return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * CON ACK — 자식이 보낸 CON이면 피기백 제공자의 응답을 함께 실음 (data NULL = 재전송 ACK).
+ * 게이트웨이 명령/다른 노드의 CON에는 빈 ACK (시각 비콘·우편함 만료를 엉뚱한 src_id로 돌리지 않음).
+ */
+static void con_ack_locked(uint16_t mid, const otIp6Address *peer, uint16_t src_id,
+                           const uint8_t *data, size_t len)
+{
+    uint8_t piggy[THREAD_ACK_PAYLOAD_MAX];
+    size_t piggy_len = 0;
+    thread_ack_payload_cb_t cb = s_ack_payload_cb;
+    if (cb != NULL && peer_is_child_locked(peer)) {
+        piggy_len = cb(src_id, data, len, piggy, sizeof(piggy));
+    }
+    frame_send_locked(THREAD_FRAME_ACK, mid, piggy, piggy_len, peer, NULL);
+}
+
+/* RX 슬롯을 잡아 페이로드를 읽음 (게시는 rx_publish) — 슬롯이 없으면 NULL */
+static msg_ring_slot_t *rx_read(const otMessage *message, uint16_t offset, uint16_t len,
+                                uint16_t src_id, bool mcast)
+{
+    msg_ring_slot_t *slot = msg_ring_claim(&s_rx_ring);
+    if (slot == NULL) {
+        s_rx_dropped++;
+        return NULL;
+    }
+    slot->len = otMessageRead(message, offset, slot->data, len);
+    slot->tag = RX_TAG(src_id, mcast);
+    return slot;
+}
+
+static void rx_publish(msg_ring_slot_t *slot)
+{
+    msg_ring_publish(&s_rx_ring, slot);
+
+    uint16_t depth = (uint16_t)msg_ring_depth(&s_rx_ring);
+    if (depth > s_rx_depth_max) s_rx_depth_max = depth;
+    TaskHandle_t consumer = s_rx_consumer;
+    if (consumer) xTaskNotifyGive(consumer);
+}
+
+/*
+ * OT 콜백 컨텍스트에서 호출 — lock 보유 상태.
+ * 헤더만 스택에 읽고 페이로드는 RX 슬롯에 직접 읽어 게시한다 (사용자 콜백은 rx_drain).
+ */
 static void udp_receive_cb(void *context, otMessage *message,
                             const otMessageInfo *message_info)
 {
-    uint16_t len = otMessageGetLength(message) - otMessageGetOffset(message);
-    if (len > 512) len = 512;
+    uint16_t offset = otMessageGetOffset(message);
+    uint16_t len = otMessageGetLength(message) - offset;
+    const otIp6Address *peer = &message_info->mPeerAddr;
+    uint16_t src_id = (uint16_t)((peer->mFields.m8[14] << 8) | peer->mFields.m8[15]);
+    bool mcast = (message_info->mSockAddr.mFields.m8[0] == 0xFF);
+    s_rx_received++;
+
+    uint8_t raw[THREAD_FRAME_HDR_LEN];
+    uint16_t raw_len = otMessageRead(message, offset, raw, sizeof(raw));
+
+    thread_frame_hdr_t hdr;
+    const uint8_t *payload;
+    size_t payload_len;
+    uint16_t skip = THREAD_FRAME_HDR_LEN;
+    esp_err_t err = thread_frame_parse(raw, raw_len, &hdr, &payload, &payload_len);
+    if (err == ESP_ERR_NOT_FOUND) {
+        skip = 0;  /* 헤더 없는 기존 CBOR 데이터그램 */
+        hdr.type = THREAD_FRAME_NON;
+    } else if (err != ESP_OK) {
+        return;
+    } else if (hdr.type == THREAD_FRAME_ACK || hdr.type == THREAD_FRAME_RST) {
+        /* 피기백 응답(부모 우편함 명령)은 ACK 통지 전에 게시 → 송신자가 깨면 이미 링에 있음 */
+        uint16_t piggy_len = len - skip;
+        if (hdr.type == THREAD_FRAME_ACK && piggy_len > 0 && piggy_len <= MSG_RING_PAYLOAD_MAX &&
+            con_waiting(hdr.mid)) {
+            msg_ring_slot_t *slot = rx_read(message, offset + skip, piggy_len, src_id, mcast);
+            if (slot) rx_publish(slot);
+        }
+        uplink_ack_rx(&hdr, message_info);
+        return;
+    }
+    /*
+     * 멀티캐스트 CON(게이트웨이 탐색·프로브)에는 ACK/RST하지 않고 전달만 한다.
+     * 다른 노드가 응답하면 송신자가 그 노드를 게이트웨이로 학습해 업링크를 잃는다.
+     */
+    bool reply = thread_frame_needs_reply(hdr.type, mcast);
+    uint64_t key = thread_frame_dedup_key(&peer->mFields.m8[8], hdr.mid);
+    len -= skip;
+
+    if (len > MSG_RING_PAYLOAD_MAX) {
+        s_rx_oversize++;
+        if (reply) frame_send_locked(THREAD_FRAME_RST, hdr.mid, NULL, 0, peer, NULL);
+        return;
+    }
+    if (skip > 0 && thread_frame_dedup_contains(&s_rx_dedup, key)) {
+        /* 이미 받은 메시지: ACK만 다시 보냄 (이전 ACK 손실) */
+        s_rx_duplicates++;
+        if (reply) con_ack_locked(hdr.mid, peer, src_id, NULL, 0);
+        return;
+    }
+    if (len == 0) {
+        if (reply) frame_send_locked(THREAD_FRAME_ACK, hdr.mid, NULL, 0, peer, NULL);
+        return;
+    }
+
+    /* 슬롯이 없으면 CON도 ACK하지 않음 → 송신 측 재전송이 백프레셔 역할 */
+    msg_ring_slot_t *slot = rx_read(message, offset + skip, len, src_id, mcast);
+    if (slot == NULL) return;
+    if (skip > 0) thread_frame_dedup_check(&s_rx_dedup, key);  /* mid 기록 */
+    if (reply) con_ack_locked(hdr.mid, peer, src_id, slot->data, slot->len);
+    rx_publish(slot);
+}
+
+/* 게시된 RX 슬롯을 복사 없이 사용자 콜백에 넘김 (ot_rx 워커 또는 poll 호출자) */
+static int rx_drain(void)
+{
+    int delivered = 0;
+    msg_ring_slot_t *slot;
+    while ((slot = msg_ring_acquire(&s_rx_ring)) != NULL) {
+        thread_rx_cb_t cb = s_rx_cb;
+        thread_rx_meta_t meta = {
+            .src_id    = (uint16_t)(slot->tag & 0xFFFF),
+            .multicast = (slot->tag >> 16) != 0,
+        };
+        if (cb) cb(slot->data, slot->len, &meta);
+        msg_ring_release(&s_rx_ring, slot);
+        delivered++;
+    }
+    atomic_fetch_add(&s_rx_delivered, (unsigned)delivered);
+    return delivered;
+}
+
+static void rx_task(void *param)
+{
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        rx_drain();
+    }
+}
+
+static size_t tx_depth(void)
+{
+    size_t depth = 0;
+    for (int c = 0; c < THREAD_TX_CLASS_COUNT; c++) {
+        depth += msg_ring_depth(&s_tx_ring[c]);
+    }
+    return depth;
+}
+
+/* 클래스 큐에 복사 후 워커 깨움 — 블로킹 없음 */
+static esp_err_t tx_enqueue(thread_tx_class_t cls, thread_frame_type_t type, bool via_parent,
+                            uint16_t mid, const uint8_t *data, size_t len)
+{
+    msg_ring_t *r = &s_tx_ring[cls];
+    uint32_t tag = TX_TAG(type, via_parent, mid);
+
+    esp_err_t ret = msg_ring_push(r, tag, data, len);
+    if (ret == ESP_ERR_NO_MEM && s_tx_overwrite[cls] &&
+        msg_ring_pop(r, NULL, NULL, NULL) == ESP_OK) {
+        atomic_fetch_add(&s_tx_overwritten[cls], 1);
+        ret = msg_ring_push(r, tag, data, len);
+    }
+    if (ret != ESP_OK) {
+        atomic_fetch_add(&s_tx_dropped[cls], 1);
+        return ret;
+    }
+    atomic_fetch_add(&s_tx_queued[cls], 1);
+
+    unsigned depth = (unsigned)tx_depth();
+    unsigned prev = atomic_load(&s_tx_depth_max);
+    while (depth > prev && !atomic_compare_exchange_weak(&s_tx_depth_max, &prev, depth)) {
+    }
+
+    TaskHandle_t task = s_tx_task;
+    if (task) xTaskNotifyGive(task);
+    return ESP_OK;
+}
+
+/* 우선순위(클래스 번호) 순으로 1건 꺼냄 */
+static bool tx_pop(uint32_t *tag, uint8_t *buf, size_t *len)
+{
+    for (int c = 0; c < THREAD_TX_CLASS_COUNT; c++) {
+        if (msg_ring_pop(&s_tx_ring[c], tag, buf, len) == ESP_OK) return true;
+    }
+    return false;
+}
+
+/* 송신 워커 — OT lock은 이 태스크만 잡는다 */
+static void tx_task(void *param)
+{
+    static uint8_t buf[THREAD_TX_PAYLOAD_MAX];
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
 
-    uint8_t buf[512];
-    otMessageRead(message, otMessageGetOffset(message), buf, len);
+        int sent;
+        do {
+            int64_t t0 = esp_timer_get_time();
+            esp_openthread_lock_acquire(portMAX_DELAY);
+            uint32_t waited = (uint32_t)(esp_timer_get_time() - t0);
+            s_lock_waits++;
+            s_lock_wait_total_us += waited;
+            if (waited > s_lock_wait_max_us) s_lock_wait_max_us = waited;
 
-    if (s_rx_cb) {
-        s_rx_cb(buf, len);
+            for (sent = 0; sent < TX_BURST; sent++) {
+                uint32_t tag;
+                size_t len;
+                if (!tx_pop(&tag, buf, &len)) break;
+
+                /* 부모 경유는 ML-EID로 보내 부모가 게이트웨이와 같은 node_id를 얻게 함 */
+                otIp6Address dst;
+                const otIp6Address *src = NULL;
+                if (TX_TAG_PARENT(tag) && parent_dest(&dst)) {
+                    src = otThreadGetMeshLocalEid(s_instance);
+                } else {
+                    uplink_dest(&dst);
+                }
+                if (frame_send_locked(TX_TAG_TYPE(tag), TX_TAG_MID(tag), buf, len,
+                                      &dst, src) == ESP_OK) {
+                    s_tx_sent++;
+                } else {
+                    s_tx_errors++;
+                }
+            }
+            esp_openthread_lock_release();
+            /* 복사 중인 슬롯은 생산자가 게시 후 다시 깨우므로 빈 burst면 대기로 */
+        } while (sent == TX_BURST);
     }
 }
 
@@ -125,6 +648,24 @@ esp_err_t thread_node_init(bool is_router)
 
     s_instance = esp_openthread_get_instance();
 
+    if (s_attach_evt == NULL) {
+        s_attach_evt = xEventGroupCreate();
+        for (int i = 0; i < CON_CHAN_COUNT; i++) {
+            s_con[i].mutex = xSemaphoreCreateMutex();
+            s_con[i].ack_sem = xSemaphoreCreateBinary();
+            if (s_con[i].mutex == NULL || s_con[i].ack_sem == NULL) return ESP_ERR_NO_MEM;
+        }
+        if (s_attach_evt == NULL) return ESP_ERR_NO_MEM;
+    }
+    thread_frame_dedup_reset(&s_rx_dedup);
+    if (!s_rx_ready) {
+        msg_ring_init(&s_rx_ring, s_rx_slots, RX_RING_LEN);
+        s_rx_ready = true;
+    }
+    for (int c = 0; c < THREAD_TX_CLASS_COUNT; c++) {
+        msg_ring_init(&s_tx_ring[c], s_tx_slots[c], TX_RING_LEN);
+    }
+
     /* OpenThread netif 바인딩 */
     esp_netif_config_t netif_cfg = ESP_NETIF_DEFAULT_OPENTHREAD();
     s_netif = esp_netif_new(&netif_cfg);
@@ -156,63 +697,219 @@ esp_err_t thread_node_start(void)
         otDatasetSetActive(s_instance, &dataset);
     }
 
-    otThreadSetEnabled(s_instance, true);
-
+    /* 모드/타임아웃을 enable 전에 설정 — enable 후 변경하면 Child Update가 한 번 더 오감 */
     if (!s_is_router) {
         otLinkModeConfig mode = {0};
         mode.mRxOnWhenIdle = false;
         mode.mNetworkData = false;
         otThreadSetLinkMode(s_instance, mode);
 
-        /* Child timeout: 라우터가 이 시간 내 응답 없으면 자식 제거 */
-        otThreadSetChildTimeout(s_instance, 300);  /* 5분 (최대 sleep 간격 이상) */
+        /* Child timeout: 부모가 이 시간 동안 poll을 못 받으면 자식 제거 → 다음 wake는 full attach */
+        otThreadSetChildTimeout(s_instance, s_child_timeout_s);
     }
 
+    s_attach_ms = 0;
+    s_connected = false;
+    xEventGroupClearBits(s_attach_evt, ATTACHED_BIT);
+    s_start_us = esp_timer_get_time();
+    otThreadSetEnabled(s_instance, true);
+    /* 설정에서 RLOC16이 복원됐으면 부모에게 Child Update만 보냄 (fast resume) */
+    s_resume = (otThreadGetRloc16(s_instance) != 0xFFFE);
+
     /* 메인 루프 태스크 시작 — 이후부터 외부 호출은 lock 필수 */
     xTaskCreate(thread_main_task, "ot_main", 6144, NULL, 5, NULL);
+    xTaskCreate(tx_task, "ot_tx", 3072, NULL, 5, &s_tx_task);
+    xTaskNotifyGive(s_tx_task);  /* 시작 전 예약된 메시지 전송 */
 
     ESP_LOGI(TAG, "Thread started");
     return ESP_OK;
 }
 
+esp_err_t thread_node_config_uplink(const thread_uplink_config_t *cfg)
+{
+    if (cfg == NULL) return ESP_ERR_INVALID_ARG;
+
+    s_uplink_cfg = *cfg;
+    s_gw_static = false;
+    if (cfg->gateway_addr != NULL && cfg->gateway_addr[0] != '\0') {
+        otIp6Address addr;
+        if (otIp6AddressFromString(cfg->gateway_addr, &addr) != OT_ERROR_NONE) {
+            ESP_LOGE(TAG, "Invalid gateway address: %s", cfg->gateway_addr);
+            return ESP_ERR_INVALID_ARG;
+        }
+        s_gw_addr = addr;
+        s_gw_known = true;
+        s_gw_static = true;
+    }
+    return ESP_OK;
+}
+
+esp_err_t thread_node_send_async(thread_tx_class_t cls, const uint8_t *data, size_t len)
+{
+    if (s_instance == NULL || data == NULL || cls >= THREAD_TX_CLASS_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len > THREAD_TX_PAYLOAD_MAX) return ESP_ERR_INVALID_SIZE;
+
+    /* 이전 프로브 ACK 누락 집계 → 연속 누락 시 게이트웨이 재탐색 (부모 경유 시 불필요) */
+    bool parent = uplink_via_parent();
+    bool rediscover = false;
+    taskENTER_CRITICAL(&s_tx_mux);
+    bool probe = !parent && (!s_gw_known || ++s_since_probe >= UPLINK_PROBE_EVERY);
+    if (probe) {
+        if (s_probe_outstanding && s_gw_known && !s_gw_static &&
+            ++s_probe_missed >= UPLINK_PROBE_MISSES) {
+            s_gw_known = false;
+            rediscover = true;
+        }
+        if (!s_probe_outstanding) s_probe_missed = 0;
+        s_since_probe = 0;
+    }
+    uint16_t mid = next_mid();
+    if (probe) {
+        s_probe_mid = mid;
+        s_probe_outstanding = true;
+    }
+    taskEXIT_CRITICAL(&s_tx_mux);
+
+    if (rediscover) {
+        ESP_LOGW(TAG, "Gateway probe unanswered, rediscovering via multicast");
+    }
+    esp_err_t ret = tx_enqueue(cls, probe ? THREAD_FRAME_CON : THREAD_FRAME_NON, parent, mid,
+                               data, len);
+    if (ret != ESP_OK) {
+        ESP_LOGD(TAG, "TX queue %d full, %d bytes dropped", (int)cls, (int)len);
+    }
+    return ret;
+}
+
 esp_err_t thread_node_send(const uint8_t *data, size_t len)
 {
-    if (s_instance == NULL || data == NULL) return ESP_ERR_INVALID_ARG;
+    return thread_node_send_async(THREAD_TX_TELEMETRY, data, len);
+}
 
-    /* 외부 태스크에서 호출 — lock 필수 */
-    if (!esp_openthread_lock_acquire(pdMS_TO_TICKS(1000))) {
-        ESP_LOGW(TAG, "Failed to acquire OT lock for send");
-        return ESP_ERR_TIMEOUT;
+/* CON 1건 교환 (ch->mutex 보유) — ACK/RST 수신 또는 재전송 소진까지 블로킹 */
+static esp_err_t con_exchange(con_chan_t *ch, uint16_t mid, bool via_parent,
+                              const uint8_t *data, size_t len, int *tries)
+{
+    xSemaphoreTake(ch->ack_sem, 0);  /* 이전 CON의 늦은 ACK 통지 제거 */
+    ch->result = ESP_ERR_TIMEOUT;
+    ch->mid = mid;
+    ch->via_parent = via_parent;
+    ch->pending = true;
+
+    esp_err_t ret = ESP_ERR_TIMEOUT;
+    int attempt;
+    for (attempt = 0; attempt <= s_uplink_cfg.max_retransmit; attempt++) {
+        if (attempt > 0) {
+            ch->retransmits++;
+            ESP_LOGD(TAG, "Retransmit mid %u (#%d)", (unsigned)mid, attempt);
+        }
+        /* 큐가 가득 차도 손실과 같이 취급, 백오프 후 재시도 */
+        tx_enqueue(ch->cls, THREAD_FRAME_CON, via_parent, mid, data, len);
+
+        uint32_t wait = thread_frame_backoff_ms(s_uplink_cfg.ack_timeout_ms, attempt,
+                                                esp_random());
+        if (xSemaphoreTake(ch->ack_sem, pdMS_TO_TICKS(wait)) == pdTRUE) {
+            ret = ch->result;
+            break;
+        }
     }
+    ch->pending = false;
+    if (ret == ESP_ERR_TIMEOUT) ch->timeouts++;
+    *tries = attempt + 1;
+    return ret;
+}
 
-    otMessage *msg = otUdpNewMessage(s_instance, NULL);
-    if (msg == NULL) {
-        esp_openthread_lock_release();
-        ESP_LOGE(TAG, "Failed to allocate UDP message");
-        return ESP_ERR_NO_MEM;
+esp_err_t thread_node_send_confirmed(const uint8_t *data, size_t len)
+{
+    con_chan_t *ch = &s_con[CON_CHAN_CONTROL];
+    if (s_instance == NULL || data == NULL || ch->mutex == NULL) return ESP_ERR_INVALID_ARG;
+    if (len > THREAD_TX_PAYLOAD_MAX) return ESP_ERR_INVALID_SIZE;
+
+    xSemaphoreTake(ch->mutex, portMAX_DELAY);
+
+    bool parent = uplink_via_parent();
+    uint16_t parent_rloc = s_parent_rloc;
+    bool unicast = s_gw_known;
+    taskENTER_CRITICAL(&s_tx_mux);
+    uint16_t mid = next_mid();
+    taskEXIT_CRITICAL(&s_tx_mux);
+
+    int tries;
+    esp_err_t ret = con_exchange(ch, mid, parent, data, len, &tries);
+    if (parent && ret == ESP_ERR_TIMEOUT) {
+        /* 중계하지 않는 부모 (child_relay 미실행/비 RBMS Router) → 이 부모 동안 직접 전송 */
+        s_parent_failed_rloc = parent_rloc;
+        ESP_LOGW(TAG, "Parent 0x%04x not relaying, sending to gateway", parent_rloc);
+        parent = false;
+        unicast = s_gw_known;
+        ret = con_exchange(ch, mid, false, data, len, &tries);
     }
 
-    if (otMessageAppend(msg, data, (uint16_t)len) != OT_ERROR_NONE) {
-        otMessageFree(msg);
-        esp_openthread_lock_release();
-        ESP_LOGE(TAG, "Failed to append UDP message data");
-        return ESP_ERR_NO_MEM;
+    if (ret == ESP_OK) {
+        ESP_LOGD(TAG, "Sent %d bytes (CON mid %u, %d tries%s)", (int)len, (unsigned)mid,
+                 tries, parent ? ", via parent" : "");
+    } else if (ret == ESP_FAIL) {
+        ESP_LOGW(TAG, "Uplink mid %u rejected (RST)", (unsigned)mid);
+    } else {
+        ESP_LOGW(TAG, "Uplink mid %u not acknowledged", (unsigned)mid);
+        if (unicast && !s_gw_static) {
+            s_gw_known = false;  /* 다음 전송은 멀티캐스트로 재탐색 */
+            ESP_LOGW(TAG, "Gateway unreachable, rediscovering via multicast");
+        }
     }
 
-    otMessageInfo info;
-    memset(&info, 0, sizeof(info));
-    otIp6AddressFromString("ff03::1", &info.mPeerAddr);
-    info.mPeerPort = THREAD_UDP_PORT;
+    xSemaphoreGive(ch->mutex);
+    return ret;
+}
 
-    otError err = otUdpSend(s_instance, &s_socket, msg, &info);
-    esp_openthread_lock_release();
+esp_err_t thread_node_send_alarm(const uint8_t *data, size_t len)
+{
+    con_chan_t *ch = &s_con[CON_CHAN_ALARM];
+    if (s_instance == NULL || data == NULL || ch->mutex == NULL) return ESP_ERR_INVALID_ARG;
+    if (len > THREAD_TX_PAYLOAD_MAX) return ESP_ERR_INVALID_SIZE;
 
-    if (err != OT_ERROR_NONE) {
-        ESP_LOGE(TAG, "UDP send failed: %d", err);
-        return ESP_FAIL;
+    xSemaphoreTake(ch->mutex, portMAX_DELAY);
+    bool unicast = s_gw_known;
+    taskENTER_CRITICAL(&s_tx_mux);
+    uint16_t mid = next_mid();
+    taskEXIT_CRITICAL(&s_tx_mux);
+
+    /* 부모 중계 창을 거치지 않도록 항상 게이트웨이로 직접 */
+    int tries;
+    esp_err_t ret = con_exchange(ch, mid, false, data, len, &tries);
+    if (ret == ESP_OK) {
+        ESP_LOGD(TAG, "Alarm sent (CON mid %u, %d tries)", (unsigned)mid, tries);
+    } else if (ret == ESP_ERR_TIMEOUT && unicast && !s_gw_static) {
+        s_gw_known = false;  /* 다음 전송은 멀티캐스트로 재탐색 */
+        ESP_LOGW(TAG, "Alarm mid %u not acknowledged, rediscovering gateway", (unsigned)mid);
     }
+    xSemaphoreGive(ch->mutex);
+    return ret;
+}
 
-    ESP_LOGD(TAG, "Sent %d bytes via Thread UDP", (int)len);
+esp_err_t thread_node_get_tx_stats(thread_tx_stats_t *out)
+{
+    if (out == NULL) return ESP_ERR_INVALID_ARG;
+
+    memset(out, 0, sizeof(*out));
+    for (int c = 0; c < THREAD_TX_CLASS_COUNT; c++) {
+        out->queued[c] = atomic_load(&s_tx_queued[c]);
+        out->dropped[c] = atomic_load(&s_tx_dropped[c]);
+        out->overwritten[c] = atomic_load(&s_tx_overwritten[c]);
+    }
+    out->sent = s_tx_sent;
+    out->send_errors = s_tx_errors;
+    for (int i = 0; i < CON_CHAN_COUNT; i++) {
+        out->con_retransmits += s_con[i].retransmits;
+        out->con_timeouts += s_con[i].timeouts;
+    }
+    out->depth = (uint16_t)tx_depth();
+    out->depth_max = (uint16_t)atomic_load(&s_tx_depth_max);
+    out->lock_waits = s_lock_waits;
+    out->lock_wait_max_us = s_lock_wait_max_us;
+    out->lock_wait_total_us = s_lock_wait_total_us;
     return ESP_OK;
 }
 
@@ -222,6 +919,57 @@ esp_err_t thread_node_set_rx_callback(thread_rx_cb_t cb)
     return ESP_OK;
 }
 
+esp_err_t thread_node_set_ack_payload_cb(thread_ack_payload_cb_t cb)
+{
+    s_ack_payload_cb = cb;
+    return ESP_OK;
+}
+
+esp_err_t thread_node_rx_start_task(uint32_t stack_size, int priority)
+{
+    if (!s_rx_ready) return ESP_ERR_INVALID_STATE;
+    if (s_rx_task != NULL) return ESP_OK;
+
+    if (xTaskCreate(rx_task, "ot_rx", stack_size, NULL, priority, &s_rx_task) != pdPASS) {
+        s_rx_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    s_rx_consumer = s_rx_task;
+    xTaskNotifyGive(s_rx_task);  /* 시작 전 게시된 메시지 처리 */
+    return ESP_OK;
+}
+
+int thread_node_rx_poll(uint32_t timeout_ms)
+{
+    if (!s_rx_ready || s_rx_task != NULL) return 0;  /* 워커가 소비 중 */
+
+    s_rx_consumer = xTaskGetCurrentTaskHandle();
+    int delivered = rx_drain();
+    TickType_t start = xTaskGetTickCount();
+    TickType_t wait = pdMS_TO_TICKS(timeout_ms);
+    while (delivered == 0) {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed >= wait || ulTaskNotifyTake(pdTRUE, wait - elapsed) == 0) break;
+        delivered = rx_drain();  /* 이미 비운 메시지의 통지면 0 → 남은 시간 대기 */
+    }
+    s_rx_consumer = NULL;
+    return delivered;
+}
+
+esp_err_t thread_node_get_rx_stats(thread_rx_stats_t *out)
+{
+    if (out == NULL) return ESP_ERR_INVALID_ARG;
+
+    out->received = s_rx_received;
+    out->delivered = atomic_load(&s_rx_delivered);
+    out->dropped = s_rx_dropped;
+    out->oversize = s_rx_oversize;
+    out->duplicates = s_rx_duplicates;
+    out->depth = (uint16_t)msg_ring_depth(&s_rx_ring);
+    out->depth_max = s_rx_depth_max;
+    return ESP_OK;
+}
+
 esp_err_t thread_node_set_poll_period(uint32_t period_ms)
 {
     if (s_instance == NULL) return ESP_ERR_INVALID_STATE;
@@ -236,11 +984,40 @@ esp_err_t thread_node_set_poll_period(uint32_t period_ms)
     return ESP_OK;
 }
 
+esp_err_t thread_node_config_sed(uint32_t child_timeout_s)
+{
+    if (child_timeout_s == 0) return ESP_ERR_INVALID_ARG;
+    s_child_timeout_s = child_timeout_s;
+    return ESP_OK;
+}
+
+esp_err_t thread_node_wait_attached(uint32_t timeout_ms)
+{
+    if (s_attach_evt == NULL) return ESP_ERR_INVALID_STATE;
+
+    EventBits_t bits = xEventGroupWaitBits(s_attach_evt, ATTACHED_BIT, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeout_ms));
+    return (bits & ATTACHED_BIT) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+esp_err_t thread_node_get_attach_info(thread_attach_info_t *out)
+{
+    if (out == NULL) return ESP_ERR_INVALID_ARG;
+    out->attach_ms = s_attach_ms;
+    out->resumed = s_resume;
+    return ESP_OK;
+}
+
 bool thread_node_is_connected(void)
 {
     return s_connected;
 }
 
+bool thread_node_uplink_via_parent(void)
+{
+    return uplink_via_parent();
+}
+
 esp_err_t thread_node_stop(void)
 {
     if (s_instance == NULL) return ESP_OK;
@@ -248,6 +1025,16 @@ esp_err_t thread_node_stop(void)
     if (!esp_openthread_lock_acquire(pdMS_TO_TICKS(1000))) {
         return ESP_ERR_TIMEOUT;
     }
+    /* 워커는 lock을 잡지 않은 상태 (대기 중이어도 삭제 가능) */
+    if (s_tx_task) {
+        vTaskDelete(s_tx_task);
+        s_tx_task = NULL;
+    }
+    if (s_rx_task) {
+        vTaskDelete(s_rx_task);  /* 콜백 실행 중이면 그 명령은 미완료 (재전송으로 복구) */
+        s_rx_task = NULL;
+        s_rx_consumer = NULL;
+    }
     otThreadSetEnabled(s_instance, false);
     otUdpClose(s_instance, &s_socket);
     esp_openthread_lock_release();
@@ -255,6 +1042,7 @@ esp_err_t thread_node_stop(void)
     esp_openthread_deinit();
     s_instance = NULL;
     s_connected = false;
+    xEventGroupClearBits(s_attach_evt, ATTACHED_BIT);
     ESP_LOGI(TAG, "Thread stopped");
     return ESP_OK;
 }
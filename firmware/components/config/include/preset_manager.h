@@ -6,11 +6,24 @@
 #define RBMS_PRESET_MANAGER_H
 
 #include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define PRESET_SEASONS_MAX   6
+#define PRESET_NIGHT_DROP_MAX 15.0f  /* °C */
+
+/* 계절 구간 — 시작일부터 다음 구간 시작 전까지 */
+typedef struct {
+    uint8_t month, day;              /* 시작일 */
+    uint8_t on_hour, off_hour;
+    uint8_t sunrise_min, sunset_min;
+    float   night_drop;              /* 소등 중 temp_hot 목표 하강폭 (°C) */
+} preset_season_t;
+
 typedef struct {
     char species[32];
     struct { float target, min, max; } temp_hot;
@@ -25,17 +38,29 @@ typedef struct {
         float overtemp_offset;
         uint32_t heater_max_sec;
     } safety;
+    /*
+     * 계절 캘린더 (v2): 시작일 오름차순, 각 구간은 다음 구간 시작 전까지 (연 순환).
+     * count 0이면 light 고정 스케줄, 야간 하강 없음. 반드시 마지막 필드 —
+     * v1 blob(캘린더 이전)은 이 필드 앞부분과 같은 레이아웃이라 그대로 이전된다.
+     */
+    struct {
+        uint8_t count;
+        preset_season_t season[PRESET_SEASONS_MAX];
+    } calendar;
 } preset_t;
 
 /** @brief 기본 프리셋 로드 (볼파이톤) */
 esp_err_t preset_load_default(preset_t *preset);
 
-/** @brief NVS에서 프리셋 로드 */
+/** @brief NVS에서 프리셋 로드 (v1 blob은 캘린더 없이 이전 후 다시 저장) */
 esp_err_t preset_load(preset_t *preset);
 
 /** @brief NVS에 프리셋 저장 */
 esp_err_t preset_save(const preset_t *preset);
 
+/** @brief 프리셋 값 유효성 검증 (NVS 로드 및 원격 변경 시) */
+bool preset_validate(const preset_t *preset);
+
 #ifdef __cplusplus
 }
 #endif
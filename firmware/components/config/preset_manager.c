@@ -7,11 +7,15 @@
 #include "esp_log.h"
 #include <string.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <math.h>
 
 static const char *TAG = "preset";
 #define PRESET_NVS_KEY "preset"
 
+/* v1 (캘린더 이전) blob 길이 = 현재 구조체의 calendar 앞부분 */
+#define PRESET_V1_SIZE offsetof(preset_t, calendar)
+
 /* 기본 프리셋: 볼파이톤 */
 static const preset_t s_default_preset = {
     .species = "Ball Python",
@@ -24,6 +28,16 @@ static const preset_t s_default_preset = {
     },
     .pid = { .kp = 2.0f, .ki = 0.5f, .kd = 1.0f },
     .safety = { .overtemp_offset = 5.0f, .heater_max_sec = 3600 },
+    /* 3~10월 12/12 + 야간 1°C 하강, 11~2월 겨울 쿨링 10/14 + 야간 2°C 하강 (temp_hot.min까지) */
+    .calendar = {
+        .count = 2,
+        .season = {
+            { .month = 3,  .day = 1, .on_hour = 7, .off_hour = 19,
+              .sunrise_min = 30, .sunset_min = 30, .night_drop = 1.0f },
+            { .month = 11, .day = 1, .on_hour = 8, .off_hour = 18,
+              .sunrise_min = 45, .sunset_min = 45, .night_drop = 2.0f },
+        },
+    },
 };
 
 esp_err_t preset_load_default(preset_t *preset)
@@ -34,9 +48,10 @@ esp_err_t preset_load_default(preset_t *preset)
     return ESP_OK;
 }
 
-/* NVS에서 읽은 프리셋 데이터 유효성 검증 */
-static bool preset_validate(const preset_t *p)
+bool preset_validate(const preset_t *p)
 {
+    if (p == NULL) return false;
+
     /* species null-termination 보장 확인 */
     bool has_null = false;
     for (int i = 0; i < (int)sizeof(p->species); i++) {
@@ -64,6 +79,21 @@ static bool preset_validate(const preset_t *p)
     /* 조명 스케줄 검사 (시간: 0~23) */
     if (p->light.on_hour > 23 || p->light.off_hour > 23) return false;
 
+    /* 계절 캘린더 검사 (시작일 오름차순, 하강폭 0~15°C, 야간 목표도 temp_hot.min 이상) */
+    if (p->calendar.count > PRESET_SEASONS_MAX) return false;
+    int prev = 0;
+    for (int i = 0; i < p->calendar.count; i++) {
+        const preset_season_t *se = &p->calendar.season[i];
+        if (se->month < 1 || se->month > 12 || se->day < 1 || se->day > 31) return false;
+        if (se->on_hour > 23 || se->off_hour > 23) return false;
+        if (isnanf(se->night_drop) || se->night_drop < 0.0f ||
+            se->night_drop > PRESET_NIGHT_DROP_MAX) return false;
+        if (p->temp_hot.target - se->night_drop < p->temp_hot.min) return false;
+        int start = se->month * 100 + se->day;
+        if (start <= prev) return false;
+        prev = start;
+    }
+
     return true;
 }
 
@@ -73,7 +103,12 @@ esp_err_t preset_load(preset_t *preset)
 
     size_t len = 0;
     esp_err_t ret = nvs_config_load_blob(PRESET_NVS_KEY, preset, sizeof(preset_t), &len);
-    if (ret != ESP_OK || len != sizeof(preset_t)) {
+    bool migrated = false;
+    if (ret == ESP_OK && len == PRESET_V1_SIZE) {
+        /* v1 → v2: 기존 설정 유지, 캘린더 없음 (고정 스케줄 그대로) */
+        memset(&preset->calendar, 0, sizeof(preset->calendar));
+        migrated = true;
+    } else if (ret != ESP_OK || len != sizeof(preset_t)) {
         ESP_LOGW(TAG, "No saved preset, loading default");
         return preset_load_default(preset);
     }
@@ -86,6 +121,11 @@ esp_err_t preset_load(preset_t *preset)
         return preset_load_default(preset);
     }
 
+    if (migrated) {
+        ESP_LOGI(TAG, "Preset migrated from v1 layout");
+        preset_save(preset);
+    }
+
     ESP_LOGI(TAG, "Preset loaded from NVS: %s", preset->species);
     return ESP_OK;
 }
@@ -1,6 +1,15 @@
 /**
  * @file scheduler.h
  * @brief RTC 기반 조명/히터 스케줄러
+ *
+ * 시스템 시각은 게이트웨이 시각 비콘(time_sync.h)으로 맞춘다. 첫 비콘 전에는
+ * 시각을 모르므로 조명을 켜지 않는다 (1970년 시각으로 스케줄 실행 방지).
+ *
+ * 하루를 구간 경계(점등, 일출 끝, 일몰 시작, 소등, 캘린더 사용 시 자정)로 나누면 각 구간 안에서
+ * 디밍은 시간에 선형이다. 현재 구간(시작 레벨, 끝 레벨, 끝 시각)을 한 번 계산해
+ * 두고, 끝 시각이 지나기 전의 tick은 시각 비교만 한다. 일출/일몰 구간은 통째로
+ * scheduler_get_ramp()로 넘겨 LEDC 하드웨어 페이드가 실행한다 (pwm_dimmer.h).
+ * 스케줄/시간대 변경, 1초 이상의 시각 보정은 다음 tick에서 다시 계산한다.
  */
 #ifndef RBMS_SCHEDULER_H
 #define RBMS_SCHEDULER_H
@@ -20,18 +29,86 @@ typedef struct {
     uint8_t  sunset_min;    /* 일몰 페이드 시간 (분) */
 } light_schedule_t;
 
+#define SCHED_SEASONS_MAX 6
+
+/* 계절 구간: 시작일부터 다음 구간 시작일 전날까지 (연 단위 순환) */
+typedef struct {
+    uint8_t          month;       /* 시작 월 (1-12) */
+    uint8_t          day;         /* 시작 일 (1-31) */
+    light_schedule_t light;       /* 광주기 + 일출/일몰 */
+    float            night_drop;  /* 소등 중 목표 온도 하강폭 (°C, 0 = 없음) */
+} sched_season_t;
+
+/* 계절 캘린더 — 시작일 오름차순, count 0이면 scheduler_set_light() 고정 스케줄 */
+typedef struct {
+    uint8_t        count;
+    sched_season_t seasons[SCHED_SEASONS_MAX];
+} sched_calendar_t;
+
 esp_err_t scheduler_init(void);
 esp_err_t scheduler_set_light(const light_schedule_t *sched);
 esp_err_t scheduler_set_time(uint8_t hour, uint8_t minute);
 
+/**
+ * @brief 계절 캘린더 설정 (활성 중에는 scheduler_set_light()보다 우선)
+ * @param cal NULL 또는 count 0 = 해제
+ * @note 계절은 날짜가 바뀔 때(자정 경계)만 다시 고른다
+ */
+esp_err_t scheduler_set_calendar(const sched_calendar_t *cal);
+
+/**
+ * @brief 시스템 시각 보정 (시각 비콘/드리프트 보정량 적용)
+ * @param delta_us 현재 시각에 더할 값
+ */
+esp_err_t scheduler_adjust_time(int64_t delta_us);
+
+/**
+ * @brief 지역 시간대 설정 (비콘의 UTC 오프셋, 기본 KST = +540분)
+ * @param utc_offset_min UTC 기준 분 (-720~840)
+ */
+esp_err_t scheduler_set_utc_offset(int16_t utc_offset_min);
+
+/** @brief 시스템 시각이 설정되었는지 (비콘 또는 scheduler_set_time) */
+bool scheduler_time_valid(void);
+
 /** @brief 현재 조명이 켜져야 하는지 */
 bool scheduler_is_light_on(void);
 
-/** @brief 현재 디밍 레벨 (0.0=OFF ~ 1.0=MAX) */
+/**
+ * @brief 현재 목표 온도 하강폭 (°C) — 소등 중이면 현재 계절의 night_drop, 아니면 0
+ * @note 조명 구간과 함께 갱신되므로 scheduler_update()가 true일 때 다시 읽으면 된다
+ */
+float scheduler_get_night_drop(void);
+
+/** @brief 현재 구간 시작 시점의 디밍 레벨 (0.0=OFF ~ 1.0=MAX) */
 float scheduler_get_dimming(void);
 
-/** @brief 매 분마다 호출하여 내부 상태 업데이트 */
-void scheduler_tick(void);
+/**
+ * @brief 현재 구간의 디밍 램프 (일출/일몰을 하드웨어 페이드 한 번으로)
+ * @param now_us      현재 시각 (epoch us)
+ * @param[out] level  now_us의 디밍 레벨 (NULL 허용)
+ * @param[out] target 구간 끝의 디밍 레벨 (NULL 허용)
+ * @return 구간 끝까지 남은 ms, 레벨이 일정한 구간이면 0
+ */
+uint32_t scheduler_get_ramp(int64_t now_us, float *level, float *target);
+
+/**
+ * @brief 현재 시각으로 상태 갱신 (주기 호출, 전이 전에는 시각 비교만)
+ * @return 구간이 바뀌어 다시 계산했으면 true (조명 출력을 다시 적용할 때)
+ */
+bool scheduler_tick(void);
+
+/**
+ * @brief 지정 시각으로 상태 갱신 (scheduler_tick()의 본체, 테스트/재생용)
+ * @param now_us 시스템 시각 (epoch us)
+ */
+bool scheduler_update(int64_t now_us);
+
+/**
+ * @brief 현재 구간 끝 = 다음 전이 시각 (epoch us, 시스템 시각 기준)
+ * @return 0 = 아직 계산 전 (다음 tick에서 계산)
+ */
+int64_t scheduler_next_event_us(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,42 @@
+/**
+ * @file temp_resolution.h
+ * @brief DS18B20 변환 해상도 선택 정책
+ *
+ * 상황에 충분한 가장 거친 해상도를 고른다 (변환 시간 9비트 94 ms ~ 12비트 750 ms).
+ *  - 과열 한계 근처: 12비트 (0.0625°C) — 안전 판정 정밀도 우선
+ *  - 직전 측정 대비 변화 중: stable_bits + 1
+ *  - 안정: stable_bits (기본 10비트 = 0.25°C, 188 ms)
+ */
+#ifndef RBMS_TEMP_RESOLUTION_H
+#define RBMS_TEMP_RESOLUTION_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TEMP_RES_BITS_MIN 9
+#define TEMP_RES_BITS_MAX 12
+
+typedef struct {
+    float   guard_c;      /* 한계까지 이 이내면 최고 해상도 */
+    float   stable_c;     /* 직전 측정 대비 변화가 이 이하면 안정 */
+    uint8_t stable_bits;  /* 안정 시 해상도 (9~12, 12면 항상 12비트) */
+} temp_resolution_config_t;
+
+/**
+ * @brief 다음 변환 해상도 선택
+ * @param temp      현재 측정값 (NaN = 미측정 → 최고 해상도)
+ * @param prev_temp 직전 측정값 (NaN = 없음 → 변화 중으로 간주)
+ * @param limit_c   과열 한계 (setpoint + overtemp_offset)
+ * @return 해상도 비트 (9~12)
+ */
+uint8_t temp_resolution_select(const temp_resolution_config_t *cfg, float temp,
+                               float prev_temp, float limit_c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_TEMP_RESOLUTION_H */
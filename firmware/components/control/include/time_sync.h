@@ -0,0 +1,64 @@
+/**
+ * @file time_sync.h
+ * @brief 네트워크 시각 비콘 기반 시계 보정 (오프셋 + 드리프트 추정)
+ *
+ * 비콘마다 시스템 시각을 네트워크 시각으로 맞추고(오프셋), 그동안 비콘이 고친
+ * 누적 오차를 긴 구간(TIME_SYNC_DRIFT_SPAN_US)으로 나눠 로컬 시계 속도 오차를
+ * 추정한다. 비콘 사이에는 time_sync_adjust()로 추정 드리프트만큼 미리 보정
+ * (Type B: 매 wake, 배치 모드처럼 업링크 없이 깨는 동안에도 wake 슬롯 유지).
+ *
+ * 상태는 호출자 소유 — Type B는 RTC_DATA_ATTR에 두어 deep sleep을 넘겨 유지.
+ * 시각 인자는 모두 시스템 시각(us, gettimeofday 기준), 반환값은 시스템 시각에
+ * 더할 보정량이다.
+ */
+#ifndef RBMS_TIME_SYNC_H
+#define RBMS_TIME_SYNC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 이보다 큰 오차는 드리프트가 아니라 시계 재설정 (첫 비콘, 전원 차단, 서버 시각 변경) */
+#define TIME_SYNC_STEP_US        2000000LL
+/* 드리프트 측정 구간 — 비콘 지연 지터(~100 ms)가 수십 ppm 이하가 되도록 */
+#define TIME_SYNC_DRIFT_SPAN_US  (30LL * 60 * 1000000)
+/* 추정 한계 ±500 ppm (보정된 RC 슬로우 클럭 + 온도 변화 여유) */
+#define TIME_SYNC_DRIFT_MAX_PPB  500000
+
+typedef struct {
+    int64_t  anchor_us;       /* 드리프트 측정 구간 시작 (시스템 시각) */
+    int64_t  accum_us;        /* 구간 동안 비콘이 고친 오차 합 */
+    int64_t  last_adjust_us;  /* 마지막 드리프트 보정 시점 */
+    int32_t  drift_ppb;       /* 로컬 시계가 늦는 정도 (+: 느림 → 앞으로 보정) */
+    int32_t  last_error_us;   /* 마지막 비콘에서 측정한 오차 (진단) */
+    uint16_t syncs;           /* 받은 비콘 수 (포화) */
+    uint16_t drift_updates;   /* 드리프트 추정 갱신 수 (포화) */
+} time_sync_t;
+
+void time_sync_init(time_sync_t *ts);
+
+/** @brief 비콘 한 번이라도 받았는지 (시스템 시각이 네트워크 시각) */
+bool time_sync_is_synced(const time_sync_t *ts);
+
+/**
+ * @brief 비콘 수신 처리
+ * @param local_us 비콘 수신 시점 시스템 시각
+ * @param net_us   비콘이 알려준 네트워크 시각
+ * @return 시스템 시각에 더할 보정량 (us)
+ */
+int64_t time_sync_beacon(time_sync_t *ts, int64_t local_us, int64_t net_us);
+
+/**
+ * @brief 마지막 보정 이후 추정 드리프트만큼 보정 (비콘 없이 깬 경우)
+ * @return 시스템 시각에 더할 보정량 (us), 동기 전/드리프트 미추정이면 0
+ */
+int64_t time_sync_adjust(time_sync_t *ts, int64_t local_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_TIME_SYNC_H */
@@ -0,0 +1,50 @@
+/**
+ * @file wake_slot.h
+ * @brief Type B wake 슬롯 배정 (다수 SED의 동시 wake 분산)
+ *
+ * 시간축을 frame_ms 길이 프레임으로 나누고, 각 프레임을 slot_ms 폭 슬롯으로 나눈다.
+ * 노드는 (노드 ID, 서버 배포 epoch) 해시로 정한 슬롯의 중앙에서만 깨어나며,
+ * 적응형 주기는 프레임 배수로 맞춘다. 정전 후 동시에 부팅해도 노드마다
+ * 다른 슬롯에서 송신하므로 부모에서 충돌하지 않는다.
+ *
+ * 매 wake마다 현재 RTC 시각으로 다음 슬롯을 다시 계산하므로 오차는 한 번의
+ * sleep 동안의 RTC 드리프트뿐이고, 슬롯 중앙을 노려 ±slot_ms/2까지 흡수한다.
+ * epoch를 바꾸면 전체 배정이 다시 섞인다 (특정 노드 쌍의 충돌 해소).
+ */
+#ifndef RBMS_WAKE_SLOT_H
+#define RBMS_WAKE_SLOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t frame_ms;   /* 슬롯 프레임 = 최단 wake 간격 (빠른 폴링 주기) */
+    uint32_t slot_ms;    /* 슬롯 폭 (한 번의 송수신 + RTC 드리프트 여유) */
+} wake_slot_config_t;
+
+/**
+ * @brief 프레임 내 슬롯 번호
+ * @return 0 .. frame_ms/slot_ms - 1 (설정 오류면 0)
+ */
+uint32_t wake_slot_index(const wake_slot_config_t *cfg, uint64_t node_id, uint32_t epoch);
+
+/**
+ * @brief 다음 wake까지 sleep 시간
+ *
+ * period_s를 가장 가까운 프레임 배수 P(최소 1프레임)로 맞추고, now_ms + P 기준
+ * ±frame/2 안에서 슬롯 중앙에 해당하는 시각까지의 간격을 돌려준다.
+ * @param now_ms 현재 RTC 시각 (deep sleep 동안 유지되는 시계)
+ * @return sleep ms (P - frame/2 이상, P + frame/2 미만)
+ */
+uint32_t wake_slot_sleep_ms(const wake_slot_config_t *cfg, uint32_t slot, uint64_t now_ms,
+                            uint32_t period_s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_WAKE_SLOT_H */
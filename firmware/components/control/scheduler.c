@@ -4,7 +4,8 @@
  */
 #include "scheduler.h"
 #include "esp_log.h"
-#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
 #include <sys/time.h>
 
@@ -15,25 +16,44 @@ static light_schedule_t s_sched = {
     .sunrise_min = 30, .sunset_min = 30,
 };
 
+/* 계절 캘린더 — 활성이면 s_active가 오늘의 계절을 가리킴 */
+static sched_calendar_t s_calendar = { .count = 0 };
+static const light_schedule_t *s_active = &s_sched;
+static float    s_season_drop = 0.0f;
+static int      s_season_day = -1;          /* 계절을 고른 날 (년*1000+yday) */
+
 static bool     s_light_on = false;
 static float    s_dimming = 0.0f;
+static int16_t  s_utc_offset_min = 9 * 60;  /* KST, 첫 비콘 전 기본값 */
+static int64_t  s_next_event_us = 0;        /* 0 = 다음 tick에서 재계산 */
+static int64_t  s_seg_start_us = 0;         /* 현재 구간 계산 시각 (s_dimming 기준점) */
+static float    s_ramp_target = 0.0f;       /* 구간 끝(s_next_event_us)의 디밍 레벨 */
+
+/* 이보다 이전이면 시각 미설정 (부팅 직후 1970년) */
+#define TIME_VALID_MIN_SEC 1704067200  /* 2024-01-01 UTC */
+
+/* 이보다 작은 시각 보정(비콘 지터)은 구간을 다시 계산하지 않음 */
+#define ADJUST_RECALC_US   1000000LL
 
-/* 시스템 시간에서 현재 시/분 획득 */
-static void get_current_time(uint8_t *hour, uint8_t *minute)
+/* 시각 미설정 중 재확인 간격 */
+#define INVALID_RECHECK_US 60000000LL
+
+/* POSIX TZ는 부호가 반대: UTC+9 → "UTC-9" */
+static void apply_tz(int16_t offset_min)
 {
-    time_t now;
-    struct tm timeinfo;
-    time(&now);
-    localtime_r(&now, &timeinfo);
-    *hour = (uint8_t)(timeinfo.tm_hour);
-    *minute = (uint8_t)(timeinfo.tm_min);
+    char tz[16];
+    int west = -offset_min;
+    char sign = (west < 0) ? '-' : '+';
+    if (west < 0) west = -west;
+    snprintf(tz, sizeof(tz), "UTC%c%d:%02d", sign, west / 60, west % 60);
+    setenv("TZ", tz, 1);
+    tzset();
 }
 
 esp_err_t scheduler_init(void)
 {
-    /* 타임존 설정 (KST = UTC+9) */
-    setenv("TZ", "KST-9", 1);
-    tzset();
+    apply_tz(s_utc_offset_min);
+    s_next_event_us = 0;
     ESP_LOGI(TAG, "Scheduler init: ON=%02d:00, OFF=%02d:00", s_sched.on_hour, s_sched.off_hour);
     return ESP_OK;
 }
@@ -42,6 +62,8 @@ esp_err_t scheduler_set_light(const light_schedule_t *sched)
 {
     if (sched == NULL) return ESP_ERR_INVALID_ARG;
     s_sched = *sched;
+    s_season_day = -1;
+    s_next_event_us = 0;
     ESP_LOGI(TAG, "Light schedule: ON=%02d:00 OFF=%02d:00 sunrise=%dmin sunset=%dmin",
              sched->on_hour, sched->off_hour, sched->sunrise_min, sched->sunset_min);
     return ESP_OK;
@@ -59,73 +81,220 @@ esp_err_t scheduler_set_time(uint8_t hour, uint8_t minute)
     tv.tv_sec = mktime(&t);
     tv.tv_usec = 0;
     settimeofday(&tv, NULL);
+    s_next_event_us = 0;
     return ESP_OK;
 }
 
-/* now_min이 [on, off) 범위 안에 있는지 판단 (자정 경과 지원) */
-static bool is_in_light_period(int now_min, int on_min, int off_min)
+esp_err_t scheduler_set_calendar(const sched_calendar_t *cal)
+{
+    if (cal != NULL && cal->count > SCHED_SEASONS_MAX) return ESP_ERR_INVALID_ARG;
+
+    if (cal == NULL) {
+        s_calendar.count = 0;
+    } else {
+        s_calendar = *cal;
+    }
+    s_season_day = -1;
+    s_next_event_us = 0;
+    ESP_LOGI(TAG, "Calendar: %d season(s)", s_calendar.count);
+    return ESP_OK;
+}
+
+esp_err_t scheduler_adjust_time(int64_t delta_us)
+{
+    if (delta_us == 0) return ESP_OK;
+
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    int64_t us = (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec + delta_us;
+    tv.tv_sec = (time_t)(us / 1000000LL);
+    tv.tv_usec = (suseconds_t)(us % 1000000LL);
+    if (delta_us >= ADJUST_RECALC_US || delta_us <= -ADJUST_RECALC_US) {
+        s_next_event_us = 0;
+    }
+    return (settimeofday(&tv, NULL) == 0) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t scheduler_set_utc_offset(int16_t utc_offset_min)
 {
-    if (on_min <= off_min) {
+    if (utc_offset_min < -720 || utc_offset_min > 840) return ESP_ERR_INVALID_ARG;
+    if (utc_offset_min == s_utc_offset_min) return ESP_OK;
+
+    s_utc_offset_min = utc_offset_min;
+    apply_tz(utc_offset_min);
+    s_next_event_us = 0;
+    ESP_LOGI(TAG, "UTC offset %+d min", utc_offset_min);
+    return ESP_OK;
+}
+
+bool scheduler_time_valid(void)
+{
+    return time(NULL) >= TIME_VALID_MIN_SEC;
+}
+
+#define DAY_SEC 86400
+
+/* now_s가 [on, off) 범위 안에 있는지 판단 (자정 경과 지원) */
+static bool is_in_light_period(int now_s, int on_s, int off_s)
+{
+    if (on_s <= off_s) {
         /* 일반: 07:00~19:00 */
-        return (now_min >= on_min && now_min < off_min);
+        return (now_s >= on_s && now_s < off_s);
     } else {
         /* 야간: 19:00~07:00 (자정 경과) */
-        return (now_min >= on_min || now_min < off_min);
+        return (now_s >= on_s || now_s < off_s);
     }
 }
 
-/* 자정 경과를 고려한 점등 시작으로부터의 경과 분 계산 */
-static int minutes_since_on(int now_min, int on_min)
+/* 자정 경과를 고려한 from → to 경과 초 (0~86399) */
+static int seconds_between(int from_s, int to_s)
 {
-    int diff = now_min - on_min;
-    if (diff < 0) diff += 1440;  /* 24h = 1440분 */
+    int diff = to_s - from_s;
+    if (diff < 0) diff += DAY_SEC;
     return diff;
 }
 
-/* 자정 경과를 고려한 소등까지 남은 분 계산 */
-static int minutes_until_off(int now_min, int off_min)
+/* 하루 중 now_s 초의 조명 상태 (일출/일몰은 초 단위 선형) */
+static void light_state_at(int now_s, bool *on, float *dimming)
 {
-    int diff = off_min - now_min;
-    if (diff < 0) diff += 1440;
-    return diff;
+    int on_s  = s_active->on_hour * 3600;
+    int off_s = s_active->off_hour * 3600;
+    int rise_s = s_active->sunrise_min * 60;
+    int set_s  = s_active->sunset_min * 60;
+
+    if (!is_in_light_period(now_s, on_s, off_s)) {
+        /* 소등 시간 */
+        *on = false;
+        *dimming = 0.0f;
+        return;
+    }
+
+    int elapsed = seconds_between(on_s, now_s);
+    int remaining = seconds_between(now_s, off_s);
+
+    *on = true;
+    if (rise_s > 0 && elapsed < rise_s) {
+        /* 일출 전이 (0→1) */
+        *dimming = (float)elapsed / (float)rise_s;
+    } else if (set_s > 0 && remaining < set_s) {
+        /* 일몰 전이 (1→0) */
+        *dimming = (float)remaining / (float)set_s;
+    } else {
+        /* 완전 점등 */
+        *dimming = 1.0f;
+    }
+
+    /* clamp */
+    if (*dimming < 0.0f) *dimming = 0.0f;
+    if (*dimming > 1.0f) *dimming = 1.0f;
 }
 
-void scheduler_tick(void)
+/*
+ * now_s 이후 첫 구간 경계까지의 초 (1~86400).
+ * 경계(점등, 일출 끝, 일몰 시작, 소등) 사이에서 디밍은 시간에 선형이다.
+ */
+static int seconds_to_next_boundary(int now_s)
 {
-    /* 시스템 시간에서 현재 시각 획득 */
-    uint8_t hour, minute;
-    get_current_time(&hour, &minute);
+    int on_s  = s_active->on_hour * 3600;
+    int off_s = s_active->off_hour * 3600;
+    const int bounds[5] = {
+        on_s, on_s + s_active->sunrise_min * 60,
+        off_s - s_active->sunset_min * 60, off_s,
+        0,  /* 자정: 캘린더 계절 전환 */
+    };
+    int n = (s_calendar.count > 0) ? 5 : 4;
 
-    int now_min = hour * 60 + minute;
-    int on_min  = s_sched.on_hour * 60;
-    int off_min = s_sched.off_hour * 60;
+    int best = DAY_SEC;
+    for (int i = 0; i < n; i++) {
+        int d = seconds_between(now_s, ((bounds[i] % DAY_SEC) + DAY_SEC) % DAY_SEC);
+        if (d == 0) d = DAY_SEC;
+        if (d < best) best = d;
+    }
+    return best;
+}
 
-    if (!is_in_light_period(now_min, on_min, off_min)) {
-        /* 소등 시간 */
+/* 오늘의 계절 — 시작일이 오늘 이전인 마지막 구간, 없으면 작년의 마지막 구간 */
+static void select_season(const struct tm *tm)
+{
+    if (s_calendar.count == 0) {
+        s_active = &s_sched;
+        s_season_drop = 0.0f;
+        return;
+    }
+
+    int day = (tm->tm_year + 1900) * 1000 + tm->tm_yday;
+    if (day == s_season_day) return;  /* 하루 한 번 */
+    s_season_day = day;
+
+    int today = (tm->tm_mon + 1) * 100 + tm->tm_mday;
+    int idx = s_calendar.count - 1;
+    for (int i = 0; i < s_calendar.count; i++) {
+        const sched_season_t *se = &s_calendar.seasons[i];
+        if (se->month * 100 + se->day <= today) idx = i;
+    }
+    s_active = &s_calendar.seasons[idx].light;
+    s_season_drop = s_calendar.seasons[idx].night_drop;
+    ESP_LOGI(TAG, "Season %d: ON=%02d:00 OFF=%02d:00 night -%.1f C",
+             idx, s_active->on_hour, s_active->off_hour, s_season_drop);
+}
+
+bool scheduler_update(int64_t now_us)
+{
+    if (s_next_event_us != 0 && now_us < s_next_event_us) {
+        return false;  /* 다음 전이 전 — 시각 변환/재계산 없음 */
+    }
+
+    time_t now = (time_t)(now_us / 1000000LL);
+    s_seg_start_us = (int64_t)now * 1000000LL;
+
+    if (now < TIME_VALID_MIN_SEC) {
+        /* 시각 비콘 대기 — 조명 OFF 유지 (시각 변경 시 즉시 재계산) */
         s_light_on = false;
         s_dimming = 0.0f;
-    } else {
-        int elapsed = minutes_since_on(now_min, on_min);
-        int remaining = minutes_until_off(now_min, off_min);
-
-        if (s_sched.sunrise_min > 0 && elapsed < s_sched.sunrise_min) {
-            /* 일출 전이 (0→1) */
-            s_light_on = true;
-            s_dimming = (float)elapsed / (float)s_sched.sunrise_min;
-        } else if (s_sched.sunset_min > 0 && remaining < s_sched.sunset_min) {
-            /* 일몰 전이 (1→0) */
-            s_light_on = true;
-            s_dimming = (float)remaining / (float)s_sched.sunset_min;
-        } else {
-            /* 완전 점등 */
-            s_light_on = true;
-            s_dimming = 1.0f;
-        }
+        s_ramp_target = 0.0f;
+        s_season_drop = 0.0f;   /* 날짜를 모르면 낮 목표 유지 */
+        s_season_day = -1;
+        s_next_event_us = now_us + INVALID_RECHECK_US;
+        return true;
     }
 
-    /* clamp */
-    if (s_dimming < 0.0f) s_dimming = 0.0f;
-    if (s_dimming > 1.0f) s_dimming = 1.0f;
+    struct tm tm;
+    localtime_r(&now, &tm);
+    select_season(&tm);
+    int now_s = tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+    light_state_at(now_s, &s_light_on, &s_dimming);
+
+    /* 구간 끝 레벨: 경계 1초 전 값을 선형 연장 (경계 자체는 다음 구간 값) */
+    int d = seconds_to_next_boundary(now_s);
+    s_ramp_target = s_dimming;
+    if (s_light_on && d > 1) {
+        bool on;
+        float before;
+        light_state_at((now_s + d - 1) % DAY_SEC, &on, &before);
+        s_ramp_target = s_dimming + (before - s_dimming) * (float)d / (float)(d - 1);
+        if (s_ramp_target < 0.0f) s_ramp_target = 0.0f;
+        if (s_ramp_target > 1.0f) s_ramp_target = 1.0f;
+    }
+
+    /* 다음 경계 — mktime으로 날짜/DST 경계 처리 */
+    tm.tm_sec += d;
+    tm.tm_isdst = -1;
+    time_t next = mktime(&tm);
+    s_next_event_us = (next > now) ? (int64_t)next * 1000000LL
+                                   : now_us + INVALID_RECHECK_US;
+    return true;
+}
+
+bool scheduler_tick(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return scheduler_update((int64_t)tv.tv_sec * 1000000LL + tv.tv_usec);
+}
+
+int64_t scheduler_next_event_us(void)
+{
+    return s_next_event_us;
 }
 
 bool scheduler_is_light_on(void)
@@ -133,7 +302,30 @@ bool scheduler_is_light_on(void)
     return s_light_on;
 }
 
+float scheduler_get_night_drop(void)
+{
+    return s_light_on ? 0.0f : s_season_drop;
+}
+
 float scheduler_get_dimming(void)
 {
     return s_dimming;
 }
+
+uint32_t scheduler_get_ramp(int64_t now_us, float *level, float *target)
+{
+    float from = s_dimming, to = s_ramp_target;
+    int64_t span = s_next_event_us - s_seg_start_us;
+    int64_t left = s_next_event_us - now_us;
+
+    if (!s_light_on || from == to || span <= 0 || left <= 0) {
+        if (level) *level = s_light_on ? from : 0.0f;
+        if (target) *target = s_light_on ? from : 0.0f;
+        return 0;
+    }
+    if (left > span) left = span;
+
+    if (level) *level = to - (to - from) * (float)left / (float)span;
+    if (target) *target = to;
+    return (uint32_t)(left / 1000);
+}
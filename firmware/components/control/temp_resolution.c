@@ -0,0 +1,26 @@
+/**
+ * @file temp_resolution.c
+ * @brief DS18B20 변환 해상도 선택 정책
+ */
+#include "temp_resolution.h"
+#include <math.h>
+#include <stddef.h>
+
+uint8_t temp_resolution_select(const temp_resolution_config_t *cfg, float temp,
+                               float prev_temp, float limit_c)
+{
+    if (cfg == NULL || isnan(temp)) return TEMP_RES_BITS_MAX;
+
+    uint8_t bits = cfg->stable_bits;
+    if (bits < TEMP_RES_BITS_MIN) bits = TEMP_RES_BITS_MIN;
+    if (bits > TEMP_RES_BITS_MAX) bits = TEMP_RES_BITS_MAX;
+
+    /* 과열 한계 근처 (또는 초과) */
+    if (temp >= limit_c - cfg->guard_c) return TEMP_RES_BITS_MAX;
+
+    /* 변화 중 — 한 단계 정밀하게 */
+    if (isnan(prev_temp) || fabsf(temp - prev_temp) > cfg->stable_c) {
+        if (bits < TEMP_RES_BITS_MAX) bits++;
+    }
+    return bits;
+}
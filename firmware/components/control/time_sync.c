@@ -0,0 +1,64 @@
+/**
+ * @file time_sync.c
+ * @brief 네트워크 시각 비콘 기반 시계 보정
+ */
+#include "time_sync.h"
+#include <string.h>
+
+#define PPB 1000000000LL
+
+void time_sync_init(time_sync_t *ts)
+{
+    if (ts == NULL) return;
+    memset(ts, 0, sizeof(*ts));
+}
+
+bool time_sync_is_synced(const time_sync_t *ts)
+{
+    return ts != NULL && ts->syncs > 0;
+}
+
+int64_t time_sync_adjust(time_sync_t *ts, int64_t local_us)
+{
+    if (ts == NULL || ts->syncs == 0) return 0;
+
+    int64_t dt = local_us - ts->last_adjust_us;
+    int64_t corr = (dt > 0) ? dt * ts->drift_ppb / PPB : 0;
+    ts->last_adjust_us = local_us + corr;
+    return corr;
+}
+
+int64_t time_sync_beacon(time_sync_t *ts, int64_t local_us, int64_t net_us)
+{
+    if (ts == NULL) return 0;
+
+    /* 모델 보정을 먼저 적용하고 남은 오차만 측정 */
+    int64_t corr = time_sync_adjust(ts, local_us);
+    int64_t err = net_us - (local_us + corr);
+    ts->last_error_us = (int32_t)((err > INT32_MAX) ? INT32_MAX
+                                : (err < INT32_MIN) ? INT32_MIN : err);
+
+    if (ts->syncs == 0 || err > TIME_SYNC_STEP_US || err < -TIME_SYNC_STEP_US) {
+        /* 시계 재설정 — 측정 구간을 다시 시작, 추정한 드리프트는 유지 */
+        ts->anchor_us = net_us;
+        ts->accum_us = 0;
+    } else {
+        ts->accum_us += err;
+        int64_t span = net_us - ts->anchor_us;
+        if (span >= TIME_SYNC_DRIFT_SPAN_US) {
+            /* 남은 속도 오차: 첫 추정은 그대로, 이후는 1/2 가중 (지연 지터 평균) */
+            int64_t residual = ts->accum_us * PPB / span;
+            int64_t drift = ts->drift_ppb + ((ts->drift_updates == 0) ? residual : residual / 2);
+            if (drift > TIME_SYNC_DRIFT_MAX_PPB) drift = TIME_SYNC_DRIFT_MAX_PPB;
+            if (drift < -TIME_SYNC_DRIFT_MAX_PPB) drift = -TIME_SYNC_DRIFT_MAX_PPB;
+            ts->drift_ppb = (int32_t)drift;
+            if (ts->drift_updates < UINT16_MAX) ts->drift_updates++;
+            ts->anchor_us = net_us;
+            ts->accum_us = 0;
+        }
+    }
+
+    ts->last_adjust_us = net_us;
+    if (ts->syncs < UINT16_MAX) ts->syncs++;
+    return corr + err;
+}
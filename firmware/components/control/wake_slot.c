@@ -0,0 +1,43 @@
+/**
+ * @file wake_slot.c
+ * @brief Type B wake 슬롯 배정
+ */
+#include "wake_slot.h"
+
+/* splitmix64 — 인접한 MAC/epoch도 고르게 흩어지도록 */
+static uint64_t mix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+uint32_t wake_slot_index(const wake_slot_config_t *cfg, uint64_t node_id, uint32_t epoch)
+{
+    if (cfg == NULL || cfg->slot_ms == 0 || cfg->frame_ms < cfg->slot_ms) return 0;
+
+    uint32_t slots = cfg->frame_ms / cfg->slot_ms;
+    return (uint32_t)(mix64(node_id ^ mix64(epoch)) % slots);
+}
+
+uint32_t wake_slot_sleep_ms(const wake_slot_config_t *cfg, uint32_t slot, uint64_t now_ms,
+                            uint32_t period_s)
+{
+    uint64_t period_ms = (uint64_t)period_s * 1000;
+    if (cfg == NULL || cfg->frame_ms == 0 || cfg->slot_ms == 0) {
+        return (uint32_t)period_ms;
+    }
+
+    uint64_t frame = cfg->frame_ms;
+    uint64_t frames = (period_ms + frame / 2) / frame;
+    if (frames == 0) frames = 1;
+
+    /* 슬롯 중앙 (프레임 내 위치) */
+    uint64_t center = ((uint64_t)slot * cfg->slot_ms + cfg->slot_ms / 2) % frame;
+
+    /* [now + P - F/2, now + P + F/2) 안에서 t ≡ center (mod F)인 유일한 t */
+    uint64_t base = now_ms + frames * frame - frame / 2;
+    uint64_t t = base + (center + frame - base % frame) % frame;
+    return (uint32_t)(t - now_ms);
+}
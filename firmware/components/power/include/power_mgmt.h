@@ -35,6 +35,12 @@ esp_err_t power_mgmt_register_hold_gpio(int gpio);
  */
 void power_mgmt_deep_sleep(uint32_t sleep_sec);
 
+/**
+ * @brief Deep Sleep 진입 (ms 단위, wake 슬롯 정렬용)
+ * @param sleep_ms 수면 시간 (ms)
+ */
+void power_mgmt_deep_sleep_ms(uint32_t sleep_ms);
+
 #ifdef __cplusplus
 }
 #endif
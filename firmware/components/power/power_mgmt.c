@@ -51,7 +51,12 @@ esp_err_t power_mgmt_register_hold_gpio(int gpio)
 
 void power_mgmt_deep_sleep(uint32_t sleep_sec)
 {
-    ESP_LOGI(TAG, "Entering Deep Sleep for %lu seconds", (unsigned long)sleep_sec);
+    power_mgmt_deep_sleep_ms(sleep_sec * 1000U);
+}
+
+void power_mgmt_deep_sleep_ms(uint32_t sleep_ms)
+{
+    ESP_LOGI(TAG, "Entering Deep Sleep for %lu ms", (unsigned long)sleep_ms);
 
     /* 등록된 GPIO를 LOW로 설정 후 hold */
     for (int i = 0; i < s_hold_count; i++) {
@@ -66,7 +71,7 @@ void power_mgmt_deep_sleep(uint32_t sleep_sec)
     esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_OFF);
     esp_sleep_pd_config(ESP_PD_DOMAIN_XTAL, ESP_PD_OPTION_OFF);
 
-    esp_sleep_enable_timer_wakeup((uint64_t)sleep_sec * 1000000ULL);
+    esp_sleep_enable_timer_wakeup((uint64_t)sleep_ms * 1000ULL);
     esp_deep_sleep_start();
     /* 이 아래는 실행되지 않음 */
 }
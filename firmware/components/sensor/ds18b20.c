@@ -2,160 +2,76 @@
  * @file ds18b20.c
  * @brief DS18B20 1-Wire 온도 센서 드라이버
  *
- * 1-Wire 프로토콜을 GPIO bit-bang으로 구현.
+ * 1-Wire 전송은 onewire_bus (RMT 또는 GPIO bit-bang 백엔드), 버스 여러 개(핀별)에
+ * 센서를 검색 순서대로 한 표에 모은다. 변환은 버스마다 SKIP ROM 한 번.
  * Type B에서는 power_gpio로 VCC를 제어하여 배터리 절약.
  */
 #include "ds18b20.h"
+#include "onewire_backend.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include <string.h>
 
-static portMUX_TYPE s_ow_mux = portMUX_INITIALIZER_UNLOCKED;
-
 static const char *TAG = "ds18b20";
 
-/* 1-Wire 타이밍 (마이크로초) */
-#define OW_RESET_PULSE_US     480
-#define OW_PRESENCE_WAIT_US   70
-#define OW_PRESENCE_SAMPLE_US 410
-#define OW_WRITE_SLOT_US      60
-#define OW_WRITE_1_LOW_US     6
-#define OW_WRITE_0_LOW_US     60
-#define OW_READ_INIT_US       6
-#define OW_READ_SAMPLE_US     9
-#define OW_READ_SLOT_US       55
-
-/* DS18B20 ROM 커맨드 */
-#define CMD_SEARCH_ROM   0xF0
-#define CMD_SKIP_ROM     0xCC
-#define CMD_MATCH_ROM    0x55
 /* DS18B20 Function 커맨드 */
 #define CMD_CONVERT_T    0x44
+#define CMD_WRITE_SCRATCH 0x4E
 #define CMD_READ_SCRATCH 0xBE
 
-#define CONVERSION_DELAY_MS  750  /* 12비트 해상도 */
+#define CONVERSION_DELAY_MS  750  /* 12비트 해상도 최대 변환 시간 */
+#define CONVERSION_POLL_MS   10   /* 완료 비트(read slot) 확인 간격 */
+
+typedef struct {
+    onewire_bus_t     bus;
+    gpio_num_t        gpio;
+    onewire_backend_t backend;
+} ds_bus_t;
 
-static gpio_num_t s_data_gpio  = GPIO_NUM_NC;
+static ds_bus_t s_buses[DS18B20_MAX_BUSES];
+static int s_bus_count = 0;
 static gpio_num_t s_power_gpio = GPIO_NUM_NC;
 static ds18b20_sensor_t s_sensors[DS18B20_MAX_SENSORS];
 static int s_sensor_count = 0;
 static bool s_initialized = false;
 
-/* --- 1-Wire 저수준 --- */
-
-static inline void ow_delay_us(uint32_t us)
-{
-    uint64_t end = esp_timer_get_time() + us;
-    while (esp_timer_get_time() < end) { }
-}
-
-static void ow_set_output(int level)
-{
-    gpio_set_direction(s_data_gpio, GPIO_MODE_OUTPUT);
-    gpio_set_level(s_data_gpio, level);
-}
-
-static int ow_read_input(void)
-{
-    gpio_set_direction(s_data_gpio, GPIO_MODE_INPUT);
-    return gpio_get_level(s_data_gpio);
-}
-
-static bool ow_reset(void)
-{
-    portENTER_CRITICAL(&s_ow_mux);
-    ow_set_output(0);
-    ow_delay_us(OW_RESET_PULSE_US);
-    ow_read_input();  /* 릴리즈 (풀업) */
-    ow_delay_us(OW_PRESENCE_WAIT_US);
-    int presence = ow_read_input();
-    ow_delay_us(OW_PRESENCE_SAMPLE_US);
-    portEXIT_CRITICAL(&s_ow_mux);
-    return (presence == 0);  /* 0 = 디바이스 응답 */
-}
-
-static void ow_write_bit(int bit)
-{
-    portENTER_CRITICAL(&s_ow_mux);
-    ow_set_output(0);
-    if (bit) {
-        ow_delay_us(OW_WRITE_1_LOW_US);
-        ow_set_output(1);
-        ow_delay_us(OW_WRITE_SLOT_US - OW_WRITE_1_LOW_US);
-    } else {
-        ow_delay_us(OW_WRITE_0_LOW_US);
-        ow_set_output(1);
-    }
-    ow_delay_us(2);
-    portEXIT_CRITICAL(&s_ow_mux);
-}
-
-static int ow_read_bit(void)
-{
-    portENTER_CRITICAL(&s_ow_mux);
-    ow_set_output(0);
-    ow_delay_us(OW_READ_INIT_US);
-    ow_read_input();
-    ow_delay_us(OW_READ_SAMPLE_US - OW_READ_INIT_US);
-    int val = ow_read_input();
-    ow_delay_us(OW_READ_SLOT_US);
-    portEXIT_CRITICAL(&s_ow_mux);
-    return val;
-}
+/* 비동기 변환 상태 — 최대 변환 시간에 esp_timer가 대기 태스크를 깨움 */
+static esp_timer_handle_t s_conv_timer = NULL;
+static SemaphoreHandle_t s_conv_sem = NULL;
+static bool s_conv_pending = false;
+static uint8_t s_conv_buses = 0;     /* 완료 비트를 아직 확인할 버스 (비트마스크) */
+static int64_t s_conv_start_us = 0;
+static uint32_t s_conv_max_ms = CONVERSION_DELAY_MS;  /* 진행 중 변환의 최대 시간 */
 
-static void ow_write_byte(uint8_t byte)
+/* 해상도별 최대 변환 시간 (데이터시트: 93.75 / 187.5 / 375 / 750 ms, 올림) */
+uint32_t ds18b20_conversion_ms(uint8_t bits)
 {
-    for (int i = 0; i < 8; i++) {
-        ow_write_bit(byte & 0x01);
-        byte >>= 1;
-    }
+    if (bits < DS18B20_RES_MIN || bits > DS18B20_RES_MAX) bits = DS18B20_RES_MAX;
+    int shift = DS18B20_RES_MAX - bits;
+    return (CONVERSION_DELAY_MS + (1u << shift) - 1) >> shift;
 }
 
-static uint8_t ow_read_byte(void)
+/* 최대 변환 시간 경과 (esp_timer 태스크) */
+static void conv_timer_cb(void *arg)
 {
-    uint8_t byte = 0;
-    for (int i = 0; i < 8; i++) {
-        byte |= (ow_read_bit() << i);
-    }
-    return byte;
-}
-
-/* Dallas CRC8 (polynomial 0x8C reflected) */
-static uint8_t ds_crc8(const uint8_t *data, size_t len)
-{
-    uint8_t crc = 0;
-    for (size_t i = 0; i < len; i++) {
-        uint8_t byte = data[i];
-        for (int b = 0; b < 8; b++) {
-            uint8_t mix = (crc ^ byte) & 0x01;
-            crc >>= 1;
-            if (mix) crc ^= 0x8C;
-            byte >>= 1;
-        }
-    }
-    return crc;
+    xSemaphoreGive(s_conv_sem);
 }
 
 /* --- 공개 API --- */
 
-esp_err_t ds18b20_init(gpio_num_t data_gpio, gpio_num_t power_gpio)
+esp_err_t ds18b20_init(gpio_num_t data_gpio, gpio_num_t power_gpio,
+                       onewire_backend_t backend)
 {
-    s_data_gpio = data_gpio;
     s_power_gpio = power_gpio;
     s_sensor_count = 0;
+    s_bus_count = 0;
     memset(s_sensors, 0, sizeof(s_sensors));
 
-    /* 데이터 핀: 오픈 드레인 + 외부 풀업 */
-    gpio_config_t io_conf = {
-        .pin_bit_mask = (1ULL << data_gpio),
-        .mode = GPIO_MODE_INPUT,
-        .pull_up_en = GPIO_PULLUP_ENABLE,
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_DISABLE,
-    };
-    gpio_config(&io_conf);
+    esp_err_t ret = ds18b20_add_bus(data_gpio, backend);
+    if (ret != ESP_OK) return ret;
 
     /* 전원 제어 핀 (Type B) */
     if (power_gpio != GPIO_NUM_NC) {
@@ -170,12 +86,49 @@ esp_err_t ds18b20_init(gpio_num_t data_gpio, gpio_num_t power_gpio)
         gpio_set_level(power_gpio, 0);  /* 초기: OFF */
     }
 
+    if (s_conv_sem == NULL) {
+        s_conv_sem = xSemaphoreCreateBinary();
+        if (s_conv_sem == NULL) return ESP_ERR_NO_MEM;
+    }
+    if (s_conv_timer == NULL) {
+        const esp_timer_create_args_t targs = {
+            .callback = conv_timer_cb,
+            .name = "ds18b20",
+        };
+        ret = esp_timer_create(&targs, &s_conv_timer);
+        if (ret != ESP_OK) return ret;
+    }
+    s_conv_pending = false;
+
     s_initialized = true;
-    ESP_LOGI(TAG, "DS18B20 initialized, data=GPIO%d, power=GPIO%d",
-             data_gpio, (power_gpio != GPIO_NUM_NC) ? power_gpio : -1);
+    ESP_LOGI(TAG, "DS18B20 initialized, power=GPIO%d",
+             (power_gpio != GPIO_NUM_NC) ? power_gpio : -1);
     return ESP_OK;
 }
 
+esp_err_t ds18b20_add_bus(gpio_num_t data_gpio, onewire_backend_t backend)
+{
+    if (s_bus_count >= DS18B20_MAX_BUSES) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    /* 데이터 핀: 오픈 드레인 + 외부 풀업 (RMT 채널이 없으면 bit-bang) */
+    ds_bus_t *b = &s_buses[s_bus_count];
+    esp_err_t ret = onewire_bus_new(backend, data_gpio, &b->bus, &b->backend);
+    if (ret != ESP_OK) return ret;
+    b->gpio = data_gpio;
+
+    ESP_LOGI(TAG, "Bus %d: GPIO%d (%s)", s_bus_count, data_gpio,
+             (b->backend == ONEWIRE_BACKEND_RMT) ? "RMT" : "bit-bang");
+    s_bus_count++;
+    return ESP_OK;
+}
+
+int ds18b20_bus_count(void)
+{
+    return s_bus_count;
+}
+
 esp_err_t ds18b20_power_on(void)
 {
     if (s_power_gpio == GPIO_NUM_NC) {
@@ -204,72 +157,38 @@ esp_err_t ds18b20_search(int *count)
     }
 
     s_sensor_count = 0;
-    uint8_t last_discrepancy = 0;
-    bool search_done = false;
-    uint8_t rom[8] = {0};
-
-    while (!search_done && s_sensor_count < DS18B20_MAX_SENSORS) {
-        if (!ow_reset()) {
-            ESP_LOGW(TAG, "No device response on bus");
-            break;
-        }
-
-        ow_write_byte(CMD_SEARCH_ROM);
-        uint8_t discrepancy_marker = 0;
-
-        for (int bit_num = 1; bit_num <= 64; bit_num++) {
-            int id_bit     = ow_read_bit();
-            int cmp_id_bit = ow_read_bit();
-
-            int byte_idx = (bit_num - 1) / 8;
-            int bit_mask = 1 << ((bit_num - 1) % 8);
-
-            if (id_bit == 1 && cmp_id_bit == 1) {
-                /* 디바이스 없음 */
-                break;
-            }
-
-            int direction;
-            if (id_bit != cmp_id_bit) {
-                direction = id_bit;
-            } else {
-                /* 충돌 */
-                if (bit_num < last_discrepancy) {
-                    direction = (rom[byte_idx] & bit_mask) ? 1 : 0;
-                } else if (bit_num == last_discrepancy) {
-                    direction = 1;
-                } else {
-                    direction = 0;
-                }
-                if (direction == 0) {
-                    discrepancy_marker = bit_num;
-                }
-            }
-
-            if (direction) {
-                rom[byte_idx] |= bit_mask;
-            } else {
-                rom[byte_idx] &= ~bit_mask;
+    memset(s_sensors, 0, sizeof(s_sensors));
+    uint8_t rom[ONEWIRE_ROM_LEN];
+
+    for (int b = 0; b < s_bus_count && s_sensor_count < DS18B20_MAX_SENSORS; b++) {
+        onewire_search_t search;
+        onewire_search_init(&search);
+        int found = 0;
+
+        while (s_sensor_count < DS18B20_MAX_SENSORS) {
+            esp_err_t ret = onewire_search_next(&s_buses[b].bus, &search, rom);
+            if (ret == ESP_ERR_INVALID_CRC) {
+                ESP_LOGW(TAG, "Bus %d: ROM CRC mismatch, skipped", b);
+                continue;
             }
-
-            ow_write_bit(direction);
-        }
-
-        /* CRC 검증 */
-        if (ds_crc8(rom, 7) == rom[7]) {
-            memcpy(s_sensors[s_sensor_count].rom, rom, 8);
-            s_sensors[s_sensor_count].valid = true;
-            ESP_LOGI(TAG, "Found sensor %d: %02X%02X%02X%02X%02X%02X%02X%02X",
-                     s_sensor_count,
+            if (ret != ESP_OK) break;
+
+            ds18b20_sensor_t *sn = &s_sensors[s_sensor_count];
+            memcpy(sn->rom, rom, ONEWIRE_ROM_LEN);
+            sn->bus = (uint8_t)b;
+            sn->valid = true;
+            sn->resolution = DS18B20_RES_MAX;  /* 전원 투입 기본값 */
+            ESP_LOGI(TAG, "Found sensor %d (bus %d): %02X%02X%02X%02X%02X%02X%02X%02X",
+                     s_sensor_count, b,
                      rom[0], rom[1], rom[2], rom[3],
                      rom[4], rom[5], rom[6], rom[7]);
             s_sensor_count++;
+            found++;
         }
-
-        last_discrepancy = discrepancy_marker;
-        if (last_discrepancy == 0) {
-            search_done = true;
-        }
+        if (found == 0) ESP_LOGW(TAG, "Bus %d: no device response", b);
+    }
+    if (s_sensor_count == DS18B20_MAX_SENSORS) {
+        ESP_LOGW(TAG, "Sensor table full (%d), rest ignored", DS18B20_MAX_SENSORS);
     }
 
     *count = s_sensor_count;
@@ -277,68 +196,218 @@ esp_err_t ds18b20_search(int *count)
     return ESP_OK;
 }
 
+/* 센서가 하나라도 있는 버스 (센서 표가 비었으면 모든 버스) */
+static uint8_t used_buses(void)
+{
+    uint8_t mask = 0;
+    for (int i = 0; i < s_sensor_count; i++) mask |= (uint8_t)(1u << s_sensors[i].bus);
+    return (s_sensor_count > 0) ? mask : (uint8_t)((1u << s_bus_count) - 1);
+}
+
+esp_err_t ds18b20_attach(const uint8_t rom[][ONEWIRE_ROM_LEN], const uint8_t *bus, int count)
+{
+    if (!s_initialized || rom == NULL || bus == NULL || count <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_sensor_count = 0;
+    memset(s_sensors, 0, sizeof(s_sensors));
+    if (count > DS18B20_MAX_SENSORS) count = DS18B20_MAX_SENSORS;
+    for (int i = 0; i < count; i++) {
+        if (bus[i] >= s_bus_count) {
+            return ESP_ERR_INVALID_ARG;   /* 버스 구성이 바뀜 → 검색 */
+        }
+        memcpy(s_sensors[i].rom, rom[i], ONEWIRE_ROM_LEN);
+        s_sensors[i].bus = bus[i];
+        s_sensors[i].valid = true;
+        s_sensors[i].resolution = DS18B20_RES_MAX;  /* 전원 투입 기본값 */
+    }
+
+    /* 센서가 있는 버스마다 리셋 한 번 */
+    uint8_t mask = 0;
+    for (int i = 0; i < count; i++) mask |= (uint8_t)(1u << bus[i]);
+    for (int b = 0; b < s_bus_count; b++) {
+        if ((mask & (1u << b)) && !onewire_reset(&s_buses[b].bus)) {
+            ESP_LOGW(TAG, "Bus %d: no device response", b);
+            return ESP_ERR_NOT_FOUND;
+        }
+    }
+    s_sensor_count = count;
+    ESP_LOGD(TAG, "Attached %d cached sensor(s)", count);
+    return ESP_OK;
+}
+
 esp_err_t ds18b20_start_conversion(void)
 {
     if (!s_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
 
-    if (!ow_reset()) {
+    /* 버스마다 SKIP ROM 한 번으로 그 버스의 모든 센서 동시 변환 */
+    uint8_t started = 0;
+    uint8_t mask = used_buses();
+    for (int b = 0; b < s_bus_count; b++) {
+        if ((mask & (1u << b)) && onewire_select(&s_buses[b].bus, NULL, CMD_CONVERT_T) == ESP_OK) {
+            started |= (uint8_t)(1u << b);
+        }
+    }
+    if (started == 0) {
         return ESP_ERR_NOT_FOUND;
     }
 
-    ow_write_byte(CMD_SKIP_ROM);   /* 모든 센서에 동시 명령 */
-    ow_write_byte(CMD_CONVERT_T);
+    /* 동시 변환 — 가장 정밀한 센서의 변환 시간이 기준 */
+    s_conv_max_ms = (s_sensor_count > 0) ? 0 : CONVERSION_DELAY_MS;
+    for (int i = 0; i < s_sensor_count; i++) {
+        uint32_t ms = ds18b20_conversion_ms(s_sensors[i].resolution);
+        if (ms > s_conv_max_ms) s_conv_max_ms = ms;
+    }
+
+    s_conv_start_us = esp_timer_get_time();
+    s_conv_pending = true;
+    s_conv_buses = started;
+    xSemaphoreTake(s_conv_sem, 0);  /* 이전 변환의 알림 제거 */
+    esp_timer_stop(s_conv_timer);
+    esp_timer_start_once(s_conv_timer, s_conv_max_ms * 1000ULL);
     return ESP_OK;
 }
 
-esp_err_t ds18b20_read_temp(int idx, float *temperature)
+esp_err_t ds18b20_set_resolution(int idx, uint8_t bits)
 {
-    if (!s_initialized || idx < 0 || idx >= s_sensor_count || temperature == NULL) {
+    if (!s_initialized || idx < -1 || idx >= s_sensor_count ||
+        bits < DS18B20_RES_MIN || bits > DS18B20_RES_MAX) {
         return ESP_ERR_INVALID_ARG;
     }
+    if (idx >= 0 && s_sensors[idx].resolution == bits) {
+        return ESP_OK;
+    }
 
-    if (!ow_reset()) {
-        return ESP_ERR_NOT_FOUND;
+    /* TH, TL (알람 미사용, 기본값), 설정 레지스터 R1:R0 — EEPROM 복사 없음 */
+    const uint8_t cfg[3] = { 0x4B, 0x46, (uint8_t)(((bits - DS18B20_RES_MIN) << 5) | 0x1F) };
+    uint8_t mask = (idx < 0) ? used_buses() : (uint8_t)(1u << s_sensors[idx].bus);
+    for (int b = 0; b < s_bus_count; b++) {
+        if (!(mask & (1u << b))) continue;
+        /* 전체면 버스마다 SKIP ROM */
+        esp_err_t ret = onewire_select(&s_buses[b].bus, (idx < 0) ? NULL : s_sensors[idx].rom,
+                                       CMD_WRITE_SCRATCH);
+        if (ret == ESP_OK) {
+            ret = onewire_write(&s_buses[b].bus, cfg, sizeof(cfg));
+        }
+        if (ret != ESP_OK) {
+            return ret;
+        }
     }
 
-    /* 특정 센서 선택 */
-    ow_write_byte(CMD_MATCH_ROM);
-    for (int i = 0; i < 8; i++) {
-        ow_write_byte(s_sensors[idx].rom[i]);
+    for (int i = 0; i < s_sensor_count; i++) {
+        if (idx < 0 || i == idx) s_sensors[i].resolution = bits;
     }
+    ESP_LOGD(TAG, "Resolution %d-bit (sensor %d)", bits, idx);
+    return ESP_OK;
+}
 
-    /* Scratchpad 읽기 */
-    ow_write_byte(CMD_READ_SCRATCH);
-    uint8_t scratch[9];
-    for (int i = 0; i < 9; i++) {
-        scratch[i] = ow_read_byte();
+bool ds18b20_conversion_done(void)
+{
+    if (!s_conv_pending) return true;
+
+    /*
+     * 버스에 변환 중인 센서가 하나라도 있으면 read slot이 0 (wired-AND).
+     * 읽기 실패는 미완료로 두고 최대 변환 시간에 맡긴다 (이른 읽기 = 이전 값/85°C).
+     */
+    for (int b = 0; b < s_bus_count; b++) {
+        int bit = 0;
+        if ((s_conv_buses & (1u << b)) && onewire_read_bit(&s_buses[b].bus, &bit) == ESP_OK &&
+            bit == 1) {
+            s_conv_buses &= (uint8_t)~(1u << b);
+        }
+    }
+    if (s_conv_buses == 0 || esp_timer_get_time() - s_conv_start_us >= s_conv_max_ms * 1000LL) {
+        s_conv_pending = false;
+        s_conv_buses = 0;
+        esp_timer_stop(s_conv_timer);
+    }
+    return !s_conv_pending;
+}
+
+esp_err_t ds18b20_wait_conversion(uint32_t timeout_ms)
+{
+    if (!s_initialized) {
+        return ESP_ERR_INVALID_STATE;
     }
 
-    /* CRC 검증 */
-    if (ds_crc8(scratch, 8) != scratch[8]) {
+    int64_t deadline = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    while (!ds18b20_conversion_done()) {
+        if (esp_timer_get_time() >= deadline) {
+            return ESP_ERR_TIMEOUT;
+        }
+        /* 완료 비트 폴링 간격만큼 대기, 최대 변환 시간이면 타이머가 즉시 깨움 */
+        xSemaphoreTake(s_conv_sem, pdMS_TO_TICKS(CONVERSION_POLL_MS));
+    }
+    return ESP_OK;
+}
+
+esp_err_t ds18b20_read_temp(int idx, float *temperature)
+{
+    if (!s_initialized || idx < 0 || idx >= s_sensor_count || temperature == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* 특정 센서 선택 + Scratchpad 읽기 */
+    ds18b20_sensor_t *sn = &s_sensors[idx];
+    const onewire_bus_t *bus = &s_buses[sn->bus].bus;
+    uint8_t scratch[9];
+    esp_err_t ret = onewire_select(bus, sn->rom, CMD_READ_SCRATCH);
+    if (ret == ESP_OK) {
+        ret = onewire_read(bus, scratch, sizeof(scratch));
+    }
+    /* CRC 검증 (응답 없는 센서는 0xFF만 읽혀 여기서 걸림) */
+    if (ret == ESP_OK && onewire_crc8(scratch, 8) != scratch[8]) {
         ESP_LOGE(TAG, "Scratchpad CRC mismatch (sensor %d)", idx);
-        return ESP_ERR_INVALID_CRC;
+        ret = ESP_ERR_INVALID_CRC;
+    }
+    sn->valid = (ret == ESP_OK);
+    if (ret != ESP_OK) {
+        return ret;
     }
 
-    /* 12비트 해상도 변환 */
-    int16_t raw = (scratch[1] << 8) | scratch[0];
+    /* 1/16°C 단위, 낮은 해상도에서는 하위 비트가 미정의 → 마스크 */
+    uint8_t bits = s_sensors[idx].resolution;
+    if (bits < DS18B20_RES_MIN || bits > DS18B20_RES_MAX) bits = DS18B20_RES_MAX;
+    int16_t raw = (int16_t)((scratch[1] << 8) | scratch[0]);
+    raw &= (int16_t)~((1 << (DS18B20_RES_MAX - bits)) - 1);
     *temperature = (float)raw / 16.0f;
     s_sensors[idx].temperature = *temperature;
 
     return ESP_OK;
 }
 
+int ds18b20_read_all(void)
+{
+    /* 변환이 끝난 뒤 센서 순서대로 연달아 읽기 (사이에 다른 버스 트랜잭션 없음) */
+    int ok = 0;
+    for (int i = 0; i < s_sensor_count; i++) {
+        float t;
+        if (ds18b20_read_temp(i, &t) == ESP_OK) ok++;
+    }
+    return ok;
+}
+
 const ds18b20_sensor_t *ds18b20_get_sensors(void)
 {
     return s_sensors;
 }
 
+int ds18b20_get_count(void)
+{
+    return s_sensor_count;
+}
+
 esp_err_t ds18b20_deinit(void)
 {
     if (!s_initialized) {
         return ESP_OK;
     }
+    if (s_conv_timer != NULL) esp_timer_stop(s_conv_timer);
+    s_conv_pending = false;
+    s_conv_buses = 0;
     ds18b20_power_off();
     s_initialized = false;
     s_sensor_count = 0;
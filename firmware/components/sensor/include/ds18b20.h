@@ -7,25 +7,48 @@
 
 #include "esp_err.h"
 #include "driver/gpio.h"
+#include "onewire_backend.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-#define DS18B20_MAX_SENSORS 2
+/* 센서 표 (모든 버스 합계) / 1-Wire 버스(데이터 핀) 수 */
+#define DS18B20_MAX_SENSORS 8
+#define DS18B20_MAX_BUSES   ONEWIRE_BUS_MAX
+
+/* 변환 해상도 (비트): 9 = 0.5°C 94 ms ... 12 = 0.0625°C 750 ms */
+#define DS18B20_RES_MIN 9
+#define DS18B20_RES_MAX 12
 
 typedef struct {
     uint8_t rom[8];     /* 64-bit ROM 코드 */
     float   temperature;
-    bool    valid;
+    bool    valid;      /* 검색/attach 직후 true, 이후 마지막 읽기 성공 여부 */
+    uint8_t resolution; /* 현재 설정 해상도 (비트) */
+    uint8_t bus;        /* 버스 인덱스 (ds18b20_init = 0, ds18b20_add_bus 순서) */
 } ds18b20_sensor_t;
 
 /**
- * @brief DS18B20 초기화
+ * @brief DS18B20 초기화 (버스 0)
  * @param data_gpio 1-Wire 데이터 핀
  * @param power_gpio 전원 제어 핀 (Type B), GPIO_NUM_NC이면 상시 전원
+ * @param backend 1-Wire 전송 (RMT 채널을 못 잡으면 GPIO bit-bang으로 대체)
+ */
+esp_err_t ds18b20_init(gpio_num_t data_gpio, gpio_num_t power_gpio,
+                       onewire_backend_t backend);
+
+/**
+ * @brief 1-Wire 버스 추가 (다른 데이터 핀) — ds18b20_init 후, 검색 전에
+ * @note RMT 채널(ESP32-C6: 2개)이 모자라면 그 버스는 bit-bang으로 대체된다.
+ * @return ESP_ERR_NO_MEM DS18B20_MAX_BUSES 초과
  */
-esp_err_t ds18b20_init(gpio_num_t data_gpio, gpio_num_t power_gpio);
+esp_err_t ds18b20_add_bus(gpio_num_t data_gpio, onewire_backend_t backend);
+
+/** @brief 등록된 버스 수 */
+int ds18b20_bus_count(void);
 
 /** @brief 외부 전원 ON (Type B GPIO 스위칭) */
 esp_err_t ds18b20_power_on(void);
@@ -34,17 +57,56 @@ esp_err_t ds18b20_power_on(void);
 esp_err_t ds18b20_power_off(void);
 
 /**
- * @brief 버스 상의 센서 검색
- * @param[out] count 발견된 센서 수
+ * @brief 모든 버스의 센서 검색 (버스 순서, 버스 안에서는 ROM 검색 순서)
+ * @param[out] count 발견된 센서 수 (최대 DS18B20_MAX_SENSORS)
  */
 esp_err_t ds18b20_search(int *count);
 
 /**
- * @brief 온도 변환 시작 (모든 센서 동시)
- * 변환 완료까지 약 750ms 대기 필요
+ * @brief 알고 있는 ROM 코드로 센서 목록 설정 (검색 생략, rom_cache 등)
+ *
+ * 센서가 있는 버스마다 리셋 한 번으로 presence만 확인한다. 개별 센서가 빠졌는지는
+ * 읽기 실패(scratchpad CRC 불일치)로 드러나므로 그때 검색으로 돌아간다.
+ * @param bus   센서별 버스 인덱스
+ * @param count 최대 DS18B20_MAX_SENSORS개만 사용
+ * @return ESP_ERR_NOT_FOUND presence 없음, ESP_ERR_INVALID_ARG 없는 버스 (구성 변경)
+ */
+esp_err_t ds18b20_attach(const uint8_t rom[][ONEWIRE_ROM_LEN], const uint8_t *bus, int count);
+
+/**
+ * @brief 온도 변환 시작 (모든 센서 동시, 비동기)
+ *
+ * 센서가 있는 버스마다 SKIP ROM + Convert T 한 번 — 센서 수와 무관하게 버스당 명령 1회.
+ * 명령만 보내고 바로 반환한다. 최대 변환 시간(센서 중 최고 해상도 기준)에 esp_timer가
+ * ds18b20_wait_conversion() 대기를 깨우며, 그 전이라도 센서가 완료 비트를
+ * 내면 먼저 끝난다 (보통 750 ms보다 빠름). 변환 중 다른 작업 가능.
  */
 esp_err_t ds18b20_start_conversion(void);
 
+/**
+ * @brief 변환 해상도 설정 (scratchpad 설정 레지스터, EEPROM 저장 없음)
+ * @param idx  센서 인덱스, -1 = 버스 전체 (SKIP ROM 한 번)
+ * @param bits 9~12
+ * @note 센서 전원을 끄면 EEPROM 값(보통 12비트)으로 돌아가므로 전원 투입마다 다시 설정.
+ *       변환 대기 시간과 온도 환산은 설정된 해상도를 따른다.
+ */
+esp_err_t ds18b20_set_resolution(int idx, uint8_t bits);
+
+/** @brief 해상도별 최대 변환 시간 (ms) */
+uint32_t ds18b20_conversion_ms(uint8_t bits);
+
+/**
+ * @brief 변환 완료 여부 (대기 없음, 변환 중이면 read slot 1회로 완료 비트 확인)
+ * @note 상시 전원 전용 — 기생 전원이면 최대 변환 시간 경과로만 판정
+ */
+bool ds18b20_conversion_done(void);
+
+/**
+ * @brief 변환 완료까지 대기 (완료 비트 폴링 + 최대 변환 시간 타이머)
+ * @return ESP_OK 완료 (진행 중인 변환이 없어도), ESP_ERR_TIMEOUT
+ */
+esp_err_t ds18b20_wait_conversion(uint32_t timeout_ms);
+
 /**
  * @brief 센서 온도 읽기
  * @param idx 센서 인덱스 (0 ~ count-1)
@@ -53,10 +115,21 @@ esp_err_t ds18b20_start_conversion(void);
 esp_err_t ds18b20_read_temp(int idx, float *temperature);
 
 /**
- * @brief 전체 센서 데이터 가져오기
+ * @brief 모든 센서를 연달아 읽기 (변환 완료 후)
+ *
+ * 결과는 ds18b20_get_sensors()의 temperature / valid.
+ * @return 읽기에 성공한 센서 수
+ */
+int ds18b20_read_all(void);
+
+/**
+ * @brief 전체 센서 데이터 가져오기 (ds18b20_get_count()개)
  */
 const ds18b20_sensor_t *ds18b20_get_sensors(void);
 
+/** @brief 검색/attach로 등록된 센서 수 */
+int ds18b20_get_count(void);
+
 /** @brief 드라이버 해제 */
 esp_err_t ds18b20_deinit(void);
 
@@ -0,0 +1,46 @@
+/**
+ * @file onewire_backend.h
+ * @brief 1-Wire 백엔드 생성 (GPIO bit-bang / RMT)
+ */
+#ifndef RBMS_ONEWIRE_BACKEND_H
+#define RBMS_ONEWIRE_BACKEND_H
+
+#include "onewire_bus.h"
+#include "driver/gpio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 동시에 열 수 있는 버스 수 (백엔드별 정적 풀) — RMT는 RX 채널 수로 더 제한됨 */
+#define ONEWIRE_BUS_MAX 4
+
+typedef enum {
+    ONEWIRE_BACKEND_GPIO = 0,   /* bit-bang, 슬롯마다 임계 구역 */
+    ONEWIRE_BACKEND_RMT,        /* RMT TX/RX 채널 한 쌍, 트랜잭션 단위 하드웨어 타이밍 */
+} onewire_backend_t;
+
+/**
+ * @brief GPIO bit-bang 백엔드
+ * @note 슬롯 타이밍 동안 인터럽트를 막는다 (바이트당 ~0.6 ms).
+ */
+esp_err_t onewire_gpio_new(gpio_num_t gpio, onewire_bus_t *bus);
+
+/**
+ * @brief RMT 백엔드 (오픈 드레인 TX + 같은 핀 루프백 RX)
+ * @return ESP_ERR_NOT_FOUND 남은 RMT 채널 없음 (ESP32-C6: 버스 2개) 등 — 호출자는 GPIO 백엔드로 대체
+ */
+esp_err_t onewire_rmt_new(gpio_num_t gpio, onewire_bus_t *bus);
+
+/**
+ * @brief 백엔드 선택 생성, RMT 실패 시 GPIO bit-bang으로 대체
+ * @param[out] used 실제 사용한 백엔드 (NULL 가능)
+ */
+esp_err_t onewire_bus_new(onewire_backend_t backend, gpio_num_t gpio,
+                          onewire_bus_t *bus, onewire_backend_t *used);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_ONEWIRE_BACKEND_H */
@@ -0,0 +1,94 @@
+/**
+ * @file onewire_bus.h
+ * @brief 1-Wire 전송 계층 추상화
+ *
+ * 백엔드(GPIO bit-bang, RMT 주변장치)는 reset / 비트열 쓰기 / 비트열 읽기 세 가지만
+ * 구현하고, 바이트 단위 입출력·검색 트리플릿·ROM 검색·CRC는 이 계층이 공통으로 처리한다.
+ * 비트열 단위로 넘기므로 RMT 백엔드는 여러 바이트를 트랜잭션 한 번으로 보낸다.
+ *
+ * 백엔드 생성은 onewire_backend.h.
+ */
+#ifndef RBMS_ONEWIRE_BUS_H
+#define RBMS_ONEWIRE_BUS_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ROM 커맨드 */
+#define ONEWIRE_CMD_SEARCH_ROM  0xF0
+#define ONEWIRE_CMD_MATCH_ROM   0x55
+#define ONEWIRE_CMD_SKIP_ROM    0xCC
+
+#define ONEWIRE_ROM_LEN 8
+
+/* 백엔드 연산 — 비트는 LSB 먼저, data[i / 8]의 (i % 8)번째 비트 */
+typedef struct {
+    /** @brief 리셋 펄스, true = presence 응답 */
+    bool      (*reset)(void *ctx);
+    esp_err_t (*write_bits)(void *ctx, const uint8_t *data, size_t nbits);
+    /** @brief read slot nbits개 (응답 없는 슬롯은 1) */
+    esp_err_t (*read_bits)(void *ctx, uint8_t *data, size_t nbits);
+} onewire_ops_t;
+
+typedef struct {
+    const onewire_ops_t *ops;
+    void *ctx;
+} onewire_bus_t;
+
+/* ROM 검색 상태 (호출자 소유) */
+typedef struct {
+    uint8_t rom[ONEWIRE_ROM_LEN];
+    int     last_discrepancy;   /* 마지막으로 0을 고른 충돌 비트 (1~64), 0 = 없음 */
+    bool    done;
+} onewire_search_t;
+
+bool      onewire_reset(const onewire_bus_t *bus);
+esp_err_t onewire_write(const onewire_bus_t *bus, const uint8_t *data, size_t len);
+esp_err_t onewire_read(const onewire_bus_t *bus, uint8_t *data, size_t len);
+esp_err_t onewire_write_bit(const onewire_bus_t *bus, int bit);
+/**
+ * @param[out] bit 0/1 — 전송 실패(RMT 수신 타임아웃 등)면 건드리지 않음
+ * @note 실패를 1(유휴 레벨)로 보면 변환 완료로 오인하므로 호출자가 구분한다.
+ */
+esp_err_t onewire_read_bit(const onewire_bus_t *bus, int *bit);
+
+/**
+ * @brief 검색 트리플릿: ID 비트와 보수 비트를 읽고 진행 방향을 써서 해당 디바이스만 남긴다
+ * @param preferred 충돌(두 비트 모두 0)일 때 쓸 방향
+ * @param[out] id_bit, cmp_bit 읽은 두 비트
+ * @param[out] direction 실제로 쓴 방향 (둘 다 1이면 쓰지 않음)
+ */
+esp_err_t onewire_triplet(const onewire_bus_t *bus, int preferred,
+                          int *id_bit, int *cmp_bit, int *direction);
+
+void onewire_search_init(onewire_search_t *s);
+
+/**
+ * @brief 다음 디바이스 ROM 검색
+ * @param[out] rom 찾은 ROM 코드
+ * @return ESP_OK, ESP_ERR_NOT_FOUND 더 없음/응답 없음, ESP_ERR_INVALID_CRC ROM CRC 불일치
+ *         (CRC 불일치여도 검색 상태는 진행하므로 계속 호출 가능)
+ */
+esp_err_t onewire_search_next(const onewire_bus_t *bus, onewire_search_t *s,
+                              uint8_t rom[ONEWIRE_ROM_LEN]);
+
+/**
+ * @brief 리셋 + ROM 선택 (rom == NULL이면 SKIP ROM) + 커맨드 바이트
+ * @return ESP_ERR_NOT_FOUND presence 없음
+ */
+esp_err_t onewire_select(const onewire_bus_t *bus, const uint8_t *rom, uint8_t cmd);
+
+/** @brief Dallas CRC8 (다항식 x^8+x^5+x^4+1, reflected 0x8C) */
+uint8_t onewire_crc8(const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_ONEWIRE_BUS_H */
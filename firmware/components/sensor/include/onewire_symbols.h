@@ -0,0 +1,71 @@
+/**
+ * @file onewire_symbols.h
+ * @brief 1-Wire 타임 슬롯 ↔ RMT 심볼 변환
+ *
+ * RMT 백엔드가 바이트/트리플릿 전체를 한 번에 보내고 받도록 슬롯 단위로 심볼을 만들고,
+ * 루프백으로 수신한 라인 파형에서 presence와 read 비트를 복원한다.
+ * 해상도 1 MHz (duration = us).
+ */
+#ifndef RBMS_ONEWIRE_SYMBOLS_H
+#define RBMS_ONEWIRE_SYMBOLS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 타이밍 (us) — 표준 속도 */
+#define OW_SYM_RESET_LOW_US     480
+#define OW_SYM_RESET_HIGH_US    480   /* presence 응답 + 복구 */
+#define OW_SYM_SLOT_US          70    /* 슬롯 + 복구 */
+#define OW_SYM_WRITE_1_LOW_US   6
+#define OW_SYM_WRITE_0_LOW_US   60
+#define OW_SYM_READ_LOW_US      6
+/* read slot 샘플 시점: 이보다 짧은 low = 1 (디바이스가 잡지 않음) */
+#define OW_SYM_READ_SAMPLE_US   15
+/* presence 펄스 판정 범위 (데이터시트 60~240 us, 여유 포함) */
+#define OW_SYM_PRESENCE_MIN_US  40
+#define OW_SYM_PRESENCE_MAX_US  300
+
+/* rmt_symbol_word_t와 같은 비트 배치 (level 0 = low) */
+typedef union {
+    struct {
+        uint16_t duration0 : 15;
+        uint16_t level0 : 1;
+        uint16_t duration1 : 15;
+        uint16_t level1 : 1;
+    };
+    uint32_t val;
+} ow_symbol_t;
+
+/** @brief 리셋 펄스 심볼 1개 */
+size_t ow_sym_encode_reset(ow_symbol_t *out);
+
+/**
+ * @brief 쓰기 슬롯 심볼 (비트 하나에 심볼 하나, LSB 먼저)
+ * @return 쓴 심볼 수 (= nbits)
+ */
+size_t ow_sym_encode_bits(const uint8_t *data, size_t nbits, ow_symbol_t *out);
+
+/** @brief read slot 심볼 nbits개 (쓰기 1 슬롯과 같은 파형) */
+size_t ow_sym_encode_read(size_t nbits, ow_symbol_t *out);
+
+/** @brief 리셋 후 수신 파형에 presence 펄스가 있는지 */
+bool ow_sym_decode_presence(const ow_symbol_t *rx, size_t n_rx);
+
+/**
+ * @brief read slot 수신 파형에서 비트 복원
+ * @param out     결과 비트열, bit_off 번째 비트부터 nbits개 기록
+ * @return 복원한 비트 수 — 모자라면 나머지 비트는 1 (응답 없음)
+ */
+size_t ow_sym_decode_bits(const ow_symbol_t *rx, size_t n_rx,
+                          uint8_t *out, size_t bit_off, size_t nbits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_ONEWIRE_SYMBOLS_H */
@@ -0,0 +1,60 @@
+/**
+ * @file rom_cache.h
+ * @brief 1-Wire ROM 코드 캐시 (Type B wake 간 ROM 검색 생략)
+ *
+ * 검색으로 찾은 ROM 목록을 CRC와 함께 보관한다. Type B는 RTC_DATA_ATTR에 두고
+ * (전원 투입 후에는 NVS 사본), 유효하면 검색 대신 리셋 한 번으로 presence만 확인한다.
+ * 주기(rescan_every회 사용)가 차거나 rom_cache_request_rescan()이 불리면 다시 검색.
+ *
+ * 구조체 그대로 NVS blob으로 저장하므로 필드 배치를 바꾸면 ROM_CACHE_MAGIC도 바꾼다.
+ */
+#ifndef RBMS_ROM_CACHE_H
+#define RBMS_ROM_CACHE_H
+
+#include "onewire_bus.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ROM_CACHE_MAX    8
+#define ROM_CACHE_MAGIC  0x524F4D32u   /* "ROM2" (버스 인덱스 추가) */
+
+typedef struct {
+    uint32_t magic;
+    uint8_t  count;
+    uint8_t  rescan;      /* 1 = 다음 사용 때 검색 (읽기 실패, 원격 명령) */
+    uint16_t uses;        /* 마지막 검색 이후 캐시로 건너뛴 횟수 */
+    uint8_t  rom[ROM_CACHE_MAX][ONEWIRE_ROM_LEN];
+    uint8_t  bus[ROM_CACHE_MAX];   /* ROM별 1-Wire 버스 인덱스 */
+    uint32_t crc;         /* 앞 필드 전체의 CRC-32 */
+} rom_cache_t;
+
+/** @brief 매직·개수·CRC(전체 + ROM별 CRC-8) 확인 — 초기화 안 된 RTC/NVS 내용 거부 */
+bool rom_cache_valid(const rom_cache_t *c);
+
+/**
+ * @brief 검색 결과 저장 (사용 횟수·재검색 요청 초기화)
+ * @param bus 센서별 버스 인덱스
+ * @return ROM/버스 목록이 이전 유효 내용과 다르면 true (NVS 사본 갱신 필요)
+ */
+bool rom_cache_store(rom_cache_t *c, const uint8_t rom[][ONEWIRE_ROM_LEN],
+                     const uint8_t *bus, int count);
+
+/**
+ * @brief 이번 wake에 캐시를 쓸지 결정하고 사용 횟수 증가
+ * @param rescan_every 이 횟수만큼 쓰면 검색 (0 = 주기 검색 없음)
+ * @return 쓸 수 있는 ROM 수, 0이면 검색 필요
+ */
+int rom_cache_take(rom_cache_t *c, uint16_t rescan_every);
+
+/** @brief 다음 rom_cache_take()에서 검색하도록 표시 */
+void rom_cache_request_rescan(rom_cache_t *c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_ROM_CACHE_H */
@@ -0,0 +1,67 @@
+/**
+ * @file sensor_roles.h
+ * @brief DS18B20 역할 매핑 (ROM 코드 → HOT/COOL/보조)
+ *
+ * 검색 순서(ROM 값 순)는 프로브를 더하거나 바꾸면 달라지므로 역할을 인덱스가 아니라
+ * ROM 코드로 기억한다. 역할 r의 ROM을 map.rom[r]에 두고 NVS blob으로 저장한다.
+ *   - 알고 있는 ROM은 같은 역할 유지 (버스를 옮겨 꽂아도)
+ *   - 새 ROM은 지금 있는 센서가 쓰지 않는 가장 낮은 역할을 받는다
+ *     → HOT 프로브 교체 시 새 프로브가 HOT을 이어받음
+ *   - 원격 명령(sensor_roles_swap)으로 잘못 꽂힌 HOT/COOL을 바로잡는다
+ *
+ * 구조체 그대로 NVS blob으로 저장하므로 필드 배치를 바꾸면 SENSOR_ROLES_MAGIC도 바꾼다.
+ */
+#ifndef RBMS_SENSOR_ROLES_H
+#define RBMS_SENSOR_ROLES_H
+
+#include "onewire_bus.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SENSOR_ROLE_HOT    0      /* 핫존 (히터 제어) */
+#define SENSOR_ROLE_COOL   1      /* 쿨존 */
+/* 2 ~ SENSOR_ROLE_MAX-1: 보조 프로브 (은신처, 바닥 등 — 로그/조회용) */
+#define SENSOR_ROLE_MAX    8
+#define SENSOR_ROLE_NONE   0xFF
+
+#define SENSOR_ROLES_MAGIC 0x524F4C31u   /* "ROL1" */
+
+typedef struct {
+    uint32_t magic;
+    uint8_t  rom[SENSOR_ROLE_MAX][ONEWIRE_ROM_LEN];   /* 0 = 빈 역할 */
+} sensor_role_map_t;
+
+/** @brief 빈 매핑 */
+void sensor_roles_init(sensor_role_map_t *map);
+
+/** @brief 매직·ROM CRC-8 확인 (NVS에서 읽은 내용 검증) */
+bool sensor_roles_valid(const sensor_role_map_t *map);
+
+/**
+ * @brief 발견된 센서에 역할 부여 (매핑이 무효면 새로 시작)
+ * @param rom   센서 ROM 코드 (검색/attach 순서)
+ * @param count 센서 수
+ * @param[out] role_of 센서별 역할 (역할이 모자라면 SENSOR_ROLE_NONE)
+ * @return 매핑이 바뀌었으면 true (NVS 저장 필요)
+ */
+bool sensor_roles_assign(sensor_role_map_t *map, const uint8_t rom[][ONEWIRE_ROM_LEN],
+                         int count, uint8_t *role_of);
+
+/**
+ * @brief 두 역할의 ROM 교환 (다음 sensor_roles_assign부터 반영)
+ * @return 범위 밖이거나 같은 역할이면 false
+ */
+bool sensor_roles_swap(sensor_role_map_t *map, uint8_t a, uint8_t b);
+
+/** @brief 역할을 가진 센서 인덱스, 없으면 -1 */
+int sensor_roles_index(const uint8_t *role_of, int count, uint8_t role);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RBMS_SENSOR_ROLES_H */
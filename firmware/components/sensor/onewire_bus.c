@@ -0,0 +1,145 @@
+/**
+ * @file onewire_bus.c
+ * @brief 1-Wire 전송 계층 공통 처리 (바이트 입출력, 검색, CRC)
+ */
+#include "onewire_bus.h"
+#include <string.h>
+
+bool onewire_reset(const onewire_bus_t *bus)
+{
+    return bus->ops->reset(bus->ctx);
+}
+
+esp_err_t onewire_write(const onewire_bus_t *bus, const uint8_t *data, size_t len)
+{
+    return bus->ops->write_bits(bus->ctx, data, len * 8);
+}
+
+esp_err_t onewire_read(const onewire_bus_t *bus, uint8_t *data, size_t len)
+{
+    return bus->ops->read_bits(bus->ctx, data, len * 8);
+}
+
+esp_err_t onewire_write_bit(const onewire_bus_t *bus, int bit)
+{
+    uint8_t b = bit ? 1 : 0;
+    return bus->ops->write_bits(bus->ctx, &b, 1);
+}
+
+esp_err_t onewire_read_bit(const onewire_bus_t *bus, int *bit)
+{
+    uint8_t b = 0;
+    esp_err_t ret = bus->ops->read_bits(bus->ctx, &b, 1);
+    if (ret == ESP_OK) *bit = b & 0x01;
+    return ret;
+}
+
+esp_err_t onewire_triplet(const onewire_bus_t *bus, int preferred,
+                          int *id_bit, int *cmp_bit, int *direction)
+{
+    /* 두 read slot을 한 번에 (RMT: 트랜잭션 1회) */
+    uint8_t bits = 0x03;
+    esp_err_t ret = bus->ops->read_bits(bus->ctx, &bits, 2);
+    if (ret != ESP_OK) return ret;
+
+    *id_bit = bits & 0x01;
+    *cmp_bit = (bits >> 1) & 0x01;
+    if (*id_bit && *cmp_bit) {
+        *direction = 1;   /* 응답 디바이스 없음 */
+        return ESP_OK;
+    }
+    *direction = (*id_bit != *cmp_bit) ? *id_bit : (preferred ? 1 : 0);
+    return onewire_write_bit(bus, *direction);
+}
+
+void onewire_search_init(onewire_search_t *s)
+{
+    memset(s, 0, sizeof(*s));
+}
+
+esp_err_t onewire_search_next(const onewire_bus_t *bus, onewire_search_t *s,
+                              uint8_t rom[ONEWIRE_ROM_LEN])
+{
+    if (s->done || !onewire_reset(bus)) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    uint8_t cmd = ONEWIRE_CMD_SEARCH_ROM;
+    esp_err_t ret = onewire_write(bus, &cmd, 1);
+    if (ret != ESP_OK) return ret;
+
+    int discrepancy_marker = 0;
+    for (int bit_num = 1; bit_num <= 64; bit_num++) {
+        int byte_idx = (bit_num - 1) / 8;
+        uint8_t bit_mask = (uint8_t)(1 << ((bit_num - 1) % 8));
+
+        /* 충돌 시: 이전 경로 유지 / 마지막 충돌 지점이면 1 / 새 충돌이면 0 */
+        int preferred;
+        if (bit_num < s->last_discrepancy) {
+            preferred = (s->rom[byte_idx] & bit_mask) ? 1 : 0;
+        } else {
+            preferred = (bit_num == s->last_discrepancy);
+        }
+
+        int id_bit, cmp_bit, direction;
+        ret = onewire_triplet(bus, preferred, &id_bit, &cmp_bit, &direction);
+        if (ret != ESP_OK) return ret;
+        if (id_bit && cmp_bit) {
+            /* 검색 중 디바이스 이탈 */
+            s->done = true;
+            return ESP_ERR_NOT_FOUND;
+        }
+        if (!id_bit && !cmp_bit && direction == 0) {
+            discrepancy_marker = bit_num;
+        }
+
+        if (direction) {
+            s->rom[byte_idx] |= bit_mask;
+        } else {
+            s->rom[byte_idx] &= (uint8_t)~bit_mask;
+        }
+    }
+
+    s->last_discrepancy = discrepancy_marker;
+    if (s->last_discrepancy == 0) {
+        s->done = true;
+    }
+
+    memcpy(rom, s->rom, ONEWIRE_ROM_LEN);
+    return (onewire_crc8(rom, 7) == rom[7]) ? ESP_OK : ESP_ERR_INVALID_CRC;
+}
+
+esp_err_t onewire_select(const onewire_bus_t *bus, const uint8_t *rom, uint8_t cmd)
+{
+    if (!onewire_reset(bus)) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    /* ROM 커맨드 + ROM + 기능 커맨드를 쓰기 한 번으로 */
+    uint8_t buf[2 + ONEWIRE_ROM_LEN];
+    size_t len = 0;
+    if (rom != NULL) {
+        buf[len++] = ONEWIRE_CMD_MATCH_ROM;
+        memcpy(&buf[len], rom, ONEWIRE_ROM_LEN);
+        len += ONEWIRE_ROM_LEN;
+    } else {
+        buf[len++] = ONEWIRE_CMD_SKIP_ROM;
+    }
+    buf[len++] = cmd;
+    return onewire_write(bus, buf, len);
+}
+
+uint8_t onewire_crc8(const uint8_t *data, size_t len)
+{
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        uint8_t byte = data[i];
+        for (int b = 0; b < 8; b++) {
+            uint8_t mix = (crc ^ byte) & 0x01;
+            crc >>= 1;
+            if (mix) crc ^= 0x8C;
+            byte >>= 1;
+        }
+    }
+    return crc;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file onewire_gpio.c
+ * @brief 1-Wire GPIO bit-bang 백엔드
+ *
+ * 슬롯마다 임계 구역 안에서 busy-wait로 타이밍을 만든다. RMT 채널이 없을 때의 대체 경로.
+ */
+#include "onewire_backend.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/* 1-Wire 타이밍 (마이크로초) */
+#define OW_RESET_PULSE_US     480
+#define OW_PRESENCE_WAIT_US   70
+#define OW_PRESENCE_SAMPLE_US 410
+#define OW_WRITE_SLOT_US      60
+#define OW_WRITE_1_LOW_US     6
+#define OW_WRITE_0_LOW_US     60
+#define OW_READ_INIT_US       6
+#define OW_READ_SAMPLE_US     9
+#define OW_READ_SLOT_US       55
+
+typedef struct {
+    gpio_num_t   gpio;
+    portMUX_TYPE mux;
+    bool         used;
+} ow_gpio_t;
+
+static ow_gpio_t s_gpio[ONEWIRE_BUS_MAX];
+
+static inline void ow_delay_us(uint32_t us)
+{
+    uint64_t end = esp_timer_get_time() + us;
+    while (esp_timer_get_time() < end) { }
+}
+
+static void ow_set_output(ow_gpio_t *g, int level)
+{
+    gpio_set_direction(g->gpio, GPIO_MODE_OUTPUT);
+    gpio_set_level(g->gpio, level);
+}
+
+static int ow_read_input(ow_gpio_t *g)
+{
+    gpio_set_direction(g->gpio, GPIO_MODE_INPUT);
+    return gpio_get_level(g->gpio);
+}
+
+static bool gpio_reset(void *ctx)
+{
+    ow_gpio_t *g = ctx;
+    portENTER_CRITICAL(&g->mux);
+    ow_set_output(g, 0);
+    ow_delay_us(OW_RESET_PULSE_US);
+    ow_read_input(g);  /* 릴리즈 (풀업) */
+    ow_delay_us(OW_PRESENCE_WAIT_US);
+    int presence = ow_read_input(g);
+    ow_delay_us(OW_PRESENCE_SAMPLE_US);
+    portEXIT_CRITICAL(&g->mux);
+    return (presence == 0);  /* 0 = 디바이스 응답 */
+}
+
+static void ow_write_slot(ow_gpio_t *g, int bit)
+{
+    portENTER_CRITICAL(&g->mux);
+    ow_set_output(g, 0);
+    if (bit) {
+        ow_delay_us(OW_WRITE_1_LOW_US);
+        ow_set_output(g, 1);
+        ow_delay_us(OW_WRITE_SLOT_US - OW_WRITE_1_LOW_US);
+    } else {
+        ow_delay_us(OW_WRITE_0_LOW_US);
+        ow_set_output(g, 1);
+    }
+    ow_delay_us(2);
+    portEXIT_CRITICAL(&g->mux);
+}
+
+static int ow_read_slot(ow_gpio_t *g)
+{
+    portENTER_CRITICAL(&g->mux);
+    ow_set_output(g, 0);
+    ow_delay_us(OW_READ_INIT_US);
+    ow_read_input(g);
+    ow_delay_us(OW_READ_SAMPLE_US - OW_READ_INIT_US);
+    int val = ow_read_input(g);
+    ow_delay_us(OW_READ_SLOT_US);
+    portEXIT_CRITICAL(&g->mux);
+    return val;
+}
+
+/* 임계 구역은 슬롯 단위 — 슬롯 사이에 인터럽트 처리 가능 */
+static esp_err_t gpio_write_bits(void *ctx, const uint8_t *data, size_t nbits)
+{
+    for (size_t i = 0; i < nbits; i++) {
+        ow_write_slot(ctx, (data[i / 8] >> (i % 8)) & 0x01);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t gpio_read_bits(void *ctx, uint8_t *data, size_t nbits)
+{
+    for (size_t i = 0; i < nbits; i++) {
+        uint8_t mask = (uint8_t)(1u << (i % 8));
+        if (ow_read_slot(ctx)) {
+            data[i / 8] |= mask;
+        } else {
+            data[i / 8] &= (uint8_t)~mask;
+        }
+    }
+    return ESP_OK;
+}
+
+static const onewire_ops_t s_gpio_ops = {
+    .reset      = gpio_reset,
+    .write_bits = gpio_write_bits,
+    .read_bits  = gpio_read_bits,
+};
+
+esp_err_t onewire_gpio_new(gpio_num_t gpio, onewire_bus_t *bus)
+{
+    if (bus == NULL) return ESP_ERR_INVALID_ARG;
+
+    ow_gpio_t *g = NULL;
+    for (int i = 0; i < ONEWIRE_BUS_MAX; i++) {
+        if (s_gpio[i].used && s_gpio[i].gpio == gpio) {
+            g = &s_gpio[i];   /* 같은 핀 재초기화 */
+            break;
+        }
+        if (g == NULL && !s_gpio[i].used) g = &s_gpio[i];
+    }
+    if (g == NULL) return ESP_ERR_NO_MEM;
+
+    /* 데이터 핀: 오픈 드레인 + 외부 풀업 */
+    gpio_config_t io_conf = {
+        .pin_bit_mask = (1ULL << gpio),
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE,
+    };
+    esp_err_t ret = gpio_config(&io_conf);
+    if (ret != ESP_OK) return ret;
+
+    g->gpio = gpio;
+    g->mux = (portMUX_TYPE)portMUX_INITIALIZER_UNLOCKED;
+    g->used = true;
+    bus->ops = &s_gpio_ops;
+    bus->ctx = g;
+    return ESP_OK;
+}
@@ -0,0 +1,227 @@
+/**
+ * @file onewire_rmt.c
+ * @brief 1-Wire RMT 백엔드
+ *
+ * TX 채널(오픈 드레인, 루프백)이 슬롯 심볼을 내보내고, 같은 핀의 RX 채널이 라인 파형을
+ * 받아 presence/read 비트를 복원한다. 바이트열·트리플릿 전체가 트랜잭션 한 번이라
+ * 슬롯 사이에 CPU가 개입하지 않고 인터럽트를 막지도 않는다 (bit-bang은 슬롯마다 임계 구역).
+ */
+#include "onewire_backend.h"
+#include "onewire_symbols.h"
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "driver/rmt_tx.h"
+#include "driver/rmt_rx.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include <string.h>
+
+static const char *TAG = "onewire_rmt";
+
+#define OW_RMT_RESOLUTION_HZ  1000000   /* 1 tick = 1 us (심볼 duration 단위) */
+#define OW_RMT_MEM_SYMBOLS    48        /* ESP32-C6 채널당 RMT 메모리 (DMA 없음) */
+/* 쓰기 한 번 최대 16바이트 (MATCH ROM + ROM + 커맨드 = 10), 넘으면 나눠 보냄 */
+#define OW_RMT_TX_SYMBOLS     128
+/* read 트랜잭션당 슬롯 수 — 수신 파형이 RX 채널 메모리 한 블록에 들어가도록 */
+#define OW_RMT_RX_CHUNK_BITS  32
+#define OW_RMT_RX_SYMBOLS     OW_RMT_MEM_SYMBOLS
+/* 이보다 긴 high = 수신 끝 (리셋 low 480 us보다 길어야 함) */
+#define OW_RMT_RX_IDLE_NS     ((OW_SYM_RESET_LOW_US + OW_SYM_RESET_HIGH_US) * 1000)
+#define OW_RMT_RX_GLITCH_NS   1000
+#define OW_RMT_TIMEOUT_MS     50
+/* ESP32-C6 RMT: TX 2 + RX 2 채널 → 버스 2개, 나머지는 bit-bang */
+#define OW_RMT_BUS_MAX        2
+
+typedef struct {
+    rmt_channel_handle_t tx;
+    rmt_channel_handle_t rx;
+    rmt_encoder_handle_t enc;
+    QueueHandle_t        rx_done;
+    ow_symbol_t          tx_buf[OW_RMT_TX_SYMBOLS];
+    ow_symbol_t          rx_buf[OW_RMT_RX_SYMBOLS];
+    gpio_num_t           gpio;
+    bool                 used;
+} ow_rmt_t;
+
+static ow_rmt_t s_rmt[OW_RMT_BUS_MAX];
+
+_Static_assert(sizeof(ow_symbol_t) == sizeof(rmt_symbol_word_t), "RMT symbol layout");
+
+static bool IRAM_ATTR rx_done_cb(rmt_channel_handle_t ch, const rmt_rx_done_event_data_t *ev,
+                                 void *arg)
+{
+    BaseType_t woken = pdFALSE;
+    xQueueSendFromISR((QueueHandle_t)arg, ev, &woken);
+    return woken == pdTRUE;
+}
+
+/*
+ * tx_buf의 심볼 n_tx개 전송. n_rx != NULL이면 같은 구간 라인 파형을 rx_buf로 수신
+ * (수신 심볼 수 반환). 끝나면 라인은 릴리즈(high).
+ */
+static esp_err_t rmt_xfer(ow_rmt_t *b, size_t n_tx, size_t *n_rx)
+{
+    if (n_rx != NULL) {
+        const rmt_receive_config_t rc = {
+            .signal_range_min_ns = OW_RMT_RX_GLITCH_NS,
+            .signal_range_max_ns = OW_RMT_RX_IDLE_NS,
+        };
+        xQueueReset(b->rx_done);
+        esp_err_t ret = rmt_receive(b->rx, b->rx_buf, sizeof(b->rx_buf), &rc);
+        if (ret != ESP_OK) return ret;
+    }
+
+    const rmt_transmit_config_t tc = {
+        .loop_count = 0,
+        .flags.eot_level = 1,
+    };
+    esp_err_t ret = rmt_transmit(b->tx, b->enc, b->tx_buf, n_tx * sizeof(ow_symbol_t), &tc);
+    if (ret == ESP_OK) {
+        ret = rmt_tx_wait_all_done(b->tx, OW_RMT_TIMEOUT_MS);
+    }
+    if (n_rx == NULL) return ret;
+
+    rmt_rx_done_event_data_t ev;
+    if (ret == ESP_OK &&
+        xQueueReceive(b->rx_done, &ev, pdMS_TO_TICKS(OW_RMT_TIMEOUT_MS)) == pdTRUE) {
+        *n_rx = ev.num_symbols;
+        return ESP_OK;
+    }
+
+    /* 대기 중인 수신 취소 */
+    rmt_disable(b->rx);
+    rmt_enable(b->rx);
+    *n_rx = 0;
+    return (ret != ESP_OK) ? ret : ESP_ERR_TIMEOUT;
+}
+
+static bool rmt_reset(void *ctx)
+{
+    ow_rmt_t *b = ctx;
+    size_t n_rx = 0;
+    ow_sym_encode_reset(b->tx_buf);
+    if (rmt_xfer(b, 1, &n_rx) != ESP_OK) return false;
+    return ow_sym_decode_presence(b->rx_buf, n_rx);
+}
+
+static esp_err_t rmt_write_bits(void *ctx, const uint8_t *data, size_t nbits)
+{
+    ow_rmt_t *b = ctx;
+    for (size_t off = 0; off < nbits; off += OW_RMT_TX_SYMBOLS) {
+        size_t n = nbits - off;
+        if (n > OW_RMT_TX_SYMBOLS) n = OW_RMT_TX_SYMBOLS;
+        /* off는 8의 배수 (OW_RMT_TX_SYMBOLS) */
+        ow_sym_encode_bits(&data[off / 8], n, b->tx_buf);
+        esp_err_t ret = rmt_xfer(b, n, NULL);
+        if (ret != ESP_OK) return ret;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t rmt_read_bits(void *ctx, uint8_t *data, size_t nbits)
+{
+    ow_rmt_t *b = ctx;
+    for (size_t off = 0; off < nbits; off += OW_RMT_RX_CHUNK_BITS) {
+        size_t n = nbits - off;
+        if (n > OW_RMT_RX_CHUNK_BITS) n = OW_RMT_RX_CHUNK_BITS;
+        size_t n_rx = 0;
+        ow_sym_encode_read(n, b->tx_buf);
+        esp_err_t ret = rmt_xfer(b, n, &n_rx);
+        if (ret != ESP_OK) return ret;
+        if (ow_sym_decode_bits(b->rx_buf, n_rx, data, off, n) != n) {
+            ESP_LOGW(TAG, "GPIO%d: %u/%u read slots captured",
+                     b->gpio, (unsigned)n_rx, (unsigned)n);
+            return ESP_ERR_INVALID_SIZE;
+        }
+    }
+    return ESP_OK;
+}
+
+static const onewire_ops_t s_rmt_ops = {
+    .reset      = rmt_reset,
+    .write_bits = rmt_write_bits,
+    .read_bits  = rmt_read_bits,
+};
+
+static void rmt_release(ow_rmt_t *b)
+{
+    if (b->tx != NULL) { rmt_disable(b->tx); rmt_del_channel(b->tx); }
+    if (b->rx != NULL) { rmt_disable(b->rx); rmt_del_channel(b->rx); }
+    if (b->enc != NULL) rmt_del_encoder(b->enc);
+    if (b->rx_done != NULL) vQueueDelete(b->rx_done);
+    memset(b, 0, sizeof(*b));
+}
+
+esp_err_t onewire_rmt_new(gpio_num_t gpio, onewire_bus_t *bus)
+{
+    if (bus == NULL) return ESP_ERR_INVALID_ARG;
+
+    ow_rmt_t *b = NULL;
+    for (int i = 0; i < OW_RMT_BUS_MAX; i++) {
+        if (s_rmt[i].used && s_rmt[i].gpio == gpio) {
+            bus->ops = &s_rmt_ops;   /* 이미 열린 버스 */
+            bus->ctx = &s_rmt[i];
+            return ESP_OK;
+        }
+        if (b == NULL && !s_rmt[i].used) b = &s_rmt[i];
+    }
+    if (b == NULL) return ESP_ERR_NOT_FOUND;
+
+    /* RX를 먼저 만들고 TX가 같은 핀을 오픈 드레인 + 루프백으로 공유 */
+    const rmt_rx_channel_config_t rx_cfg = {
+        .gpio_num = gpio,
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .resolution_hz = OW_RMT_RESOLUTION_HZ,
+        .mem_block_symbols = OW_RMT_MEM_SYMBOLS,
+    };
+    const rmt_tx_channel_config_t tx_cfg = {
+        .gpio_num = gpio,
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .resolution_hz = OW_RMT_RESOLUTION_HZ,
+        .mem_block_symbols = OW_RMT_MEM_SYMBOLS,
+        .trans_queue_depth = 1,
+        .flags.io_loop_back = 1,
+        .flags.io_od_mode = 1,
+    };
+    const rmt_copy_encoder_config_t enc_cfg = {};
+    const rmt_rx_event_callbacks_t cbs = { .on_recv_done = rx_done_cb };
+
+    esp_err_t ret = ESP_ERR_NO_MEM;
+    b->rx_done = xQueueCreate(1, sizeof(rmt_rx_done_event_data_t));
+    if (b->rx_done == NULL) goto fail;
+    if ((ret = rmt_new_rx_channel(&rx_cfg, &b->rx)) != ESP_OK) goto fail;
+    if ((ret = rmt_new_tx_channel(&tx_cfg, &b->tx)) != ESP_OK) goto fail;
+    if ((ret = rmt_new_copy_encoder(&enc_cfg, &b->enc)) != ESP_OK) goto fail;
+    if ((ret = rmt_rx_register_event_callbacks(b->rx, &cbs, b->rx_done)) != ESP_OK) goto fail;
+    if ((ret = rmt_enable(b->rx)) != ESP_OK) goto fail;
+    if ((ret = rmt_enable(b->tx)) != ESP_OK) goto fail;
+
+    /* 외부 4.7k 풀업 보조 (루프백 설정 후 — 채널 생성이 핀 설정을 덮어씀) */
+    gpio_pullup_en(gpio);
+
+    b->gpio = gpio;
+    b->used = true;
+    bus->ops = &s_rmt_ops;
+    bus->ctx = b;
+    ESP_LOGI(TAG, "1-Wire RMT bus on GPIO%d", gpio);
+    return ESP_OK;
+
+fail:
+    ESP_LOGW(TAG, "RMT setup failed on GPIO%d: %s", gpio, esp_err_to_name(ret));
+    rmt_release(b);
+    return ret;
+}
+
+esp_err_t onewire_bus_new(onewire_backend_t backend, gpio_num_t gpio,
+                          onewire_bus_t *bus, onewire_backend_t *used)
+{
+    if (backend == ONEWIRE_BACKEND_RMT && onewire_rmt_new(gpio, bus) == ESP_OK) {
+        if (used != NULL) *used = ONEWIRE_BACKEND_RMT;
+        return ESP_OK;
+    }
+    if (backend == ONEWIRE_BACKEND_RMT) {
+        ESP_LOGW(TAG, "GPIO%d: falling back to bit-bang", gpio);
+    }
+    if (used != NULL) *used = ONEWIRE_BACKEND_GPIO;
+    return onewire_gpio_new(gpio, bus);
+}
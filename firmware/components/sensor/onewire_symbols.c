@@ -0,0 +1,111 @@
+/**
+ * @file onewire_symbols.c
+ * @brief 1-Wire 타임 슬롯 ↔ RMT 심볼 변환
+ */
+#include "onewire_symbols.h"
+
+/* 리셋 펄스로 볼 최소 low 길이 (수신 파형) */
+#define RESET_DETECT_US  (OW_SYM_RESET_LOW_US * 3 / 4)
+
+static ow_symbol_t make_slot(uint16_t low_us, uint16_t high_us)
+{
+    ow_symbol_t s = { .val = 0 };
+    s.level0 = 0;
+    s.duration0 = low_us;
+    s.level1 = 1;
+    s.duration1 = high_us;
+    return s;
+}
+
+size_t ow_sym_encode_reset(ow_symbol_t *out)
+{
+    out[0] = make_slot(OW_SYM_RESET_LOW_US, OW_SYM_RESET_HIGH_US);
+    return 1;
+}
+
+size_t ow_sym_encode_bits(const uint8_t *data, size_t nbits, ow_symbol_t *out)
+{
+    for (size_t i = 0; i < nbits; i++) {
+        if ((data[i / 8] >> (i % 8)) & 0x01) {
+            out[i] = make_slot(OW_SYM_WRITE_1_LOW_US, OW_SYM_SLOT_US - OW_SYM_WRITE_1_LOW_US);
+        } else {
+            out[i] = make_slot(OW_SYM_WRITE_0_LOW_US, OW_SYM_SLOT_US - OW_SYM_WRITE_0_LOW_US);
+        }
+    }
+    return nbits;
+}
+
+size_t ow_sym_encode_read(size_t nbits, ow_symbol_t *out)
+{
+    for (size_t i = 0; i < nbits; i++) {
+        out[i] = make_slot(OW_SYM_READ_LOW_US, OW_SYM_SLOT_US - OW_SYM_READ_LOW_US);
+    }
+    return nbits;
+}
+
+/*
+ * 수신 파형의 n번째 low 펄스 길이. RMT는 레벨이 바뀔 때마다 반 심볼씩 채우므로
+ * low가 duration0/duration1 어느 쪽에도 올 수 있다 (길이 0 = 수신 종료 표시).
+ */
+typedef struct {
+    const ow_symbol_t *rx;
+    size_t n_rx;
+    size_t half;   /* 다음에 볼 반 심볼 (심볼 i의 0/1 = 2i/2i+1) */
+} low_iter_t;
+
+static bool next_low(low_iter_t *it, uint32_t *low_us)
+{
+    while (it->half < it->n_rx * 2) {
+        const ow_symbol_t *s = &it->rx[it->half / 2];
+        bool second = (it->half & 1) != 0;
+        it->half++;
+        uint32_t dur = second ? s->duration1 : s->duration0;
+        uint32_t level = second ? s->level1 : s->level0;
+        if (dur == 0) return false;
+        if (level == 0) {
+            *low_us = dur;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ow_sym_decode_presence(const ow_symbol_t *rx, size_t n_rx)
+{
+    low_iter_t it = { .rx = rx, .n_rx = n_rx, .half = 0 };
+    uint32_t low;
+    bool reset_seen = false;
+
+    while (next_low(&it, &low)) {
+        if (!reset_seen) {
+            reset_seen = (low >= RESET_DETECT_US);
+        } else if (low >= OW_SYM_PRESENCE_MIN_US && low <= OW_SYM_PRESENCE_MAX_US) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t ow_sym_decode_bits(const ow_symbol_t *rx, size_t n_rx,
+                          uint8_t *out, size_t bit_off, size_t nbits)
+{
+    low_iter_t it = { .rx = rx, .n_rx = n_rx, .half = 0 };
+    uint32_t low;
+    size_t got = 0;
+
+    for (size_t i = 0; i < nbits; i++) {
+        size_t pos = bit_off + i;
+        uint8_t mask = (uint8_t)(1u << (pos % 8));
+        int bit = 1;
+        if (got == i && next_low(&it, &low)) {
+            bit = (low < OW_SYM_READ_SAMPLE_US);
+            got++;
+        }
+        if (bit) {
+            out[pos / 8] |= mask;
+        } else {
+            out[pos / 8] &= (uint8_t)~mask;
+        }
+    }
+    return got;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file rom_cache.c
+ * @brief 1-Wire ROM 코드 캐시
+ */
+#include "rom_cache.h"
+#include <stddef.h>
+#include <string.h>
+
+/* CRC-32 (IEEE 802.3, reflected 0xEDB88320) */
+static uint32_t crc32(const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= p[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320u : 0);
+        }
+    }
+    return ~crc;
+}
+
+static void seal(rom_cache_t *c)
+{
+    c->crc = crc32(c, offsetof(rom_cache_t, crc));
+}
+
+bool rom_cache_valid(const rom_cache_t *c)
+{
+    if (c == NULL || c->magic != ROM_CACHE_MAGIC || c->count > ROM_CACHE_MAX ||
+        c->crc != crc32(c, offsetof(rom_cache_t, crc))) {
+        return false;
+    }
+    for (int i = 0; i < c->count; i++) {
+        if (onewire_crc8(c->rom[i], 7) != c->rom[i][7]) return false;
+    }
+    return true;
+}
+
+bool rom_cache_store(rom_cache_t *c, const uint8_t rom[][ONEWIRE_ROM_LEN],
+                     const uint8_t *bus, int count)
+{
+    if (count < 0) count = 0;
+    if (count > ROM_CACHE_MAX) count = ROM_CACHE_MAX;
+
+    bool changed = !rom_cache_valid(c) || c->count != count ||
+                   memcmp(c->rom, rom, (size_t)count * ONEWIRE_ROM_LEN) != 0 ||
+                   memcmp(c->bus, bus, (size_t)count) != 0;
+
+    memset(c, 0, sizeof(*c));
+    c->magic = ROM_CACHE_MAGIC;
+    c->count = (uint8_t)count;
+    memcpy(c->rom, rom, (size_t)count * ONEWIRE_ROM_LEN);
+    memcpy(c->bus, bus, (size_t)count);
+    seal(c);
+    return changed;
+}
+
+int rom_cache_take(rom_cache_t *c, uint16_t rescan_every)
+{
+    if (!rom_cache_valid(c) || c->rescan || c->count == 0) return 0;
+    if (rescan_every > 0 && c->uses >= rescan_every) return 0;
+
+    c->uses++;
+    seal(c);
+    return c->count;
+}
+
+void rom_cache_request_rescan(rom_cache_t *c)
+{
+    if (!rom_cache_valid(c)) return;
+    c->rescan = 1;
+    seal(c);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file sensor_roles.c
+ * @brief DS18B20 역할 매핑
+ */
+#include "sensor_roles.h"
+#include <string.h>
+
+static bool rom_empty(const uint8_t *rom)
+{
+    for (int i = 0; i < ONEWIRE_ROM_LEN; i++) {
+        if (rom[i] != 0) return false;
+    }
+    return true;
+}
+
+void sensor_roles_init(sensor_role_map_t *map)
+{
+    memset(map, 0, sizeof(*map));
+    map->magic = SENSOR_ROLES_MAGIC;
+}
+
+bool sensor_roles_valid(const sensor_role_map_t *map)
+{
+    if (map == NULL || map->magic != SENSOR_ROLES_MAGIC) return false;
+    for (int r = 0; r < SENSOR_ROLE_MAX; r++) {
+        if (!rom_empty(map->rom[r]) && onewire_crc8(map->rom[r], 7) != map->rom[r][7]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool sensor_roles_assign(sensor_role_map_t *map, const uint8_t rom[][ONEWIRE_ROM_LEN],
+                         int count, uint8_t *role_of)
+{
+    bool changed = false;
+    if (!sensor_roles_valid(map)) {
+        sensor_roles_init(map);
+        changed = true;
+    }
+
+    /* 1단계: 알고 있는 ROM */
+    bool taken[SENSOR_ROLE_MAX] = { false };
+    for (int i = 0; i < count; i++) {
+        role_of[i] = SENSOR_ROLE_NONE;
+        for (int r = 0; r < SENSOR_ROLE_MAX; r++) {
+            if (!taken[r] && memcmp(map->rom[r], rom[i], ONEWIRE_ROM_LEN) == 0) {
+                role_of[i] = (uint8_t)r;
+                taken[r] = true;
+                break;
+            }
+        }
+    }
+
+    /* 2단계: 새 ROM → 지금 있는 센서가 쓰지 않는 가장 낮은 역할 (없어진 프로브 자리 포함) */
+    for (int i = 0; i < count; i++) {
+        if (role_of[i] != SENSOR_ROLE_NONE) continue;
+        for (int r = 0; r < SENSOR_ROLE_MAX; r++) {
+            if (taken[r]) continue;
+            memcpy(map->rom[r], rom[i], ONEWIRE_ROM_LEN);
+            role_of[i] = (uint8_t)r;
+            taken[r] = true;
+            changed = true;
+            break;
+        }
+    }
+    return changed;
+}
+
+bool sensor_roles_swap(sensor_role_map_t *map, uint8_t a, uint8_t b)
+{
+    if (!sensor_roles_valid(map) || a >= SENSOR_ROLE_MAX || b >= SENSOR_ROLE_MAX || a == b) {
+        return false;
+    }
+    uint8_t tmp[ONEWIRE_ROM_LEN];
+    memcpy(tmp, map->rom[a], ONEWIRE_ROM_LEN);
+    memcpy(map->rom[a], map->rom[b], ONEWIRE_ROM_LEN);
+    memcpy(map->rom[b], tmp, ONEWIRE_ROM_LEN);
+    return true;
+}
+
+int sensor_roles_index(const uint8_t *role_of, int count, uint8_t role)
+{
+    for (int i = 0; i < count; i++) {
+        if (role_of[i] == role) return i;
+    }
+    return -1;
+}
@@ -9,22 +9,58 @@
 #include "esp_task_wdt.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include <math.h>
+#include <string.h>
+#include <sys/time.h>
 
 #include "sht30.h"
 #include "ds18b20.h"
+#include "sensor_roles.h"
 #include "ssr.h"
 #include "pwm_dimmer.h"
 #include "pid.h"
 #include "scheduler.h"
+#include "time_sync.h"
+#include "temp_resolution.h"
 #include "safety_monitor.h"
 #include "thread_node.h"
 #include "cbor_codec.h"
+#include "cmd_dispatcher.h"
+#include "child_relay.h"
+#include "mesh_diag.h"
+#include "alarm_uplink.h"
 #include "nvs_config.h"
 #include "preset_manager.h"
 
 static const char *TAG = "APP_A";
 
+#if defined(CONFIG_REPORT_FORMAT_SCALED)
+#define REPORT_FORMAT CBOR_REPORT_SCALED
+#else
+#define REPORT_FORMAT CBOR_REPORT_FLOAT32
+#endif
+
+#if defined(CONFIG_ONEWIRE_RMT)
+#define ONEWIRE_BACKEND ONEWIRE_BACKEND_RMT
+#else
+#define ONEWIRE_BACKEND ONEWIRE_BACKEND_GPIO
+#endif
+
+/* 추가 1-Wire 버스 (Kconfig -1 = 사용 안 함) */
+static const int s_ds_extra_gpio[] = {
+    CONFIG_SENSOR_DS18B20_GPIO2, CONFIG_SENSOR_DS18B20_GPIO3, CONFIG_SENSOR_DS18B20_GPIO4,
+};
+
+static void add_ds_buses(void)
+{
+    for (size_t i = 0; i < sizeof(s_ds_extra_gpio) / sizeof(s_ds_extra_gpio[0]); i++) {
+        if (s_ds_extra_gpio[i] >= 0) {
+            ds18b20_add_bus((gpio_num_t)s_ds_extra_gpio[i], ONEWIRE_BACKEND);
+        }
+    }
+}
+
 /* 공유 데이터 (태스크 간) — volatile로 컴파일러 최적화 방지 */
 static volatile float s_temp_hot  = 0.0f;
 static volatile float s_temp_cool = 0.0f;
@@ -34,37 +70,320 @@ static preset_t s_preset;
 static volatile safety_status_t s_safety = SAFETY_OK;
 static uint32_t s_ssr_tick_counter = 0;
 
+/* s_pid/s_preset/스케줄 변경은 이 mutex 안에서 한 번에 적용 (원격 명령) */
+static SemaphoreHandle_t s_cfg_mutex = NULL;
+
+/* DS18B20 역할 (ROM → HOT/COOL/보조, NVS "ds_roles") — s_cfg_mutex 보호 */
+#define SENSOR_ROLES_KEY "ds_roles"
+static sensor_role_map_t s_roles;
+static uint8_t s_role_of[DS18B20_MAX_SENSORS];
+
+/* 리포트 주기 (초, NVS "report_int") */
+#define REPORT_INTERVAL_KEY     "report_int"
+#define REPORT_INTERVAL_DEFAULT 10
+#define REPORT_INTERVAL_MIN     5
+#define REPORT_INTERVAL_MAX     3600
+static volatile uint32_t s_report_interval_s = REPORT_INTERVAL_DEFAULT;
+
+/* 리포트 CBOR 템플릿 (thread_task 전용) */
+static cbor_report_template_t s_report_tmpl;
+
+/* --- 원격 명령 핸들러 (cmd 워커 태스크에서 실행) --- */
+
+/* 프리셋의 조명 스케줄/계절 캘린더를 스케줄러에 반영 (s_cfg_mutex 보유 또는 부팅 중) */
+static void apply_schedule(const preset_t *p)
+{
+    light_schedule_t lsched = {
+        .on_hour = p->light.on_hour,
+        .off_hour = p->light.off_hour,
+        .sunrise_min = p->light.sunrise_min,
+        .sunset_min = p->light.sunset_min,
+    };
+    scheduler_set_light(&lsched);
+
+    sched_calendar_t cal = { .count = p->calendar.count };
+    for (int i = 0; i < p->calendar.count && i < SCHED_SEASONS_MAX; i++) {
+        const preset_season_t *se = &p->calendar.season[i];
+        cal.seasons[i] = (sched_season_t){
+            .month = se->month, .day = se->day,
+            .light = {
+                .on_hour = se->on_hour, .off_hour = se->off_hour,
+                .sunrise_min = se->sunrise_min, .sunset_min = se->sunset_min,
+            },
+            .night_drop = se->night_drop,
+        };
+    }
+    scheduler_set_calendar(&cal);
+}
+
+/* 검증된 프리셋을 런타임 상태에 일괄 반영 후 NVS 저장 */
+static cmd_status_t apply_preset(const preset_t *next)
+{
+    if (!preset_validate(next)) return CMD_STATUS_REJECTED;
+
+    xSemaphoreTake(s_cfg_mutex, portMAX_DELAY);
+    /* Ki 변경 시 적분 항 출력이 유지되도록 누적값 환산 (bumpless) */
+    if (next->pid.ki != s_pid.ki) {
+        s_pid.integral = (next->pid.ki > 0.001f)
+                             ? s_pid.integral * s_pid.ki / next->pid.ki
+                             : 0.0f;
+    }
+    s_pid.kp = next->pid.kp;
+    s_pid.ki = next->pid.ki;
+    s_pid.kd = next->pid.kd;
+    /* 야간 하강은 스케줄러 재계산 후 control_task가 다시 적용 */
+    pid_set_setpoint(&s_pid, next->temp_hot.target);
+    apply_schedule(next);
+    s_preset = *next;
+    xSemaphoreGive(s_cfg_mutex);
+
+    return (preset_save(next) == ESP_OK) ? CMD_STATUS_OK : CMD_STATUS_NOT_SAVED;
+}
+
+/* 현재 프리셋 사본 (변경은 cmd 워커만 하므로 사본-수정-적용 사이 경합 없음) */
+static void preset_snapshot(preset_t *out)
+{
+    xSemaphoreTake(s_cfg_mutex, portMAX_DELAY);
+    *out = s_preset;
+    xSemaphoreGive(s_cfg_mutex);
+}
+
+static cmd_status_t cmd_set_setpoint(cbor_reader_t *arg, void *ctx)
+{
+    float target;
+    if (cbor_reader_get_float(arg, &target) != ESP_OK) return CMD_STATUS_BAD_ARG;
+
+    preset_t next;
+    preset_snapshot(&next);
+    /* 종별 허용 범위 밖 목표는 거부 */
+    if (isnanf(target) || target < next.temp_hot.min || target > next.temp_hot.max) {
+        return CMD_STATUS_REJECTED;
+    }
+    next.temp_hot.target = target;
+    return apply_preset(&next);
+}
+
+static cmd_status_t cmd_set_pid(cbor_reader_t *arg, void *ctx)
+{
+    float k[3];
+    if (cmd_arg_floats(arg, k, 3) != ESP_OK) return CMD_STATUS_BAD_ARG;
+
+    preset_t next;
+    preset_snapshot(&next);
+    next.pid.kp = k[0];
+    next.pid.ki = k[1];
+    next.pid.kd = k[2];
+    return apply_preset(&next);
+}
+
+static cmd_status_t cmd_set_light(cbor_reader_t *arg, void *ctx)
+{
+    float v[4];
+    if (cmd_arg_floats(arg, v, 4) != ESP_OK) return CMD_STATUS_BAD_ARG;
+    for (int i = 0; i < 4; i++) {
+        if (v[i] < 0.0f || v[i] > 255.0f) return CMD_STATUS_REJECTED;
+    }
+
+    preset_t next;
+    preset_snapshot(&next);
+    next.light.on_hour = (uint8_t)v[0];
+    next.light.off_hour = (uint8_t)v[1];
+    next.light.sunrise_min = (uint8_t)v[2];
+    next.light.sunset_min = (uint8_t)v[3];
+    /* 원격 고정 스케줄이 계절 캘린더보다 우선 (캘린더 해제) */
+    next.calendar.count = 0;
+    return apply_preset(&next);
+}
+
+static cmd_status_t cmd_set_report_interval(cbor_reader_t *arg, void *ctx)
+{
+    int32_t sec;
+    if (cbor_reader_get_int(arg, &sec) != ESP_OK) return CMD_STATUS_BAD_ARG;
+    if (sec < REPORT_INTERVAL_MIN || sec > REPORT_INTERVAL_MAX) return CMD_STATUS_REJECTED;
+
+    s_report_interval_s = (uint32_t)sec;
+    return (nvs_config_save_u32(REPORT_INTERVAL_KEY, (uint32_t)sec) == ESP_OK)
+               ? CMD_STATUS_OK : CMD_STATUS_NOT_SAVED;
+}
+
+/* 검색된 센서의 ROM 코드 (검색 후 변하지 않음 — mutex 불필요), 센서 수 반환 */
+static int ds_roms(uint8_t roms[][ONEWIRE_ROM_LEN])
+{
+    const ds18b20_sensor_t *sensors = ds18b20_get_sensors();
+    int count = ds18b20_get_count();
+    for (int i = 0; i < count; i++) {
+        memcpy(roms[i], sensors[i].rom, ONEWIRE_ROM_LEN);
+    }
+    return count;
+}
+
+static cmd_status_t cmd_swap_sensor_roles(cbor_reader_t *arg, void *ctx)
+{
+    float v[2];
+    if (cmd_arg_floats(arg, v, 2) != ESP_OK) return CMD_STATUS_BAD_ARG;
+    for (int i = 0; i < 2; i++) {
+        if (v[i] < 0.0f || v[i] >= (float)SENSOR_ROLE_MAX) return CMD_STATUS_REJECTED;
+    }
+
+    uint8_t roms[DS18B20_MAX_SENSORS][ONEWIRE_ROM_LEN];
+    int count = ds_roms(roms);
+
+    /* flash 쓰기는 mutex 밖에서 (control/safety 태스크 블로킹 방지) */
+    sensor_role_map_t map;
+    xSemaphoreTake(s_cfg_mutex, portMAX_DELAY);
+    if (!sensor_roles_swap(&s_roles, (uint8_t)v[0], (uint8_t)v[1])) {
+        xSemaphoreGive(s_cfg_mutex);
+        return CMD_STATUS_REJECTED;
+    }
+    /* 다음 sensor_task 주기부터 교환된 역할 */
+    sensor_roles_assign(&s_roles, (const uint8_t (*)[ONEWIRE_ROM_LEN])roms, count, s_role_of);
+    map = s_roles;
+    xSemaphoreGive(s_cfg_mutex);
+
+    return (nvs_config_save_blob(SENSOR_ROLES_KEY, &map, sizeof(map)) == ESP_OK)
+               ? CMD_STATUS_OK : CMD_STATUS_NOT_SAVED;
+}
+
+static const cmd_entry_t s_cmd_table[] = {
+    { CMD_SET_SETPOINT,        cmd_set_setpoint },
+    { CMD_SET_PID,             cmd_set_pid },
+    { CMD_SET_LIGHT,           cmd_set_light },
+    { CMD_SET_REPORT_INTERVAL, cmd_set_report_interval },
+    { CMD_SWAP_SENSOR_ROLES,   cmd_swap_sensor_roles },
+};
+
+/* --- 네트워크 시각 (게이트웨이 비콘: ff03::1 주기 전송 + CON ACK, ot_rx 워커) --- */
+
+static time_sync_t s_time_sync;
+static volatile bool s_time_synced = false;
+static volatile int16_t s_utc_offset_min = 9 * 60;
+static thread_rx_cb_t s_relay_rx = NULL;
+
+static int64_t now_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+static void time_beacon_rx(const cbor_time_t *t)
+{
+    int64_t net_us = (int64_t)t->unix_sec * 1000000LL + (int64_t)t->ms * 1000;
+
+    /* control_task의 scheduler_update(localtime)와 겹치지 않게 */
+    xSemaphoreTake(s_cfg_mutex, portMAX_DELAY);
+    int64_t corr = time_sync_beacon(&s_time_sync, now_us(), net_us);
+    scheduler_adjust_time(corr);
+    scheduler_set_utc_offset(t->utc_offset_min);
+    xSemaphoreGive(s_cfg_mutex);
+
+    s_utc_offset_min = t->utc_offset_min;
+    if (!s_time_synced || corr > TIME_SYNC_STEP_US || corr < -TIME_SYNC_STEP_US) {
+        ESP_LOGI(TAG, "Clock set from beacon (%lld ms)", (long long)(corr / 1000));
+    }
+    s_time_synced = true;
+}
+
+/* 명령 외 데이터그램: 시각 비콘, 나머지는 자식 중계 */
+static void other_rx(const uint8_t *data, size_t len, const thread_rx_meta_t *meta)
+{
+    cbor_time_t t;
+    if (cbor_decode_time(data, len, &t) == ESP_OK) {
+        time_beacon_rx(&t);
+        return;
+    }
+    if (s_relay_rx) s_relay_rx(data, len, meta);
+}
+
+/* 자식 업링크 ACK에 실을 시각 (OT 콜백 컨텍스트 — 동기 전이면 싣지 않음) */
+static size_t relay_time(uint8_t *out, size_t out_size)
+{
+    if (!s_time_synced) return 0;
+
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    cbor_time_t t = {
+        .unix_sec = (uint32_t)tv.tv_sec,
+        .ms = (uint16_t)(tv.tv_usec / 1000),
+        .utc_offset_min = s_utc_offset_min,
+    };
+    size_t len = 0;
+    return (cbor_encode_time(&t, out, out_size, &len) == ESP_OK) ? len : 0;
+}
+
 /* --- 태스크: 센서 읽기 (1초) --- */
 static void sensor_task(void *param)
 {
     esp_task_wdt_add(NULL);
 
+    const temp_resolution_config_t res_cfg = {
+        .guard_c = 2.0f,
+        .stable_c = 0.25f,
+        .stable_bits = CONFIG_DS18B20_STABLE_RESOLUTION,
+    };
+    float prev[DS18B20_MAX_SENSORS];
+    for (int i = 0; i < DS18B20_MAX_SENSORS; i++) prev[i] = NAN;
+
+    /* 모든 버스 검색 → ROM 코드로 역할 매핑 (검색 순서와 무관) */
     int ds_count = 0;
     ds18b20_search(&ds_count);
+    uint8_t roms[DS18B20_MAX_SENSORS][ONEWIRE_ROM_LEN];
+    int rom_count = ds_roms(roms);
+    sensor_role_map_t map;
+    xSemaphoreTake(s_cfg_mutex, portMAX_DELAY);
+    bool roles_changed = sensor_roles_assign(&s_roles, (const uint8_t (*)[ONEWIRE_ROM_LEN])roms,
+                                             rom_count, s_role_of);
+    map = s_roles;
+    xSemaphoreGive(s_cfg_mutex);
+    if (roles_changed) {
+        nvs_config_save_blob(SENSOR_ROLES_KEY, &map, sizeof(map));
+    }
+    ds18b20_start_conversion();
+    TickType_t wake = xTaskGetTickCount();
 
     while (1) {
         esp_task_wdt_reset();
 
-        /* SHT30 온습도 */
+        /* DS18B20 온도 — 지난 주기에 시작한 변환은 보통 이미 완료, 전체를 연달아 읽기 */
+        if (ds18b20_wait_conversion(1000) == ESP_OK) {
+            ds18b20_read_all();
+            const ds18b20_sensor_t *sensors = ds18b20_get_sensors();
+
+            uint8_t role_of[DS18B20_MAX_SENSORS];
+            xSemaphoreTake(s_cfg_mutex, portMAX_DELAY);
+            float limit = s_preset.temp_hot.target + s_preset.safety.overtemp_offset;
+            memcpy(role_of, s_role_of, sizeof(role_of));
+            xSemaphoreGive(s_cfg_mutex);
+
+            int hot = sensor_roles_index(role_of, ds_count, SENSOR_ROLE_HOT);
+            int cool = sensor_roles_index(role_of, ds_count, SENSOR_ROLE_COOL);
+            s_temp_hot = (hot >= 0 && sensors[hot].valid) ? sensors[hot].temperature : 0.0f;
+            s_temp_cool = (cool >= 0 && sensors[cool].valid) ? sensors[cool].temperature : 0.0f;
+
+            /* 다음 변환 해상도 (센서별): 안정 시 거칠게, 과열 한계 근처 12비트 */
+            for (int i = 0; i < ds_count; i++) {
+                if (!sensors[i].valid) continue;
+                float t = sensors[i].temperature;
+                ds18b20_set_resolution(i, temp_resolution_select(&res_cfg, t, prev[i], limit));
+                prev[i] = t;
+                if (role_of[i] > SENSOR_ROLE_COOL && role_of[i] != SENSOR_ROLE_NONE) {
+                    ESP_LOGD(TAG, "T_aux%u=%.1f (bus %u)", role_of[i], t, sensors[i].bus);
+                }
+            }
+        }
+        /* 읽자마자 다음 변환 시작 → 다음 주기에 새 값이 준비됨 */
+        ds18b20_start_conversion();
+
+        /* SHT30 온습도 (DS18B20 변환과 겹쳐 실행) */
         sht30_data_t sht;
         if (sht30_read(&sht) == ESP_OK) {
             s_humidity = sht.humidity;
         }
 
-        /* DS18B20 온도 (핫존/쿨존) */
-        ds18b20_start_conversion();
-        vTaskDelay(pdMS_TO_TICKS(750));
-
-        float th = 0, tc = 0;
-        if (ds_count >= 1) ds18b20_read_temp(0, &th);
-        if (ds_count >= 2) ds18b20_read_temp(1, &tc);
-        s_temp_hot = th;
-        s_temp_cool = tc;
-
         ESP_LOGI(TAG, "T_hot=%.1f T_cool=%.1f H=%.1f%%",
-                 th, tc, (float)s_humidity);
+                 (float)s_temp_hot, (float)s_temp_cool, (float)s_humidity);
 
-        vTaskDelay(pdMS_TO_TICKS(250));  /* 총 ~1초 */
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(1000));
     }
 }
 
@@ -72,28 +391,49 @@ static void sensor_task(void *param)
 static void control_task(void *param)
 {
     esp_task_wdt_add(NULL);
+    bool light_dirty = true;  /* 부팅/안전 차단 후 현재 구간 재적용 */
 
     while (1) {
         esp_task_wdt_reset();
         if (s_safety >= SAFETY_FAULT_OVERTEMP) {
-            /* 안전 이상 시 출력 차단 */
+            /* 안전 이상 시 출력 차단 (조명은 safety_task가 램프까지 중단) */
             ssr_force_off_all();
+            light_dirty = true;
             vTaskDelay(pdMS_TO_TICKS(1000));
             continue;
         }
 
+        int64_t now = now_us();
+
+        xSemaphoreTake(s_cfg_mutex, portMAX_DELAY);
         float output = pid_compute(&s_pid, s_temp_hot, 1.0f);
+        /* 구간 끝 전에는 시각 비교만 */
+        bool light_changed = scheduler_update(now) || light_dirty;
+        float level = 0.0f, target = 0.0f;
+        uint32_t ramp_ms = 0;
+        if (light_changed) {
+            ramp_ms = scheduler_get_ramp(now, &level, &target);
+            /* 계절 캘린더 야간 하강 — 소등/점등 구간이 바뀔 때만 목표 변경 */
+            float setpoint = s_preset.temp_hot.target - scheduler_get_night_drop();
+            if (s_pid.setpoint != setpoint) {
+                pid_set_setpoint(&s_pid, setpoint);
+            }
+        }
+        xSemaphoreGive(s_cfg_mutex);
+
         if (isnanf(output) || output < 0.0f) output = 0.0f;
         if (output > 100.0f) output = 100.0f;
         ssr_set_duty(0, (uint8_t)output);  /* 히터 */
 
-        /* 스케줄러 기반 조명 */
-        scheduler_tick();
-        if (scheduler_is_light_on()) {
-            float dim = scheduler_get_dimming();
-            pwm_dimmer_set((uint16_t)(dim * 1000.0f));
-        } else {
-            pwm_dimmer_set(0);
+        /* 스케줄러 기반 조명 — 구간이 바뀔 때만 LEDC에 전달, 일출/일몰은 하드웨어 페이드 */
+        if (light_changed) {
+            if (ramp_ms > 0) {
+                pwm_dimmer_ramp((uint16_t)(level * 1000.0f), (uint16_t)(target * 1000.0f),
+                                ramp_ms);
+            } else {
+                pwm_dimmer_set((uint16_t)(level * 1000.0f));
+            }
+            light_dirty = false;
         }
 
         /* SSR Cycle Skipping tick (10초 = 100 ticks @ 100ms) */
@@ -112,9 +452,14 @@ static void safety_task(void *param)
 
     while (1) {
         esp_task_wdt_reset();
-        s_safety = safety_check(s_temp_hot, s_temp_cool,
-                                 s_preset.temp_hot.target,
-                                 s_humidity);
+        /* 과열 기준은 낮 목표 — 야간 하강 직후 식는 동안 오경보 방지 */
+        xSemaphoreTake(s_cfg_mutex, portMAX_DELAY);
+        float setpoint = s_preset.temp_hot.target;
+        xSemaphoreGive(s_cfg_mutex);
+
+        s_safety = safety_check(s_temp_hot, s_temp_cool, setpoint, s_humidity);
+        /* 상태 전이는 리포트 주기를 기다리지 않고 경보 채널로 즉시 전송 */
+        alarm_uplink_raise((int)s_safety);
 
         if (s_safety >= SAFETY_FAULT_OVERTEMP) {
             ESP_LOGE(TAG, "SAFETY FAULT: %s", safety_status_str(s_safety));
@@ -130,7 +475,7 @@ static void safety_task(void *param)
     }
 }
 
-/* --- 태스크: Thread 리포트 (10초) --- */
+/* --- 태스크: Thread 리포트 (기본 10초, 원격 변경 가능) --- */
 static void thread_task(void *param)
 {
     esp_task_wdt_add(NULL);
@@ -147,13 +492,20 @@ static void thread_task(void *param)
                 .light_duty  = (float)pwm_dimmer_get() / 10.0f,  /* 0-1000 → 0-100 */
                 .safety_status = (int)s_safety,
             };
-            uint8_t buf[64];
+            /* 필드 구성이 같으면 값 슬롯만 덮어씀 (스택 버퍼 불필요) */
+            const uint8_t *data = NULL;
             size_t len = 0;
-            if (cbor_encode_report(&report, buf, sizeof(buf), &len) == ESP_OK) {
-                thread_node_send(buf, len);
+            /* 주기 리포트는 NON unicast (손실 시 다음 주기가 대체) */
+            if (cbor_template_encode(&s_report_tmpl, &report, REPORT_FORMAT,
+                                     &data, &len) == ESP_OK) {
+                thread_node_send(data, len);
             }
         }
-        vTaskDelay(pdMS_TO_TICKS(10000));
+        /* WDT(10초)보다 긴 주기도 대기할 수 있게 1초 단위로 나눠 대기 */
+        for (uint32_t t = 0; t < s_report_interval_s; t++) {
+            vTaskDelay(pdMS_TO_TICKS(1000));
+            esp_task_wdt_reset();
+        }
     }
 }
 
@@ -165,10 +517,24 @@ void app_type_a_start(void)
     /* 설정 로드 */
     nvs_config_init();
     preset_load(&s_preset);
+    s_cfg_mutex = xSemaphoreCreateMutex();
+
+    uint32_t interval = 0;
+    if (nvs_config_load_u32(REPORT_INTERVAL_KEY, &interval) == ESP_OK &&
+        interval >= REPORT_INTERVAL_MIN && interval <= REPORT_INTERVAL_MAX) {
+        s_report_interval_s = interval;
+    }
 
     /* 센서 초기화 */
     sht30_init(I2C_NUM_0, GPIO_NUM_6, GPIO_NUM_7, CONFIG_SENSOR_SHT30_ADDR);
-    ds18b20_init(CONFIG_SENSOR_DS18B20_GPIO, GPIO_NUM_NC);  /* Type A: 상시 전원 */
+    ds18b20_init(CONFIG_SENSOR_DS18B20_GPIO, GPIO_NUM_NC, ONEWIRE_BACKEND);  /* Type A: 상시 전원 */
+    add_ds_buses();
+
+    size_t roles_len = 0;
+    if (nvs_config_load_blob(SENSOR_ROLES_KEY, &s_roles, sizeof(s_roles), &roles_len) != ESP_OK ||
+        roles_len != sizeof(s_roles) || !sensor_roles_valid(&s_roles)) {
+        sensor_roles_init(&s_roles);
+    }
 
     /* 액추에이터 초기화 */
     ssr_init(0, CONFIG_SSR_HEATER_GPIO, "heater");
@@ -182,13 +548,7 @@ void app_type_a_start(void)
 
     /* 스케줄러 초기화 */
     scheduler_init();
-    light_schedule_t lsched = {
-        .on_hour = s_preset.light.on_hour,
-        .off_hour = s_preset.light.off_hour,
-        .sunrise_min = s_preset.light.sunrise_min,
-        .sunset_min = s_preset.light.sunset_min,
-    };
-    scheduler_set_light(&lsched);
+    apply_schedule(&s_preset);
 
     /* 안전 감시 초기화 */
     safety_config_t scfg = {
@@ -202,7 +562,53 @@ void app_type_a_start(void)
 
     /* Thread 초기화 (Router) */
     thread_node_init(true);
+    thread_uplink_config_t ucfg = {
+        .ack_timeout_ms = CONFIG_UPLINK_ACK_TIMEOUT_MS,
+        .max_retransmit = CONFIG_UPLINK_MAX_RETRANSMIT,
+        .gateway_addr   = CONFIG_UPLINK_GATEWAY_ADDR,
+    };
+    thread_node_config_uplink(&ucfg);
     thread_node_start();
+    if (alarm_uplink_start() != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start alarm uplink");
+    }
+
+    /* 자식(Type B) 업링크 중계: 창 동안 모아 다중 노드 데이터그램 하나로 전송,
+     * 게이트웨이가 맡긴 자식 앞 명령(없으면 현재 시각)은 자식 업링크 ACK에 실어 전달 */
+#if defined(CONFIG_CHILD_RELAY_ENABLE)
+    child_relay_config_t rcfg = {
+        .window_ms = CONFIG_CHILD_RELAY_WINDOW_S * 1000,
+        .mailbox_ttl_ms = CONFIG_CHILD_MAILBOX_TTL_S * 1000U,
+        .time_beacon = relay_time,
+    };
+    if (child_relay_start(&rcfg) == ESP_OK) {
+        s_relay_rx = child_relay_rx;
+    } else {
+        ESP_LOGE(TAG, "Failed to start child relay");
+    }
+#endif
+
+    /* 메시 진단 (링크 품질/재전송 카운터) 저빈도 보고 */
+#if CONFIG_MESH_DIAG_INTERVAL_S > 0
+    mesh_diag_config_t dcfg = {
+        .interval_ms = CONFIG_MESH_DIAG_INTERVAL_S * 1000,
+    };
+    if (mesh_diag_start(&dcfg) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start mesh diagnostics");
+    }
+#endif
+
+    /* 원격 명령 수신 (워커 태스크에서 처리) */
+    cmd_dispatcher_config_t ccfg = {
+        .table = s_cmd_table,
+        .count = sizeof(s_cmd_table) / sizeof(s_cmd_table[0]),
+        .ctx = NULL,
+        .use_task = true,
+        .other_rx = other_rx,
+    };
+    if (cmd_dispatcher_init(&ccfg) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start command dispatcher");
+    }
 
     /* FreeRTOS 태스크 생성 (safety > sensor > control > thread 우선순위) */
     BaseType_t ret;
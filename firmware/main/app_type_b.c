@@ -9,15 +9,27 @@
 
 #include "esp_log.h"
 #include "esp_sleep.h"
+#include "esp_mac.h"
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
 #include "sht30.h"
 #include "ds18b20.h"
+#include "rom_cache.h"
+#include "sensor_roles.h"
 #include "adaptive_poll.h"
+#include "temp_resolution.h"
+#include "wake_slot.h"
+#include "scheduler.h"
+#include "time_sync.h"
 #include "safety_monitor.h"
 #include "thread_node.h"
 #include "cbor_codec.h"
+#include "cmd_dispatcher.h"
 #include "power_mgmt.h"
 #include "battery_monitor.h"
 #include "nvs_config.h"
@@ -25,10 +37,313 @@
 
 static const char *TAG = "APP_B";
 
+#if defined(CONFIG_REPORT_FORMAT_SCALED)
+#define REPORT_FORMAT CBOR_REPORT_SCALED
+#else
+#define REPORT_FORMAT CBOR_REPORT_FLOAT32
+#endif
+
+#if defined(CONFIG_UPLINK_VIA_PARENT)
+#define UPLINK_VIA_PARENT true
+#else
+#define UPLINK_VIA_PARENT false
+#endif
+
+#if defined(CONFIG_ONEWIRE_RMT)
+#define ONEWIRE_BACKEND ONEWIRE_BACKEND_RMT
+#else
+#define ONEWIRE_BACKEND ONEWIRE_BACKEND_GPIO
+#endif
+
+/* 추가 1-Wire 버스 (Kconfig -1 = 사용 안 함) */
+static const int s_ds_extra_gpio[] = {
+    CONFIG_SENSOR_DS18B20_GPIO2, CONFIG_SENSOR_DS18B20_GPIO3, CONFIG_SENSOR_DS18B20_GPIO4,
+};
+
+static void add_ds_buses(void)
+{
+    for (size_t i = 0; i < sizeof(s_ds_extra_gpio) / sizeof(s_ds_extra_gpio[0]); i++) {
+        if (s_ds_extra_gpio[i] >= 0) {
+            ds18b20_add_bus((gpio_num_t)s_ds_extra_gpio[i], ONEWIRE_BACKEND);
+        }
+    }
+}
+
 /* RTC 메모리 — Deep Sleep을 걸쳐도 유지 */
 static RTC_DATA_ATTR float s_prev_temp = 0.0f;
+static RTC_DATA_ATTR uint8_t s_ds_bits = 0;   /* 다음 wake의 DS18B20 해상도 (0 = 12비트) */
 static RTC_DATA_ATTR uint32_t s_boot_count = 0;
 static RTC_DATA_ATTR uint32_t s_battery_check_counter = 0;
+static RTC_DATA_ATTR time_sync_t s_time_sync;  /* 드리프트 추정을 wake 간 유지 */
+static RTC_DATA_ATTR rom_cache_t s_rom_cache;  /* DS18B20 ROM 목록 (검색 생략) */
+static RTC_DATA_ATTR sensor_role_map_t s_roles;  /* DS18B20 ROM → HOT/COOL/보조 */
+#if CONFIG_REPORT_BATCH_SIZE > 1
+static RTC_DATA_ATTR sensor_batch_t s_batch;
+#endif
+
+/* 리포트 주기 (느린 폴링 주기 대체, NVS "report_int") */
+#define REPORT_INTERVAL_KEY "report_int"
+#define REPORT_INTERVAL_MIN CONFIG_POLL_PERIOD_FAST  /* 빠른 주기보다 짧을 수 없음 */
+#define REPORT_INTERVAL_MAX 3600
+
+/* wake 슬롯 epoch (서버 배포, NVS "wake_epoch") */
+#define WAKE_EPOCH_KEY "wake_epoch"
+
+/* DS18B20 ROM 캐시 NVS 사본 (전원 투입 후 RTC 메모리가 비었을 때) */
+#define ROM_CACHE_KEY "ds_roms"
+
+/* DS18B20 역할 매핑 NVS 사본 */
+#define SENSOR_ROLES_KEY "ds_roles"
+
+/* ACK/명령 수신 동안의 SED poll 주기 */
+#define UPLINK_POLL_MS 100
+
+/* 부모 연결 대기 / child timeout (전송 간격 + 여유, 최소 300초) */
+#define ATTACH_TIMEOUT_MS       5000
+#define CHILD_TIMEOUT_MIN_S     300
+#define CHILD_TIMEOUT_MARGIN_S  60
+
+static preset_t s_preset;
+static uint32_t s_period_slow_s = CONFIG_POLL_PERIOD_SLOW;
+static uint32_t s_wake_epoch = 0;
+
+/* --- 원격 명령 핸들러 (수신 창 동안 메인 컨텍스트에서 실행) --- */
+
+static cmd_status_t cmd_set_setpoint(cbor_reader_t *arg, void *ctx)
+{
+    float target;
+    if (cbor_reader_get_float(arg, &target) != ESP_OK) return CMD_STATUS_BAD_ARG;
+    if (isnanf(target) || target < s_preset.temp_hot.min || target > s_preset.temp_hot.max) {
+        return CMD_STATUS_REJECTED;
+    }
+
+    preset_t next = s_preset;
+    next.temp_hot.target = target;
+    if (!preset_validate(&next)) return CMD_STATUS_REJECTED;
+    s_preset = next;
+    return (preset_save(&next) == ESP_OK) ? CMD_STATUS_OK : CMD_STATUS_NOT_SAVED;
+}
+
+static cmd_status_t cmd_set_report_interval(cbor_reader_t *arg, void *ctx)
+{
+    int32_t sec;
+    if (cbor_reader_get_int(arg, &sec) != ESP_OK) return CMD_STATUS_BAD_ARG;
+    if (sec < REPORT_INTERVAL_MIN || sec > REPORT_INTERVAL_MAX) return CMD_STATUS_REJECTED;
+
+    s_period_slow_s = (uint32_t)sec;
+    return (nvs_config_save_u32(REPORT_INTERVAL_KEY, (uint32_t)sec) == ESP_OK)
+               ? CMD_STATUS_OK : CMD_STATUS_NOT_SAVED;
+}
+
+static cmd_status_t cmd_set_wake_epoch(cbor_reader_t *arg, void *ctx)
+{
+    int32_t epoch;
+    if (cbor_reader_get_int(arg, &epoch) != ESP_OK) return CMD_STATUS_BAD_ARG;
+    if (epoch < 0) return CMD_STATUS_REJECTED;
+
+    s_wake_epoch = (uint32_t)epoch;  /* 이번 sleep부터 새 슬롯 */
+    return (nvs_config_save_u32(WAKE_EPOCH_KEY, (uint32_t)epoch) == ESP_OK)
+               ? CMD_STATUS_OK : CMD_STATUS_NOT_SAVED;
+}
+
+/* 다음 wake에 ROM 검색 (프로브 교체 후) — NVS 사본은 검색 결과가 다를 때 갱신 */
+static cmd_status_t cmd_rescan_sensors(cbor_reader_t *arg, void *ctx)
+{
+    rom_cache_request_rescan(&s_rom_cache);
+    return CMD_STATUS_OK;
+}
+
+/* HOT/COOL 프로브가 바뀌어 꽂힘 → 역할 교환, 다음 wake부터 반영 */
+static cmd_status_t cmd_swap_sensor_roles(cbor_reader_t *arg, void *ctx)
+{
+    float v[2];
+    if (cmd_arg_floats(arg, v, 2) != ESP_OK) return CMD_STATUS_BAD_ARG;
+    for (int i = 0; i < 2; i++) {
+        if (v[i] < 0.0f || v[i] >= (float)SENSOR_ROLE_MAX) return CMD_STATUS_REJECTED;
+    }
+    if (!sensor_roles_swap(&s_roles, (uint8_t)v[0], (uint8_t)v[1])) {
+        return CMD_STATUS_REJECTED;
+    }
+    return (nvs_config_save_blob(SENSOR_ROLES_KEY, &s_roles, sizeof(s_roles)) == ESP_OK)
+               ? CMD_STATUS_OK : CMD_STATUS_NOT_SAVED;
+}
+
+/* Type B: 히터/조명 없음 → PID/조명 명령은 UNKNOWN 응답 */
+static const cmd_entry_t s_cmd_table[] = {
+    { CMD_SET_SETPOINT,        cmd_set_setpoint },
+    { CMD_SET_REPORT_INTERVAL, cmd_set_report_interval },
+    { CMD_SET_WAKE_EPOCH,      cmd_set_wake_epoch },
+    { CMD_RESCAN_SENSORS,      cmd_rescan_sensors },
+    { CMD_SWAP_SENSOR_ROLES,   cmd_swap_sensor_roles },
+};
+
+/* --- 네트워크 시각 (업링크 ACK에 실린 비콘) --- */
+
+static int64_t now_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+/* 명령 외 데이터그램 — 부모가 버퍼링했다 늦게 준 멀티캐스트 비콘은 시각이 낡아 무시 */
+static void time_rx(const uint8_t *data, size_t len, const thread_rx_meta_t *meta)
+{
+    cbor_time_t t;
+    if (meta->multicast || cbor_decode_time(data, len, &t) != ESP_OK) return;
+
+    int64_t net_us = (int64_t)t.unix_sec * 1000000LL + (int64_t)t.ms * 1000;
+    bool first = !time_sync_is_synced(&s_time_sync);
+    int64_t corr = time_sync_beacon(&s_time_sync, now_us(), net_us);
+    scheduler_adjust_time(corr);
+    if (first || corr > TIME_SYNC_STEP_US || corr < -TIME_SYNC_STEP_US) {
+        ESP_LOGI(TAG, "Clock set from beacon (%lld ms)", (long long)(corr / 1000));
+    } else {
+        ESP_LOGD(TAG, "Clock error %ld us, drift %ld ppb", (long)s_time_sync.last_error_us,
+                 (long)s_time_sync.drift_ppb);
+    }
+}
+
+/*
+ * DS18B20 센서 목록: ROM 캐시가 유효하면 리셋 한 번(presence)으로 끝내고,
+ * 캐시 없음/주기 도래/재검색 요청/presence 실패면 전체 ROM 검색 후 캐시 갱신.
+ */
+static int ds_attach(void)
+{
+    if (!rom_cache_valid(&s_rom_cache)) {
+        /* 전원 투입 (RTC 메모리 초기화) → NVS 사본 */
+        size_t len = 0;
+        if (nvs_config_load_blob(ROM_CACHE_KEY, &s_rom_cache, sizeof(s_rom_cache),
+                                 &len) != ESP_OK || len != sizeof(s_rom_cache)) {
+            memset(&s_rom_cache, 0, sizeof(s_rom_cache));
+        }
+    }
+
+    int n = rom_cache_take(&s_rom_cache, CONFIG_DS18B20_RESCAN_WAKES);
+    if (n > 0 && ds18b20_attach((const uint8_t (*)[ONEWIRE_ROM_LEN])s_rom_cache.rom,
+                                s_rom_cache.bus, n) == ESP_OK) {
+        return ds18b20_get_count();
+    }
+
+    int count = 0;
+    ds18b20_search(&count);
+    if (count > 0) {
+        uint8_t roms[DS18B20_MAX_SENSORS][ONEWIRE_ROM_LEN];
+        uint8_t bus[DS18B20_MAX_SENSORS];
+        const ds18b20_sensor_t *sensors = ds18b20_get_sensors();
+        for (int i = 0; i < count; i++) {
+            memcpy(roms[i], sensors[i].rom, ONEWIRE_ROM_LEN);
+            bus[i] = sensors[i].bus;
+        }
+        /* flash 쓰기는 ROM 목록이 바뀔 때만 */
+        if (rom_cache_store(&s_rom_cache, (const uint8_t (*)[ONEWIRE_ROM_LEN])roms, bus, count)) {
+            nvs_config_save_blob(ROM_CACHE_KEY, &s_rom_cache, sizeof(s_rom_cache));
+            ESP_LOGI(TAG, "DS18B20 ROM cache updated (%d sensor(s))", count);
+        }
+    }
+    return count;
+}
+
+/* 센서별 역할 (RTC 사본, 전원 투입 후 NVS) — 매핑이 바뀔 때만 flash 쓰기 */
+static void ds_assign_roles(uint8_t *role_of)
+{
+    if (!sensor_roles_valid(&s_roles)) {
+        size_t len = 0;
+        if (nvs_config_load_blob(SENSOR_ROLES_KEY, &s_roles, sizeof(s_roles), &len) != ESP_OK ||
+            len != sizeof(s_roles)) {
+            sensor_roles_init(&s_roles);
+        }
+    }
+
+    const ds18b20_sensor_t *sensors = ds18b20_get_sensors();
+    int count = ds18b20_get_count();
+    uint8_t roms[DS18B20_MAX_SENSORS][ONEWIRE_ROM_LEN];
+    for (int i = 0; i < count; i++) memcpy(roms[i], sensors[i].rom, ONEWIRE_ROM_LEN);
+    if (sensor_roles_assign(&s_roles, (const uint8_t (*)[ONEWIRE_ROM_LEN])roms, count, role_of)) {
+        nvs_config_save_blob(SENSOR_ROLES_KEY, &s_roles, sizeof(s_roles));
+        ESP_LOGI(TAG, "DS18B20 roles updated");
+    }
+}
+
+#if CONFIG_WAKE_SLOT_MS > 0
+/*
+ * 다음 wake를 이 노드의 슬롯 중앙에 맞춘 sleep 시간.
+ * 기준 시계는 비콘으로 맞춘 RTC 시각 (deep sleep 동안 유지), 노드 ID는 공장 MAC.
+ */
+static uint32_t wake_slot_sleep(uint32_t sleep_sec)
+{
+    wake_slot_config_t wcfg = {
+        .frame_ms = CONFIG_POLL_PERIOD_FAST * 1000U,
+        .slot_ms  = CONFIG_WAKE_SLOT_MS,
+    };
+    uint8_t mac[6] = {0};
+    esp_efuse_mac_get_default(mac);
+    uint64_t node_id = 0;
+    for (int i = 0; i < 6; i++) node_id = (node_id << 8) | mac[i];
+
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    uint64_t now_ms = (uint64_t)tv.tv_sec * 1000ULL + (uint64_t)tv.tv_usec / 1000ULL;
+
+    uint32_t slot = wake_slot_index(&wcfg, node_id, s_wake_epoch);
+    uint32_t sleep_ms = wake_slot_sleep_ms(&wcfg, slot, now_ms, sleep_sec);
+    ESP_LOGI(TAG, "Wake slot %lu/%lu (epoch %lu)", (unsigned long)slot,
+             (unsigned long)(wcfg.frame_ms / wcfg.slot_ms), (unsigned long)s_wake_epoch);
+    return sleep_ms;
+}
+#endif
+
+/*
+ * Thread 연결 후 페이로드 1건을 확인형으로 전송, 게이트웨이 ACK 여부 반환.
+ * 부모 경유면 ACK에 실려 온 우편함 명령을 바로 처리하고, 게이트웨이 직접이면
+ * 전송 후 CONFIG_CMD_RX_WINDOW_MS 동안 짧은 poll로 부모에 쌓인 다운링크 명령을 받는다.
+ */
+static bool uplink_send(const uint8_t *buf, size_t len)
+{
+    thread_node_init(false);  /* SED 모드 */
+    thread_uplink_config_t ucfg = {
+        .ack_timeout_ms = CONFIG_UPLINK_ACK_TIMEOUT_MS,
+        .max_retransmit = CONFIG_UPLINK_MAX_RETRANSMIT,
+        .gateway_addr   = CONFIG_UPLINK_GATEWAY_ADDR,
+        .via_parent     = UPLINK_VIA_PARENT,
+    };
+    thread_node_config_uplink(&ucfg);
+
+    /* 부모가 다음 전송까지 자식 정보를 유지해야 다음 wake도 Child Update로 복귀 */
+    uint32_t child_timeout = s_period_slow_s * CONFIG_REPORT_BATCH_SIZE + CHILD_TIMEOUT_MARGIN_S;
+    if (child_timeout < CHILD_TIMEOUT_MIN_S) child_timeout = CHILD_TIMEOUT_MIN_S;
+    thread_node_config_sed(child_timeout);
+    thread_node_start();
+
+    bool sent = false;
+    if (thread_node_wait_attached(ATTACH_TIMEOUT_MS) == ESP_OK) {
+        thread_attach_info_t ai;
+        thread_node_get_attach_info(&ai);
+        ESP_LOGI(TAG, "Attached in %lu ms (%s)", (unsigned long)ai.attach_ms,
+                 ai.resumed ? "resume" : "full attach");
+
+        /* ACK는 부모에 간접 전송되므로 짧은 poll로 가져옴 */
+        thread_node_set_poll_period(UPLINK_POLL_MS);
+        sent = (thread_node_send_confirmed(buf, len) == ESP_OK);
+
+        /* ACK에 실린 메시지(부모 우편함 명령 또는 시각 비콘)는 이미 수신 링에 있음.
+         * 명령 응답의 ACK에 다음 명령이 실리므로 링이 빌 때까지 처리.
+         * 부모 경유면 명령이 모두 이 경로로 오므로 수신 창 없이 종료 */
+        if (sent) {
+            while (cmd_dispatcher_poll(0) > 0) {
+            }
+        }
+        bool piggyback = sent && thread_node_uplink_via_parent();
+#if CONFIG_CMD_RX_WINDOW_MS > 0
+        /* 명령 응답도 확인형 — 처리 후 추가 대기 없이 종료 */
+        if (!piggyback) cmd_dispatcher_poll(CONFIG_CMD_RX_WINDOW_MS);
+#endif
+    } else {
+        ESP_LOGW(TAG, "Thread not connected");
+    }
+    thread_node_stop();
+    return sent;
+}
 
 void app_type_b_start(void)
 {
@@ -41,35 +356,76 @@ void app_type_b_start(void)
 
     /* 2. 설정 로드 */
     nvs_config_init();
-    preset_t preset;
-    preset_load(&preset);
+    preset_load(&s_preset);
+
+    uint32_t interval = 0;
+    if (nvs_config_load_u32(REPORT_INTERVAL_KEY, &interval) == ESP_OK &&
+        interval >= REPORT_INTERVAL_MIN && interval <= REPORT_INTERVAL_MAX) {
+        s_period_slow_s = interval;
+    }
+    nvs_config_load_u32(WAKE_EPOCH_KEY, &s_wake_epoch);
+
+    /* 지난 비콘 이후 RTC 드리프트 보정 (배치 시각, wake 슬롯 기준) */
+    if (first_boot) {
+        time_sync_init(&s_time_sync);
+    }
+    scheduler_adjust_time(time_sync_adjust(&s_time_sync, now_us()));
+
+    cmd_dispatcher_config_t ccfg = {
+        .table = s_cmd_table,
+        .count = sizeof(s_cmd_table) / sizeof(s_cmd_table[0]),
+        .ctx = NULL,
+        .use_task = false,
+        .other_rx = time_rx,
+    };
+    cmd_dispatcher_init(&ccfg);
 
-    /* 3. DS18B20 전원 ON */
-    ds18b20_init(CONFIG_SENSOR_DS18B20_GPIO, CONFIG_DS18B20_POWER_GPIO);
+    /* 3. DS18B20 전원 ON + 변환 시작 (비동기) */
+    ds18b20_init(CONFIG_SENSOR_DS18B20_GPIO, CONFIG_DS18B20_POWER_GPIO, ONEWIRE_BACKEND);
+    add_ds_buses();
     ds18b20_power_on();
+    int ds_count = ds_attach();
+    uint8_t role_of[DS18B20_MAX_SENSORS];
+    ds_assign_roles(role_of);
+    /* 전원 투입마다 EEPROM 기본값(12비트)으로 돌아가므로 지난 wake에 고른 해상도 재설정 */
+    if (s_ds_bits >= DS18B20_RES_MIN && s_ds_bits < DS18B20_RES_MAX) {
+        ds18b20_set_resolution(-1, s_ds_bits);
+    }
+    ds18b20_start_conversion();
 
-    /* 4. SHT30 초기화 + 측정 */
+    /* 4. SHT30 초기화 + 측정 (DS18B20 변환과 겹쳐 실행) */
     sht30_init(I2C_NUM_0, GPIO_NUM_6, GPIO_NUM_7, CONFIG_SENSOR_SHT30_ADDR);
     sht30_data_t sht_data = {0};
     sht30_read(&sht_data);
 
-    /* 5. DS18B20 변환 시작 + 대기 */
-    int ds_count = 0;
-    ds18b20_search(&ds_count);
-    ds18b20_start_conversion();
-    vTaskDelay(pdMS_TO_TICKS(750));
+    /* 5. DS18B20 변환 완료 대기 (완료 비트가 서면 750 ms 전에 반환) */
+    ds18b20_wait_conversion(1000);
 
-    /* 6. DS18B20 온도 읽기 */
+    /* 6. DS18B20 온도 읽기 (전체 연달아) → 역할로 핫존/쿨존 */
     float temp_hot = 0.0f, temp_cool = 0.0f;
-    if (ds_count >= 1) ds18b20_read_temp(0, &temp_hot);
-    if (ds_count >= 2) ds18b20_read_temp(1, &temp_cool);
+    bool ds_ok = (ds_count > 0) && ds18b20_read_all() == ds_count;
+    const ds18b20_sensor_t *sensors = ds18b20_get_sensors();
+    int hot = sensor_roles_index(role_of, ds_count, SENSOR_ROLE_HOT);
+    int cool = sensor_roles_index(role_of, ds_count, SENSOR_ROLE_COOL);
+    if (hot >= 0 && sensors[hot].valid) temp_hot = sensors[hot].temperature;
+    if (cool >= 0 && sensors[cool].valid) temp_cool = sensors[cool].temperature;
+    for (int i = 0; i < ds_count; i++) {
+        if (role_of[i] > SENSOR_ROLE_COOL && role_of[i] != SENSOR_ROLE_NONE && sensors[i].valid) {
+            ESP_LOGI(TAG, "T_aux%u=%.1f (bus %u)", role_of[i], sensors[i].temperature,
+                     sensors[i].bus);
+        }
+    }
+    if (!ds_ok) {
+        /* 캐시된 프로브가 빠졌거나 교체됨 → 다음 wake에 검색 */
+        rom_cache_request_rescan(&s_rom_cache);
+    }
 
     ESP_LOGI(TAG, "T_hot=%.1f T_cool=%.1f H=%.1f%%",
              temp_hot, temp_cool, sht_data.humidity);
 
     /* 7. 안전 검사 */
     safety_config_t scfg = {
-        .overtemp_offset   = preset.safety.overtemp_offset,
+        .overtemp_offset   = s_preset.safety.overtemp_offset,
         .heater_max_sec    = 0,     /* Type B: 히터 없음 */
         .stale_timeout_sec = 0,     /* Type B: 단발성 읽기, stale 검사 불필요 */
         .sensor_mismatch_c = 15.0f,
@@ -77,7 +433,7 @@ void app_type_b_start(void)
     };
     safety_init(&scfg);
     safety_status_t status = safety_check(temp_hot, temp_cool,
-                                           preset.temp_hot.target,
+                                           s_preset.temp_hot.target,
                                            sht_data.humidity);
     if (status != SAFETY_OK) {
         ESP_LOGW(TAG, "Safety: %s", safety_status_str(status));
@@ -106,34 +462,57 @@ void app_type_b_start(void)
         .safety_status = (int)status,
     };
 
-    uint8_t cbor_buf[64];
-    size_t cbor_len = 0;
-    if (cbor_encode_report(&report, cbor_buf, sizeof(cbor_buf), &cbor_len) == ESP_OK) {
-        thread_node_init(false);  /* SED 모드 */
-        thread_node_start();
-
-        /* 네트워크 연결 대기 (최대 5초) */
-        for (int i = 0; i < 50 && !thread_node_is_connected(); i++) {
-            vTaskDelay(pdMS_TO_TICKS(100));
-        }
+#if CONFIG_REPORT_BATCH_SIZE > 1
+    /* 배치 모드: RTC 메모리에 누적, N개마다 (또는 이상 시 즉시) 1회 전송 */
+    if (first_boot) {
+        cbor_batch_reset(&s_batch);
+    }
+    cbor_batch_add(&s_batch, (uint32_t)time(NULL), &report);
 
-        if (thread_node_is_connected()) {
-            thread_node_send(cbor_buf, cbor_len);
-            vTaskDelay(pdMS_TO_TICKS(100));  /* 전송 완료 대기 */
+    bool flush = first_boot || status != SAFETY_OK ||
+                 s_batch.count >= CONFIG_REPORT_BATCH_SIZE ||
+                 fabsf(temp_hot - s_prev_temp) >= (float)CONFIG_POLL_DELTA_HIGH / 10.0f;
+    if (flush) {
+        uint8_t cbor_buf[CBOR_BATCH_BUF_SIZE];
+        size_t cbor_len = 0;
+        if (cbor_encode_batch(&s_batch, (uint32_t)time(NULL),
+                              cbor_buf, sizeof(cbor_buf), &cbor_len) == ESP_OK &&
+            uplink_send(cbor_buf, cbor_len)) {
+            cbor_batch_reset(&s_batch);
         } else {
-            ESP_LOGW(TAG, "Thread not connected, data lost");
+            ESP_LOGW(TAG, "Batch kept for next wake (%d samples)", s_batch.count);
         }
-        thread_node_stop();
+    } else {
+        ESP_LOGI(TAG, "Sample buffered (%d/%d)", s_batch.count, CONFIG_REPORT_BATCH_SIZE);
     }
+#else
+    uint8_t cbor_buf[64];
+    size_t cbor_len = 0;
+    if (cbor_encode_report_fmt(&report, REPORT_FORMAT, cbor_buf, sizeof(cbor_buf),
+                               &cbor_len) == ESP_OK) {
+        if (!uplink_send(cbor_buf, cbor_len)) {
+            ESP_LOGW(TAG, "Report not sent, data lost");
+        }
+    }
+#endif
 
     /* 9. 적응형 폴링 주기 계산 */
     adaptive_poll_config_t apcfg = {
         .period_fast_s = CONFIG_POLL_PERIOD_FAST,
-        .period_slow_s = CONFIG_POLL_PERIOD_SLOW,
+        .period_slow_s = s_period_slow_s,
         .delta_high = (float)CONFIG_POLL_DELTA_HIGH / 10.0f,
     };
     adaptive_poll_init(&apcfg);
     uint32_t sleep_sec = adaptive_poll_calc(temp_hot, s_prev_temp);
+
+    /* 다음 wake의 변환 해상도 (안정 시 10비트 188 ms — awake 창 단축) */
+    const temp_resolution_config_t res_cfg = {
+        .guard_c = 2.0f,
+        .stable_c = 0.25f,
+        .stable_bits = CONFIG_DS18B20_STABLE_RESOLUTION,
+    };
+    s_ds_bits = temp_resolution_select(&res_cfg, temp_hot, s_prev_temp,
+                                       s_preset.temp_hot.target + s_preset.safety.overtemp_offset);
     s_prev_temp = temp_hot;
 
     /* 11. DS18B20 전원 OFF + 센서 해제 */
@@ -141,7 +520,13 @@ void app_type_b_start(void)
     ds18b20_deinit();
     sht30_deinit();
 
-    /* 12. Deep Sleep 진입 */
+    /* 12. Deep Sleep 진입 (슬롯 정렬 시 주기는 빠른 주기 배수로 맞춰짐) */
+#if CONFIG_WAKE_SLOT_MS > 0
+    uint32_t sleep_ms = wake_slot_sleep(sleep_sec);
+    ESP_LOGI(TAG, "Sleeping %lu ms...", (unsigned long)sleep_ms);
+    power_mgmt_deep_sleep_ms(sleep_ms);
+#else
     ESP_LOGI(TAG, "Sleeping %lu seconds...", (unsigned long)sleep_sec);
     power_mgmt_deep_sleep(sleep_sec);
+#endif
 }
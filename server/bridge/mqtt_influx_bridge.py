@@ -10,8 +10,14 @@ TLS 지원:
   MQTT TLS:     MQTT_TLS=true, MQTT_CA_CERT=/path/to/ca.pem
 
 토픽: rbms/<node_id>/telemetry
-페이로드: CBOR map {1:temp_hot, 2:temp_cool, 3:humidity, 4:battery_v,
-                     5:heater_duty, 6:light_duty, 7:safety_status}
+페이로드: CBOR map {1:temp_hot, 2:temp_cool, 3:humidity, 4:battery_pct,
+                     5:heater_duty, 6:light_duty, 7:safety_status, 19:schema 버전}
+         키 0 = 1 이면 SCALED 포맷 (값 x100 정수, safety 제외)
+         키 0 = 2 이면 배치 포맷 → 샘플별 timestamp 포인트로 전개
+         키 20 (리포트) = 라우터 중계 대기 초 → 측정 시각을 그만큼 앞당김
+토픽: rbms/<node_id>/status (메시 진단, 키 0 = 6 — firmware mesh_health.h)
+      → measurement mesh_health (노드 카운터), mesh_link (이웃별 RSSI/마진)
+키/필드 이름: rbms_schema.py (schema/telemetry.json 에서 생성)
 """
 
 import logging
@@ -25,6 +31,14 @@ import cbor2
 import paho.mqtt.client as mqtt
 from influxdb import InfluxDBClient
 
+from rbms_schema import (
+    BATCH_SAMPLE_FIELDS, FIELD_MAP, FIELDS, KEY_BATCH_AGE, KEY_BATCH_BASE,
+    KEY_BATCH_DELTAS, KEY_HEALTH_LINKS, KEY_HEALTH_MAC, KEY_HEALTH_MLE,
+    KEY_HEALTH_NODE, KEY_HEALTH_UPLINK, KEY_MSG_TYPE, KEY_SCHEMA_VERSION,
+    MSG_BATCH, MSG_HEALTH, MSG_REPORT, MSG_REPORT_SCALED, SCALED_FACTOR,
+    SCHEMA_VERSION, UNSCALED_KEYS,
+)
+
 # --- 설정 (환경변수) ---
 MQTT_HOST = os.environ.get("MQTT_HOST", "localhost")
 MQTT_PORT = int(os.environ.get("MQTT_PORT", "1883"))
@@ -33,6 +47,7 @@ MQTT_PASS = os.environ.get("MQTT_PASS")
 MQTT_TLS = os.environ.get("MQTT_TLS", "false").lower() in ("true", "1", "yes")
 MQTT_CA_CERT = os.environ.get("MQTT_CA_CERT", "")
 MQTT_TOPIC = "rbms/+/telemetry"
+MQTT_STATUS_TOPIC = "rbms/+/status"
 
 INFLUX_HOST = os.environ.get("INFLUX_HOST", "localhost")
 INFLUX_PORT = int(os.environ.get("INFLUX_PORT", "8086"))
@@ -42,17 +57,25 @@ INFLUX_PASS = os.environ.get("INFLUX_PASS", "")
 INFLUX_SSL = os.environ.get("INFLUX_SSL", "false").lower() in ("true", "1", "yes")
 INFLUX_SSL_CERT = os.environ.get("INFLUX_SSL_CERT", "")  # CA cert path
 
-# CBOR 정수 키 -> 필드 이름 매핑
-FIELD_MAP = {
-    1: "temp_hot",
-    2: "temp_cool",
-    3: "humidity",
-    4: "battery_v",
-    5: "heater_duty",
-    6: "light_duty",
-    7: "safety",
+# 메시지 타입별 (키, 필드 이름, 정수 값 제수) — 시작 시 한 번 계산.
+# 메시지마다 페이로드 키를 FIELD_MAP에서 찾는 대신 스키마 필드만 순회한다.
+FIELD_DECODERS = {
+    MSG_REPORT: tuple((key, name, 1.0) for key, name, _ in FIELDS),
+    MSG_REPORT_SCALED: tuple(
+        (key, name, SCALED_FACTOR if scaled else 1.0)
+        for key, name, scaled in FIELDS),
 }
 
+# 메시 진단 배열 항목 → mesh_health 필드 이름 (firmware mesh_health.h 순서)
+HEALTH_FIELDS = (
+    (KEY_HEALTH_NODE, ("role", "uptime_s", "child_count", "neighbor_count")),
+    (KEY_HEALTH_MLE, ("parent_changes", "attach_attempts", "partition_changes")),
+    (KEY_HEALTH_MAC, ("mac_tx_total", "mac_tx_retry", "mac_tx_err_cca",
+                      "mac_tx_fail", "mac_rx_total", "mac_rx_err")),
+    (KEY_HEALTH_UPLINK, ("con_retransmits", "con_timeouts", "send_errors",
+                         "tx_dropped", "rx_dropped", "relay_failed")),
+)
+
 # 버퍼 설정
 BUFFER_FLUSH_SIZE = 10
 BUFFER_FLUSH_SEC = 5.0
@@ -69,6 +92,7 @@ write_buffer = []
 last_flush_time = time.time()
 retry_count = 0
 MAX_RETRY = 3
+newer_schema_nodes = set()
 
 
 def flush_buffer():
@@ -93,10 +117,91 @@ def flush_buffer():
     last_flush_time = time.time()
 
 
+def expand_batch(data: dict, rx_time: float) -> list:
+    """배치 페이로드를 샘플별 (timestamp, fields) 목록으로 전개
+
+    base_age: 전송 시점 기준 첫 샘플 경과 초
+    deltas:   [dt, d_hot, d_cool, d_hum] * (N-1), 값은 x100 정수
+    """
+    age = data.get(KEY_BATCH_AGE, 0)
+    base = data.get(KEY_BATCH_BASE)
+    deltas = data.get(KEY_BATCH_DELTAS, [])
+    if not isinstance(base, list) or len(base) != 3 \
+            or not isinstance(deltas, list) or len(deltas) % 4 != 0:
+        raise ValueError("malformed batch")
+
+    ts = rx_time - age
+    values = list(base)
+    samples = [(ts, values[:])]
+    for i in range(0, len(deltas), 4):
+        ts += deltas[i]
+        for j in range(3):
+            values[j] += deltas[i + 1 + j]
+        samples.append((ts, values[:]))
+
+    points = []
+    for ts, vals in samples:
+        fields = {name: v / SCALED_FACTOR
+                  for name, v in zip(BATCH_SAMPLE_FIELDS, vals)}
+        points.append((ts, fields))
+
+    # 배치 공통 값 (battery, safety 등 샘플 외 필드)은 마지막 샘플에 기록
+    for key, name in FIELD_MAP.items():
+        value = data.get(key)
+        if name in BATCH_SAMPLE_FIELDS or not isinstance(value, int):
+            continue
+        points[-1][1][name] = (
+            float(value) if key in UNSCALED_KEYS else value / SCALED_FACTOR)
+    return points
+
+
+def expand_health(data: dict) -> list:
+    """메시 진단 → mesh_health 포인트 1개 + 이웃 링크별 mesh_link 포인트
+
+    카운터는 부팅 후 누적값 그대로 기록 (증가율은 조회 시 non_negative_derivative).
+    """
+    fields = {}
+    for key, names in HEALTH_FIELDS:
+        values = data.get(key)
+        if not isinstance(values, list):
+            continue
+        for name, value in zip(names, values):
+            if isinstance(value, int) and not isinstance(value, bool):
+                fields[name] = value
+    links = data.get(KEY_HEALTH_LINKS, [])
+    if not isinstance(links, list):
+        links = []
+
+    points = [("mesh_health", {}, fields)]
+    for link in links:
+        if not (isinstance(link, list) and len(link) == 5
+                and all(isinstance(v, int) for v in link)):
+            continue
+        rloc16, rssi, margin, frame_err, child = link
+        points.append(("mesh_link", {
+            "neighbor": f"{rloc16 & 0xFFFF:04x}",
+            "kind": "child" if child else "router",
+        }, {"rssi": rssi, "link_margin": margin, "frame_err_pct": frame_err}))
+    fields["links_reported"] = len(points) - 1
+    return points
+
+
+def buffer_point(point: dict):
+    global write_buffer
+    # 버퍼 최대 크기 초과 시 가장 오래된 데이터 삭제
+    if len(write_buffer) >= BUFFER_MAX_SIZE:
+        dropped = len(write_buffer) - BUFFER_MAX_SIZE // 2
+        write_buffer = write_buffer[dropped:]
+        log.warning("Buffer overflow: dropped %d oldest points", dropped)
+
+    write_buffer.append(point)
+
+
 def on_connect(client, userdata, flags, rc):
     if rc == 0:
-        log.info("MQTT connected, subscribing to %s", MQTT_TOPIC)
-        client.subscribe(MQTT_TOPIC, qos=1)
+        log.info("MQTT connected, subscribing to %s, %s", MQTT_TOPIC,
+                 MQTT_STATUS_TOPIC)
+        client.subscribe([(MQTT_TOPIC, 1), (MQTT_STATUS_TOPIC, 1)])
     else:
         log.error("MQTT connect failed: rc=%d", rc)
 
@@ -109,7 +214,7 @@ def on_disconnect(client, userdata, rc):
 def on_message(client, userdata, msg):
     global write_buffer
     try:
-        # 토픽에서 node_id 추출: rbms/<node_id>/telemetry
+        # 토픽에서 node_id 추출: rbms/<node_id>/telemetry|status
         parts = msg.topic.split("/")
         if len(parts) != 3:
             return
@@ -121,12 +226,52 @@ def on_message(client, userdata, msg):
             log.warning("Invalid CBOR payload from %s", node_id)
             return
 
-        # 필드 변환
+        # 더 새로운 스키마: 아는 키만 기록 (노드당 한 번 경고)
+        version = data.get(KEY_SCHEMA_VERSION, 0)
+        if isinstance(version, int) and version > SCHEMA_VERSION \
+                and node_id not in newer_schema_nodes:
+            newer_schema_nodes.add(node_id)
+            log.warning("Node %s uses schema v%d (bridge v%d), unknown keys ignored",
+                        node_id, version, SCHEMA_VERSION)
+
+        msg_type = data.get(KEY_MSG_TYPE, MSG_REPORT)
+        if msg_type == MSG_HEALTH:
+            for measurement, tags, fields in expand_health(data):
+                buffer_point({
+                    "measurement": measurement,
+                    "tags": {"node_id": node_id, **tags},
+                    "fields": fields,
+                })
+            if len(write_buffer) >= BUFFER_FLUSH_SIZE:
+                flush_buffer()
+            return
+
+        if msg_type == MSG_BATCH:
+            for ts, fields in expand_batch(data, time.time()):
+                buffer_point({
+                    "measurement": "telemetry",
+                    "tags": {"node_id": node_id},
+                    "time": int(ts * 1e9),
+                    "fields": fields,
+                })
+            if len(write_buffer) >= BUFFER_FLUSH_SIZE:
+                flush_buffer()
+            return
+
+        decoders = FIELD_DECODERS.get(msg_type)
+        if decoders is None:
+            return
+
+        # 필드 변환 (SCALED 포맷은 정수 값을 1/100로 환산)
         fields = {}
-        for key, value in data.items():
-            field_name = FIELD_MAP.get(key)
-            if field_name and isinstance(value, (int, float)):
-                fields[field_name] = float(value)
+        for key, name, divisor in decoders:
+            value = data.get(key)
+            if value is None or isinstance(value, bool):
+                continue
+            if isinstance(value, int):
+                fields[name] = value / divisor
+            elif isinstance(value, float):
+                fields[name] = value
 
         if not fields:
             return
@@ -136,14 +281,11 @@ def on_message(client, userdata, msg):
             "tags": {"node_id": node_id},
             "fields": fields,
         }
-
-        # 버퍼 최대 크기 초과 시 가장 오래된 데이터 삭제
-        if len(write_buffer) >= BUFFER_MAX_SIZE:
-            dropped = len(write_buffer) - BUFFER_MAX_SIZE // 2
-            write_buffer = write_buffer[dropped:]
-            log.warning("Buffer overflow: dropped %d oldest points", dropped)
-
-        write_buffer.append(point)
+        # 라우터가 모아 보낸 리포트: 게이트웨이가 대기 시간을 키 20에 기록
+        age = data.get(KEY_BATCH_AGE)
+        if isinstance(age, int) and not isinstance(age, bool) and age > 0:
+            point["time"] = int((time.time() - age) * 1e9)
+        buffer_point(point)
 
         # 버퍼 플러시 조건
         if len(write_buffer) >= BUFFER_FLUSH_SIZE:
@@ -0,0 +1,83 @@
+"""
+RBMS 텔레메트리 스키마 (자동 생성 — 직접 수정 금지)
+
+원본: schema/telemetry.json
+갱신: python tools/gen_schema.py
+"""
+
+SCHEMA_VERSION = 1
+SCALED_FACTOR = 100.0
+
+# 프로토콜 키
+KEY_MSG_TYPE = 0
+KEY_SCHEMA_VERSION = 19
+KEY_BATCH_AGE = 20
+KEY_BATCH_BASE = 21
+KEY_BATCH_DELTAS = 22
+KEY_AGG_ENTRIES = 23
+KEY_HEALTH_NODE = 24
+KEY_HEALTH_MLE = 25
+KEY_HEALTH_MAC = 26
+KEY_HEALTH_UPLINK = 27
+KEY_HEALTH_LINKS = 28
+KEY_CMD_SEQ = 30
+KEY_CMD_ID = 31
+KEY_CMD_ARG = 32
+KEY_CMD_STATUS = 33
+KEY_ALARM_SEQ = 40
+KEY_ALARM_PREV = 41
+KEY_ALARM_AGE_MS = 42
+KEY_TIME_SEC = 50
+KEY_TIME_MS = 51
+KEY_TIME_UTC_OFFSET = 52
+
+# 메시지 타입 (키 0 값)
+MSG_REPORT = 0
+MSG_REPORT_SCALED = 1
+MSG_BATCH = 2
+MSG_CMD = 3
+MSG_CMD_ACK = 4
+MSG_AGGREGATE = 5
+MSG_HEALTH = 6
+MSG_ALARM = 7
+MSG_TIME = 8
+
+# (키, InfluxDB 필드 이름, SCALED 포맷에서 x100 여부)
+FIELDS = (
+    (1, "temp_hot", True),
+    (2, "temp_cool", True),
+    (3, "humidity", True),
+    (4, "battery_pct", True),
+    (5, "heater_duty", True),
+    (6, "light_duty", True),
+    (7, "safety", False),
+)
+
+FIELD_MAP = {key: name for key, name, _ in FIELDS}
+UNSCALED_KEYS = frozenset(key for key, _, scaled in FIELDS if not scaled)
+BATCH_SAMPLE_FIELDS = ("temp_hot", "temp_cool", "humidity")
+
+# 게이트웨이 검증용: 텔레메트리 + 프로토콜 키
+VALID_KEYS = frozenset(FIELD_MAP) | frozenset({
+    KEY_MSG_TYPE,
+    KEY_SCHEMA_VERSION,
+    KEY_BATCH_AGE,
+    KEY_BATCH_BASE,
+    KEY_BATCH_DELTAS,
+    KEY_AGG_ENTRIES,
+    KEY_HEALTH_NODE,
+    KEY_HEALTH_MLE,
+    KEY_HEALTH_MAC,
+    KEY_HEALTH_UPLINK,
+    KEY_HEALTH_LINKS,
+    KEY_CMD_SEQ,
+    KEY_CMD_ID,
+    KEY_CMD_ARG,
+    KEY_CMD_STATUS,
+    KEY_ALARM_SEQ,
+    KEY_ALARM_PREV,
+    KEY_ALARM_AGE_MS,
+    KEY_TIME_SEC,
+    KEY_TIME_MS,
+    KEY_TIME_UTC_OFFSET,
+})
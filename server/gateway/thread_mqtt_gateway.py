@@ -13,23 +13,64 @@ ESP32-C6 노드의 UDP/CBOR 텔레메트리를 MQTT로 변환 발행.
     -> mqtt_influx_bridge.py (CBOR 디코딩 -> InfluxDB)
 
 노드 ID: 송신자 IPv6 주소의 마지막 4자리 hex
-토픽: rbms/<node_id>/telemetry
+토픽: rbms/<node_id>/telemetry   (리포트/배치)
+      rbms/<node_id>/command/ack (명령 응답, 키 0 = 4)
+      rbms/<node_id>/status      (메시 진단, 키 0 = 6 — Type A Router)
+      rbms/<node_id>/alert       (안전 경보, 키 0 = 7 — JSON, retained, 브릿지 미경유)
+
+다운링크 명령 (rbms/<node_id>/command 구독, CBOR {0: 3, 30: seq, 31: cmd_id, 32: arg}):
+  노드별 대기열(DOWNLINK_QUEUE_MAX)에 보관했다가 노드가 깨어 있을 때 CON unicast
+  - Type B(SED): 업링크 수신 직후 DOWNLINK_AWAKE_SEC 동안 (노드 수신 창)
+  - NON 리포트/진단/집계를 보내는 Router(Type A): 주소를 아는 즉시
+  - 부모 경유 자식(집계로만 보임): 부모 Router에 {0: 5, 23: [[node_id, 0, 명령]]}로
+    맡김 → 부모가 자식의 다음 업링크 ACK에 실어 전달 (firmware child_mailbox.h)
+  노드당 1건씩, ACK 없으면 같은 mid로 재전송, 못 보낸 명령은 다음 업링크까지 유지
+
+전송 프레임 (firmware thread_frame.h):
+  3 bytes 헤더 [Ver=1|Type|0000][mid16] + CBOR
+  CON → 즉시 같은 mid의 ACK를 송신자에게 unicast (노드는 이 주소를 게이트웨이로 학습)
+  (노드, mid) 재전송은 ACK만 다시 보내고 MQTT 발행은 1회
+  헤더 없는 CBOR (구 펌웨어 멀티캐스트)도 그대로 수용
+
+시각 비콘 {0: 8, 50: unix_sec, 51: ms, 52: utc_offset_min} (firmware time_sync.h):
+  TIME_BEACON_SEC마다 ff03::1로 NON 전송 (Router가 수신) + 모든 CON ACK에 실음
+  (Type B는 업링크 ACK로 받음, 부모 경유 자식은 부모 Router가 자기 시각을 실어 줌)
+  utc_offset_min은 게이트웨이 지역 시간대의 현재 오프셋 (TZ 환경 변수, DST 반영)
+
+집계 데이터그램 (Type A 자식 중계, firmware child_agg.h):
+  {0: 5, 23: [[node_id, age, payload], ...]} → 항목마다 rbms/<node_id>/... 로 발행
+  age(라우터 대기 초)는 키 20에 더해 브릿지가 샘플 시각을 보정
 
 MQTT TLS: MQTT_TLS=true, MQTT_CA_CERT=/path/to/ca.pem
 """
 
+import json
 import logging
 import os
+import random
 import signal
 import socket
 import ssl
 import struct
 import sys
+import threading
 import time
+from collections import OrderedDict, deque
 
 import cbor2
 import paho.mqtt.client as mqtt
 
+# 키/메시지 타입은 schema/telemetry.json 생성 모듈 사용 (tools/gen_schema.py)
+from rbms_schema import (
+    KEY_AGG_ENTRIES, KEY_ALARM_AGE_MS, KEY_ALARM_PREV, KEY_ALARM_SEQ,
+    KEY_BATCH_AGE, KEY_CMD_ID, KEY_CMD_SEQ, KEY_MSG_TYPE, KEY_TIME_MS, KEY_TIME_SEC,
+    KEY_TIME_UTC_OFFSET, MSG_AGGREGATE, MSG_ALARM, MSG_CMD, MSG_CMD_ACK, MSG_HEALTH,
+    MSG_TIME, FIELDS, VALID_KEYS,
+)
+
+# 경보의 safety 상태는 텔레메트리 safety 필드 키를 그대로 사용
+KEY_SAFETY = next(key for key, name, _ in FIELDS if name == "safety")
+
 # --- Configuration (env vars) ---
 MQTT_HOST = os.environ.get("MQTT_HOST", "localhost")
 MQTT_PORT = int(os.environ.get("MQTT_PORT", "1883"))
@@ -42,8 +83,30 @@ UDP_PORT = int(os.environ.get("THREAD_UDP_PORT", "5684"))
 THREAD_IFACE = os.environ.get("THREAD_IFACE", "wpan0")
 MULTICAST_GROUP = os.environ.get("THREAD_MULTICAST", "ff03::1")
 
-# CBOR integer key -> field name (firmware cbor_codec.c 와 동일)
-VALID_KEYS = {1, 2, 3, 4, 5, 6, 7}
+# 전송 프레임 (firmware thread_frame.h)
+FRAME_VERSION = 1
+FRAME_HDR_LEN = 3
+FRAME_CON, FRAME_NON, FRAME_ACK, FRAME_RST = 0, 1, 2, 3
+
+# 중복 제거: 노드별 최근 mid 기억 시간 (노드 최대 재전송 구간 이상)
+DEDUP_WINDOW_SEC = 120
+DEDUP_MAX_NODES = 1024
+
+# 다운링크 명령
+COMMAND_TOPIC = "rbms/+/command"
+DOWNLINK_QUEUE_MAX = int(os.environ.get("DOWNLINK_QUEUE_MAX", "8"))     # 노드당 대기 명령
+DOWNLINK_TTL_SEC = int(os.environ.get("DOWNLINK_TTL_SEC", "86400"))      # 전달 못 한 명령 폐기
+DOWNLINK_AWAKE_SEC = float(os.environ.get("DOWNLINK_AWAKE_SEC", "1.0"))  # 업링크 후 수신 가능 구간
+DOWNLINK_ACK_TIMEOUT = 0.3     # 부모 간접 전송 + 노드 poll(100 ms) 왕복
+DOWNLINK_MAX_RETRANSMIT = 3    # 깨어 있는 구간당
+DOWNLINK_PAYLOAD_MAX = 128     # 노드 수신 슬롯 (firmware msg_ring.h MSG_RING_PAYLOAD_MAX)
+MAILBOX_MSG_MAX = 48           # 부모 우편함 항목 (firmware child_mailbox.h CHILD_MAILBOX_MSG_MAX)
+DOWNLINK_MAX_NODES = DEDUP_MAX_NODES
+DOWNLINK_TICK_SEC = 0.1        # 수신 대기 중 재전송/만료 확인 간격
+
+# 시각 비콘 멀티캐스트 주기 (0 = ACK에만 실음)
+TIME_BEACON_SEC = float(os.environ.get("TIME_BEACON_SEC", "60"))
+TIME_BEACON_HOPS = 16          # Thread 메시 전체 (realm-local)
 
 # 소켓 재생성 간격 (wpan0 복구 대기)
 SOCKET_RETRY_INTERVAL = 10  # seconds
@@ -83,12 +146,16 @@ def create_udp_socket() -> socket.socket:
         sock.setsockopt(socket.IPPROTO_IPV6, socket.IPV6_JOIN_GROUP, mreq)
         log.info("Joined multicast %s on %s (index %d)",
                  MULTICAST_GROUP, THREAD_IFACE, iface_index)
+        # 시각 비콘 송신: Thread 인터페이스로, 자기 비콘은 다시 받지 않음
+        sock.setsockopt(socket.IPPROTO_IPV6, socket.IPV6_MULTICAST_IF, iface_index)
+        sock.setsockopt(socket.IPPROTO_IPV6, socket.IPV6_MULTICAST_HOPS, TIME_BEACON_HOPS)
+        sock.setsockopt(socket.IPPROTO_IPV6, socket.IPV6_MULTICAST_LOOP, 0)
     except OSError as e:
         log.warning("Multicast join failed (%s may not exist yet): %s",
                     THREAD_IFACE, e)
         log.info("Will receive unicast UDP only on port %d", UDP_PORT)
 
-    sock.settimeout(1.0)
+    sock.settimeout(DOWNLINK_TICK_SEC)
     return sock
 
 
@@ -106,25 +173,358 @@ def try_rejoin_multicast(sock: socket.socket) -> bool:
         return False
 
 
-def validate_cbor(data: bytes) -> bool:
-    """CBOR 페이로드 유효성 검증"""
+def parse_frame(data: bytes):
+    """전송 헤더 분리 → (type, mid, payload), 헤더 없는 CBOR은 (None, None, data)
+
+    잘못된 헤더면 None
+    """
+    if not data or data[0] >> 6 != FRAME_VERSION:
+        return None, None, data
+    if len(data) < FRAME_HDR_LEN or data[0] & 0x0F:
+        return None
+    ftype = (data[0] >> 4) & 0x03
+    mid = (data[1] << 8) | data[2]
+    return ftype, mid, data[FRAME_HDR_LEN:]
+
+
+def make_frame(ftype: int, mid: int, payload: bytes = b"") -> bytes:
+    return bytes(((FRAME_VERSION << 6) | (ftype << 4), mid >> 8, mid & 0xFF)) + payload
+
+
+class DedupCache:
+    """(노드 주소, mid) 최근 수신 기록 — 재전송을 한 번만 발행"""
+
+    def __init__(self, window: float = DEDUP_WINDOW_SEC, max_nodes: int = DEDUP_MAX_NODES):
+        self.window = window
+        self.max_nodes = max_nodes
+        self.nodes = OrderedDict()  # addr -> {mid: 수신 시각}
+
+    def seen(self, addr: str, mid: int, now: float) -> bool:
+        mids = self.nodes.pop(addr, None)
+        if mids is None:
+            mids = {}
+        self.nodes[addr] = mids  # LRU: 최근 노드를 뒤로
+        if len(self.nodes) > self.max_nodes:
+            self.nodes.popitem(last=False)
+
+        expired = [m for m, t in mids.items() if now - t > self.window]
+        for m in expired:
+            del mids[m]
+        if mid in mids:
+            return True
+        mids[mid] = now
+        return False
+
+
+def parse_command(data: bytes):
+    """MQTT 명령 페이로드 검증 → seq (형식 오류면 None)
+
+    노드 디스패처와 같이 {0: 3} 마커가 맵 첫 항목이어야 한다.
+    """
+    if len(data) > DOWNLINK_PAYLOAD_MAX:
+        return None
+    try:
+        cmd = cbor2.loads(data)
+    except Exception:
+        return None
+    if not isinstance(cmd, dict) or not cmd or next(iter(cmd)) != KEY_MSG_TYPE:
+        return None
+    seq = cmd.get(KEY_CMD_SEQ)
+    cmd_id = cmd.get(KEY_CMD_ID)
+    if (cmd[KEY_MSG_TYPE] != MSG_CMD
+            or not isinstance(seq, int) or not 0 <= seq <= 0xFFFF
+            or not isinstance(cmd_id, int) or not 0 <= cmd_id <= 0xFF):
+        return None
+    return seq
+
+
+class Downlink:
+    """노드별 다운링크 명령 대기열 (MQTT 스레드 enqueue → UDP 루프 전송)
+
+    명령은 노드가 수신 중일 때만 보낸다: 업링크 직후 DOWNLINK_AWAKE_SEC 동안
+    (Type B 수신 창), 또는 rx_on으로 표시된 Router. 부모 경유 자식(via)의 명령은
+    부모 Router에 우편으로 보내고 부모의 ACK로 전달 완료 처리한다.
+    노드당 CON 1건씩 보내고 ACK를 받으면 다음 명령을 바로 보낸다. 재전송은 같은
+    mid (노드가 중복 제거, 같은 seq는 디스패처가 재실행하지 않음), 재전송이 소진되면
+    다음 업링크까지 보류(held).
+    """
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.nodes = OrderedDict()  # node_id -> 상태 (LRU, 대기 명령 없는 노드부터 제거)
+        self.next_mid = random.getrandbits(16)  # 재시작 후 노드 중복 캐시와 겹치지 않게
+        self.stats = {"queued": 0, "sent": 0, "acked": 0, "rejected": 0, "expired": 0}
+
+    def _node(self, node_id: str):
+        node = self.nodes.get(node_id)
+        if node is not None:
+            self.nodes.move_to_end(node_id)
+            return node
+        if len(self.nodes) >= DOWNLINK_MAX_NODES:
+            idle = next((k for k, n in self.nodes.items() if not n["queue"]), None)
+            if idle is None:
+                return None
+            del self.nodes[idle]
+        node = {"addr": None, "awake_until": 0.0, "rx_on": False, "via": None,
+                "held": False, "queue": deque(), "mid": None, "sent_at": 0.0, "tries": 0}
+        self.nodes[node_id] = node
+        return node
+
+    def enqueue(self, node_id: str, seq: int, data: bytes, now: float) -> bool:
+        """명령 추가 (같은 seq가 이미 있으면 MQTT 재전달로 보고 무시), 가득 차면 거부"""
+        with self.lock:
+            node = self._node(node_id)
+            if node is None or len(node["queue"]) >= DOWNLINK_QUEUE_MAX:
+                self.stats["rejected"] += 1
+                return False
+            if all(s != seq for s, _, _ in node["queue"]):
+                node["queue"].append((seq, data, now))
+                self.stats["queued"] += 1
+            return True
+
+    def heard(self, node_id: str, addr_info, now: float, rx_on: bool):
+        """노드 데이터그램 수신 → 주소와 수신 가능 구간 갱신"""
+        with self.lock:
+            node = self._node(node_id)
+            if node is None:
+                return
+            node["addr"] = addr_info
+            node["awake_until"] = now + DOWNLINK_AWAKE_SEC
+            node["rx_on"] = node["rx_on"] or rx_on
+            node["via"] = None
+            node["held"] = False
+            node["tries"] = 0
+
+    def relayed(self, node_id: str, router_id: str):
+        """부모 Router 집계로 자식 데이터 수신 → 이후 명령은 그 부모에 맡김"""
+        with self.lock:
+            node = self._node(node_id)
+            if node is None:
+                return
+            if node["via"] != router_id:
+                node["mid"] = None  # 다른 경로로 보낸 mid는 무효
+            node["via"] = router_id
+            node["held"] = False
+            node["tries"] = 0
+
+    def acked(self, sender_id: str, ftype: int, mid: int, now: float):
+        """전송 중인 명령의 ACK/RST (노드 또는 우편을 받은 부모) → 대기열에서 제거"""
+        with self.lock:
+            node_id = next((k for k, n in self.nodes.items()
+                            if n["mid"] == mid and n["queue"]
+                            and (n["via"] or k) == sender_id), None)
+            if node_id is None:
+                return
+            node = self.nodes[node_id]
+            seq = node["queue"].popleft()[0]
+            node["mid"] = None
+            node["tries"] = 0
+            if node["via"] is None:
+                node["awake_until"] = now + DOWNLINK_AWAKE_SEC
+            if ftype != FRAME_ACK:
+                self.stats["rejected"] += 1
+                log.warning("Node %s: command seq %d rejected (RST)", node_id, seq)
+            elif node["via"] is not None:
+                self.stats["acked"] += 1
+                log.info("Node %s: command seq %d left at parent %s", node_id, seq, sender_id)
+            else:
+                self.stats["acked"] += 1
+                log.info("Node %s: command seq %d delivered", node_id, seq)
+
+    def due(self, now: float) -> list:
+        """지금 보낼 [(주소, 프레임)] — 새 명령과 ACK 타임아웃 재전송"""
+        out = []
+        with self.lock:
+            for node_id, node in self.nodes.items():
+                queue = node["queue"]
+                while queue and now - queue[0][2] > DOWNLINK_TTL_SEC:
+                    seq = queue.popleft()[0]
+                    node["mid"] = None
+                    self.stats["expired"] += 1
+                    log.warning("Node %s: command seq %d expired undelivered", node_id, seq)
+                if not queue or node["held"]:
+                    continue
+                dest = node if node["via"] is None else self.nodes.get(node["via"])
+                if dest is None or dest["addr"] is None:
+                    continue
+                if not dest["rx_on"] and now >= dest["awake_until"]:
+                    continue
+                if node["mid"] is not None:
+                    if now - node["sent_at"] < DOWNLINK_ACK_TIMEOUT:
+                        continue
+                    if node["tries"] >= DOWNLINK_MAX_RETRANSMIT:
+                        # 잠들었거나 연결 끊김: 다음 업링크까지 보류
+                        node["held"] = True
+                        log.info("Node %s: command seq %d held until next uplink",
+                                 node_id, queue[0][0])
+                        continue
+                    node["tries"] += 1
+                else:
+                    node["mid"] = self.next_mid
+                    self.next_mid = (self.next_mid + 1) & 0xFFFF
+                    node["tries"] = 0
+                data = queue[0][1]
+                if node["via"] is not None:
+                    if len(data) > MAILBOX_MSG_MAX:
+                        queue.popleft()
+                        node["mid"] = None
+                        self.stats["rejected"] += 1
+                        log.warning("Node %s: command too large for parent mailbox", node_id)
+                        continue
+                    data = cbor2.dumps({KEY_MSG_TYPE: MSG_AGGREGATE,
+                                        KEY_AGG_ENTRIES: [[int(node_id, 16), 0, data]]})
+                node["sent_at"] = now
+                out.append((dest["addr"], make_frame(FRAME_CON, node["mid"], data)))
+                self.stats["sent"] += 1
+        return out
+
+    def pending(self) -> int:
+        with self.lock:
+            return sum(len(n["queue"]) for n in self.nodes.values())
+
+
+def time_beacon(now: float) -> bytes:
+    """현재 시각 비콘 CBOR (키 0이 먼저 — 노드 디코더 요구)"""
+    sec = int(now)
+    offset_min = time.localtime(sec).tm_gmtoff // 60
+    return cbor2.dumps({
+        KEY_MSG_TYPE: MSG_TIME,
+        KEY_TIME_SEC: sec,
+        KEY_TIME_MS: min(int((now - sec) * 1000), 999),
+        KEY_TIME_UTC_OFFSET: offset_min,
+    })
+
+
+def send_time_beacon(sock: socket.socket, mid: int):
+    """ff03::1로 시각 비콘 NON 전송 (Router 수신, mid는 노드 중복 제거용)"""
+    try:
+        addr = (MULTICAST_GROUP, UDP_PORT, 0, socket.if_nametoindex(THREAD_IFACE))
+        sock.sendto(make_frame(FRAME_NON, mid, time_beacon(time.time())), addr)
+    except OSError as e:
+        log.debug("Time beacon send failed: %s", e)
+
+
+def decode_cbor(data: bytes):
+    """CBOR 페이로드 검증 후 dict 반환 (유효하지 않으면 None)"""
     try:
         payload = cbor2.loads(data)
         if not isinstance(payload, dict):
-            return False
+            return None
         # At least one valid key must be present
-        return any(k in VALID_KEYS for k in payload.keys())
+        if not any(k in VALID_KEYS for k in payload.keys()):
+            return None
+        return payload
     except Exception:
-        return False
+        return None
+
+
+def unpack_aggregate(payload: dict) -> list:
+    """집계 데이터그램 → [(node_id, 디코딩된 dict, 발행할 CBOR)]
+
+    형식이 잘못된 항목은 건너뛴다. 리포트/배치는 라우터 대기 시간(age)을
+    키 20에 더해 다시 인코딩한다 (배치는 base_age에 누적).
+    """
+    entries = payload.get(KEY_AGG_ENTRIES)
+    if not isinstance(entries, list):
+        return []
+
+    out = []
+    for entry in entries:
+        if not (isinstance(entry, list) and len(entry) == 3
+                and isinstance(entry[0], int) and isinstance(entry[1], int)
+                and isinstance(entry[2], bytes)):
+            continue
+        node_id = f"{entry[0] & 0xFFFF:04x}"
+        age = max(entry[1], 0)
+        child = decode_cbor(entry[2])
+        if child is None or child.get(KEY_MSG_TYPE) == MSG_AGGREGATE:
+            continue
+        data = entry[2]
+        if age > 0 and child.get(KEY_MSG_TYPE) == MSG_ALARM:
+            child[KEY_ALARM_AGE_MS] = child.get(KEY_ALARM_AGE_MS, 0) + age * 1000
+            data = cbor2.dumps(child)
+        elif age > 0 and child.get(KEY_MSG_TYPE) != MSG_CMD_ACK:
+            child[KEY_BATCH_AGE] = child.get(KEY_BATCH_AGE, 0) + age
+            data = cbor2.dumps(child)
+        out.append((node_id, child, data))
+    return out
+
+
+def alert_json(node_id: str, payload: dict, rx_time: float) -> bytes:
+    """경보 → retained 알림용 JSON (감지 시각 = 수신 시각 - 노드 측 경과 ms)"""
+    age_ms = payload.get(KEY_ALARM_AGE_MS, 0)
+    if not isinstance(age_ms, int) or age_ms < 0:
+        age_ms = 0
+    return json.dumps({
+        "node_id": node_id,
+        "safety": payload.get(KEY_SAFETY),
+        "prev": payload.get(KEY_ALARM_PREV),
+        "seq": payload.get(KEY_ALARM_SEQ),
+        "age_ms": age_ms,
+        "detected_at": round(rx_time - age_ms / 1000.0, 3),
+        "received_at": round(rx_time, 3),
+    }).encode()
+
+
+def publish(mqttc, node_id: str, payload: dict, data: bytes, stats: dict):
+    """CBOR 그대로 MQTT 발행 (명령 응답/메시 진단/경보는 별도 토픽)"""
+    msg_type = payload.get(KEY_MSG_TYPE)
+    retain = False
+    if msg_type == MSG_ALARM:
+        # 경보: 브릿지 버퍼를 거치지 않는 retained 토픽 (구독 즉시 현재 상태 수신)
+        topic = f"rbms/{node_id}/alert"
+        data = alert_json(node_id, payload, time.time())
+        retain = True
+        log.warning("Node %s: safety %s -> %s (alarm #%s, %s ms after detection)",
+                    node_id, payload.get(KEY_ALARM_PREV), payload.get(KEY_SAFETY),
+                    payload.get(KEY_ALARM_SEQ), payload.get(KEY_ALARM_AGE_MS))
+    elif msg_type == MSG_CMD_ACK:
+        topic = f"rbms/{node_id}/command/ack"
+    elif msg_type == MSG_HEALTH:
+        topic = f"rbms/{node_id}/status"
+    else:
+        topic = f"rbms/{node_id}/telemetry"
+    result = mqttc.publish(topic, data, qos=1, retain=retain)
+
+    if result.rc == mqtt.MQTT_ERR_SUCCESS:
+        stats["pub"] += 1
+        log.debug("Node %s: %d bytes -> %s", node_id, len(data), topic)
+    else:
+        stats["err"] += 1
+        log.error("MQTT publish failed for node %s: rc=%d", node_id, result.rc)
+
+
+def send_frame(sock: socket.socket, addr_info, frame: bytes):
+    """노드에 ACK/RST/명령 unicast (수신 주소 그대로, scope id 포함)"""
+    try:
+        sock.sendto(frame, addr_info)
+    except OSError as e:
+        log.warning("Frame send to %s failed: %s", addr_info[0], e)
 
 
 def on_mqtt_connect(client, userdata, flags, rc):
     if rc == 0:
         log.info("MQTT connected to %s:%d", MQTT_HOST, MQTT_PORT)
+        client.subscribe(COMMAND_TOPIC, qos=1)  # 재연결마다 재구독
     else:
         log.error("MQTT connect failed: rc=%d", rc)
 
 
+def on_mqtt_message(client, downlink, msg):
+    """rbms/<node_id>/command → 다운링크 대기열 (paho 네트워크 스레드)"""
+    parts = msg.topic.split("/")
+    node_id = parts[1].lower() if len(parts) == 3 else ""
+    seq = parse_command(msg.payload)
+    if (len(node_id) != 4 or any(c not in "0123456789abcdef" for c in node_id)
+            or seq is None):
+        log.warning("Invalid command on %s, %d bytes", msg.topic, len(msg.payload))
+        return
+    if downlink.enqueue(node_id, seq, msg.payload, time.time()):
+        log.info("Node %s: command seq %d queued", node_id, seq)
+    else:
+        log.warning("Node %s: command queue full, seq %d dropped", node_id, seq)
+
+
 def on_mqtt_disconnect(client, userdata, rc):
     if rc != 0:
         log.warning("MQTT unexpected disconnect: rc=%d, will reconnect", rc)
@@ -136,10 +536,13 @@ def main():
         log.error("MQTT_PASS environment variable is required")
         sys.exit(1)
 
+    downlink = Downlink()
+
     # MQTT client
-    mqttc = mqtt.Client(client_id="rbms-gateway")
+    mqttc = mqtt.Client(client_id="rbms-gateway", userdata=downlink)
     mqttc.username_pw_set(MQTT_USER, MQTT_PASS)
     mqttc.on_connect = on_mqtt_connect
+    mqttc.on_message = on_mqtt_message
     mqttc.on_disconnect = on_mqtt_disconnect
     mqttc.reconnect_delay_set(min_delay=1, max_delay=30)
 
@@ -169,7 +572,14 @@ def main():
     signal.signal(signal.SIGTERM, stop)
     signal.signal(signal.SIGINT, stop)
 
-    stats = {"rx": 0, "pub": 0, "err": 0, "invalid": 0}
+    def flush_downlink(now: float):
+        for addr_info, frame in downlink.due(now):
+            send_frame(sock, addr_info, frame)
+
+    stats = {"rx": 0, "pub": 0, "err": 0, "invalid": 0, "dup": 0}
+    beacon_mid = random.randrange(0x10000)
+    last_beacon_time = 0.0
+    dedup = DedupCache()
     stats_interval = 300  # 5 min
     last_stats_time = time.time()
     consecutive_errors = 0
@@ -177,17 +587,28 @@ def main():
 
     try:
         while running:
+            # 주기적 시각 비콘 (수신이 많아도 recv 전에 확인)
+            if TIME_BEACON_SEC > 0 and time.time() - last_beacon_time >= TIME_BEACON_SEC:
+                send_time_beacon(sock, beacon_mid)
+                beacon_mid = (beacon_mid + 1) & 0xFFFF
+                last_beacon_time = time.time()
+
             try:
                 data, addr_info = sock.recvfrom(512)
                 addr = addr_info[0]  # IPv6 address string
                 consecutive_errors = 0
             except socket.timeout:
                 now = time.time()
+                flush_downlink(now)
+
                 # 주기적 통계 로그
                 if now - last_stats_time >= stats_interval:
-                    log.info("Stats: rx=%d pub=%d err=%d invalid=%d",
-                             stats["rx"], stats["pub"],
-                             stats["err"], stats["invalid"])
+                    dl = downlink.stats
+                    log.info("Stats: rx=%d pub=%d err=%d invalid=%d dup=%d "
+                             "cmd queued=%d sent=%d acked=%d rejected=%d expired=%d pending=%d",
+                             stats["rx"], stats["pub"], stats["err"],
+                             stats["invalid"], stats["dup"], dl["queued"], dl["sent"],
+                             dl["acked"], dl["rejected"], dl["expired"], downlink.pending())
                     last_stats_time = now
 
                 # 주기적 멀티캐스트 재가입 시도 (wpan0 복구 감지)
@@ -222,31 +643,72 @@ def main():
             stats["rx"] += 1
             node_id = extract_node_id(addr)
 
-            # Validate CBOR before forwarding
-            if not validate_cbor(data):
+            frame = parse_frame(data)
+            if frame is None:
+                stats["invalid"] += 1
+                log.warning("Invalid frame header from %s, %d bytes", addr, len(data))
+                continue
+            ftype, mid, data = frame
+            if ftype in (FRAME_ACK, FRAME_RST):
+                # 다운링크 명령 응답 — 노드가 아직 수신 중이면 다음 명령 전송
+                now = time.time()
+                downlink.acked(node_id, ftype, mid, now)
+                flush_downlink(now)
+                continue
+
+            # Validate CBOR before acknowledging / forwarding
+            payload = decode_cbor(data)
+            if payload is None:
                 stats["invalid"] += 1
                 log.warning("Invalid CBOR from %s (node %s), %d bytes",
                             addr, node_id, len(data))
+                if ftype == FRAME_CON:
+                    send_frame(sock, addr_info, make_frame(FRAME_RST, mid))
                 continue
 
-            # Forward raw CBOR to MQTT
-            topic = f"rbms/{node_id}/telemetry"
-            result = mqttc.publish(topic, data, qos=1)
+            # 시각 비콘은 게이트웨이 → 노드 방향 전용
+            if payload.get(KEY_MSG_TYPE) == MSG_TIME:
+                continue
 
-            if result.rc == mqtt.MQTT_ERR_SUCCESS:
-                stats["pub"] += 1
-                log.debug("Node %s: %d bytes -> %s", node_id, len(data), topic)
-            else:
-                stats["err"] += 1
-                log.error("MQTT publish failed for node %s: rc=%d",
-                          node_id, result.rc)
+            # CON: 중복이어도 ACK 재전송 (이전 ACK 손실), 발행은 1회
+            # ACK에 현재 시각을 실어 보냄 (Type B의 유일한 시각 소스)
+            if ftype == FRAME_CON:
+                send_frame(sock, addr_info,
+                           make_frame(FRAME_ACK, mid, time_beacon(time.time())))
+
+            # 업링크 = 노드가 깨어 있음 → 대기 명령 전송 (재전송도 포함)
+            # NON 리포트/진단/집계는 Router(Type A)만 보내므로 항상 수신으로 표시
+            now = time.time()
+            rx_on = (ftype == FRAME_NON
+                     or payload.get(KEY_MSG_TYPE) in (MSG_AGGREGATE, MSG_HEALTH))
+            downlink.heard(node_id, addr_info, now, rx_on)
+            flush_downlink(now)
+
+            if mid is not None and dedup.seen(addr, mid, now):
+                stats["dup"] += 1
+                log.debug("Node %s: duplicate mid %d dropped", node_id, mid)
+                continue
+
+            # 집계 데이터그램은 자식 노드별로 풀어서 발행
+            if payload.get(KEY_MSG_TYPE) == MSG_AGGREGATE:
+                children = unpack_aggregate(payload)
+                log.debug("Router %s: %d child reports", node_id, len(children))
+                for child_id, child, child_data in children:
+                    downlink.relayed(child_id, node_id)
+                    publish(mqttc, child_id, child, child_data, stats)
+                flush_downlink(now)
+                continue
+
+            # Forward raw CBOR to MQTT
+            publish(mqttc, node_id, payload, data, stats)
 
     finally:
         sock.close()
         mqttc.loop_stop()
         mqttc.disconnect()
-        log.info("Gateway stopped (rx=%d pub=%d err=%d invalid=%d)",
-                 stats["rx"], stats["pub"], stats["err"], stats["invalid"])
+        log.info("Gateway stopped (rx=%d pub=%d err=%d invalid=%d dup=%d)",
+                 stats["rx"], stats["pub"], stats["err"], stats["invalid"],
+                 stats["dup"])
 
 
 if __name__ == "__main__":
@@ -141,11 +141,13 @@ echo "  인증 정보 저장: $INSTALL_DIR/.env"
 # --- 6. Gateway (Thread UDP -> MQTT) ---
 echo "[6/9] Thread UDP->MQTT 게이트웨이 설치..."
 cp "$SERVER_DIR/gateway/thread_mqtt_gateway.py" "$INSTALL_DIR/gateway/"
+cp "$SERVER_DIR/gateway/rbms_schema.py" "$INSTALL_DIR/gateway/"
 cp "$SERVER_DIR/gateway/requirements.txt" "$INSTALL_DIR/gateway/"
 
 # --- 7. Bridge (MQTT -> InfluxDB) ---
 echo "[7/9] MQTT->InfluxDB 브릿지 설치..."
 cp "$SERVER_DIR/bridge/mqtt_influx_bridge.py" "$INSTALL_DIR/bridge/"
+cp "$SERVER_DIR/bridge/rbms_schema.py" "$INSTALL_DIR/bridge/"
 cp "$SERVER_DIR/bridge/requirements.txt" "$INSTALL_DIR/bridge/"
 
 # Shared Python venv for both gateway and bridge
@@ -0,0 +1,121 @@
+/**
+ * @file bench_cbor_reader.c
+ * @brief Throughput benchmark for the streaming CBOR reader
+ *
+ * make bench
+ *
+ * malloc/calloc/realloc를 링커 --wrap으로 가로채 디코드 루프 중
+ * 힙 할당이 0회인지 확인한다 (OT 콜백 경로 요구사항).
+ * 할당이 발생하면 exit 1.
+ */
+#define _POSIX_C_SOURCE 199309L
+#include "cbor_reader.h"
+#include "cbor_codec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static volatile long s_alloc_count;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t size);
+
+void *__wrap_malloc(size_t size) { s_alloc_count++; return __real_malloc(size); }
+void *__wrap_calloc(size_t n, size_t size) { s_alloc_count++; return __real_calloc(n, size); }
+void *__wrap_realloc(void *p, size_t size) { s_alloc_count++; return __real_realloc(p, size); }
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* 다운링크 형태 메시지: {0: 3, 1: 42, 2: 5, 3: [32.5, 26.0], 4: "preset-a", 5: h'00..0f'} */
+static const uint8_t s_downlink[] = {
+    0xA6,
+    0x00, 0x03,
+    0x01, 0x18, 0x2A,
+    0x02, 0x05,
+    0x03, 0x82, 0xFA, 0x42, 0x02, 0x00, 0x00, 0xFA, 0x41, 0xD0, 0x00, 0x00,
+    0x04, 0x68, 'p', 'r', 'e', 's', 'e', 't', '-', 'a',
+    0x05, 0x50, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+};
+
+/* 전체 항목 순회 (컨테이너 전개) */
+static uint64_t walk_all(const uint8_t *buf, size_t len)
+{
+    cbor_reader_t r;
+    cbor_item_t item;
+    uint64_t acc = 0;
+    cbor_reader_init(&r, buf, len);
+    while (cbor_reader_next(&r, &item) == ESP_OK) {
+        acc += item.type + item.uval + item.len;
+    }
+    return acc;
+}
+
+static void report(const char *name, long iters, size_t bytes, double sec)
+{
+    printf("%-28s %8.1f ns/msg  %8.1f MB/s\n", name,
+           sec * 1e9 / (double)iters,
+           (double)bytes * (double)iters / sec / 1e6);
+}
+
+int main(int argc, char **argv)
+{
+    long iters = (argc > 1) ? strtol(argv[1], NULL, 10) : 1000000;
+
+    sensor_report_t src = {
+        .temp_hot = 32.5f, .temp_cool = 26.0f, .humidity = 60.0f,
+        .battery_pct = 85.0f, .heater_duty = 45.0f, .light_duty = 100.0f,
+        .safety_status = 0,
+    };
+    uint8_t report_buf[64];
+    size_t report_len = 0;
+    cbor_encode_report_fmt(&src, CBOR_REPORT_SCALED, report_buf, sizeof(report_buf), &report_len);
+
+    sensor_batch_t batch;
+    cbor_batch_reset(&batch);
+    for (int i = 0; i < CBOR_BATCH_MAX_SAMPLES; i++) {
+        src.temp_hot += 0.25f;
+        cbor_batch_add(&batch, 100 + (uint32_t)i * 60, &src);
+    }
+    uint8_t batch_buf[CBOR_BATCH_BUF_SIZE];
+    size_t batch_len = 0;
+    cbor_encode_batch(&batch, 700, batch_buf, sizeof(batch_buf), &batch_len);
+
+    /* stdout 버퍼 할당을 측정 전에 끝내둔다 */
+    printf("bench_cbor_reader: %ld iterations\n", iters);
+
+    uint64_t sink = 0;
+    s_alloc_count = 0;
+
+    double t0 = now_sec();
+    for (long i = 0; i < iters; i++) {
+        sink += walk_all(s_downlink, sizeof(s_downlink));
+    }
+    report("reader walk (downlink)", iters, sizeof(s_downlink), now_sec() - t0);
+
+    sensor_report_t out;
+    t0 = now_sec();
+    for (long i = 0; i < iters; i++) {
+        cbor_decode_report(report_buf, report_len, &out);
+        sink += (uint64_t)out.safety_status;
+    }
+    report("cbor_decode_report (scaled)", iters, report_len, now_sec() - t0);
+
+    sensor_batch_t bout;
+    t0 = now_sec();
+    for (long i = 0; i < iters; i++) {
+        cbor_decode_batch(batch_buf, batch_len, 700, &bout);
+        sink += bout.count;
+    }
+    report("cbor_decode_batch (8)", iters, batch_len, now_sec() - t0);
+
+    long allocs = s_alloc_count;
+    printf("heap allocations during decode: %ld (sink %llu)\n",
+           allocs, (unsigned long long)sink);
+    return (allocs == 0) ? 0 : 1;
+}
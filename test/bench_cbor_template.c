@@ -0,0 +1,90 @@
+/**
+ * @file bench_cbor_template.c
+ * @brief Report encoder benchmark: full rebuild vs template patch
+ *
+ * make bench
+ *
+ * 같은 필드 구성의 리포트를 반복 인코딩하여 cbor_encode_report() /
+ * cbor_encode_report_fmt(SCALED)와 cbor_template_patch()를 비교한다.
+ */
+#define _POSIX_C_SOURCE 199309L
+#include "cbor_codec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void report(const char *name, long iters, size_t bytes, double sec, double base)
+{
+    double ns = sec * 1e9 / (double)iters;
+    printf("%-30s %7.1f ns/report  %2d bytes", name, ns, (int)bytes);
+    if (base > 0.0) {
+        printf("  (%.1fx)", base / ns);
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    long iters = (argc > 1) ? strtol(argv[1], NULL, 10) : 2000000;
+
+    sensor_report_t r = {
+        .temp_hot = 32.5f, .temp_cool = 26.0f, .humidity = 60.0f,
+        .battery_pct = -1.0f, .heater_duty = 45.0f, .light_duty = 100.0f,
+        .safety_status = 0,
+    };
+    printf("bench_cbor_template: %ld iterations (Type A report)\n", iters);
+
+    volatile uint8_t sink = 0;
+    uint8_t buf[64];
+    size_t len = 0;
+
+    /* 매 반복 값이 바뀌도록 (실제 주기와 동일하게) */
+    double t0 = now_sec();
+    for (long i = 0; i < iters; i++) {
+        r.temp_hot = 30.0f + (float)(i & 63) * 0.05f;
+        cbor_encode_report(&r, buf, sizeof(buf), &len);
+        sink ^= buf[len - 1];
+    }
+    double base_f32 = (now_sec() - t0) * 1e9 / (double)iters;
+    report("cbor_encode_report (f32)", iters, len, base_f32 * (double)iters / 1e9, 0.0);
+
+    t0 = now_sec();
+    for (long i = 0; i < iters; i++) {
+        r.temp_hot = 30.0f + (float)(i & 63) * 0.05f;
+        cbor_encode_report_fmt(&r, CBOR_REPORT_SCALED, buf, sizeof(buf), &len);
+        sink ^= buf[len - 1];
+    }
+    double base_scaled = (now_sec() - t0) * 1e9 / (double)iters;
+    report("cbor_encode_report_fmt (scaled)", iters, len, base_scaled * (double)iters / 1e9, 0.0);
+
+    cbor_report_template_t tmpl;
+    const uint8_t *data = NULL;
+
+    cbor_template_encode(&tmpl, &r, CBOR_REPORT_FLOAT32, &data, &len);
+    t0 = now_sec();
+    for (long i = 0; i < iters; i++) {
+        r.temp_hot = 30.0f + (float)(i & 63) * 0.05f;
+        cbor_template_encode(&tmpl, &r, CBOR_REPORT_FLOAT32, &data, &len);
+        sink ^= data[len - 1];
+    }
+    report("template patch (f32)", iters, len, now_sec() - t0, base_f32);
+
+    cbor_template_encode(&tmpl, &r, CBOR_REPORT_SCALED, &data, &len);
+    t0 = now_sec();
+    for (long i = 0; i < iters; i++) {
+        r.temp_hot = 30.0f + (float)(i & 63) * 0.05f;
+        cbor_template_encode(&tmpl, &r, CBOR_REPORT_SCALED, &data, &len);
+        sink ^= data[len - 1];
+    }
+    report("template patch (scaled)", iters, len, now_sec() - t0, base_scaled);
+
+    printf("(sink %u)\n", (unsigned)sink);
+    return 0;
+}
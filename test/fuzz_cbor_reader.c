@@ -0,0 +1,140 @@
+/**
+ * @file fuzz_cbor_reader.c
+ * @brief Fuzz target for the streaming CBOR reader and report/batch decoders
+ *
+ * libFuzzer:  make fuzz-libfuzzer   (clang -fsanitize=fuzzer,address,undefined)
+ * Standalone: make fuzz             (gcc + ASan/UBSan, 시드 변이 반복)
+ *
+ * 검사 항목: 입력 범위 밖 읽기 없음 (ASan), pos 단조 증가 및 len 이하,
+ * 문자열 포인터가 입력 버퍼 내부, 모든 경로가 종료.
+ */
+#include "cbor_reader.h"
+#include "cbor_codec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FUZZ_CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "FUZZ CHECK FAILED: %s (%s:%d)\n", #cond, __FILE__, __LINE__); \
+        abort(); \
+    } \
+} while (0)
+
+static void walk(const uint8_t *data, size_t size)
+{
+    cbor_reader_t r;
+    cbor_item_t item;
+    cbor_reader_init(&r, data, size);
+
+    /* 최상위 항목을 번갈아 전개/건너뛰기 */
+    bool descend = true;
+    for (;;) {
+        size_t before = r.pos;
+        if (cbor_reader_next(&r, &item) != ESP_OK) break;
+        FUZZ_CHECK(r.pos > before && r.pos <= size);
+        if (item.type == CBOR_TYPE_BYTES || item.type == CBOR_TYPE_TEXT) {
+            FUZZ_CHECK(item.ptr >= data && item.ptr + item.len <= data + size);
+        }
+        if (!descend) {
+            before = r.pos;
+            if (cbor_reader_skip(&r, &item) != ESP_OK) break;
+            FUZZ_CHECK(r.pos >= before && r.pos <= size);
+        }
+        descend = !descend;
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    walk(data, size);
+
+    sensor_report_t report;
+    (void)cbor_decode_report(data, size, &report);
+
+    sensor_batch_t batch;
+    if (cbor_decode_batch(data, size, 1000, &batch) == ESP_OK) {
+        FUZZ_CHECK(batch.count >= 1 && batch.count <= CBOR_BATCH_MAX_SAMPLES);
+    }
+    return 0;
+}
+
+#ifndef RBMS_LIBFUZZER
+
+/* 결정적 xorshift (재현 가능) */
+static uint32_t s_rng = 0x12345678;
+
+static uint32_t rng(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static size_t make_seed(int idx, uint8_t *buf, size_t size)
+{
+    sensor_report_t report = {
+        .temp_hot = 32.5f, .temp_cool = 26.0f, .humidity = 60.0f,
+        .battery_pct = 85.0f, .heater_duty = 45.0f, .light_duty = -1.0f,
+        .safety_status = 0,
+    };
+    size_t len = 0;
+    if (idx == 0) {
+        cbor_encode_report_fmt(&report, CBOR_REPORT_FLOAT32, buf, size, &len);
+    } else if (idx == 1) {
+        cbor_encode_report_fmt(&report, CBOR_REPORT_SCALED, buf, size, &len);
+    } else {
+        sensor_batch_t batch;
+        cbor_batch_reset(&batch);
+        for (int i = 0; i < CBOR_BATCH_MAX_SAMPLES; i++) {
+            report.temp_hot += 0.25f;
+            cbor_batch_add(&batch, 100 + (uint32_t)i * 60, &report);
+        }
+        cbor_encode_batch(&batch, 700, buf, size, &len);
+    }
+    return len;
+}
+
+int main(int argc, char **argv)
+{
+    long iterations = (argc > 1) ? strtol(argv[1], NULL, 10) : 200000;
+    uint8_t seed[3][CBOR_BATCH_BUF_SIZE + 32];
+    size_t seed_len[3];
+    for (int i = 0; i < 3; i++) {
+        seed_len[i] = make_seed(i, seed[i], sizeof(seed[i]));
+    }
+
+    uint8_t buf[256];
+    for (long it = 0; it < iterations; it++) {
+        size_t len;
+        if ((it & 3) == 0) {
+            /* 순수 랜덤 */
+            len = rng() % sizeof(buf);
+            for (size_t i = 0; i < len; i++) buf[i] = (uint8_t)rng();
+        } else {
+            /* 시드 변이: 바이트 교체/비트 반전 + 임의 절단 */
+            int s = (int)(rng() % 3);
+            len = seed_len[s];
+            memcpy(buf, seed[s], len);
+            int flips = 1 + (int)(rng() % 4);
+            for (int f = 0; f < flips; f++) {
+                size_t at = rng() % len;
+                buf[at] = (rng() & 1) ? (uint8_t)rng() : (uint8_t)(buf[at] ^ (1u << (rng() % 8)));
+            }
+            if (rng() % 4 == 0) len = rng() % (len + 1);
+        }
+
+        /* 정확한 길이의 힙 복사본으로 ASan이 1 byte 초과 읽기도 검출 */
+        uint8_t *exact = malloc(len ? len : 1);
+        FUZZ_CHECK(exact != NULL);
+        memcpy(exact, buf, len);
+        LLVMFuzzerTestOneInput(exact, len);
+        free(exact);
+    }
+
+    printf("fuzz_cbor_reader: %ld iterations OK\n", iterations);
+    return 0;
+}
+
+#endif /* RBMS_LIBFUZZER */
@@ -1,6 +1,7 @@
 #ifndef MOCK_ESP_ERR_H
 #define MOCK_ESP_ERR_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 typedef int32_t esp_err_t;
@@ -10,6 +11,11 @@ typedef int32_t esp_err_t;
 #define ESP_ERR_NO_MEM          0x101
 #define ESP_ERR_INVALID_ARG     0x102
 #define ESP_ERR_INVALID_STATE   0x103
+#define ESP_ERR_INVALID_SIZE    0x104
+#define ESP_ERR_NOT_FOUND       0x105
+#define ESP_ERR_NOT_SUPPORTED   0x106
 #define ESP_ERR_TIMEOUT         0x107
+#define ESP_ERR_INVALID_RESPONSE 0x108
+#define ESP_ERR_INVALID_CRC     0x109
 
 #endif
@@ -30,8 +30,8 @@ void test_encode_full_report(void)
     esp_err_t err = cbor_encode_report(&report, buf, sizeof(buf), &out_len);
     TEST_ASSERT_EQUAL(ESP_OK, err);
     TEST_ASSERT_GREATER_THAN(0, out_len);
-    /* Map header should indicate 7 fields */
-    TEST_ASSERT_EQUAL(0xA7, buf[0]);  /* CBOR map(7) */
+    /* Map header: schema version + 7 fields */
+    TEST_ASSERT_EQUAL(0xA8, buf[0]);  /* CBOR map(8) */
 }
 
 void test_encode_type_b_report(void)
@@ -48,8 +48,8 @@ void test_encode_type_b_report(void)
     };
     esp_err_t err = cbor_encode_report(&report, buf, sizeof(buf), &out_len);
     TEST_ASSERT_EQUAL(ESP_OK, err);
-    /* Map header should indicate 4 fields */
-    TEST_ASSERT_EQUAL(0xA4, buf[0]);  /* CBOR map(4) */
+    /* Map header: schema version + 4 fields */
+    TEST_ASSERT_EQUAL(0xA5, buf[0]);  /* CBOR map(5) */
 }
 
 void test_encode_decode_roundtrip(void)
@@ -134,6 +134,421 @@ void test_decode_optional_fields_default(void)
     TEST_ASSERT_EQUAL(-1, output.safety_status);
 }
 
+void test_encode_scaled_roundtrip(void)
+{
+    sensor_report_t input = {
+        .temp_hot = 33.7f,
+        .temp_cool = -4.25f,
+        .humidity = 65.3f,
+        .battery_pct = 72.1f,
+        .heater_duty = 88.5f,
+        .light_duty = 0.0f,
+        .safety_status = 3,
+    };
+    esp_err_t err = cbor_encode_report_fmt(&input, CBOR_REPORT_SCALED,
+                                           buf, sizeof(buf), &out_len);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    /* map(9): 마커 + 버전 + 7 필드, 마커 {0: 1}이 첫 항목 */
+    TEST_ASSERT_EQUAL(0xA9, buf[0]);
+    TEST_ASSERT_EQUAL(0x00, buf[1]);
+    TEST_ASSERT_EQUAL(CBOR_MSG_REPORT_SCALED, buf[2]);
+
+    sensor_report_t output;
+    err = cbor_decode_report(buf, out_len, &output);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, input.temp_hot, output.temp_hot);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, input.temp_cool, output.temp_cool);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, input.humidity, output.humidity);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, input.battery_pct, output.battery_pct);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, input.heater_duty, output.heater_duty);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, 0.0f, output.light_duty);
+    TEST_ASSERT_EQUAL(3, output.safety_status);
+}
+
+void test_encode_scaled_is_smaller(void)
+{
+    sensor_report_t report = {
+        .temp_hot = 30.0f, .temp_cool = 25.0f, .humidity = 55.0f,
+        .battery_pct = 90.0f, .heater_duty = -1.0f, .light_duty = -1.0f,
+        .safety_status = 0,
+    };
+    size_t float_len = 0, scaled_len = 0;
+    cbor_encode_report_fmt(&report, CBOR_REPORT_FLOAT32, buf, sizeof(buf), &float_len);
+    cbor_encode_report_fmt(&report, CBOR_REPORT_SCALED, buf, sizeof(buf), &scaled_len);
+    /* float32: 1 + 2 + 4*6 + 2 = 29, scaled: 1 + 2 + 2 + 4*4 + 2 = 23 */
+    TEST_ASSERT_EQUAL(29, float_len);
+    TEST_ASSERT_EQUAL(23, scaled_len);
+}
+
+void test_decode_float16_values(void)
+{
+    /* {1: 32.5 (f16 0x5010), 2: -2.0 (f16 0xC000), 3: 60.0 (f16 0x5380)} */
+    const uint8_t in[] = { 0xA3,
+        0x01, 0xF9, 0x50, 0x10,
+        0x02, 0xF9, 0xC0, 0x00,
+        0x03, 0xF9, 0x53, 0x80 };
+    sensor_report_t r;
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_decode_report(in, sizeof(in), &r));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 32.5f, r.temp_hot);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, -2.0f, r.temp_cool);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 60.0f, r.humidity);
+}
+
+void test_decode_truncated_input(void)
+{
+    sensor_report_t input = {
+        .temp_hot = 31.0f, .temp_cool = 24.0f, .humidity = 50.0f,
+        .battery_pct = -1.0f, .heater_duty = -1.0f, .light_duty = -1.0f,
+        .safety_status = -1,
+    };
+    cbor_encode_report_fmt(&input, CBOR_REPORT_SCALED, buf, sizeof(buf), &out_len);
+
+    /* 모든 길이에서 범위 밖을 읽지 않고 종료해야 함 */
+    for (size_t len = 2; len < out_len; len++) {
+        sensor_report_t r;
+        TEST_ASSERT_EQUAL(ESP_OK, cbor_decode_report(buf, len, &r));
+    }
+}
+
+void test_decode_skips_unknown_nested_values(void)
+{
+    /* {9: [1, {2: "x"}], 1: 32.5(f32), 8: h'0102', 7: 2} */
+    const uint8_t in[] = { 0xA4,
+                           0x09, 0x82, 0x01, 0xA1, 0x02, 0x61, 'x',
+                           0x01, 0xFA, 0x42, 0x02, 0x00, 0x00,
+                           0x08, 0x42, 0x01, 0x02,
+                           0x07, 0x02 };
+    sensor_report_t r;
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_decode_report(in, sizeof(in), &r));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 32.5f, r.temp_hot);
+    TEST_ASSERT_EQUAL(2, r.safety_status);
+}
+
+void test_decode_rejects_wrong_typed_marker(void)
+{
+    /* {0: -2, 1: 3250}, {0: simple(1), ...}, {0: h'01', ...} — SCALED 마커 아님 */
+    const uint8_t negint[] = { 0xA2, 0x00, 0x21, 0x01, 0x19, 0x0C, 0xB2 };
+    const uint8_t simple[] = { 0xA2, 0x00, 0xE1, 0x01, 0x19, 0x0C, 0xB2 };
+    const uint8_t bytes[]  = { 0xA2, 0x00, 0x41, 0x01, 0x01, 0x19, 0x0C, 0xB2 };
+    sensor_report_t r;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, cbor_decode_report(negint, sizeof(negint), &r));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, cbor_decode_report(simple, sizeof(simple), &r));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, cbor_decode_report(bytes, sizeof(bytes), &r));
+
+    /* {0: 1, 1: -250} — SCALED 음수 값은 환산 */
+    const uint8_t scaled_neg[] = { 0xA2, 0x00, 0x01, 0x01, 0x38, 0xF9 };
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_decode_report(scaled_neg, sizeof(scaled_neg), &r));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, -2.5f, r.temp_hot);
+}
+
+static sensor_report_t make_report(float hot, float cool, float hum)
+{
+    sensor_report_t r = {
+        .temp_hot = hot, .temp_cool = cool, .humidity = hum,
+        .battery_pct = -1.0f, .heater_duty = -1.0f, .light_duty = -1.0f,
+        .safety_status = 0,
+    };
+    return r;
+}
+
+void test_batch_roundtrip(void)
+{
+    sensor_batch_t batch;
+    cbor_batch_reset(&batch);
+    for (int i = 0; i < CBOR_BATCH_MAX_SAMPLES; i++) {
+        sensor_report_t r = make_report(30.0f + 0.0625f * i, 25.5f - 0.1f * i, 60.0f + i);
+        if (i == 3) r.battery_pct = 81.5f;
+        if (i == 5) r.safety_status = 1;
+        TEST_ASSERT_EQUAL(ESP_OK, cbor_batch_add(&batch, 1000 + 300 * i, &r));
+    }
+
+    uint32_t now = 1000 + 300 * (CBOR_BATCH_MAX_SAMPLES - 1) + 2;
+    esp_err_t err = cbor_encode_batch(&batch, now, buf, CBOR_BATCH_BUF_SIZE, &out_len);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    /* 단일 802.15.4 프레임 페이로드 예산 이내 */
+    TEST_ASSERT_LESS_THAN(83, out_len);
+
+    /* 수신 측 시계가 달라도 상대 시각은 보존 */
+    sensor_batch_t out;
+    err = cbor_decode_batch(buf, out_len, 50000, &out);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(CBOR_BATCH_MAX_SAMPLES, out.count);
+    for (int i = 0; i < out.count; i++) {
+        TEST_ASSERT_EQUAL(batch.samples[i].temp_hot, out.samples[i].temp_hot);
+        TEST_ASSERT_EQUAL(batch.samples[i].temp_cool, out.samples[i].temp_cool);
+        TEST_ASSERT_EQUAL(batch.samples[i].humidity, out.samples[i].humidity);
+        TEST_ASSERT_EQUAL_UINT32(50000 - (now - batch.samples[i].timestamp),
+                                 out.samples[i].timestamp);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 81.5f, out.battery_pct);
+    TEST_ASSERT_EQUAL(1, out.safety_status);
+}
+
+void test_batch_full_drops_oldest(void)
+{
+    sensor_batch_t batch;
+    cbor_batch_reset(&batch);
+    for (int i = 0; i < CBOR_BATCH_MAX_SAMPLES + 2; i++) {
+        sensor_report_t r = make_report((float)i, 0.0f, 0.0f);
+        cbor_batch_add(&batch, (uint32_t)i, &r);
+    }
+    TEST_ASSERT_EQUAL(CBOR_BATCH_MAX_SAMPLES, batch.count);
+    TEST_ASSERT_EQUAL_UINT32(2, batch.samples[0].timestamp);
+    TEST_ASSERT_EQUAL(200, batch.samples[0].temp_hot);
+}
+
+void test_batch_single_sample(void)
+{
+    sensor_batch_t batch, out;
+    cbor_batch_reset(&batch);
+    sensor_report_t r = make_report(-5.5f, 12.0f, 99.9f);
+    cbor_batch_add(&batch, 10, &r);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_encode_batch(&batch, 10, buf, sizeof(buf), &out_len));
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_decode_batch(buf, out_len, 10, &out));
+    TEST_ASSERT_EQUAL(1, out.count);
+    TEST_ASSERT_EQUAL(-550, out.samples[0].temp_hot);
+    TEST_ASSERT_EQUAL(9990, out.samples[0].humidity);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -1.0f, out.battery_pct);
+}
+
+void test_batch_buffer_too_small(void)
+{
+    sensor_batch_t batch;
+    cbor_batch_reset(&batch);
+    sensor_report_t r = make_report(30.0f, 25.0f, 60.0f);
+    cbor_batch_add(&batch, 0, &r);
+    cbor_batch_add(&batch, 300, &r);
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, cbor_encode_batch(&batch, 300, buf, 16, &out_len));
+    cbor_batch_reset(&batch);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, cbor_encode_batch(&batch, 0, buf, 64, &out_len));
+}
+
+void test_batch_decode_rejects_report(void)
+{
+    sensor_report_t r = make_report(30.0f, 25.0f, 60.0f);
+    sensor_batch_t out;
+    cbor_encode_report_fmt(&r, CBOR_REPORT_SCALED, buf, sizeof(buf), &out_len);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, cbor_decode_batch(buf, out_len, 0, &out));
+}
+
+void test_batch_decode_skips_unknown_keys(void)
+{
+    sensor_batch_t batch, out;
+    cbor_batch_reset(&batch);
+    sensor_report_t r = make_report(30.0f, 25.0f, 60.0f);
+    cbor_batch_add(&batch, 0, &r);
+    cbor_batch_add(&batch, 300, &r);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_encode_batch(&batch, 300, buf, sizeof(buf), &out_len));
+
+    /* 새 버전 송신 측: 맵 끝에 99: [1, "x"], "zz": 1 추가 */
+    TEST_ASSERT_EQUAL(0xA0, buf[0] & 0xE0);
+    TEST_ASSERT((buf[0] & 0x1F) < 22);
+    buf[0] += 2;
+    const uint8_t extra[] = { 0x18, 0x63, 0x82, 0x01, 0x61, 'x', 0x62, 'z', 'z', 0x01 };
+    memcpy(&buf[out_len], extra, sizeof(extra));
+    out_len += sizeof(extra);
+
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_decode_batch(buf, out_len, 300, &out));
+    TEST_ASSERT_EQUAL(2, out.count);
+    TEST_ASSERT_EQUAL(3000, out.samples[1].temp_hot);
+    TEST_ASSERT_EQUAL_UINT32(300, out.samples[1].timestamp);
+}
+
+/* --- 리포트 템플릿 --- */
+
+static void assert_reports_equal(const sensor_report_t *a, const sensor_report_t *b)
+{
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, a->temp_hot, b->temp_hot);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, a->temp_cool, b->temp_cool);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, a->humidity, b->humidity);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, a->battery_pct, b->battery_pct);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, a->heater_duty, b->heater_duty);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, a->light_duty, b->light_duty);
+    TEST_ASSERT_EQUAL(a->safety_status, b->safety_status);
+}
+
+void test_payloads_carry_schema_version(void)
+{
+    sensor_report_t r = make_report(30.0f, 25.0f, 55.0f);
+    cbor_report_template_t tmpl;
+    const uint8_t *data = NULL;
+    size_t len = 0;
+    sensor_batch_t batch;
+    cbor_batch_reset(&batch);
+    cbor_batch_add(&batch, 10, &r);
+
+    /* float32 리포트: 버전이 첫 항목, SCALED/배치/템플릿: 마커 다음 */
+    cbor_encode_report(&r, buf, sizeof(buf), &out_len);
+    TEST_ASSERT_EQUAL(CBOR_KEY_SCHEMA_VERSION, buf[1]);
+    TEST_ASSERT_EQUAL(RBMS_SCHEMA_VERSION, buf[2]);
+    cbor_encode_report_fmt(&r, CBOR_REPORT_SCALED, buf, sizeof(buf), &out_len);
+    TEST_ASSERT_EQUAL(CBOR_KEY_SCHEMA_VERSION, buf[3]);
+    TEST_ASSERT_EQUAL(RBMS_SCHEMA_VERSION, buf[4]);
+    cbor_encode_batch(&batch, 10, buf, sizeof(buf), &out_len);
+    TEST_ASSERT_EQUAL(CBOR_KEY_SCHEMA_VERSION, buf[3]);
+    TEST_ASSERT_EQUAL(RBMS_SCHEMA_VERSION, buf[4]);
+    cbor_template_encode(&tmpl, &r, CBOR_REPORT_SCALED, &data, &len);
+    TEST_ASSERT_EQUAL(CBOR_KEY_SCHEMA_VERSION, data[3]);
+    TEST_ASSERT_EQUAL(RBMS_SCHEMA_VERSION, data[4]);
+
+    /* 스키마 순서 = 키 순서 = 마스크 비트 */
+    TEST_ASSERT_EQUAL(4, CBOR_KEY_BATTERY);
+    TEST_ASSERT_EQUAL(7, CBOR_KEY_SAFETY);
+    TEST_ASSERT_EQUAL(1 << 6, CBOR_FIELD_SAFETY);
+    TEST_ASSERT_EQUAL(CBOR_FIELD_TEMP_HOT | CBOR_FIELD_TEMP_COOL |
+                      CBOR_FIELD_HUMIDITY | CBOR_FIELD_SAFETY,
+                      cbor_report_field_mask(&r));
+}
+
+void test_template_matches_encoder(void)
+{
+    sensor_report_t in = {
+        .temp_hot = 32.5f, .temp_cool = -3.25f, .humidity = 60.0f,
+        .battery_pct = -1.0f, .heater_duty = 45.0f, .light_duty = 0.0f,
+        .safety_status = 2,
+    };
+    cbor_report_template_t tmpl;
+    const uint8_t *data;
+    size_t len;
+    sensor_report_t out;
+
+    /* FLOAT32: 값 바이트까지 기존 인코더와 동일 (safety만 고정 폭) */
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_template_encode(&tmpl, &in, CBOR_REPORT_FLOAT32, &data, &len));
+    cbor_encode_report(&in, buf, sizeof(buf), &out_len);
+    TEST_ASSERT_EQUAL(out_len + 1, len);
+    TEST_ASSERT_EQUAL(0, memcmp(buf, data, out_len - 1));
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_decode_report(data, len, &out));
+    assert_reports_equal(&in, &out);
+
+    /* SCALED: 고정 폭 정수, 음수 포함 */
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_template_encode(&tmpl, &in, CBOR_REPORT_SCALED, &data, &len));
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_decode_report(data, len, &out));
+    assert_reports_equal(&in, &out);
+}
+
+void test_template_patch_keeps_layout(void)
+{
+    sensor_report_t r = make_report(30.0f, 25.0f, 55.0f);
+    cbor_report_template_t tmpl;
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_template_init(&tmpl, cbor_report_field_mask(&r),
+                                                 CBOR_REPORT_SCALED));
+    uint8_t len0 = tmpl.len;
+    uint8_t header[4];
+    memcpy(header, tmpl.buf, sizeof(header));
+
+    /* 값 크기가 달라져도 (1 → 3 bytes 최소 인코딩) 레이아웃 불변 */
+    const float temps[] = { 0.0f, 0.05f, 32.5f, -10.0f, 655.0f };
+    for (int i = 0; i < 5; i++) {
+        r.temp_hot = temps[i];
+        TEST_ASSERT_EQUAL(ESP_OK, cbor_template_patch(&tmpl, &r));
+        TEST_ASSERT_EQUAL(len0, tmpl.len);
+        TEST_ASSERT_EQUAL(0, memcmp(header, tmpl.buf, sizeof(header)));
+
+        sensor_report_t out;
+        TEST_ASSERT_EQUAL(ESP_OK, cbor_decode_report(tmpl.buf, tmpl.len, &out));
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, temps[i], out.temp_hot);
+    }
+}
+
+void test_template_rebuilds_on_mask_change(void)
+{
+    sensor_report_t r = make_report(30.0f, 25.0f, 55.0f);
+    cbor_report_template_t tmpl;
+    const uint8_t *data;
+    size_t len;
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_template_encode(&tmpl, &r, CBOR_REPORT_SCALED, &data, &len));
+    size_t len_without_batt = len;
+
+    /* 직접 patch는 구성 불일치를 거부 */
+    r.battery_pct = 80.0f;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, cbor_template_patch(&tmpl, &r));
+
+    /* encode는 재생성 */
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_template_encode(&tmpl, &r, CBOR_REPORT_SCALED, &data, &len));
+    TEST_ASSERT_EQUAL(len_without_batt + 4, len);
+    sensor_report_t out;
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_decode_report(data, len, &out));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 80.0f, out.battery_pct);
+}
+
+void test_template_saturates_out_of_range(void)
+{
+    sensor_report_t r = make_report(1000.0f, -1000.0f, NAN);
+    cbor_report_template_t tmpl;
+    const uint8_t *data;
+    size_t len;
+    sensor_report_t out;
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_template_encode(&tmpl, &r, CBOR_REPORT_SCALED, &data, &len));
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_decode_report(data, len, &out));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 655.35f, out.temp_hot);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -655.36f, out.temp_cool);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, out.humidity);
+}
+
+void test_alarm_encode(void)
+{
+    cbor_alarm_t alarm = { .seq = 300, .safety_status = 3, .prev_status = 0, .age_ms = 70000 };
+    uint8_t buf[32];
+    size_t len;
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_encode_alarm(&alarm, buf, sizeof(buf), &len));
+    TEST_ASSERT_EQUAL(22, len);
+
+    const uint8_t expected[] = {
+        0xA6, 0x00, 0x07, 0x13, RBMS_SCHEMA_VERSION, 0x07, 0x03,
+        0x18, 0x28, 0x19, 0x01, 0x2C,                   /* 40: 300 */
+        0x18, 0x29, 0x00,                               /* 41: 0 */
+        0x18, 0x2A, 0x1A, 0x00, 0x01, 0x11, 0x70,       /* 42: 70000 */
+    };
+    for (size_t i = 0; i < sizeof(expected); i++) {
+        TEST_ASSERT_EQUAL(expected[i], buf[i]);
+    }
+
+    /* 일반 디코더는 safety만 읽고 경보 키는 건너뜀 */
+    sensor_report_t out;
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_decode_report(buf, len, &out));
+    TEST_ASSERT_EQUAL(3, out.safety_status);
+
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, cbor_encode_alarm(&alarm, buf, 12, &len));
+    alarm.prev_status = -1;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, cbor_encode_alarm(&alarm, buf, sizeof(buf), &len));
+}
+
+void test_time_roundtrip(void)
+{
+    uint8_t buf[CBOR_TIME_BUF_SIZE];
+    size_t len = 0;
+    cbor_time_t t = { .unix_sec = 1790000000, .ms = 999, .utc_offset_min = -210 };
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_encode_time(&t, buf, sizeof(buf), &len));
+    TEST_ASSERT_EQUAL(19, len);   /* -210 = negint 1 byte 인자 */
+
+    cbor_time_t out;
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_decode_time(buf, len, &out));
+    TEST_ASSERT_EQUAL_UINT32(1790000000, out.unix_sec);
+    TEST_ASSERT_EQUAL(999, out.ms);
+    TEST_ASSERT_EQUAL(-210, out.utc_offset_min);
+
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, cbor_encode_time(&t, buf, 10, &len));
+    t.ms = 1000;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, cbor_encode_time(&t, buf, sizeof(buf), &len));
+}
+
+void test_time_decode_rejects(void)
+{
+    cbor_time_t out;
+    /* 명령 메시지 → 비콘 아님 */
+    const uint8_t cmd[] = {0xA2, 0x00, 0x03, 0x18, 0x1E, 0x01};
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, cbor_decode_time(cmd, sizeof(cmd), &out));
+
+    /* 초 없음 */
+    const uint8_t no_sec[] = {0xA2, 0x00, 0x08, 0x18, 0x33, 0x05};
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, cbor_decode_time(no_sec, sizeof(no_sec), &out));
+
+    /* UTC 오프셋 범위 초과 (900분) */
+    const uint8_t bad_tz[] = {0xA3, 0x00, 0x08, 0x18, 0x32, 0x01,
+                              0x18, 0x34, 0x19, 0x03, 0x84};
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, cbor_decode_time(bad_tz, sizeof(bad_tz), &out));
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -145,5 +560,25 @@ int main(void)
     RUN_TEST(test_decode_null_args);
     RUN_TEST(test_decode_too_short);
     RUN_TEST(test_decode_optional_fields_default);
+    RUN_TEST(test_encode_scaled_roundtrip);
+    RUN_TEST(test_encode_scaled_is_smaller);
+    RUN_TEST(test_decode_float16_values);
+    RUN_TEST(test_decode_truncated_input);
+    RUN_TEST(test_decode_skips_unknown_nested_values);
+    RUN_TEST(test_decode_rejects_wrong_typed_marker);
+    RUN_TEST(test_batch_roundtrip);
+    RUN_TEST(test_batch_full_drops_oldest);
+    RUN_TEST(test_batch_single_sample);
+    RUN_TEST(test_batch_buffer_too_small);
+    RUN_TEST(test_batch_decode_rejects_report);
+    RUN_TEST(test_batch_decode_skips_unknown_keys);
+    RUN_TEST(test_payloads_carry_schema_version);
+    RUN_TEST(test_template_matches_encoder);
+    RUN_TEST(test_template_patch_keeps_layout);
+    RUN_TEST(test_template_rebuilds_on_mask_change);
+    RUN_TEST(test_template_saturates_out_of_range);
+    RUN_TEST(test_alarm_encode);
+    RUN_TEST(test_time_roundtrip);
+    RUN_TEST(test_time_decode_rejects);
     return UNITY_END();
 }
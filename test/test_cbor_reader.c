@@ -0,0 +1,208 @@
+/**
+ * @file test_cbor_reader.c
+ * @brief Streaming CBOR reader unit tests
+ */
+#include "unity.h"
+#include "cbor_reader.h"
+#include <math.h>
+#include <string.h>
+
+static cbor_reader_t rd;
+static cbor_item_t item;
+
+void setUp(void) {
+    memset(&rd, 0, sizeof(rd));
+    memset(&item, 0, sizeof(item));
+}
+void tearDown(void) {}
+
+void test_read_small_and_wide_uints(void)
+{
+    /* 10, 24, 1000, 100000, 2^32 */
+    const uint8_t in[] = { 0x0A, 0x18, 0x18, 0x19, 0x03, 0xE8,
+                           0x1A, 0x00, 0x01, 0x86, 0xA0,
+                           0x1B, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00 };
+    const uint64_t expected[] = { 10, 24, 1000, 100000, 0x100000000ULL };
+    cbor_reader_init(&rd, in, sizeof(in));
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &item));
+        TEST_ASSERT_EQUAL(CBOR_TYPE_UINT, item.type);
+        TEST_ASSERT_TRUE(item.uval == expected[i]);
+    }
+    TEST_ASSERT_TRUE(cbor_reader_at_end(&rd));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, cbor_reader_next(&rd, &item));
+}
+
+void test_read_negative_ints(void)
+{
+    /* -1, -100, -1000 */
+    const uint8_t in[] = { 0x20, 0x38, 0x63, 0x39, 0x03, 0xE7 };
+    int32_t v = 0;
+    cbor_reader_init(&rd, in, sizeof(in));
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(&rd, &v));
+    TEST_ASSERT_EQUAL(-1, v);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(&rd, &v));
+    TEST_ASSERT_EQUAL(-100, v);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(&rd, &v));
+    TEST_ASSERT_EQUAL(-1000, v);
+}
+
+void test_int_out_of_range(void)
+{
+    /* 2^31 은 int32 범위 밖 */
+    const uint8_t in[] = { 0x1A, 0x80, 0x00, 0x00, 0x00 };
+    int32_t v = 0;
+    cbor_reader_init(&rd, in, sizeof(in));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, cbor_reader_get_int(&rd, &v));
+}
+
+void test_read_floats(void)
+{
+    /* f16 1.5, f32 32.5, f64 -2.25 */
+    const uint8_t in[] = { 0xF9, 0x3E, 0x00,
+                           0xFA, 0x42, 0x02, 0x00, 0x00,
+                           0xFB, 0xC0, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    float f = 0;
+    cbor_reader_init(&rd, in, sizeof(in));
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_float(&rd, &f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.5f, f);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_float(&rd, &f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 32.5f, f);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_float(&rd, &f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, -2.25f, f);
+}
+
+void test_strings_are_zero_copy(void)
+{
+    /* "ab", h'010203' */
+    const uint8_t in[] = { 0x62, 'a', 'b', 0x43, 0x01, 0x02, 0x03 };
+    cbor_reader_init(&rd, in, sizeof(in));
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &item));
+    TEST_ASSERT_EQUAL(CBOR_TYPE_TEXT, item.type);
+    TEST_ASSERT_EQUAL(2, item.len);
+    TEST_ASSERT_TRUE(item.ptr == &in[1]);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &item));
+    TEST_ASSERT_EQUAL(CBOR_TYPE_BYTES, item.type);
+    TEST_ASSERT_EQUAL(3, item.len);
+    TEST_ASSERT_TRUE(item.ptr == &in[4]);
+}
+
+void test_skip_nested_containers(void)
+{
+    /* {1: [1, {2: "x"}, [[]]], 2: 7} — 첫 값을 건너뛰고 두 번째 키 도달 */
+    const uint8_t in[] = { 0xA2,
+                           0x01, 0x83, 0x01, 0xA1, 0x02, 0x61, 'x', 0x81, 0x80,
+                           0x02, 0x07 };
+    cbor_reader_init(&rd, in, sizeof(in));
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &item));
+    TEST_ASSERT_EQUAL(CBOR_TYPE_MAP, item.type);
+    TEST_ASSERT_EQUAL(2, (int)item.uval);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &item));  /* key 1 */
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &item));  /* array(3) */
+    TEST_ASSERT_EQUAL(CBOR_TYPE_ARRAY, item.type);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_skip(&rd, &item));
+
+    int32_t v = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(&rd, &v));
+    TEST_ASSERT_EQUAL(2, v);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(&rd, &v));
+    TEST_ASSERT_EQUAL(7, v);
+    TEST_ASSERT_TRUE(cbor_reader_at_end(&rd));
+}
+
+void test_skip_deep_nesting_without_recursion(void)
+{
+    /* [[[[...]]]] 200단계 */
+    uint8_t in[200];
+    memset(in, 0x81, sizeof(in));
+    in[sizeof(in) - 1] = 0x80;
+    cbor_reader_init(&rd, in, sizeof(in));
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &item));
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_skip(&rd, &item));
+    TEST_ASSERT_TRUE(cbor_reader_at_end(&rd));
+}
+
+void test_truncated_headers_rejected(void)
+{
+    const uint8_t u16[] = { 0x19, 0x03 };        /* 2-byte 인자 중 1 byte */
+    const uint8_t str[] = { 0x65, 'a', 'b' };    /* text(5), 2 bytes만 */
+    const uint8_t f32[] = { 0xFA, 0x42, 0x02 };
+    cbor_reader_init(&rd, u16, sizeof(u16));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, cbor_reader_next(&rd, &item));
+    cbor_reader_init(&rd, str, sizeof(str));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, cbor_reader_next(&rd, &item));
+    cbor_reader_init(&rd, f32, sizeof(f32));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, cbor_reader_next(&rd, &item));
+}
+
+void test_huge_counts_rejected(void)
+{
+    /* array(2^32-1), map(2^64-1): 헤더는 읽히지만 skip은 읽기 전에 거부 */
+    const uint8_t arr[] = { 0x9A, 0xFF, 0xFF, 0xFF, 0xFF, 0x00 };
+    const uint8_t map[] = { 0xBB, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x02 };
+    cbor_reader_init(&rd, arr, sizeof(arr));
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &item));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, cbor_reader_skip(&rd, &item));
+    TEST_ASSERT_EQUAL(5, (int)rd.pos);
+    cbor_reader_init(&rd, map, sizeof(map));
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &item));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, cbor_reader_skip(&rd, &item));
+}
+
+void test_skip_truncated_container(void)
+{
+    /* [1, 2, 3] 에서 마지막 항목 누락 */
+    const uint8_t in[] = { 0x83, 0x01, 0x02 };
+    cbor_reader_init(&rd, in, sizeof(in));
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &item));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, cbor_reader_skip(&rd, &item));
+
+    const uint8_t nested[] = { 0x82, 0x82, 0x01, 0x02 };  /* 바깥 2번째 누락 */
+    cbor_reader_init(&rd, nested, sizeof(nested));
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &item));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, cbor_reader_skip(&rd, &item));
+}
+
+void test_indefinite_and_reserved_rejected(void)
+{
+    const uint8_t indef[] = { 0x9F, 0x01, 0xFF };
+    const uint8_t reserved[] = { 0x1C };
+    cbor_reader_init(&rd, indef, sizeof(indef));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED, cbor_reader_next(&rd, &item));
+    cbor_reader_init(&rd, reserved, sizeof(reserved));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, cbor_reader_next(&rd, &item));
+}
+
+void test_simple_and_tag(void)
+{
+    /* true, null, tag(1) 1000 */
+    const uint8_t in[] = { 0xF5, 0xF6, 0xC1, 0x19, 0x03, 0xE8 };
+    cbor_reader_init(&rd, in, sizeof(in));
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &item));
+    TEST_ASSERT_EQUAL(CBOR_TYPE_SIMPLE, item.type);
+    TEST_ASSERT_EQUAL(CBOR_SIMPLE_TRUE, (int)item.uval);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &item));
+    TEST_ASSERT_EQUAL(CBOR_SIMPLE_NULL, (int)item.uval);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &item));
+    TEST_ASSERT_EQUAL(CBOR_TYPE_TAG, item.type);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_skip(&rd, &item));
+    TEST_ASSERT_TRUE(cbor_reader_at_end(&rd));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_read_small_and_wide_uints);
+    RUN_TEST(test_read_negative_ints);
+    RUN_TEST(test_int_out_of_range);
+    RUN_TEST(test_read_floats);
+    RUN_TEST(test_strings_are_zero_copy);
+    RUN_TEST(test_skip_nested_containers);
+    RUN_TEST(test_skip_deep_nesting_without_recursion);
+    RUN_TEST(test_truncated_headers_rejected);
+    RUN_TEST(test_huge_counts_rejected);
+    RUN_TEST(test_skip_truncated_container);
+    RUN_TEST(test_indefinite_and_reserved_rejected);
+    RUN_TEST(test_simple_and_tag);
+    return UNITY_END();
+}
@@ -0,0 +1,287 @@
+/**
+ * @file test_child_agg.c
+ * @brief Router-side child report aggregation unit tests
+ */
+#include "unity.h"
+#include "child_agg.h"
+#include "cbor_codec.h"
+#include "cbor_reader.h"
+#include <string.h>
+
+#define AGG_BUF 128   /* THREAD_TX_PAYLOAD_MAX */
+#define WINDOW  30000
+
+static child_agg_t agg;
+static uint8_t buf[AGG_BUF];
+static size_t len, entries;
+
+/* {0: 1, 19: 1, 1: hot} (SCALED 리포트) */
+static size_t make_report(uint8_t *p, uint16_t hot, int safety)
+{
+    size_t n = 0;
+    p[n++] = (safety >= 0) ? 0xA4 : 0xA3;
+    p[n++] = 0x00; p[n++] = 0x01;
+    p[n++] = 0x13; p[n++] = 0x01;
+    p[n++] = 0x01; p[n++] = 0x19; p[n++] = (uint8_t)(hot >> 8); p[n++] = (uint8_t)hot;
+    if (safety >= 0) { p[n++] = 0x07; p[n++] = (uint8_t)safety; }
+    return n;
+}
+
+/* {0: type, 21: h'00..'} — 크기 조절용 */
+static size_t make_msg(uint8_t *p, uint8_t type, uint8_t fill)
+{
+    size_t n = 0;
+    p[n++] = 0xA2;
+    p[n++] = 0x00; p[n++] = type;
+    p[n++] = 0x15; p[n++] = 0x58; p[n++] = fill;
+    memset(p + n, 0xEE, fill);
+    return n + fill;
+}
+
+/* 인코딩 결과에서 i번째 항목 꺼내기 */
+static void read_entry(size_t i, uint16_t *node, uint32_t *age,
+                       const uint8_t **payload, size_t *plen)
+{
+    cbor_reader_t rd;
+    cbor_item_t it;
+    cbor_reader_init(&rd, buf, len);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &it));
+    TEST_ASSERT_EQUAL(CBOR_TYPE_MAP, it.type);
+    TEST_ASSERT_EQUAL(3, it.uval);
+
+    int32_t v;
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(&rd, &v));
+    TEST_ASSERT_EQUAL(CBOR_KEY_MSG_TYPE, v);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(&rd, &v));
+    TEST_ASSERT_EQUAL(CBOR_MSG_AGGREGATE, v);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(&rd, &v));
+    TEST_ASSERT_EQUAL(CBOR_KEY_SCHEMA_VERSION, v);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(&rd, &v));
+    TEST_ASSERT_EQUAL(RBMS_SCHEMA_VERSION, v);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(&rd, &v));
+    TEST_ASSERT_EQUAL(CBOR_KEY_AGG_ENTRIES, v);
+
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &it));
+    TEST_ASSERT_EQUAL(CBOR_TYPE_ARRAY, it.type);
+    TEST_ASSERT_EQUAL(entries, it.uval);
+
+    for (size_t k = 0; k <= i; k++) {
+        TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &it));
+        TEST_ASSERT_EQUAL(CBOR_TYPE_ARRAY, it.type);
+        TEST_ASSERT_EQUAL(3, it.uval);
+        TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(&rd, &v));
+        *node = (uint16_t)v;
+        TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(&rd, &v));
+        *age = (uint32_t)v;
+        TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &it));
+        TEST_ASSERT_EQUAL(CBOR_TYPE_BYTES, it.type);
+        *payload = it.ptr;
+        *plen = it.len;
+    }
+}
+
+void setUp(void)
+{
+    child_agg_init(&agg);
+    len = entries = 0;
+}
+void tearDown(void) {}
+
+void test_encode_carries_payload_and_age(void)
+{
+    uint8_t p[16];
+    size_t n = make_report(p, 2500, -1);
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_add(&agg, 0xA8C3, p, n, 1000));
+    TEST_ASSERT_EQUAL(1, child_agg_pending(&agg));
+
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_encode(&agg, 13500, buf, sizeof(buf), &len, &entries));
+    TEST_ASSERT_EQUAL(1, entries);
+    TEST_ASSERT_EQUAL(0, child_agg_pending(&agg));
+
+    uint16_t node;
+    uint32_t age;
+    const uint8_t *pl;
+    size_t plen;
+    read_entry(0, &node, &age, &pl, &plen);
+    TEST_ASSERT_EQUAL(0xA8C3, node);
+    TEST_ASSERT_EQUAL_UINT32(12, age);
+    TEST_ASSERT_EQUAL(n, plen);
+    TEST_ASSERT_EQUAL(0, memcmp(pl, p, n));
+
+    child_agg_commit(&agg);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, child_agg_encode(&agg, 0, buf, sizeof(buf), &len, &entries));
+}
+
+void test_newer_report_replaces_older(void)
+{
+    uint8_t p[16];
+    size_t n = make_report(p, 2500, -1);
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_add(&agg, 1, p, n, 0));
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_add(&agg, 2, p, n, 10));
+    n = make_report(p, 2600, -1);
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_add(&agg, 1, p, n, 5000));
+    TEST_ASSERT_EQUAL(2, child_agg_pending(&agg));
+    TEST_ASSERT_EQUAL_UINT32(1, agg.replaced);
+
+    /* 대체돼도 창 기한은 첫 수신 기준 (계속 보내는 자식이 flush를 미루지 않음) */
+    TEST_ASSERT_TRUE(child_agg_due(&agg, WINDOW, WINDOW));
+
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_encode(&agg, 7000, buf, sizeof(buf), &len, &entries));
+    uint16_t node;
+    uint32_t age;
+    const uint8_t *pl;
+    size_t plen;
+    read_entry(0, &node, &age, &pl, &plen);
+    TEST_ASSERT_EQUAL(1, node);
+    TEST_ASSERT_EQUAL_UINT32(2, age);          /* 새 페이로드 수신 시각 기준 */
+    TEST_ASSERT_EQUAL(0, memcmp(pl, p, n));    /* 2600 */
+}
+
+void test_batches_and_acks_are_not_replaced(void)
+{
+    uint8_t p[32];
+    size_t n = make_msg(p, CBOR_MSG_BATCH, 4);
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_add(&agg, 7, p, n, 0));
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_add(&agg, 7, p, n, 0));
+    n = make_report(p, 2500, -1);
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_add(&agg, 7, p, n, 0));
+    TEST_ASSERT_EQUAL(3, child_agg_pending(&agg));
+    TEST_ASSERT_EQUAL_UINT32(0, agg.replaced);
+}
+
+void test_window_deadline(void)
+{
+    uint8_t p[16];
+    size_t n = make_report(p, 2500, 0);    /* SAFETY_OK */
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, child_agg_next_due_ms(&agg, 0, WINDOW));
+    TEST_ASSERT_TRUE(!child_agg_due(&agg, 0, WINDOW));
+
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_add(&agg, 1, p, n, 1000));
+    TEST_ASSERT_TRUE(!child_agg_due(&agg, 1000, WINDOW));
+    TEST_ASSERT_EQUAL_UINT32(WINDOW - 4000, child_agg_next_due_ms(&agg, 5000, WINDOW));
+    TEST_ASSERT_TRUE(child_agg_due(&agg, 1000 + WINDOW, WINDOW));
+
+    /* window 0 = 즉시 전달 */
+    TEST_ASSERT_TRUE(child_agg_due(&agg, 1000, 0));
+}
+
+void test_urgent_messages_flush_immediately(void)
+{
+    uint8_t p[16];
+    size_t n = make_report(p, 2500, 2);    /* safety 경고 */
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_add(&agg, 1, p, n, 0));
+    TEST_ASSERT_TRUE(child_agg_due(&agg, 0, WINDOW));
+
+    child_agg_init(&agg);
+    n = make_msg(p, CBOR_MSG_CMD_ACK, 2);
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_add(&agg, 1, p, n, 0));
+    TEST_ASSERT_TRUE(child_agg_due(&agg, 0, WINDOW));
+
+    /* 경보 리포트를 정상 리포트가 대체해도 즉시 전송 유지 */
+    child_agg_init(&agg);
+    n = make_report(p, 2500, 2);
+    child_agg_add(&agg, 1, p, n, 0);
+    n = make_report(p, 2500, 0);
+    child_agg_add(&agg, 1, p, n, 0);
+    TEST_ASSERT_TRUE(child_agg_due(&agg, 0, WINDOW));
+}
+
+void test_full_buffer(void)
+{
+    uint8_t p[16];
+    size_t n = make_report(p, 2500, -1);
+    for (uint16_t i = 0; i < CHILD_AGG_MAX_ENTRIES; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, child_agg_add(&agg, i, p, n, 0));
+    }
+    TEST_ASSERT_TRUE(child_agg_due(&agg, 0, WINDOW));
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, child_agg_add(&agg, 100, p, n, 0));
+    /* 이미 있는 노드는 가득 차도 대체 가능 */
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_add(&agg, 3, p, n, 0));
+}
+
+void test_encode_splits_to_fit_datagram(void)
+{
+    uint8_t p[CHILD_AGG_PAYLOAD_MAX];
+    size_t n = make_msg(p, CBOR_MSG_BATCH, 40);   /* 46 bytes */
+    for (uint16_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, child_agg_add(&agg, 0x100 + i, p, n, 0));
+    }
+
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_encode(&agg, 0, buf, sizeof(buf), &len, &entries));
+    TEST_ASSERT_EQUAL(2, entries);
+    TEST_ASSERT_TRUE(len <= sizeof(buf));
+    TEST_ASSERT_EQUAL(2, child_agg_pending(&agg));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE,
+                      child_agg_encode(&agg, 0, buf, sizeof(buf), &len, &entries));
+
+    /* 전송 중 도착한 항목은 뒤에 남음 */
+    uint8_t r[16];
+    size_t rn = make_report(r, 2500, -1);
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_add(&agg, 0x100, r, rn, 0));
+    child_agg_commit(&agg);
+    TEST_ASSERT_EQUAL(3, child_agg_pending(&agg));
+
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_encode(&agg, 0, buf, sizeof(buf), &len, &entries));
+    uint16_t node;
+    uint32_t age;
+    const uint8_t *pl;
+    size_t plen;
+    read_entry(0, &node, &age, &pl, &plen);
+    TEST_ASSERT_EQUAL(0x102, node);
+
+    /* 최대 크기 페이로드 1건은 항상 데이터그램 하나에 들어감 */
+    child_agg_init(&agg);
+    n = make_msg(p, CBOR_MSG_BATCH, CHILD_AGG_PAYLOAD_MAX - 6);
+    TEST_ASSERT_EQUAL(CHILD_AGG_PAYLOAD_MAX, n);
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_add(&agg, 0xFFFF, p, n, 0));
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_encode(&agg, 3600000, buf, sizeof(buf), &len, &entries));
+    TEST_ASSERT_EQUAL(1, entries);
+}
+
+void test_abort_keeps_entries(void)
+{
+    uint8_t p[16];
+    size_t n = make_report(p, 2500, -1);
+    child_agg_add(&agg, 1, p, n, 0);
+    child_agg_add(&agg, 2, p, n, 0);
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_encode(&agg, 0, buf, sizeof(buf), &len, &entries));
+
+    /* 전송 중 항목은 대체하지 않고 새 항목으로 추가 */
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_add(&agg, 1, p, n, 0));
+    TEST_ASSERT_EQUAL(1, child_agg_pending(&agg));
+
+    child_agg_abort(&agg);
+    TEST_ASSERT_EQUAL(3, child_agg_pending(&agg));
+    TEST_ASSERT_EQUAL(ESP_OK, child_agg_encode(&agg, 0, buf, sizeof(buf), &len, &entries));
+    TEST_ASSERT_EQUAL(3, entries);
+}
+
+void test_rejects_invalid_payloads(void)
+{
+    const uint8_t not_map[] = { 0x83, 0x01, 0x02, 0x03 };
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, child_agg_add(&agg, 1, not_map, sizeof(not_map), 0));
+    const uint8_t truncated[] = { 0xA2, 0x00, 0x01, 0x01 };
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, child_agg_add(&agg, 1, truncated, sizeof(truncated), 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, child_agg_add(&agg, 1, NULL, 4, 0));
+
+    uint8_t big[CHILD_AGG_PAYLOAD_MAX + 1];
+    memset(big, 0, sizeof(big));
+    big[0] = 0xA0;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, child_agg_add(&agg, 1, big, sizeof(big), 0));
+    TEST_ASSERT_EQUAL(0, child_agg_pending(&agg));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_encode_carries_payload_and_age);
+    RUN_TEST(test_newer_report_replaces_older);
+    RUN_TEST(test_batches_and_acks_are_not_replaced);
+    RUN_TEST(test_window_deadline);
+    RUN_TEST(test_urgent_messages_flush_immediately);
+    RUN_TEST(test_full_buffer);
+    RUN_TEST(test_encode_splits_to_fit_datagram);
+    RUN_TEST(test_abort_keeps_entries);
+    RUN_TEST(test_rejects_invalid_payloads);
+    return UNITY_END();
+}
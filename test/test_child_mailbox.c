@@ -0,0 +1,172 @@
+/**
+ * @file test_child_mailbox.c
+ * @brief Router-side per-child command mailbox unit tests
+ */
+#include "unity.h"
+#include "child_mailbox.h"
+#include <string.h>
+
+#define TTL 60000
+
+static child_mailbox_t mb;
+static uint8_t out[CHILD_MAILBOX_MSG_MAX];
+
+/* {0: 3, 30: seq, 31: cmd_id, 32: arg} */
+static size_t make_cmd(uint8_t *p, uint8_t seq, uint8_t cmd_id, uint8_t arg)
+{
+    size_t n = 0;
+    p[n++] = 0xA4;
+    p[n++] = 0x00; p[n++] = 0x03;
+    p[n++] = 0x18; p[n++] = 0x1E; p[n++] = seq;
+    p[n++] = 0x18; p[n++] = 0x1F; p[n++] = cmd_id;
+    p[n++] = 0x18; p[n++] = 0x20; p[n++] = arg;
+    return n;
+}
+
+/* {0: 4, 30: seq, 31: cmd_id, 33: status} */
+static size_t make_ack(uint8_t *p, uint8_t seq)
+{
+    size_t n = 0;
+    p[n++] = 0xA4;
+    p[n++] = 0x00; p[n++] = 0x04;
+    p[n++] = 0x18; p[n++] = 0x1E; p[n++] = seq;
+    p[n++] = 0x18; p[n++] = 0x1F; p[n++] = 0x04;
+    p[n++] = 0x18; p[n++] = 0x21; p[n++] = 0x00;
+    return n;
+}
+
+static void put(uint16_t node, uint8_t seq, uint32_t now)
+{
+    uint8_t cmd[16];
+    size_t n = make_cmd(cmd, seq, 4, 60);
+    TEST_ASSERT_EQUAL(ESP_OK, child_mailbox_put(&mb, node, cmd, n, now));
+}
+
+/* ACK에 실린 명령의 seq (없으면 -1) */
+static int take(uint16_t node, const uint8_t *uplink, size_t uplink_len, uint32_t now)
+{
+    size_t n = child_mailbox_take(&mb, node, uplink, uplink_len, now, TTL, out, sizeof(out));
+    return (n == 0) ? -1 : out[5];
+}
+
+void setUp(void)
+{
+    child_mailbox_init(&mb);
+}
+
+void tearDown(void) {}
+
+void test_take_until_acked(void)
+{
+    uint8_t report[] = {0xA2, 0x00, 0x01, 0x01, 0x19};  /* 내용 무관 */
+    uint8_t ack[16];
+
+    put(0x0801, 7, 0);
+    put(0x0801, 8, 0);
+    put(0x0802, 1, 0);
+
+    TEST_ASSERT_EQUAL(-1, take(0x0803, report, sizeof(report), 10));
+    TEST_ASSERT_EQUAL(7, take(0x0801, report, sizeof(report), 10));
+    TEST_ASSERT_EQUAL(7, take(0x0801, NULL, 0, 20));           /* 응답 전엔 다시 실음 */
+    TEST_ASSERT_EQUAL(8, take(0x0801, ack, make_ack(ack, 7), 30));
+    TEST_ASSERT_EQUAL(-1, take(0x0801, ack, make_ack(ack, 8), 40));
+    TEST_ASSERT_EQUAL(1, child_mailbox_pending(&mb, 0x0802));
+    TEST_ASSERT_EQUAL(2, mb.acked);
+    TEST_ASSERT_EQUAL(3, mb.sent);
+}
+
+void test_ack_only_removes_own_child(void)
+{
+    uint8_t ack[16];
+    put(0x0801, 5, 0);
+    put(0x0802, 5, 0);
+
+    TEST_ASSERT_EQUAL(-1, take(0x0802, ack, make_ack(ack, 5), 10));
+    TEST_ASSERT_EQUAL(1, child_mailbox_pending(&mb, 0x0801));
+    TEST_ASSERT_EQUAL(0, child_mailbox_pending(&mb, 0x0802));
+}
+
+void test_duplicate_seq_and_limits(void)
+{
+    uint8_t cmd[16];
+    size_t n = make_cmd(cmd, 1, 4, 60);
+
+    put(0x0801, 1, 0);
+    TEST_ASSERT_EQUAL(ESP_OK, child_mailbox_put(&mb, 0x0801, cmd, n, 0));  /* 재전송 */
+    TEST_ASSERT_EQUAL(1, mb.count);
+
+    for (uint8_t s = 2; s <= CHILD_MAILBOX_PER_CHILD; s++) put(0x0801, s, 0);
+    n = make_cmd(cmd, 20, 4, 60);
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, child_mailbox_put(&mb, 0x0801, cmd, n, 0));
+
+    for (uint16_t c = 0; mb.count < CHILD_MAILBOX_SLOTS; c++) put(0x0900 + c, 1, 0);
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, child_mailbox_put(&mb, 0x0A00, cmd, n, 0));
+    TEST_ASSERT_EQUAL(2, mb.dropped);
+}
+
+void test_rejects_non_command(void)
+{
+    uint8_t ack[16], big[CHILD_MAILBOX_MSG_MAX + 1];
+    size_t n = make_ack(ack, 1);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, child_mailbox_put(&mb, 0x0801, ack, n, 0));
+
+    memset(big, 0, sizeof(big));
+    make_cmd(big, 1, 4, 60);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, child_mailbox_put(&mb, 0x0801, big, sizeof(big), 0));
+    TEST_ASSERT_EQUAL(0, mb.count);
+}
+
+void test_expiry(void)
+{
+    put(0x0801, 1, 0);
+    put(0x0802, 2, TTL / 2);
+
+    TEST_ASSERT_EQUAL(-1, take(0x0801, NULL, 0, TTL + 1));
+    TEST_ASSERT_EQUAL(1, mb.expired);
+    TEST_ASSERT_EQUAL(2, take(0x0802, NULL, 0, TTL + 1));
+
+    /* now_ms 랩어라운드 */
+    child_mailbox_init(&mb);
+    put(0x0801, 3, UINT32_MAX - 100);
+    TEST_ASSERT_EQUAL(3, take(0x0801, NULL, 0, 100));
+}
+
+void test_put_aggregate(void)
+{
+    uint8_t msg[64], cmd[16];
+    size_t n = 0;
+    msg[n++] = 0xA2;
+    msg[n++] = 0x00; msg[n++] = 0x05;
+    msg[n++] = 0x17; msg[n++] = 0x82;
+    for (int i = 0; i < 2; i++) {
+        size_t c = make_cmd(cmd, (uint8_t)(10 + i), 1, 25);
+        msg[n++] = 0x83;
+        msg[n++] = 0x19; msg[n++] = 0x08; msg[n++] = (uint8_t)(0x01 + i);
+        msg[n++] = 0x00;
+        msg[n++] = (uint8_t)(0x40 | c);
+        memcpy(msg + n, cmd, c);
+        n += c;
+    }
+
+    size_t stored = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, child_mailbox_put_aggregate(&mb, msg, n, 0, &stored));
+    TEST_ASSERT_EQUAL(2, stored);
+    TEST_ASSERT_EQUAL(10, take(0x0801, NULL, 0, 1));
+    TEST_ASSERT_EQUAL(11, take(0x0802, NULL, 0, 1));
+
+    msg[2] = 0x01;  /* 집계가 아님 */
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, child_mailbox_put_aggregate(&mb, msg, n, 0, NULL));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, child_mailbox_put_aggregate(&mb, msg, 3, 0, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_take_until_acked);
+    RUN_TEST(test_ack_only_removes_own_child);
+    RUN_TEST(test_duplicate_seq_and_limits);
+    RUN_TEST(test_rejects_non_command);
+    RUN_TEST(test_expiry);
+    RUN_TEST(test_put_aggregate);
+    return UNITY_END();
+}
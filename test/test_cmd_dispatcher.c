@@ -0,0 +1,172 @@
+/**
+ * @file test_cmd_dispatcher.c
+ * @brief Downlink command protocol unit tests (parse / dispatch / ack)
+ */
+#include "unity.h"
+#include "cmd_dispatcher.h"
+#include "cbor_codec.h"
+#include <string.h>
+
+static float s_last_setpoint;
+static int s_calls;
+
+void setUp(void) {
+    s_last_setpoint = 0.0f;
+    s_calls = 0;
+}
+void tearDown(void) {}
+
+static cmd_status_t handle_setpoint(cbor_reader_t *arg, void *ctx)
+{
+    (void)ctx;
+    float v;
+    s_calls++;
+    if (cbor_reader_get_float(arg, &v) != ESP_OK) return CMD_STATUS_BAD_ARG;
+    s_last_setpoint = v;
+    return CMD_STATUS_OK;
+}
+
+static cmd_status_t handle_pid(cbor_reader_t *arg, void *ctx)
+{
+    float k[3];
+    s_calls++;
+    if (cmd_arg_floats(arg, k, 3) != ESP_OK) return CMD_STATUS_BAD_ARG;
+    *(float *)ctx = k[0] + k[1] + k[2];
+    return CMD_STATUS_OK;
+}
+
+static const cmd_entry_t s_table[] = {
+    { CMD_SET_SETPOINT, handle_setpoint },
+    { CMD_SET_PID,      handle_pid },
+};
+#define TABLE_LEN (sizeof(s_table) / sizeof(s_table[0]))
+
+/* {0: 3, 30: 300, 31: 1, 32: 31.5(f32)} */
+static const uint8_t s_setpoint_cmd[] = {
+    0xA4, 0x00, 0x03,
+    0x18, 0x1E, 0x19, 0x01, 0x2C,
+    0x18, 0x1F, 0x01,
+    0x18, 0x20, 0xFA, 0x41, 0xFC, 0x00, 0x00,
+};
+
+void test_is_command_prefilter(void)
+{
+    TEST_ASSERT_TRUE(cmd_is_command(s_setpoint_cmd, sizeof(s_setpoint_cmd)));
+
+    /* 텔레메트리 리포트는 명령 아님 */
+    const uint8_t report[] = { 0xA4, 0x00, 0x01, 0x01, 0x19, 0x0C, 0xB2 };
+    TEST_ASSERT_TRUE(!cmd_is_command(report, sizeof(report)));
+    TEST_ASSERT_TRUE(!cmd_is_command(s_setpoint_cmd, 2));
+    TEST_ASSERT_TRUE(!cmd_is_command(NULL, 10));
+}
+
+void test_parse_command(void)
+{
+    cmd_msg_t msg;
+    TEST_ASSERT_EQUAL(ESP_OK, cmd_parse(s_setpoint_cmd, sizeof(s_setpoint_cmd), &msg));
+    TEST_ASSERT_EQUAL(300, msg.seq);
+    TEST_ASSERT_EQUAL(CMD_SET_SETPOINT, msg.cmd_id);
+    TEST_ASSERT_TRUE(msg.arg == &s_setpoint_cmd[13]);
+    TEST_ASSERT_EQUAL(5, msg.arg_len);
+}
+
+void test_parse_rejects_missing_fields(void)
+{
+    /* seq 누락 */
+    const uint8_t no_seq[] = { 0xA2, 0x00, 0x03, 0x18, 0x1F, 0x01 };
+    /* 마커가 명령이 아님 */
+    const uint8_t not_cmd[] = { 0xA3, 0x00, 0x01, 0x18, 0x1E, 0x01, 0x18, 0x1F, 0x01 };
+    cmd_msg_t msg;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, cmd_parse(no_seq, sizeof(no_seq), &msg));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, cmd_parse(not_cmd, sizeof(not_cmd), &msg));
+}
+
+void test_parse_truncated_never_ok(void)
+{
+    cmd_msg_t msg;
+    for (size_t len = 0; len < sizeof(s_setpoint_cmd); len++) {
+        TEST_ASSERT_TRUE(cmd_parse(s_setpoint_cmd, len, &msg) != ESP_OK);
+    }
+}
+
+void test_dispatch_runs_handler(void)
+{
+    cmd_msg_t msg;
+    cmd_parse(s_setpoint_cmd, sizeof(s_setpoint_cmd), &msg);
+    TEST_ASSERT_EQUAL(CMD_STATUS_OK, cmd_dispatch(s_table, TABLE_LEN, &msg, NULL));
+    TEST_ASSERT_EQUAL(1, s_calls);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 31.5f, s_last_setpoint);
+}
+
+void test_dispatch_array_arg(void)
+{
+    /* {0: 3, 30: 1, 31: 2, 32: [2, 0.5(f16), 1]} */
+    const uint8_t in[] = { 0xA4, 0x00, 0x03, 0x18, 0x1E, 0x01, 0x18, 0x1F, 0x02,
+                           0x18, 0x20, 0x83, 0x02, 0xF9, 0x38, 0x00, 0x01 };
+    float sum = 0.0f;
+    cmd_msg_t msg;
+    TEST_ASSERT_EQUAL(ESP_OK, cmd_parse(in, sizeof(in), &msg));
+    TEST_ASSERT_EQUAL(CMD_STATUS_OK, cmd_dispatch(s_table, TABLE_LEN, &msg, &sum));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 3.5f, sum);
+}
+
+void test_dispatch_bad_arg_and_unknown(void)
+{
+    /* 인자 없음 → 핸들러가 BAD_ARG */
+    const uint8_t no_arg[] = { 0xA3, 0x00, 0x03, 0x18, 0x1E, 0x05, 0x18, 0x1F, 0x01 };
+    /* 명령 9 → UNKNOWN */
+    const uint8_t unknown[] = { 0xA3, 0x00, 0x03, 0x18, 0x1E, 0x06, 0x18, 0x1F, 0x09 };
+    cmd_msg_t msg;
+    TEST_ASSERT_EQUAL(ESP_OK, cmd_parse(no_arg, sizeof(no_arg), &msg));
+    TEST_ASSERT_EQUAL(CMD_STATUS_BAD_ARG, cmd_dispatch(s_table, TABLE_LEN, &msg, NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, cmd_parse(unknown, sizeof(unknown), &msg));
+    TEST_ASSERT_EQUAL(CMD_STATUS_UNKNOWN, cmd_dispatch(s_table, TABLE_LEN, &msg, NULL));
+}
+
+void test_ack_roundtrip(void)
+{
+    uint8_t buf[CMD_ACK_BUF_SIZE];
+    size_t len = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, cmd_encode_ack(65535, 4, CMD_STATUS_REJECTED,
+                                             buf, sizeof(buf), &len));
+    TEST_ASSERT_TRUE(len <= CMD_ACK_BUF_SIZE);
+
+    /* 리더로 다시 읽어 확인 */
+    cbor_reader_t rd;
+    cbor_item_t map;
+    int32_t k, v;
+    cbor_reader_init(&rd, buf, len);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &map));
+    TEST_ASSERT_EQUAL(4, (int)map.uval);
+    const int32_t expected[4][2] = {
+        { CBOR_KEY_MSG_TYPE, CBOR_MSG_CMD_ACK },
+        { CBOR_KEY_CMD_SEQ, 65535 },
+        { CBOR_KEY_CMD_ID, 4 },
+        { CBOR_KEY_CMD_STATUS, CMD_STATUS_REJECTED },
+    };
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(&rd, &k));
+        TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(&rd, &v));
+        TEST_ASSERT_EQUAL(expected[i][0], k);
+        TEST_ASSERT_EQUAL(expected[i][1], v);
+    }
+    TEST_ASSERT_TRUE(cbor_reader_at_end(&rd));
+
+    /* 응답은 명령으로 오인되지 않아야 함 */
+    TEST_ASSERT_TRUE(!cmd_is_command(buf, len));
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, cmd_encode_ack(1, 1, CMD_STATUS_OK, buf, 8, &len));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_is_command_prefilter);
+    RUN_TEST(test_parse_command);
+    RUN_TEST(test_parse_rejects_missing_fields);
+    RUN_TEST(test_parse_truncated_never_ok);
+    RUN_TEST(test_dispatch_runs_handler);
+    RUN_TEST(test_dispatch_array_arg);
+    RUN_TEST(test_dispatch_bad_arg_and_unknown);
+    RUN_TEST(test_ack_roundtrip);
+    return UNITY_END();
+}
@@ -0,0 +1,216 @@
+/**
+ * @file test_mesh_health.c
+ * @brief Mesh health message unit tests
+ */
+#include "unity.h"
+#include "mesh_health.h"
+#include "cbor_codec.h"
+#include "cbor_reader.h"
+#include <string.h>
+
+#define HEALTH_BUF 128   /* THREAD_TX_PAYLOAD_MAX */
+
+static mesh_health_t h;
+static uint8_t buf[HEALTH_BUF];
+static size_t len, links;
+
+static void add_link(uint16_t rloc16, int8_t rssi, uint8_t margin, bool child)
+{
+    mesh_link_t l = {
+        .rloc16 = rloc16, .rssi = rssi, .margin = margin, .frame_err_pct = 3, .child = child,
+    };
+    mesh_health_add_link(&h, &l);
+}
+
+static void expect_key(cbor_reader_t *rd, int32_t key)
+{
+    int32_t v;
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(rd, &v));
+    TEST_ASSERT_EQUAL(key, v);
+}
+
+/* 키 다음 정수 배열을 vals로 읽기 */
+static void read_uints(cbor_reader_t *rd, int32_t key, int32_t *vals, size_t n)
+{
+    cbor_item_t it;
+    expect_key(rd, key);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(rd, &it));
+    TEST_ASSERT_EQUAL(CBOR_TYPE_ARRAY, it.type);
+    TEST_ASSERT_EQUAL(n, it.uval);
+    for (size_t i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(rd, &vals[i]));
+    }
+}
+
+void setUp(void)
+{
+    mesh_health_reset(&h);
+    memset(buf, 0, sizeof(buf));
+    len = links = 0;
+}
+
+void tearDown(void) {}
+
+void test_links_kept_worst_first(void)
+{
+    add_link(0x0400, -70, 25, false);
+    add_link(0x0401, -92, 3, true);
+    add_link(0x0402, -80, 15, true);
+    add_link(0x0403, -80, 15, false);
+
+    TEST_ASSERT_EQUAL(4, h.neighbor_count);
+    TEST_ASSERT_EQUAL(4, h.link_count);
+    TEST_ASSERT_EQUAL(0x0401, h.links[0].rloc16);
+    TEST_ASSERT_EQUAL(0x0402, h.links[1].rloc16);  /* 같은 마진은 도착 순 */
+    TEST_ASSERT_EQUAL(0x0403, h.links[2].rloc16);
+    TEST_ASSERT_EQUAL(0x0400, h.links[3].rloc16);
+}
+
+void test_full_table_drops_best_link(void)
+{
+    for (int i = 0; i < MESH_HEALTH_MAX_LINKS; i++) {
+        add_link((uint16_t)(0x0400 + i), -60, (uint8_t)(20 + i), true);
+    }
+    add_link(0x0500, -50, 40, false);   /* 보관 중인 링크보다 좋음 → 버림 */
+    add_link(0x0501, -95, 1, true);     /* 가장 나쁨 → 맨 앞 */
+
+    TEST_ASSERT_EQUAL(MESH_HEALTH_MAX_LINKS + 2, h.neighbor_count);
+    TEST_ASSERT_EQUAL(MESH_HEALTH_MAX_LINKS, h.link_count);
+    TEST_ASSERT_EQUAL(0x0501, h.links[0].rloc16);
+    TEST_ASSERT_EQUAL(0x0400, h.links[1].rloc16);
+    TEST_ASSERT_EQUAL(0x0400 + MESH_HEALTH_MAX_LINKS - 2,
+                      h.links[MESH_HEALTH_MAX_LINKS - 1].rloc16);
+}
+
+void test_encode_roundtrip(void)
+{
+    h.role = 3;
+    h.uptime_s = 86400;
+    h.parent_changes = 2;
+    h.attach_attempts = 5;
+    h.partition_changes = 1;
+    h.mac_tx_total = 12000;
+    h.mac_tx_retry = 900;
+    h.mac_tx_err_cca = 4;
+    h.mac_tx_fail = 7;
+    h.mac_rx_total = 30000;
+    h.mac_rx_err = 11;
+    h.con_retransmits = 13;
+    h.con_timeouts = 1;
+    h.relay_failed = 2;
+    add_link(0x0801, -88, 9, true);
+    add_link(0x0400, -65, 30, false);
+    h.child_count = 1;
+
+    TEST_ASSERT_EQUAL(ESP_OK, mesh_health_encode(&h, buf, sizeof(buf), &len, &links));
+    TEST_ASSERT_EQUAL(2, links);
+    TEST_ASSERT_LESS_THAN(HEALTH_BUF + 1, len);
+
+    cbor_reader_t rd;
+    cbor_item_t it;
+    int32_t v[6];
+    cbor_reader_init(&rd, buf, len);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &it));
+    TEST_ASSERT_EQUAL(CBOR_TYPE_MAP, it.type);
+    TEST_ASSERT_EQUAL(7, it.uval);
+
+    expect_key(&rd, CBOR_KEY_MSG_TYPE);
+    expect_key(&rd, CBOR_MSG_HEALTH);
+    expect_key(&rd, CBOR_KEY_SCHEMA_VERSION);
+    expect_key(&rd, RBMS_SCHEMA_VERSION);
+
+    read_uints(&rd, CBOR_KEY_HEALTH_NODE, v, 4);
+    TEST_ASSERT_EQUAL(3, v[0]);
+    TEST_ASSERT_EQUAL(86400, v[1]);
+    TEST_ASSERT_EQUAL(1, v[2]);
+    TEST_ASSERT_EQUAL(2, v[3]);
+
+    read_uints(&rd, CBOR_KEY_HEALTH_MLE, v, 3);
+    TEST_ASSERT_EQUAL(2, v[0]);
+    TEST_ASSERT_EQUAL(5, v[1]);
+    TEST_ASSERT_EQUAL(1, v[2]);
+
+    read_uints(&rd, CBOR_KEY_HEALTH_MAC, v, 6);
+    TEST_ASSERT_EQUAL(12000, v[0]);
+    TEST_ASSERT_EQUAL(900, v[1]);
+    TEST_ASSERT_EQUAL(7, v[3]);
+    TEST_ASSERT_EQUAL(11, v[5]);
+
+    read_uints(&rd, CBOR_KEY_HEALTH_UPLINK, v, 6);
+    TEST_ASSERT_EQUAL(13, v[0]);
+    TEST_ASSERT_EQUAL(1, v[1]);
+    TEST_ASSERT_EQUAL(2, v[5]);
+
+    expect_key(&rd, CBOR_KEY_HEALTH_LINKS);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &it));
+    TEST_ASSERT_EQUAL(CBOR_TYPE_ARRAY, it.type);
+    TEST_ASSERT_EQUAL(2, it.uval);
+
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &it));
+    TEST_ASSERT_EQUAL(5, it.uval);
+    for (int i = 0; i < 5; i++) TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(&rd, &v[i]));
+    TEST_ASSERT_EQUAL(0x0801, v[0]);
+    TEST_ASSERT_EQUAL(-88, v[1]);
+    TEST_ASSERT_EQUAL(9, v[2]);
+    TEST_ASSERT_EQUAL(3, v[3]);
+    TEST_ASSERT_EQUAL(1, v[4]);
+
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &it));
+    for (int i = 0; i < 5; i++) TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_get_int(&rd, &v[i]));
+    TEST_ASSERT_EQUAL(0x0400, v[0]);
+    TEST_ASSERT_EQUAL(0, v[4]);
+    TEST_ASSERT_EQUAL(len, rd.pos);
+}
+
+void test_encode_truncates_links_to_fit(void)
+{
+    /* 큰 카운터 (각 5 bytes) + 8개 링크 → 128 bytes에 일부만 */
+    h.uptime_s = 1000000;
+    h.mac_tx_total = h.mac_tx_retry = h.mac_tx_err_cca = 100000;
+    h.mac_tx_fail = h.mac_rx_total = h.mac_rx_err = 100000;
+    h.con_retransmits = h.con_timeouts = h.send_errors = 100000;
+    h.tx_dropped = h.rx_dropped = h.relay_failed = 100000;
+    for (int i = 0; i < MESH_HEALTH_MAX_LINKS; i++) {
+        add_link((uint16_t)(0x0400 + i), -90, (uint8_t)(30 + i), true);
+    }
+
+    TEST_ASSERT_EQUAL(ESP_OK, mesh_health_encode(&h, buf, sizeof(buf), &len, &links));
+    TEST_ASSERT_GREATER_THAN(0, links);
+    TEST_ASSERT_LESS_THAN(MESH_HEALTH_MAX_LINKS, links);
+    TEST_ASSERT_LESS_THAN(HEALTH_BUF + 1, len);
+
+    /* 마지막 항목(링크 배열)이 담은 수만큼 끝까지 읽힘 */
+    cbor_reader_t rd;
+    cbor_item_t it;
+    cbor_reader_init(&rd, buf, len);
+    TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &it));
+    for (int i = 0; i < 7; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &it));
+        if (i == 6) {
+            TEST_ASSERT_EQUAL(CBOR_KEY_HEALTH_LINKS, it.uval);
+        }
+        TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_next(&rd, &it));
+        if (i == 6) {
+            TEST_ASSERT_EQUAL(links, it.uval);
+        }
+        TEST_ASSERT_EQUAL(ESP_OK, cbor_reader_skip(&rd, &it));
+    }
+    TEST_ASSERT_EQUAL(len, rd.pos);
+}
+
+void test_encode_buffer_too_small(void)
+{
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, mesh_health_encode(&h, buf, 16, &len, &links));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, mesh_health_encode(NULL, buf, sizeof(buf), &len, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_links_kept_worst_first);
+    RUN_TEST(test_full_table_drops_best_link);
+    RUN_TEST(test_encode_roundtrip);
+    RUN_TEST(test_encode_truncates_links_to_fit);
+    RUN_TEST(test_encode_buffer_too_small);
+    return UNITY_END();
+}
@@ -0,0 +1,185 @@
+/**
+ * @file test_msg_ring.c
+ * @brief Lock-free message ring unit tests
+ */
+#include "unity.h"
+#include "msg_ring.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define RING_LEN 4
+
+static msg_ring_slot_t slots[RING_LEN];
+static msg_ring_t ring;
+static uint8_t out[MSG_RING_PAYLOAD_MAX];
+
+void setUp(void) {
+    memset(slots, 0, sizeof(slots));
+    msg_ring_init(&ring, slots, RING_LEN);
+}
+void tearDown(void) {}
+
+void test_init_rejects_bad_sizes(void)
+{
+    msg_ring_t r;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, msg_ring_init(&r, slots, 3));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, msg_ring_init(&r, slots, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, msg_ring_init(&r, NULL, 4));
+    TEST_ASSERT_EQUAL(ESP_OK, msg_ring_init(&r, slots, 2));
+}
+
+void test_fifo_order_and_tags(void)
+{
+    for (uint8_t i = 0; i < 3; i++) {
+        uint8_t msg[2] = { i, (uint8_t)(i * 10) };
+        TEST_ASSERT_EQUAL(ESP_OK, msg_ring_push(&ring, 100 + i, msg, sizeof(msg)));
+    }
+    TEST_ASSERT_EQUAL(3, msg_ring_depth(&ring));
+
+    for (uint8_t i = 0; i < 3; i++) {
+        uint32_t tag = 0;
+        size_t len = 0;
+        TEST_ASSERT_EQUAL(ESP_OK, msg_ring_pop(&ring, &tag, out, &len));
+        TEST_ASSERT_EQUAL_UINT32((uint32_t)(100 + i), tag);
+        TEST_ASSERT_EQUAL(2, len);
+        TEST_ASSERT_EQUAL(i, out[0]);
+        TEST_ASSERT_EQUAL(i * 10, out[1]);
+    }
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, msg_ring_pop(&ring, NULL, out, NULL));
+    TEST_ASSERT_EQUAL(0, msg_ring_depth(&ring));
+}
+
+void test_full_ring_rejects_push(void)
+{
+    const uint8_t b = 0xAB;
+    for (int i = 0; i < RING_LEN; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, msg_ring_push(&ring, i, &b, 1));
+    }
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, msg_ring_push(&ring, 99, &b, 1));
+    TEST_ASSERT_EQUAL(RING_LEN, msg_ring_depth(&ring));
+
+    /* 가장 오래된 것 버리면 다시 들어감 (덮어쓰기 정책) */
+    uint32_t tag = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, msg_ring_pop(&ring, &tag, NULL, NULL));
+    TEST_ASSERT_EQUAL_UINT32(0, tag);
+    TEST_ASSERT_EQUAL(ESP_OK, msg_ring_push(&ring, 99, &b, 1));
+}
+
+void test_wraps_many_times(void)
+{
+    for (uint32_t i = 0; i < 1000; i++) {
+        uint8_t v = (uint8_t)i;
+        TEST_ASSERT_EQUAL(ESP_OK, msg_ring_push(&ring, i, &v, 1));
+        if (i % 3 == 0) {
+            TEST_ASSERT_EQUAL(ESP_OK, msg_ring_push(&ring, i, &v, 1));
+            TEST_ASSERT_EQUAL(ESP_OK, msg_ring_pop(&ring, NULL, out, NULL));
+        }
+        TEST_ASSERT_EQUAL(ESP_OK, msg_ring_pop(&ring, NULL, out, NULL));
+    }
+    TEST_ASSERT_EQUAL(0, msg_ring_depth(&ring));
+}
+
+void test_payload_limits(void)
+{
+    uint8_t big[MSG_RING_PAYLOAD_MAX + 1];
+    memset(big, 0x5A, sizeof(big));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, msg_ring_push(&ring, 0, big, sizeof(big)));
+    TEST_ASSERT_EQUAL(ESP_OK, msg_ring_push(&ring, 0, big, MSG_RING_PAYLOAD_MAX));
+    TEST_ASSERT_EQUAL(ESP_OK, msg_ring_push(&ring, 1, NULL, 0));
+
+    size_t len = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, msg_ring_pop(&ring, NULL, out, &len));
+    TEST_ASSERT_EQUAL(MSG_RING_PAYLOAD_MAX, len);
+    TEST_ASSERT_EQUAL(0, memcmp(out, big, MSG_RING_PAYLOAD_MAX));
+    TEST_ASSERT_EQUAL(ESP_OK, msg_ring_pop(&ring, NULL, out, &len));
+    TEST_ASSERT_EQUAL(0, len);
+}
+
+void test_zero_copy_claim_and_acquire(void)
+{
+    msg_ring_slot_t *w = msg_ring_claim(&ring);
+    TEST_ASSERT_TRUE(w != NULL);
+    /* 게시 전에는 소비자에게 보이지 않음 */
+    TEST_ASSERT_TRUE(msg_ring_acquire(&ring) == NULL);
+
+    w->data[0] = 0x42;
+    w->len = 1;
+    w->tag = 3;
+    msg_ring_publish(&ring, w);
+
+    msg_ring_slot_t *rd = msg_ring_acquire(&ring);
+    TEST_ASSERT_TRUE(rd == w);
+    TEST_ASSERT_EQUAL(0x42, rd->data[0]);
+    TEST_ASSERT_EQUAL_UINT32(3, rd->tag);
+    /* 반환 전에는 그 슬롯을 다시 claim할 수 없음 (한 바퀴 채운 뒤) */
+    for (int i = 0; i < RING_LEN - 1; i++) {
+        msg_ring_slot_t *s = msg_ring_claim(&ring);
+        TEST_ASSERT_TRUE(s != NULL);
+        s->len = 0;
+        msg_ring_publish(&ring, s);
+    }
+    TEST_ASSERT_TRUE(msg_ring_claim(&ring) == NULL);
+    msg_ring_release(&ring, rd);
+    TEST_ASSERT_TRUE(msg_ring_claim(&ring) != NULL);
+}
+
+/* --- 다중 생산자: 모든 메시지가 정확히 한 번, 생산자별 순서 유지 --- */
+#define STRESS_PRODUCERS 3
+#define STRESS_PER_PRODUCER 20000
+
+static void *producer(void *arg)
+{
+    uint32_t id = (uint32_t)(uintptr_t)arg;
+    for (uint32_t n = 0; n < STRESS_PER_PRODUCER; n++) {
+        uint8_t payload[4];
+        memcpy(payload, &n, sizeof(n));
+        while (msg_ring_push(&ring, id, payload, sizeof(payload)) == ESP_ERR_NO_MEM) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+void test_concurrent_producers(void)
+{
+    pthread_t th[STRESS_PRODUCERS];
+    for (uintptr_t i = 0; i < STRESS_PRODUCERS; i++) {
+        pthread_create(&th[i], NULL, producer, (void *)i);
+    }
+
+    uint32_t next[STRESS_PRODUCERS] = {0};
+    uint32_t total = 0;
+    bool ordered = true;
+    while (total < STRESS_PRODUCERS * STRESS_PER_PRODUCER) {
+        uint32_t tag;
+        size_t len;
+        if (msg_ring_pop(&ring, &tag, out, &len) != ESP_OK) {
+            sched_yield();
+            continue;
+        }
+        uint32_t n;
+        memcpy(&n, out, sizeof(n));
+        if (tag >= STRESS_PRODUCERS || len != 4 || n != next[tag]) ordered = false;
+        else next[tag]++;
+        total++;
+    }
+    for (int i = 0; i < STRESS_PRODUCERS; i++) pthread_join(th[i], NULL);
+
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, msg_ring_pop(&ring, NULL, out, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_init_rejects_bad_sizes);
+    RUN_TEST(test_fifo_order_and_tags);
+    RUN_TEST(test_full_ring_rejects_push);
+    RUN_TEST(test_wraps_many_times);
+    RUN_TEST(test_payload_limits);
+    RUN_TEST(test_zero_copy_claim_and_acquire);
+    RUN_TEST(test_concurrent_producers);
+    return UNITY_END();
+}
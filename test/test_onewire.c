@@ -0,0 +1,361 @@
+/**
+ * @file test_onewire.c
+ * @brief 1-Wire symbol codec and bus layer unit tests
+ *
+ * mock 백엔드는 RMT 백엔드와 같은 경로를 흉내 낸다: 슬롯을 심볼로 인코딩하고,
+ * 가상 디바이스가 심볼 파형으로 비트를 읽고, 라인 파형을 심볼로 돌려주면 디코딩.
+ */
+#include "unity.h"
+#include "onewire_bus.h"
+#include "onewire_symbols.h"
+#include <string.h>
+
+/* --- 가상 DS18B20 버스 --- */
+
+#define SIM_DEVICES 3
+
+typedef enum { SIM_IDLE, SIM_ROM_CMD, SIM_SEARCH, SIM_MATCH, SIM_FUNC_CMD, SIM_SCRATCH } sim_state_t;
+
+static struct {
+    int         count;
+    uint8_t     rom[SIM_DEVICES][8];
+    uint8_t     scratch[SIM_DEVICES][9];
+    bool        active[SIM_DEVICES];
+    sim_state_t state;
+    int         bit;        /* 현재 상태에서 진행한 비트 수 */
+    uint8_t     shift[8];
+    int         resets;
+    int         read_calls;
+    bool        read_fail;  /* 전송 실패 (RMT 수신 타임아웃) */
+} sim;
+
+static int rom_bit(const uint8_t *rom, int n)
+{
+    return (rom[n / 8] >> (n % 8)) & 1;
+}
+
+/* 마스터 쓰기 비트 (디바이스 쪽) */
+static void sim_write(int b)
+{
+    switch (sim.state) {
+    case SIM_ROM_CMD:
+    case SIM_FUNC_CMD:
+        if (b) sim.shift[0] |= (uint8_t)(1 << sim.bit);
+        if (++sim.bit < 8) return;
+        sim.bit = 0;
+        if (sim.state == SIM_ROM_CMD) {
+            if (sim.shift[0] == ONEWIRE_CMD_SEARCH_ROM) sim.state = SIM_SEARCH;
+            else if (sim.shift[0] == ONEWIRE_CMD_MATCH_ROM) sim.state = SIM_MATCH;
+            else if (sim.shift[0] == ONEWIRE_CMD_SKIP_ROM) sim.state = SIM_FUNC_CMD;
+            else sim.state = SIM_IDLE;
+            memset(sim.shift, 0, sizeof(sim.shift));
+        } else {
+            sim.state = (sim.shift[0] == 0xBE) ? SIM_SCRATCH : SIM_IDLE;
+        }
+        return;
+    case SIM_SEARCH:
+        /* 트리플릿 세 번째 슬롯: 방향이 다른 디바이스는 빠짐 */
+        for (int d = 0; d < sim.count; d++) {
+            if (rom_bit(sim.rom[d], sim.bit / 3) != b) sim.active[d] = false;
+        }
+        sim.bit++;
+        if (sim.bit == 64 * 3) sim.state = SIM_IDLE;
+        return;
+    case SIM_MATCH:
+        for (int d = 0; d < sim.count; d++) {
+            if (rom_bit(sim.rom[d], sim.bit) != b) sim.active[d] = false;
+        }
+        if (++sim.bit == 64) {
+            sim.bit = 0;
+            sim.state = SIM_FUNC_CMD;
+        }
+        return;
+    default:
+        return;
+    }
+}
+
+/* read slot — wired-AND (응답 없는 디바이스는 1) */
+static int sim_read(void)
+{
+    int line = 1;
+    for (int d = 0; d < sim.count; d++) {
+        if (!sim.active[d]) continue;
+        int b = 1;
+        if (sim.state == SIM_SEARCH) {
+            int rb = rom_bit(sim.rom[d], sim.bit / 3);
+            b = (sim.bit % 3 == 0) ? rb : !rb;
+        } else if (sim.state == SIM_SCRATCH && sim.bit < 72) {
+            b = rom_bit(sim.scratch[d], sim.bit);
+        }
+        line &= b;
+    }
+    if (sim.state == SIM_SEARCH || sim.state == SIM_SCRATCH) sim.bit++;
+    return line;
+}
+
+/* 라인 파형 심볼 한 개 */
+static ow_symbol_t line_sym(uint16_t low_us, uint16_t high_us)
+{
+    ow_symbol_t s = { .val = 0 };
+    s.level0 = 0;
+    s.duration0 = low_us;
+    s.level1 = 1;
+    s.duration1 = high_us;
+    return s;
+}
+
+static bool mock_reset(void *ctx)
+{
+    (void)ctx;
+    ow_symbol_t tx, rx[3];
+    ow_sym_encode_reset(&tx);
+
+    bool any = sim.count > 0;
+    sim.resets++;
+    sim.state = any ? SIM_ROM_CMD : SIM_IDLE;
+    sim.bit = 0;
+    memset(sim.shift, 0, sizeof(sim.shift));
+    for (int d = 0; d < SIM_DEVICES; d++) sim.active[d] = (d < sim.count);
+
+    size_t n = 0;
+    if (any) {
+        rx[n++] = line_sym(tx.duration0, 30);
+        rx[n++] = line_sym(120, 330);   /* presence */
+    } else {
+        rx[n++] = line_sym(tx.duration0, tx.duration1);
+    }
+    rx[n] = (ow_symbol_t){ .val = 0 };   /* 수신 종료 */
+    return ow_sym_decode_presence(rx, n + 1);
+}
+
+static esp_err_t mock_write_bits(void *ctx, const uint8_t *data, size_t nbits)
+{
+    (void)ctx;
+    ow_symbol_t tx[128];
+    if (nbits > 128) return ESP_ERR_INVALID_SIZE;
+    ow_sym_encode_bits(data, nbits, tx);
+    for (size_t i = 0; i < nbits; i++) {
+        sim_write(tx[i].duration0 < OW_SYM_READ_SAMPLE_US);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t mock_read_bits(void *ctx, uint8_t *data, size_t nbits)
+{
+    (void)ctx;
+    ow_symbol_t tx[128], rx[128];
+    if (nbits > 128) return ESP_ERR_INVALID_SIZE;
+    if (sim.read_fail) return ESP_ERR_TIMEOUT;
+    ow_sym_encode_read(nbits, tx);
+    for (size_t i = 0; i < nbits; i++) {
+        /* 0이면 디바이스가 ~30 us까지 low 유지 */
+        uint16_t low = sim_read() ? tx[i].duration0 : 30;
+        rx[i] = line_sym(low, OW_SYM_SLOT_US - low);
+    }
+    sim.read_calls++;
+    return (ow_sym_decode_bits(rx, nbits, data, 0, nbits) == nbits) ? ESP_OK : ESP_FAIL;
+}
+
+static const onewire_ops_t mock_ops = {
+    .reset = mock_reset,
+    .write_bits = mock_write_bits,
+    .read_bits = mock_read_bits,
+};
+static const onewire_bus_t bus = { .ops = &mock_ops, .ctx = NULL };
+
+static void sim_add(const uint8_t serial[6], int16_t raw)
+{
+    int d = sim.count++;
+    sim.rom[d][0] = 0x28;   /* DS18B20 family */
+    memcpy(&sim.rom[d][1], serial, 6);
+    sim.rom[d][7] = onewire_crc8(sim.rom[d], 7);
+    memset(sim.scratch[d], 0, 9);
+    sim.scratch[d][0] = (uint8_t)(raw & 0xFF);
+    sim.scratch[d][1] = (uint8_t)((raw >> 8) & 0xFF);
+    sim.scratch[d][4] = 0x7F;
+    sim.scratch[d][8] = onewire_crc8(sim.scratch[d], 8);
+}
+
+void setUp(void)
+{
+    memset(&sim, 0, sizeof(sim));
+}
+
+void tearDown(void) {}
+
+/* --- 심볼 코덱 --- */
+
+void test_crc8_known_rom(void)
+{
+    /* Maxim AN27 예제 ROM */
+    const uint8_t rom[7] = { 0x02, 0x1C, 0xB8, 0x01, 0x00, 0x00, 0x00 };
+    TEST_ASSERT_EQUAL(0xA2, onewire_crc8(rom, sizeof(rom)));
+}
+
+void test_encode_bits_lsb_first(void)
+{
+    const uint8_t data = 0x05;
+    ow_symbol_t s[8];
+    TEST_ASSERT_EQUAL(8, ow_sym_encode_bits(&data, 8, s));
+    const uint16_t low[8] = { 6, 60, 6, 60, 60, 60, 60, 60 };
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL(0, s[i].level0);
+        TEST_ASSERT_EQUAL(1, s[i].level1);
+        TEST_ASSERT_EQUAL(low[i], s[i].duration0);
+        TEST_ASSERT_EQUAL(OW_SYM_SLOT_US, s[i].duration0 + s[i].duration1);
+    }
+}
+
+void test_decode_presence(void)
+{
+    ow_symbol_t rx[3];
+    rx[0] = line_sym(480, 35);
+    rx[1] = line_sym(110, 300);
+    TEST_ASSERT_TRUE(ow_sym_decode_presence(rx, 2));
+
+    /* 리셋 low만 있고 응답 없음 */
+    TEST_ASSERT(!ow_sym_decode_presence(rx, 1));
+
+    /* RX가 high부터 잡은 경우: low가 duration1 쪽에 옴 */
+    rx[0].level0 = 1; rx[0].duration0 = 5;
+    rx[0].level1 = 0; rx[0].duration1 = 480;
+    rx[1].level0 = 1; rx[1].duration0 = 30;
+    rx[1].level1 = 0; rx[1].duration1 = 100;
+    rx[2] = line_sym(0, 0);
+    rx[2].level0 = 1; rx[2].duration0 = 300;
+    TEST_ASSERT_TRUE(ow_sym_decode_presence(rx, 3));
+
+    /* 짧은 글리치는 presence 아님 */
+    rx[0] = line_sym(480, 35);
+    rx[1] = line_sym(5, 400);
+    TEST_ASSERT(!ow_sym_decode_presence(rx, 2));
+}
+
+void test_decode_bits_with_offset_and_missing_slots(void)
+{
+    ow_symbol_t rx[4];
+    rx[0] = line_sym(6, 64);    /* 1 */
+    rx[1] = line_sym(30, 40);   /* 0 */
+    rx[2] = line_sym(7, 63);    /* 1 */
+    rx[3] = (ow_symbol_t){ .val = 0 };   /* 수신 종료 */
+
+    uint8_t out[2] = { 0x00, 0x00 };
+    /* 비트 6부터 5개: 3개 수신, 나머지 2개는 1 */
+    TEST_ASSERT_EQUAL(3, ow_sym_decode_bits(rx, 4, out, 6, 5));
+    TEST_ASSERT_EQUAL(0x40, out[0]);        /* 비트 6 = 1, 7 = 0 */
+    TEST_ASSERT_EQUAL(0x07, out[1]);        /* 비트 8 = 1, 9~10 = 1 (누락) */
+}
+
+void test_read_roundtrip_byte(void)
+{
+    ow_symbol_t tx[8], rx[8];
+    const uint8_t expect = 0xA6;
+    ow_sym_encode_read(8, tx);
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL(OW_SYM_READ_LOW_US, tx[i].duration0);
+        uint16_t low = ((expect >> i) & 1) ? tx[i].duration0 : 45;
+        rx[i] = line_sym(low, OW_SYM_SLOT_US - low);
+    }
+    uint8_t got = 0;
+    TEST_ASSERT_EQUAL(8, ow_sym_decode_bits(rx, 8, &got, 0, 8));
+    TEST_ASSERT_EQUAL(expect, got);
+}
+
+/* --- 버스 계층 (mock 백엔드) --- */
+
+void test_search_finds_all_devices(void)
+{
+    const uint8_t a[6] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 };
+    const uint8_t b[6] = { 0x10, 0x22, 0x33, 0x44, 0x55, 0x66 };   /* 첫 비트부터 충돌 */
+    const uint8_t c[6] = { 0xF0, 0x0D, 0xBE, 0xEF, 0x00, 0x01 };
+    sim_add(a, 0);
+    sim_add(b, 0);
+    sim_add(c, 0);
+
+    onewire_search_t s;
+    onewire_search_init(&s);
+    uint8_t rom[8];
+    bool seen[SIM_DEVICES] = { false };
+    for (int n = 0; n < SIM_DEVICES; n++) {
+        TEST_ASSERT_EQUAL(ESP_OK, onewire_search_next(&bus, &s, rom));
+        for (int d = 0; d < SIM_DEVICES; d++) {
+            if (memcmp(rom, sim.rom[d], 8) == 0) {
+                TEST_ASSERT(!seen[d]);
+                seen[d] = true;
+            }
+        }
+    }
+    TEST_ASSERT_TRUE(seen[0] && seen[1] && seen[2]);
+    TEST_ASSERT_TRUE(s.done);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, onewire_search_next(&bus, &s, rom));
+    /* 트리플릿당 read 트랜잭션 1회 */
+    TEST_ASSERT_EQUAL(SIM_DEVICES * 64, sim.read_calls);
+}
+
+void test_search_empty_bus(void)
+{
+    onewire_search_t s;
+    onewire_search_init(&s);
+    uint8_t rom[8];
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, onewire_search_next(&bus, &s, rom));
+    TEST_ASSERT_EQUAL(1, sim.resets);
+}
+
+void test_select_and_read_scratchpad(void)
+{
+    const uint8_t a[6] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 };
+    const uint8_t b[6] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x07 };
+    sim_add(a, 0x0191);    /* 25.0625 °C */
+    sim_add(b, -0x0090);   /* -9 °C */
+
+    uint8_t scratch[9];
+    TEST_ASSERT_EQUAL(ESP_OK, onewire_select(&bus, sim.rom[1], 0xBE));
+    TEST_ASSERT_EQUAL(ESP_OK, onewire_read(&bus, scratch, sizeof(scratch)));
+    TEST_ASSERT(memcmp(sim.scratch[1], scratch, 9) == 0);
+    TEST_ASSERT_EQUAL(scratch[8], onewire_crc8(scratch, 8));
+
+    TEST_ASSERT_EQUAL(ESP_OK, onewire_select(&bus, sim.rom[0], 0xBE));
+    TEST_ASSERT_EQUAL(ESP_OK, onewire_read(&bus, scratch, sizeof(scratch)));
+    TEST_ASSERT_EQUAL(0x91, scratch[0]);
+    TEST_ASSERT_EQUAL(0x01, scratch[1]);
+
+    /* SKIP ROM에 두 디바이스가 답하면 wired-AND로 CRC 깨짐 */
+    TEST_ASSERT_EQUAL(ESP_OK, onewire_select(&bus, NULL, 0xBE));
+    TEST_ASSERT_EQUAL(ESP_OK, onewire_read(&bus, scratch, sizeof(scratch)));
+    TEST_ASSERT(scratch[8] != onewire_crc8(scratch, 8));
+}
+
+void test_select_without_presence(void)
+{
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, onewire_select(&bus, NULL, 0x44));
+}
+
+void test_read_bit_reports_transport_error(void)
+{
+    int bit = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, onewire_read_bit(&bus, &bit));
+    TEST_ASSERT_EQUAL(1, bit);   /* 유휴 버스 */
+
+    /* 실패는 1(변환 완료)과 구분, 출력값 유지 */
+    bit = 0;
+    sim.read_fail = true;
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, onewire_read_bit(&bus, &bit));
+    TEST_ASSERT_EQUAL(0, bit);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_crc8_known_rom);
+    RUN_TEST(test_encode_bits_lsb_first);
+    RUN_TEST(test_decode_presence);
+    RUN_TEST(test_decode_bits_with_offset_and_missing_slots);
+    RUN_TEST(test_read_roundtrip_byte);
+    RUN_TEST(test_search_finds_all_devices);
+    RUN_TEST(test_search_empty_bus);
+    RUN_TEST(test_select_and_read_scratchpad);
+    RUN_TEST(test_select_without_presence);
+    RUN_TEST(test_read_bit_reports_transport_error);
+    return UNITY_END();
+}
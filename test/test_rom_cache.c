@@ -0,0 +1,121 @@
+/**
+ * @file test_rom_cache.c
+ * @brief DS18B20 ROM code cache unit tests
+ */
+#include "unity.h"
+#include "rom_cache.h"
+#include <string.h>
+
+static rom_cache_t cache;
+static uint8_t roms[3][ONEWIRE_ROM_LEN];
+static const uint8_t buses[3] = { 0, 0, 1 };
+
+static void make_rom(uint8_t *rom, uint8_t serial)
+{
+    memset(rom, 0, ONEWIRE_ROM_LEN);
+    rom[0] = 0x28;
+    rom[1] = serial;
+    rom[6] = 0x03;
+    rom[7] = onewire_crc8(rom, 7);
+}
+
+void setUp(void)
+{
+    memset(&cache, 0, sizeof(cache));
+    for (int i = 0; i < 3; i++) make_rom(roms[i], (uint8_t)(0x10 + i));
+}
+
+void tearDown(void) {}
+
+void test_zeroed_and_garbage_rejected(void)
+{
+    /* 전원 투입 직후 RTC 메모리 (0) */
+    TEST_ASSERT(!rom_cache_valid(&cache));
+    TEST_ASSERT_EQUAL(0, rom_cache_take(&cache, 0));
+
+    memset(&cache, 0xA5, sizeof(cache));
+    TEST_ASSERT(!rom_cache_valid(&cache));
+    TEST_ASSERT_EQUAL(0, rom_cache_take(&cache, 0));
+}
+
+void test_store_then_take(void)
+{
+    TEST_ASSERT(rom_cache_store(&cache, roms, buses, 2));
+    TEST_ASSERT(rom_cache_valid(&cache));
+    TEST_ASSERT_EQUAL(2, rom_cache_take(&cache, 0));
+    TEST_ASSERT(memcmp(cache.rom[1], roms[1], ONEWIRE_ROM_LEN) == 0);
+    /* 사용 횟수 증가 후에도 CRC 유효 */
+    TEST_ASSERT_EQUAL(1, cache.uses);
+    TEST_ASSERT(rom_cache_valid(&cache));
+}
+
+void test_corruption_detected(void)
+{
+    rom_cache_store(&cache, roms, buses, 2);
+    cache.rom[1][3] ^= 0x01;
+    TEST_ASSERT(!rom_cache_valid(&cache));
+    TEST_ASSERT_EQUAL(0, rom_cache_take(&cache, 0));
+
+    /* 구조체 CRC는 맞지만 ROM CRC-8이 틀린 내용 (잘못 저장된 검색 결과) */
+    uint8_t bad[1][ONEWIRE_ROM_LEN];
+    memcpy(bad[0], roms[0], ONEWIRE_ROM_LEN);
+    bad[0][7] ^= 0xFF;
+    rom_cache_store(&cache, (const uint8_t (*)[ONEWIRE_ROM_LEN])bad, buses, 1);
+    TEST_ASSERT(!rom_cache_valid(&cache));
+}
+
+void test_periodic_rescan(void)
+{
+    rom_cache_store(&cache, roms, buses, 3);
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(3, rom_cache_take(&cache, 5));
+    }
+    TEST_ASSERT_EQUAL(0, rom_cache_take(&cache, 5));
+
+    /* 검색 후 같은 목록 → 변경 없음 (NVS 쓰기 불필요), 주기 다시 시작 */
+    TEST_ASSERT(!rom_cache_store(&cache, roms, buses, 3));
+    TEST_ASSERT_EQUAL(3, rom_cache_take(&cache, 5));
+}
+
+void test_rescan_request(void)
+{
+    rom_cache_store(&cache, roms, buses, 2);
+    rom_cache_request_rescan(&cache);
+    TEST_ASSERT(rom_cache_valid(&cache));
+    TEST_ASSERT_EQUAL(0, rom_cache_take(&cache, 0));
+    TEST_ASSERT_EQUAL(0, rom_cache_take(&cache, 0));
+
+    /* 프로브 교체: 다른 ROM → 변경 보고, 요청 해제 */
+    TEST_ASSERT(rom_cache_store(&cache, (const uint8_t (*)[ONEWIRE_ROM_LEN])&roms[1], buses, 2));
+    TEST_ASSERT_EQUAL(2, rom_cache_take(&cache, 0));
+}
+
+void test_bus_move_is_a_change(void)
+{
+    /* 같은 프로브를 다른 핀(버스)에 옮겨 꽂음 → NVS 갱신 필요 */
+    const uint8_t moved[3] = { 0, 1, 1 };
+    rom_cache_store(&cache, roms, buses, 3);
+    TEST_ASSERT(!rom_cache_store(&cache, roms, buses, 3));
+    TEST_ASSERT(rom_cache_store(&cache, roms, moved, 3));
+    TEST_ASSERT_EQUAL(1, cache.bus[1]);
+}
+
+void test_empty_search_not_used(void)
+{
+    rom_cache_store(&cache, roms, buses, 0);
+    TEST_ASSERT(rom_cache_valid(&cache));
+    TEST_ASSERT_EQUAL(0, rom_cache_take(&cache, 0));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_zeroed_and_garbage_rejected);
+    RUN_TEST(test_store_then_take);
+    RUN_TEST(test_corruption_detected);
+    RUN_TEST(test_periodic_rescan);
+    RUN_TEST(test_rescan_request);
+    RUN_TEST(test_bus_move_is_a_change);
+    RUN_TEST(test_empty_search_not_used);
+    return UNITY_END();
+}
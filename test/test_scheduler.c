@@ -0,0 +1,175 @@
+/**
+ * @file test_scheduler.c
+ * @brief Light scheduler event timeline unit tests
+ */
+#include "unity.h"
+#include "scheduler.h"
+
+#define MIN_US  60000000LL
+#define DAY_US  (1440 * MIN_US)
+/* 2026-03-02 00:00:00 UTC */
+#define DAY0_US (1772409600LL * 1000000LL)
+
+static int64_t at(int hour, int minute)
+{
+    return DAY0_US + (hour * 60 + minute) * MIN_US;
+}
+
+void setUp(void)
+{
+    scheduler_init();
+    scheduler_set_utc_offset(0);
+    scheduler_set_calendar(NULL);
+    light_schedule_t sched = { .on_hour = 7, .off_hour = 19, .sunrise_min = 30, .sunset_min = 30 };
+    scheduler_set_light(&sched);
+}
+
+void tearDown(void) {}
+
+void test_next_event_is_light_on(void)
+{
+    TEST_ASSERT(scheduler_update(at(3, 0)));   /* 첫 계산 */
+    TEST_ASSERT(!scheduler_is_light_on());
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler_get_ramp(at(3, 0), NULL, NULL));
+    TEST_ASSERT(scheduler_next_event_us() == at(7, 0));
+
+    /* 전이 전 호출은 재계산 없음 */
+    TEST_ASSERT(!scheduler_update(at(6, 59) + 59 * 1000000LL));
+    TEST_ASSERT(scheduler_next_event_us() == at(7, 0));
+
+    TEST_ASSERT(scheduler_update(at(7, 0)));
+    TEST_ASSERT(scheduler_is_light_on());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, scheduler_get_dimming());
+}
+
+void test_sunrise_is_one_ramp_segment(void)
+{
+    float level, target;
+
+    /* 일출 중간(부팅/복구) → 남은 20분을 램프 하나로 */
+    scheduler_update(at(7, 10));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.0f / 30.0f, scheduler_get_dimming());
+    TEST_ASSERT(scheduler_next_event_us() == at(7, 30));
+    TEST_ASSERT_EQUAL_UINT32(20 * 60 * 1000, scheduler_get_ramp(at(7, 10), &level, &target));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.0f / 30.0f, level);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, target);
+
+    /* 구간 안에서는 재계산 없이 선형 보간 */
+    TEST_ASSERT(!scheduler_update(at(7, 20)));
+    TEST_ASSERT_EQUAL_UINT32(10 * 60 * 1000, scheduler_get_ramp(at(7, 20), &level, NULL));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 20.0f / 30.0f, level);
+
+    /* 일출 끝 → 완전 점등, 다음 경계는 일몰 시작 */
+    TEST_ASSERT(scheduler_update(at(7, 30)));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, scheduler_get_dimming());
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler_get_ramp(at(7, 30), NULL, NULL));
+    TEST_ASSERT(scheduler_next_event_us() == at(18, 30));
+}
+
+void test_sunset_ramp_then_off(void)
+{
+    float level, target;
+
+    scheduler_update(at(18, 30));
+    TEST_ASSERT_EQUAL_UINT32(30 * 60 * 1000, scheduler_get_ramp(at(18, 30), &level, &target));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, level);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, target);
+    TEST_ASSERT(scheduler_next_event_us() == at(19, 0));
+
+    TEST_ASSERT(scheduler_update(at(19, 0)));
+    TEST_ASSERT(!scheduler_is_light_on());
+    TEST_ASSERT(scheduler_next_event_us() == at(24 + 7, 0));   /* 다음 날 */
+}
+
+void test_overnight_and_no_ramp(void)
+{
+    light_schedule_t night = { .on_hour = 22, .off_hour = 6, .sunrise_min = 0, .sunset_min = 0 };
+    scheduler_set_light(&night);
+    TEST_ASSERT_EQUAL(0, scheduler_next_event_us());
+
+    scheduler_update(at(23, 15));
+    TEST_ASSERT(scheduler_is_light_on());
+    TEST_ASSERT(scheduler_next_event_us() == at(24 + 6, 0));
+}
+
+void test_changes_invalidate_timeline(void)
+{
+    scheduler_update(at(12, 0));
+    TEST_ASSERT(scheduler_next_event_us() == at(18, 30));
+
+    /* 시간대 변경 → 다음 호출에서 재계산 (UTC+9: 12:00 UTC = 21:00 지역) */
+    scheduler_set_utc_offset(9 * 60);
+    TEST_ASSERT_EQUAL(0, scheduler_next_event_us());
+    TEST_ASSERT(scheduler_update(at(12, 0)));
+    TEST_ASSERT(!scheduler_is_light_on());
+    TEST_ASSERT(scheduler_next_event_us() == at(22, 0));   /* 지역 07:00 */
+}
+
+void test_invalid_time_keeps_light_off(void)
+{
+    TEST_ASSERT(scheduler_update(1000000LL));   /* 1970년 */
+    TEST_ASSERT(!scheduler_is_light_on());
+    TEST_ASSERT(scheduler_next_event_us() == 1000000LL + MIN_US);
+}
+
+/* 3/1~ 12/12 야간 -4°C, 11/1~ 10/14 야간 -6°C */
+static const sched_calendar_t s_cal = {
+    .count = 2,
+    .seasons = {
+        { .month = 3,  .day = 1, .light = { 7, 19, 30, 30 }, .night_drop = 4.0f },
+        { .month = 11, .day = 1, .light = { 8, 18, 45, 45 }, .night_drop = 6.0f },
+    },
+};
+
+void test_calendar_night_drop(void)
+{
+    scheduler_set_calendar(&s_cal);
+
+    /* 3/2 새벽: 여름 구간, 소등 중 하강 */
+    scheduler_update(at(3, 0));
+    TEST_ASSERT(!scheduler_is_light_on());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 4.0f, scheduler_get_night_drop());
+    TEST_ASSERT(scheduler_next_event_us() == at(7, 0));
+
+    scheduler_update(at(12, 0));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, scheduler_get_night_drop());
+
+    /* 캘린더 해제 → 하강 없음 */
+    scheduler_set_calendar(NULL);
+    scheduler_update(at(20, 0));
+    TEST_ASSERT(!scheduler_is_light_on());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, scheduler_get_night_drop());
+}
+
+void test_calendar_switches_season_at_midnight(void)
+{
+    scheduler_set_calendar(&s_cal);
+
+    /* 10/31 20:00 소등 → 다음 경계는 자정 (계절 재선택) */
+    scheduler_update(at(20, 0) + 243 * DAY_US);
+    TEST_ASSERT(scheduler_next_event_us() == at(24, 0) + 243 * DAY_US);
+
+    /* 11/1 00:00 겨울 구간: 08:00 점등, 하강 6°C */
+    TEST_ASSERT(scheduler_update(at(24, 0) + 243 * DAY_US));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 6.0f, scheduler_get_night_drop());
+    TEST_ASSERT(scheduler_next_event_us() == at(24 + 8, 0) + 243 * DAY_US);
+
+    /* 1/15: 해를 넘겨 마지막 구간 유지, 일출 45분 */
+    scheduler_update(at(8, 0) + 319 * DAY_US);
+    TEST_ASSERT(scheduler_is_light_on());
+    TEST_ASSERT(scheduler_next_event_us() == at(8, 45) + 319 * DAY_US);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_next_event_is_light_on);
+    RUN_TEST(test_sunrise_is_one_ramp_segment);
+    RUN_TEST(test_sunset_ramp_then_off);
+    RUN_TEST(test_overnight_and_no_ramp);
+    RUN_TEST(test_changes_invalidate_timeline);
+    RUN_TEST(test_invalid_time_keeps_light_off);
+    RUN_TEST(test_calendar_night_drop);
+    RUN_TEST(test_calendar_switches_season_at_midnight);
+    return UNITY_END();
+}
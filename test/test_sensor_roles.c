@@ -0,0 +1,132 @@
+/**
+ * @file test_sensor_roles.c
+ * @brief DS18B20 ROM → role mapping unit tests
+ */
+#include "unity.h"
+#include "sensor_roles.h"
+#include <string.h>
+
+static sensor_role_map_t map;
+static uint8_t roms[4][ONEWIRE_ROM_LEN];
+static uint8_t role_of[4];
+
+static void make_rom(uint8_t *rom, uint8_t serial)
+{
+    memset(rom, 0, ONEWIRE_ROM_LEN);
+    rom[0] = 0x28;
+    rom[1] = serial;
+    rom[6] = 0x03;
+    rom[7] = onewire_crc8(rom, 7);
+}
+
+void setUp(void)
+{
+    memset(&map, 0, sizeof(map));
+    for (int i = 0; i < 4; i++) make_rom(roms[i], (uint8_t)(0x10 + i));
+}
+
+void tearDown(void) {}
+
+void test_first_boot_assigns_in_order(void)
+{
+    TEST_ASSERT(!sensor_roles_valid(&map));
+    TEST_ASSERT(sensor_roles_assign(&map, roms, 3, role_of));
+    TEST_ASSERT(sensor_roles_valid(&map));
+    TEST_ASSERT_EQUAL(SENSOR_ROLE_HOT, role_of[0]);
+    TEST_ASSERT_EQUAL(SENSOR_ROLE_COOL, role_of[1]);
+    TEST_ASSERT_EQUAL(2, role_of[2]);
+
+    /* 같은 구성 → 변경 없음 (NVS 쓰기 불필요) */
+    TEST_ASSERT(!sensor_roles_assign(&map, roms, 3, role_of));
+}
+
+void test_roles_follow_rom_not_order(void)
+{
+    sensor_roles_assign(&map, roms, 2, role_of);
+
+    /* 새 프로브가 검색 순서 맨 앞에 끼어듦 */
+    uint8_t order[3][ONEWIRE_ROM_LEN];
+    memcpy(order[0], roms[3], ONEWIRE_ROM_LEN);
+    memcpy(order[1], roms[1], ONEWIRE_ROM_LEN);
+    memcpy(order[2], roms[0], ONEWIRE_ROM_LEN);
+    TEST_ASSERT(sensor_roles_assign(&map, (const uint8_t (*)[ONEWIRE_ROM_LEN])order, 3, role_of));
+    TEST_ASSERT_EQUAL(2, role_of[0]);
+    TEST_ASSERT_EQUAL(SENSOR_ROLE_COOL, role_of[1]);
+    TEST_ASSERT_EQUAL(SENSOR_ROLE_HOT, role_of[2]);
+    TEST_ASSERT_EQUAL(2, sensor_roles_index(role_of, 3, SENSOR_ROLE_HOT));
+}
+
+void test_replaced_probe_inherits_role(void)
+{
+    sensor_roles_assign(&map, roms, 3, role_of);
+
+    /* HOT 프로브(roms[0]) 고장 → roms[3]으로 교체 */
+    uint8_t now[3][ONEWIRE_ROM_LEN];
+    memcpy(now[0], roms[1], ONEWIRE_ROM_LEN);
+    memcpy(now[1], roms[2], ONEWIRE_ROM_LEN);
+    memcpy(now[2], roms[3], ONEWIRE_ROM_LEN);
+    TEST_ASSERT(sensor_roles_assign(&map, (const uint8_t (*)[ONEWIRE_ROM_LEN])now, 3, role_of));
+    TEST_ASSERT_EQUAL(SENSOR_ROLE_COOL, role_of[0]);
+    TEST_ASSERT_EQUAL(2, role_of[1]);
+    TEST_ASSERT_EQUAL(SENSOR_ROLE_HOT, role_of[2]);
+}
+
+void test_missing_probe_keeps_slot(void)
+{
+    sensor_roles_assign(&map, roms, 3, role_of);
+
+    /* COOL 프로브가 잠시 빠짐 → 역할 표는 그대로, 돌아오면 COOL */
+    uint8_t now[2][ONEWIRE_ROM_LEN];
+    memcpy(now[0], roms[0], ONEWIRE_ROM_LEN);
+    memcpy(now[1], roms[2], ONEWIRE_ROM_LEN);
+    TEST_ASSERT(!sensor_roles_assign(&map, (const uint8_t (*)[ONEWIRE_ROM_LEN])now, 2, role_of));
+    TEST_ASSERT_EQUAL(-1, sensor_roles_index(role_of, 2, SENSOR_ROLE_COOL));
+
+    TEST_ASSERT(!sensor_roles_assign(&map, roms, 3, role_of));
+    TEST_ASSERT_EQUAL(SENSOR_ROLE_COOL, role_of[1]);
+}
+
+void test_swap(void)
+{
+    sensor_roles_assign(&map, roms, 2, role_of);
+    TEST_ASSERT(sensor_roles_swap(&map, SENSOR_ROLE_HOT, SENSOR_ROLE_COOL));
+    TEST_ASSERT(!sensor_roles_assign(&map, roms, 2, role_of));
+    TEST_ASSERT_EQUAL(SENSOR_ROLE_COOL, role_of[0]);
+    TEST_ASSERT_EQUAL(SENSOR_ROLE_HOT, role_of[1]);
+
+    /* 빈 역할과 교환 = 보조 위치로 이동 */
+    TEST_ASSERT(sensor_roles_swap(&map, SENSOR_ROLE_HOT, 5));
+    sensor_roles_assign(&map, roms, 2, role_of);
+    TEST_ASSERT_EQUAL(5, role_of[1]);
+
+    TEST_ASSERT(!sensor_roles_swap(&map, 1, 1));
+    TEST_ASSERT(!sensor_roles_swap(&map, 0, SENSOR_ROLE_MAX));
+}
+
+void test_overflow_and_corruption(void)
+{
+    uint8_t many[SENSOR_ROLE_MAX + 1][ONEWIRE_ROM_LEN];
+    uint8_t roles[SENSOR_ROLE_MAX + 1];
+    for (int i = 0; i <= SENSOR_ROLE_MAX; i++) make_rom(many[i], (uint8_t)(0x40 + i));
+    sensor_roles_assign(&map, (const uint8_t (*)[ONEWIRE_ROM_LEN])many, SENSOR_ROLE_MAX + 1, roles);
+    TEST_ASSERT_EQUAL(SENSOR_ROLE_MAX - 1, roles[SENSOR_ROLE_MAX - 1]);
+    TEST_ASSERT_EQUAL(SENSOR_ROLE_NONE, roles[SENSOR_ROLE_MAX]);
+
+    /* NVS 내용 손상 → 무효, 다음 assign에서 새로 시작 */
+    map.rom[3][2] ^= 0x40;
+    TEST_ASSERT(!sensor_roles_valid(&map));
+    TEST_ASSERT(sensor_roles_assign(&map, roms, 1, role_of));
+    TEST_ASSERT_EQUAL(SENSOR_ROLE_HOT, role_of[0]);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_boot_assigns_in_order);
+    RUN_TEST(test_roles_follow_rom_not_order);
+    RUN_TEST(test_replaced_probe_inherits_role);
+    RUN_TEST(test_missing_probe_keeps_slot);
+    RUN_TEST(test_swap);
+    RUN_TEST(test_overflow_and_corruption);
+    return UNITY_END();
+}
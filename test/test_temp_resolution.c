@@ -0,0 +1,59 @@
+/**
+ * @file test_temp_resolution.c
+ * @brief DS18B20 resolution policy unit tests
+ */
+#include "unity.h"
+#include "temp_resolution.h"
+#include <math.h>
+
+/* 과열 한계 = 32 + 5 */
+#define LIMIT 37.0f
+
+static const temp_resolution_config_t cfg = {
+    .guard_c = 2.0f,
+    .stable_c = 0.25f,
+    .stable_bits = 10,
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_stable_uses_coarse_bits(void)
+{
+    TEST_ASSERT_EQUAL(10, temp_resolution_select(&cfg, 31.9f, 32.0f, LIMIT));
+}
+
+void test_changing_one_step_finer(void)
+{
+    TEST_ASSERT_EQUAL(11, temp_resolution_select(&cfg, 31.0f, 32.0f, LIMIT));
+    TEST_ASSERT_EQUAL(11, temp_resolution_select(&cfg, 31.0f, NAN, LIMIT));
+}
+
+void test_near_limit_full_resolution(void)
+{
+    TEST_ASSERT_EQUAL(12, temp_resolution_select(&cfg, 35.0f, 35.0f, LIMIT));
+    TEST_ASSERT_EQUAL(12, temp_resolution_select(&cfg, 40.0f, 39.0f, LIMIT));
+    TEST_ASSERT_EQUAL(10, temp_resolution_select(&cfg, 34.9f, 34.9f, LIMIT));
+}
+
+void test_unknown_and_bad_config(void)
+{
+    TEST_ASSERT_EQUAL(12, temp_resolution_select(&cfg, NAN, 30.0f, LIMIT));
+    TEST_ASSERT_EQUAL(12, temp_resolution_select(NULL, 30.0f, 30.0f, LIMIT));
+
+    temp_resolution_config_t low = cfg;
+    low.stable_bits = 3;   /* 9비트로 보정 */
+    TEST_ASSERT_EQUAL(9, temp_resolution_select(&low, 30.0f, 30.0f, LIMIT));
+    low.stable_bits = 12;  /* 고정 12비트 */
+    TEST_ASSERT_EQUAL(12, temp_resolution_select(&low, 30.0f, 25.0f, LIMIT));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_stable_uses_coarse_bits);
+    RUN_TEST(test_changing_one_step_finer);
+    RUN_TEST(test_near_limit_full_resolution);
+    RUN_TEST(test_unknown_and_bad_config);
+    return UNITY_END();
+}
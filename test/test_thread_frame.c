@@ -0,0 +1,192 @@
+/**
+ * @file test_thread_frame.c
+ * @brief Uplink frame header / dedup / backoff unit tests
+ */
+#include "unity.h"
+#include "thread_frame.h"
+#include <string.h>
+
+static thread_frame_hdr_t hdr;
+static const uint8_t *payload;
+static size_t payload_len;
+
+void setUp(void) {
+    memset(&hdr, 0, sizeof(hdr));
+    payload = NULL;
+    payload_len = 0;
+}
+void tearDown(void) {}
+
+void test_header_roundtrip(void)
+{
+    const thread_frame_type_t types[] = {
+        THREAD_FRAME_CON, THREAD_FRAME_NON, THREAD_FRAME_ACK, THREAD_FRAME_RST
+    };
+    uint8_t buf[THREAD_FRAME_HDR_LEN + 2];
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(THREAD_FRAME_HDR_LEN, thread_frame_write_hdr(buf, types[i], 0xBEEF));
+        buf[3] = 0xA1;
+        buf[4] = 0x00;
+        TEST_ASSERT_EQUAL(ESP_OK, thread_frame_parse(buf, sizeof(buf), &hdr, &payload, &payload_len));
+        TEST_ASSERT_EQUAL(types[i], hdr.type);
+        TEST_ASSERT_EQUAL(0xBEEF, hdr.mid);
+        TEST_ASSERT_TRUE(payload == buf + THREAD_FRAME_HDR_LEN);
+        TEST_ASSERT_EQUAL(2, payload_len);
+    }
+}
+
+void test_header_wire_format(void)
+{
+    /* 게이트웨이와 맞춘 바이트: CON=0x40, ACK=0x60, mid big endian */
+    uint8_t buf[THREAD_FRAME_HDR_LEN];
+    thread_frame_write_hdr(buf, THREAD_FRAME_CON, 0x1234);
+    TEST_ASSERT_EQUAL(0x40, buf[0]);
+    TEST_ASSERT_EQUAL(0x12, buf[1]);
+    TEST_ASSERT_EQUAL(0x34, buf[2]);
+    thread_frame_write_hdr(buf, THREAD_FRAME_ACK, 0x1234);
+    TEST_ASSERT_EQUAL(0x60, buf[0]);
+}
+
+void test_ack_without_payload(void)
+{
+    uint8_t buf[THREAD_FRAME_HDR_LEN];
+    thread_frame_write_hdr(buf, THREAD_FRAME_ACK, 7);
+    TEST_ASSERT_EQUAL(ESP_OK, thread_frame_parse(buf, sizeof(buf), &hdr, &payload, &payload_len));
+    TEST_ASSERT_EQUAL(THREAD_FRAME_ACK, hdr.type);
+    TEST_ASSERT_EQUAL(0, payload_len);
+}
+
+void test_legacy_cbor_is_unframed(void)
+{
+    /* 헤더 없는 CBOR 맵 (0xA0~0xBF) */
+    const uint8_t legacy[] = { 0xA2, 0x00, 0x03, 0x1E, 0x01 };
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND,
+                      thread_frame_parse(legacy, sizeof(legacy), &hdr, &payload, &payload_len));
+    const uint8_t empty_map[] = { 0xA0 };
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND,
+                      thread_frame_parse(empty_map, 1, &hdr, &payload, &payload_len));
+}
+
+void test_truncated_and_reserved_rejected(void)
+{
+    const uint8_t shortbuf[] = { 0x40, 0x12 };
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE,
+                      thread_frame_parse(shortbuf, sizeof(shortbuf), &hdr, &payload, &payload_len));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE,
+                      thread_frame_parse(shortbuf, 0, &hdr, &payload, &payload_len));
+
+    const uint8_t reserved[] = { 0x41, 0x00, 0x01 };
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED,
+                      thread_frame_parse(reserved, sizeof(reserved), &hdr, &payload, &payload_len));
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG,
+                      thread_frame_parse(NULL, 3, &hdr, &payload, &payload_len));
+}
+
+void test_dedup_detects_retransmit(void)
+{
+    thread_frame_dedup_t d;
+    thread_frame_dedup_reset(&d);
+    TEST_ASSERT_TRUE(!thread_frame_dedup_check(&d, 100));
+    TEST_ASSERT_TRUE(!thread_frame_dedup_check(&d, 101));
+    TEST_ASSERT_TRUE(thread_frame_dedup_check(&d, 100));
+    TEST_ASSERT_TRUE(thread_frame_dedup_check(&d, 101));
+
+    /* contains는 기록하지 않음 (수신 슬롯 확보 전 확인용) */
+    TEST_ASSERT_TRUE(thread_frame_dedup_contains(&d, 100));
+    TEST_ASSERT_TRUE(!thread_frame_dedup_contains(&d, 102));
+    TEST_ASSERT_TRUE(!thread_frame_dedup_check(&d, 102));
+
+    /* reset 후에는 mid 0도 새 메시지 */
+    thread_frame_dedup_reset(&d);
+    TEST_ASSERT_TRUE(!thread_frame_dedup_check(&d, 0));
+}
+
+void test_dedup_ring_forgets_oldest(void)
+{
+    thread_frame_dedup_t d;
+    thread_frame_dedup_reset(&d);
+    for (uint16_t mid = 0; mid < THREAD_FRAME_DEDUP_LEN; mid++) {
+        TEST_ASSERT_TRUE(!thread_frame_dedup_check(&d, mid));
+    }
+    /* 하나 더 넣으면 가장 오래된 mid 0이 밀려남 */
+    TEST_ASSERT_TRUE(!thread_frame_dedup_check(&d, 500));
+    TEST_ASSERT_TRUE(thread_frame_dedup_check(&d, THREAD_FRAME_DEDUP_LEN - 1));
+    TEST_ASSERT_TRUE(thread_frame_dedup_check(&d, 500));
+    TEST_ASSERT_TRUE(!thread_frame_dedup_check(&d, 0));
+}
+
+void test_dedup_keyed_by_source(void)
+{
+    /* 자식 중계: 송신자별 mid 공간이 겹쳐도 서로 다른 메시지 */
+    thread_frame_dedup_t d;
+    thread_frame_dedup_reset(&d);
+    TEST_ASSERT_TRUE(!thread_frame_dedup_check(&d, (0xA8C3u << 16) | 42));
+    TEST_ASSERT_TRUE(!thread_frame_dedup_check(&d, (0x1B07u << 16) | 42));
+    TEST_ASSERT_TRUE(thread_frame_dedup_check(&d, (0xA8C3u << 16) | 42));
+    TEST_ASSERT_TRUE(!thread_frame_dedup_contains(&d, 42));
+}
+
+void test_dedup_key_beyond_last_16_bits(void)
+{
+    /* ML-EID IID 끝 16비트가 같은 두 노드 → 서로 다른 키 */
+    const uint8_t a[8] = {0x3c, 0x91, 0x0e, 0x55, 0x12, 0x7f, 0xa8, 0xc3};
+    const uint8_t b[8] = {0x3c, 0x91, 0x77, 0x02, 0xd4, 0x10, 0xa8, 0xc3};
+    TEST_ASSERT_TRUE(thread_frame_dedup_key(a, 42) != thread_frame_dedup_key(b, 42));
+    TEST_ASSERT_TRUE(thread_frame_dedup_key(a, 42) != thread_frame_dedup_key(a, 43));
+    TEST_ASSERT_TRUE(thread_frame_dedup_key(a, 42) == thread_frame_dedup_key(a, 42));
+
+    thread_frame_dedup_t d;
+    thread_frame_dedup_reset(&d);
+    TEST_ASSERT_TRUE(!thread_frame_dedup_check(&d, thread_frame_dedup_key(a, 42)));
+    TEST_ASSERT_TRUE(!thread_frame_dedup_check(&d, thread_frame_dedup_key(b, 42)));
+}
+
+void test_multicast_con_not_answered(void)
+{
+    /* 게이트웨이 탐색 CON에 노드가 ACK하면 송신자가 노드를 게이트웨이로 학습 */
+    TEST_ASSERT_TRUE(thread_frame_needs_reply(THREAD_FRAME_CON, false));
+    TEST_ASSERT_TRUE(!thread_frame_needs_reply(THREAD_FRAME_CON, true));
+    TEST_ASSERT_TRUE(!thread_frame_needs_reply(THREAD_FRAME_NON, false));
+    TEST_ASSERT_TRUE(!thread_frame_needs_reply(THREAD_FRAME_ACK, false));
+}
+
+void test_backoff_doubles_with_jitter(void)
+{
+    /* rnd = 0 → 지터 없음 */
+    TEST_ASSERT_EQUAL_UINT32(1000, thread_frame_backoff_ms(1000, 0, 0));
+    TEST_ASSERT_EQUAL_UINT32(2000, thread_frame_backoff_ms(1000, 1, 0));
+    TEST_ASSERT_EQUAL_UINT32(8000, thread_frame_backoff_ms(1000, 3, 0));
+
+    /* 지터 상한 +50% */
+    TEST_ASSERT_EQUAL_UINT32(1500, thread_frame_backoff_ms(1000, 0, 512));
+    for (uint32_t rnd = 0; rnd < 5000; rnd += 37) {
+        uint32_t t = thread_frame_backoff_ms(1000, 2, rnd);
+        TEST_ASSERT_TRUE(t >= 4000 && t <= 6000);
+    }
+}
+
+void test_backoff_capped(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(THREAD_FRAME_BACKOFF_MAX_MS, thread_frame_backoff_ms(1000, 10, 0));
+    TEST_ASSERT_EQUAL_UINT32(THREAD_FRAME_BACKOFF_MAX_MS, thread_frame_backoff_ms(1000, 40, 0xFFFFFFFF));
+    TEST_ASSERT_EQUAL_UINT32(1000, thread_frame_backoff_ms(1000, -1, 0));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_header_roundtrip);
+    RUN_TEST(test_header_wire_format);
+    RUN_TEST(test_ack_without_payload);
+    RUN_TEST(test_legacy_cbor_is_unframed);
+    RUN_TEST(test_truncated_and_reserved_rejected);
+    RUN_TEST(test_dedup_detects_retransmit);
+    RUN_TEST(test_dedup_ring_forgets_oldest);
+    RUN_TEST(test_dedup_keyed_by_source);
+    RUN_TEST(test_dedup_key_beyond_last_16_bits);
+    RUN_TEST(test_multicast_con_not_answered);
+    RUN_TEST(test_backoff_doubles_with_jitter);
+    RUN_TEST(test_backoff_capped);
+    return UNITY_END();
+}
@@ -0,0 +1,118 @@
+/**
+ * @file test_time_sync.c
+ * @brief Network time beacon clock discipline unit tests
+ */
+#include "unity.h"
+#include "time_sync.h"
+
+#define SEC 1000000LL
+
+static time_sync_t ts;
+
+/* 시뮬레이션: 실제 시각 s_true, 시스템 시각 s_sys (slow_ppb만큼 느리게 흐름) */
+static int64_t s_true, s_sys;
+
+static void run(int64_t dt_us, int32_t slow_ppb)
+{
+    s_true += dt_us;
+    s_sys += dt_us - dt_us * slow_ppb / 1000000000LL;
+}
+
+void setUp(void)
+{
+    time_sync_init(&ts);
+    s_true = 1790000000LL * SEC;
+    s_sys = 0;
+}
+
+void tearDown(void) {}
+
+void test_first_beacon_steps_clock(void)
+{
+    TEST_ASSERT(!time_sync_is_synced(&ts));
+    TEST_ASSERT_EQUAL(0, time_sync_adjust(&ts, s_sys));
+
+    s_sys += time_sync_beacon(&ts, s_sys, s_true);
+    TEST_ASSERT(time_sync_is_synced(&ts));
+    TEST_ASSERT(s_sys == s_true);
+    TEST_ASSERT_EQUAL(0, ts.drift_ppb);
+}
+
+void test_drift_learned_from_beacons(void)
+{
+    /* 200 ppm 느린 RTC, 5분마다 비콘 */
+    const int32_t slow = 200000;
+    s_sys += time_sync_beacon(&ts, s_sys, s_true);
+    for (int i = 0; i < 36; i++) {   /* 3시간 */
+        run(300 * SEC, slow);
+        s_sys += time_sync_beacon(&ts, s_sys, s_true);
+    }
+    TEST_ASSERT_UINT32_WITHIN(5000, slow, (uint32_t)ts.drift_ppb);
+    TEST_ASSERT(ts.drift_updates >= 5);
+
+    /* 비콘 없이 30분: wake마다 adjust로 오차 유지 */
+    for (int i = 0; i < 6; i++) {
+        run(300 * SEC, slow);
+        s_sys += time_sync_adjust(&ts, s_sys);
+    }
+    int64_t err = s_true - s_sys;
+    TEST_ASSERT(err < 10000 && err > -10000);   /* 10 ms 이내 (무보정이면 360 ms) */
+}
+
+void test_jittered_beacons_converge(void)
+{
+    /* 비콘 수신 지연 0~100 ms → 측정 구간 평균으로 수십 ppm 이내 */
+    const int32_t slow = -150000;
+    uint32_t lcg = 12345;
+    s_sys += time_sync_beacon(&ts, s_sys, s_true);
+    for (int i = 0; i < 72; i++) {
+        run(300 * SEC, slow);
+        lcg = lcg * 1103515245u + 12345u;
+        int64_t delay = (int64_t)((lcg >> 16) % 100000);
+        s_sys += time_sync_beacon(&ts, s_sys + delay, s_true);
+    }
+    TEST_ASSERT(ts.drift_ppb < slow + 60000 && ts.drift_ppb > slow - 60000);
+}
+
+void test_step_keeps_drift(void)
+{
+    const int32_t slow = 100000;
+    s_sys += time_sync_beacon(&ts, s_sys, s_true);
+    for (int i = 0; i < 12; i++) {
+        run(300 * SEC, slow);
+        s_sys += time_sync_beacon(&ts, s_sys, s_true);
+    }
+    int32_t drift = ts.drift_ppb;
+    TEST_ASSERT_GREATER_THAN(0, drift);
+
+    /* 서버 시각 1시간 변경 → 재설정, 드리프트 유지 */
+    s_true += 3600 * SEC;
+    run(300 * SEC, slow);
+    s_sys += time_sync_beacon(&ts, s_sys, s_true);
+    TEST_ASSERT(s_sys == s_true);
+    TEST_ASSERT_EQUAL(drift, ts.drift_ppb);
+    TEST_ASSERT(ts.accum_us == 0);
+}
+
+void test_drift_clamped(void)
+{
+    /* 10% 느린 시계 (비정상) → 한계에서 멈춤, 오차는 매번 재설정 */
+    s_sys += time_sync_beacon(&ts, s_sys, s_true);
+    for (int i = 0; i < 40; i++) {
+        run(10 * SEC, 100000000);
+        s_sys += time_sync_beacon(&ts, s_sys, s_true);
+    }
+    TEST_ASSERT(ts.drift_ppb <= TIME_SYNC_DRIFT_MAX_PPB);
+    TEST_ASSERT(s_sys == s_true);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_beacon_steps_clock);
+    RUN_TEST(test_drift_learned_from_beacons);
+    RUN_TEST(test_jittered_beacons_converge);
+    RUN_TEST(test_step_keeps_drift);
+    RUN_TEST(test_drift_clamped);
+    return UNITY_END();
+}
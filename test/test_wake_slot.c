@@ -0,0 +1,97 @@
+/**
+ * @file test_wake_slot.c
+ * @brief Type B wake slot assignment unit tests
+ */
+#include "unity.h"
+#include "wake_slot.h"
+
+#define FRAME_MS 30000
+#define SLOT_MS  500
+#define SLOTS    (FRAME_MS / SLOT_MS)
+
+static const wake_slot_config_t cfg = { .frame_ms = FRAME_MS, .slot_ms = SLOT_MS };
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_index_in_range_and_spread(void)
+{
+    int used[SLOTS] = {0};
+    int distinct = 0;
+
+    /* 연속 MAC 50대 → 60슬롯에 고르게 */
+    for (uint64_t mac = 0x40CC0E000000ULL; mac < 0x40CC0E000000ULL + 50; mac++) {
+        uint32_t s = wake_slot_index(&cfg, mac, 0);
+        TEST_ASSERT_LESS_THAN(SLOTS, s);
+        if (used[s]++ == 0) distinct++;
+    }
+    TEST_ASSERT_GREATER_THAN(25, distinct);
+}
+
+void test_epoch_reshuffles(void)
+{
+    int moved = 0;
+    for (uint64_t mac = 1; mac <= 20; mac++) {
+        if (wake_slot_index(&cfg, mac, 1) != wake_slot_index(&cfg, mac, 2)) moved++;
+    }
+    TEST_ASSERT_GREATER_THAN(15, moved);
+    TEST_ASSERT_EQUAL(wake_slot_index(&cfg, 7, 3), wake_slot_index(&cfg, 7, 3));
+}
+
+void test_wake_lands_on_slot_center(void)
+{
+    uint32_t slot = 17;
+    uint64_t center = slot * SLOT_MS + SLOT_MS / 2;
+    uint64_t now = 1234567;
+
+    for (int i = 0; i < 5; i++) {
+        uint32_t sleep = wake_slot_sleep_ms(&cfg, slot, now, 300);
+        TEST_ASSERT_EQUAL(center, (now + sleep) % FRAME_MS);
+        TEST_ASSERT_GREATER_THAN(300000 - FRAME_MS / 2 - 1, sleep);
+        TEST_ASSERT_LESS_THAN(300000 + FRAME_MS / 2, sleep);
+        now += sleep + 850;   /* wake 동안 경과 */
+    }
+}
+
+void test_period_rounded_to_frames(void)
+{
+    /* 139초 → 5프레임(150초) 근처, 10초 → 최소 1프레임 */
+    uint32_t sleep = wake_slot_sleep_ms(&cfg, 0, 0, 139);
+    TEST_ASSERT_UINT32_WITHIN(FRAME_MS / 2, 150000, sleep);
+    sleep = wake_slot_sleep_ms(&cfg, 0, 0, 10);
+    TEST_ASSERT_UINT32_WITHIN(FRAME_MS / 2, FRAME_MS, sleep);
+    TEST_ASSERT_GREATER_THAN(0, sleep);
+}
+
+void test_drift_within_slot(void)
+{
+    /* RTC 500 ppm 오차: 300초 sleep 후에도 깨는 시각은 슬롯 안 */
+    uint32_t slot = 3;
+    uint64_t center = slot * SLOT_MS + SLOT_MS / 2;
+    uint32_t sleep = wake_slot_sleep_ms(&cfg, slot, 5000, 300);
+    uint64_t actual = 5000 + sleep + sleep / 2000;
+    TEST_ASSERT_LESS_THAN(SLOT_MS / 2, (uint32_t)(actual % FRAME_MS - center));
+
+    /* 늦게 깬 다음 wake도 다시 슬롯 중앙으로 */
+    sleep = wake_slot_sleep_ms(&cfg, slot, actual + 700, 300);
+    TEST_ASSERT_EQUAL(center, (actual + 700 + sleep) % FRAME_MS);
+}
+
+void test_disabled_config_returns_period(void)
+{
+    wake_slot_config_t off = { .frame_ms = 0, .slot_ms = 0 };
+    TEST_ASSERT_EQUAL_UINT32(300000, wake_slot_sleep_ms(&off, 0, 999, 300));
+    TEST_ASSERT_EQUAL(0, wake_slot_index(&off, 1, 1));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_index_in_range_and_spread);
+    RUN_TEST(test_epoch_reshuffles);
+    RUN_TEST(test_wake_lands_on_slot_center);
+    RUN_TEST(test_period_rounded_to_frames);
+    RUN_TEST(test_drift_within_slot);
+    RUN_TEST(test_disabled_config_returns_period);
+    return UNITY_END();
+}
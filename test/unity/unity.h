@@ -16,16 +16,22 @@ extern int unity_test_failures;
 extern const char *unity_current_test;
 
 /* --- API --- */
-#define UNITY_BEGIN() (unity_test_count = 0, unity_test_failures = 0, 0)
+#define UNITY_BEGIN() do { unity_test_count = 0; unity_test_failures = 0; } while (0)
 
 #define UNITY_END() (printf("\n%d Tests %d Failures\n", \
     unity_test_count, unity_test_failures), unity_test_failures)
 
+void setUp(void);
+void tearDown(void);
+
 #define RUN_TEST(func) do { \
+    int _fail_before = unity_test_failures; \
     unity_current_test = #func; \
     unity_test_count++; \
+    setUp(); \
     func(); \
-    printf("  PASS: %s\n", #func); \
+    tearDown(); \
+    if (unity_test_failures == _fail_before) printf("  PASS: %s\n", #func); \
 } while(0)
 
 /* --- Assertions --- */
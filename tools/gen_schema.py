@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""
+RBMS 텔레메트리 스키마 생성기 — schema/telemetry.json 단일 원본에서
+펌웨어 C 헤더와 서버 Python 모듈을 생성
+
+사용법:
+    python tools/gen_schema.py           # 생성 파일 갱신
+    python tools/gen_schema.py --check   # 생성 파일이 스키마와 다르면 실패 (CI)
+
+출력:
+    firmware/components/comm/include/telemetry_schema.h  (키/필드 X-macro)
+    server/gateway/rbms_schema.py                        (게이트웨이)
+    server/bridge/rbms_schema.py                         (브릿지)
+"""
+
+import argparse
+import json
+import sys
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+SCHEMA_PATH = ROOT / "schema" / "telemetry.json"
+C_HEADER = ROOT / "firmware" / "components" / "comm" / "include" / "telemetry_schema.h"
+PY_MODULES = [
+    ROOT / "server" / "gateway" / "rbms_schema.py",
+    ROOT / "server" / "bridge" / "rbms_schema.py",
+]
+
+KINDS = ("scaled", "enum")
+FIELD_KEY_MAX = 23  # 1 byte CBOR 키 (0~23)
+
+
+def load_schema(path: Path) -> dict:
+    """스키마 로드 + 검증 (키 중복/범위, 이름 중복)"""
+    with open(path, encoding="utf-8") as f:
+        schema = json.load(f)
+
+    errors = []
+    proto = schema["protocol_keys"]
+    used = {v: f"protocol {k}" for k, v in proto.items()}
+    names = set()
+    for field in schema["fields"]:
+        key, name = field["key"], field["name"]
+        if not 1 <= key <= FIELD_KEY_MAX:
+            errors.append(f"{name}: key {key} out of range 1..{FIELD_KEY_MAX}")
+        if key in used:
+            errors.append(f"{name}: key {key} already used by {used[key]}")
+        used[key] = name
+        if name in names:
+            errors.append(f"duplicate field name {name}")
+        names.add(name)
+        if field["kind"] not in KINDS:
+            errors.append(f"{name}: unknown kind {field['kind']}")
+        field.setdefault("id", name.upper())
+        field.setdefault("influx", name)
+    for name in schema["batch_sample_fields"]:
+        if name not in names:
+            errors.append(f"batch sample field {name} not in fields")
+    if len(schema["fields"]) > 16:
+        errors.append("more than 16 fields (template field mask is 16-bit)")
+
+    if errors:
+        for e in errors:
+            print(f"[!] {path.name}: {e}", file=sys.stderr)
+        sys.exit(1)
+    return schema
+
+
+def gen_c_header(schema: dict) -> str:
+    fields = schema["fields"]
+    id_w = max(len(f["id"]) for f in fields)
+    name_w = max(len(f["name"]) for f in fields)
+
+    out = [
+        "/**",
+        " * @file telemetry_schema.h",
+        " * @brief 텔레메트리 스키마 (자동 생성 — 직접 수정 금지)",
+        " *",
+        " * 원본: schema/telemetry.json",
+        " * 갱신: python tools/gen_schema.py",
+        " */",
+        "#ifndef RBMS_TELEMETRY_SCHEMA_H",
+        "#define RBMS_TELEMETRY_SCHEMA_H",
+        "",
+        f"#define RBMS_SCHEMA_VERSION  {schema['version']}",
+        f"#define RBMS_SCALED_FACTOR   {schema['scaled_factor']}",
+        "",
+        "/* 프로토콜 키 */",
+    ]
+    proto_w = max(len(k) for k in schema["protocol_keys"])
+    for k, v in schema["protocol_keys"].items():
+        out.append(f"#define RBMS_KEY_{k:<{proto_w}}  {v}")
+    out += ["", "/* 메시지 타입 (키 0 값) */"]
+    msg_w = max(len(k) for k in schema["message_types"])
+    for k, v in schema["message_types"].items():
+        out.append(f"#define RBMS_MSG_{k:<{msg_w}}  {v}")
+
+    out += [
+        "",
+        "/* 필드 값 종류 */",
+        "#define RBMS_KIND_SCALED  0  /* float, SCALED 포맷에서 x100 정수 */",
+        "#define RBMS_KIND_ENUM    1  /* int, 정수 그대로 */",
+        "",
+        "/*",
+        " * 텔레메트리 필드 (인코딩 순서)",
+        " *   X(ID, key, sensor_report_t 멤버, kind, optional)",
+        " *   optional = 1 이면 음수 값일 때 인코딩 생략",
+        " */",
+        "#define RBMS_TELEMETRY_FIELDS(X) \\",
+    ]
+    for f in fields:
+        kind = "RBMS_KIND_" + f["kind"].upper()
+        out.append(f"    X({f['id'] + ',':<{id_w + 1}} {f['key']:>2}, "
+                   f"{f['name'] + ',':<{name_w + 1}} {kind + ',':<17} "
+                   f"{1 if f['optional'] else 0}) \\")
+    out[-1] = out[-1].rstrip(" \\")
+    out += [
+        "",
+        f"#define RBMS_TELEMETRY_FIELD_COUNT  {len(fields)}",
+        "",
+        "#endif /* RBMS_TELEMETRY_SCHEMA_H */",
+        "",
+    ]
+    return "\n".join(out)
+
+
+def gen_py_module(schema: dict) -> str:
+    fields = schema["fields"]
+    influx = {f["name"]: f["influx"] for f in fields}
+    out = [
+        '"""',
+        "RBMS 텔레메트리 스키마 (자동 생성 — 직접 수정 금지)",
+        "",
+        "원본: schema/telemetry.json",
+        "갱신: python tools/gen_schema.py",
+        '"""',
+        "",
+        f"SCHEMA_VERSION = {schema['version']}",
+        f"SCALED_FACTOR = {float(schema['scaled_factor'])!r}",
+        "",
+        "# 프로토콜 키",
+    ]
+    for k, v in schema["protocol_keys"].items():
+        out.append(f"KEY_{k} = {v}")
+    out += ["", "# 메시지 타입 (키 0 값)"]
+    for k, v in schema["message_types"].items():
+        out.append(f"MSG_{k} = {v}")
+
+    out += ["", "# (키, InfluxDB 필드 이름, SCALED 포맷에서 x100 여부)", "FIELDS = ("]
+    for f in fields:
+        out.append(f"    ({f['key']}, \"{f['influx']}\", {f['kind'] == 'scaled'}),")
+    out += [
+        ")",
+        "",
+        "FIELD_MAP = {key: name for key, name, _ in FIELDS}",
+        "UNSCALED_KEYS = frozenset(key for key, _, scaled in FIELDS if not scaled)",
+        "BATCH_SAMPLE_FIELDS = ("
+        + ", ".join(f'"{influx[n]}"' for n in schema["batch_sample_fields"])
+        + ("," if len(schema["batch_sample_fields"]) == 1 else "") + ")",
+        "",
+        "# 게이트웨이 검증용: 텔레메트리 + 프로토콜 키",
+        "VALID_KEYS = frozenset(FIELD_MAP) | frozenset({",
+    ]
+    out += [f"    KEY_{k}," for k in schema["protocol_keys"]]
+    out += ["})", ""]
+    return "\n".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="RBMS 텔레메트리 스키마 생성")
+    parser.add_argument("--check", action="store_true",
+                        help="생성 파일이 최신인지 확인만 (다르면 exit 1)")
+    args = parser.parse_args()
+
+    schema = load_schema(SCHEMA_PATH)
+    outputs = [(C_HEADER, gen_c_header(schema))]
+    py = gen_py_module(schema)
+    outputs += [(path, py) for path in PY_MODULES]
+
+    stale = []
+    for path, content in outputs:
+        current = path.read_text(encoding="utf-8") if path.exists() else None
+        if current == content:
+            continue
+        if args.check:
+            stale.append(path)
+        else:
+            path.write_text(content, encoding="utf-8", newline="\n")
+            print(f"[+] {path.relative_to(ROOT)}")
+
+    if stale:
+        for path in stale:
+            print(f"[!] {path.relative_to(ROOT)} is out of date", file=sys.stderr)
+        print("    run: python tools/gen_schema.py", file=sys.stderr)
+        return 1
+    if args.check:
+        print(f"[OK] schema v{schema['version']}: generated files up to date")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())